@@ -0,0 +1,443 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-stream.h"
+
+#include "boolean.h"
+#include "global-value.h"
+#include "log.h"
+#include "uinteger.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AsyncFileStream");
+
+/**
+ * \ingroup core
+ * \anchor GlobalValueAsyncTraceWriter
+ * \brief A global switch to write the trace files from a background thread.
+ */
+static GlobalValue g_asyncTraceWriter =
+    GlobalValue("AsyncTraceWriter",
+                "A global switch to write the pcap and ascii trace files from a background thread",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
+/**
+ * \ingroup core
+ * \anchor GlobalValueAsyncTraceBufferLimit
+ * \brief The number of bytes of trace files waiting for the background thread.
+ */
+static GlobalValue g_asyncTraceBufferLimit =
+    GlobalValue("AsyncTraceBufferLimit",
+                "The number of bytes of trace files waiting for the background thread "
+                "above which the simulation waits for it",
+                UintegerValue(64 << 20),
+                MakeUintegerChecker<uint64_t>());
+
+/** Size of the blocks of an AsyncFileBuf. */
+static constexpr std::size_t BLOCK_SIZE = 64 << 10;
+
+/**
+ * \ingroup core
+ *
+ * \brief The thread writing the blocks of all the AsyncFileBuf
+ *
+ * The thread runs while a file is open.  It takes all the waiting
+ * blocks at once, so that the blocks of a file which filled up together
+ * are written back to back.
+ */
+class AsyncFileWriter
+{
+  public:
+    /** \returns the writer */
+    static AsyncFileWriter& Get();
+
+    ~AsyncFileWriter();
+
+    /**
+     * Start the thread, if no file was open.
+     *
+     * \param file the file opened
+     */
+    void Attach(AsyncFileBuf* file);
+    /**
+     * Stop the thread, if no file is open any more.
+     *
+     * \param file the file closed
+     */
+    void Detach(AsyncFileBuf* file);
+
+    /**
+     * Queue a block, and replace it by a free one.
+     *
+     * \param file the file of the block
+     * \param block the block
+     * \param size the number of characters of the block
+     * \returns false if the thread failed to write to the file
+     */
+    bool Submit(AsyncFileBuf* file, std::vector<char>& block, std::size_t size);
+
+    /**
+     * Wait until the thread has written all the blocks of a file.
+     *
+     * \param file the file
+     * \returns false if the thread failed to write to the file
+     */
+    bool Drain(AsyncFileBuf* file);
+
+    /** Hand the current block of all the open files over, and wait until they are written. */
+    void FlushAll();
+
+  private:
+    /** A block waiting for the thread. */
+    struct Job
+    {
+        AsyncFileBuf* file;      //!< the file of the block
+        std::vector<char> block; //!< the block
+        std::size_t size;        //!< the number of characters of the block
+        bool written;            //!< whether the block was written
+    };
+
+    /** Body of the thread. */
+    void Run();
+
+    std::mutex m_mutex;                          //!< protects the writer and the files
+    std::condition_variable m_work;              //!< wakes the thread up
+    std::condition_variable m_done;              //!< signals written blocks
+    std::deque<Job> m_jobs;                      //!< the blocks waiting for the thread
+    std::vector<std::vector<char>> m_freeBlocks; //!< the blocks written
+    uint64_t m_pendingBytes{0};                  //!< number of characters in m_jobs
+    uint64_t m_limit{0};                         //!< limit of m_pendingBytes
+    std::set<AsyncFileBuf*> m_files;             //!< the open files
+    bool m_stop{false};                          //!< asks the thread to exit
+    std::thread m_thread;                        //!< the thread
+};
+
+AsyncFileWriter&
+AsyncFileWriter::Get()
+{
+    static AsyncFileWriter writer;
+    return writer;
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_work.notify_one();
+        m_thread.join();
+    }
+}
+
+void
+AsyncFileWriter::Attach(AsyncFileBuf* file)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.insert(file);
+    if (m_files.size() == 1)
+    {
+        UintegerValue limit;
+        g_asyncTraceBufferLimit.GetValue(limit);
+        m_limit = limit.Get();
+        m_stop = false;
+        m_thread = std::thread(&AsyncFileWriter::Run, this);
+    }
+}
+
+void
+AsyncFileWriter::Detach(AsyncFileBuf* file)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_files.erase(file);
+    if (m_files.empty())
+    {
+        m_stop = true;
+        lock.unlock();
+        m_work.notify_one();
+        m_thread.join();
+        m_freeBlocks.clear();
+    }
+}
+
+bool
+AsyncFileWriter::Submit(AsyncFileBuf* file, std::vector<char>& block, std::size_t size)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this, size]() {
+        return m_pendingBytes == 0 || m_pendingBytes + size <= m_limit;
+    });
+    m_pendingBytes += size;
+    ++file->m_pending;
+    m_jobs.push_back({file, std::move(block), size, false});
+    if (m_freeBlocks.empty())
+    {
+        block = std::vector<char>(BLOCK_SIZE);
+    }
+    else
+    {
+        block = std::move(m_freeBlocks.back());
+        m_freeBlocks.pop_back();
+    }
+    bool ok = !file->m_failed;
+    lock.unlock();
+    m_work.notify_one();
+    return ok;
+}
+
+bool
+AsyncFileWriter::Drain(AsyncFileBuf* file)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [file]() { return file->m_pending == 0; });
+    return !file->m_failed;
+}
+
+void
+AsyncFileWriter::FlushAll()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::set<AsyncFileBuf*> files = m_files;
+    lock.unlock();
+    for (auto file : files)
+    {
+        file->Submit();
+    }
+    for (auto file : files)
+    {
+        file->Drain();
+    }
+}
+
+void
+AsyncFileWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_work.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty())
+        {
+            return;
+        }
+        std::deque<Job> jobs;
+        jobs.swap(m_jobs);
+        lock.unlock();
+
+        // The files are only touched by this thread while they have
+        // blocks waiting
+        for (auto& job : jobs)
+        {
+            std::streamsize size = job.size;
+            job.written = job.file->m_file.sputn(job.block.data(), size) == size;
+        }
+
+        lock.lock();
+        for (auto& job : jobs)
+        {
+            job.file->m_failed |= !job.written;
+            --job.file->m_pending;
+            m_pendingBytes -= job.size;
+            m_freeBlocks.push_back(std::move(job.block));
+        }
+        m_done.notify_all();
+    }
+}
+
+AsyncFileBuf::AsyncFileBuf()
+    : m_submitted(0),
+      m_append(false),
+      m_pending(0),
+      m_failed(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+AsyncFileBuf::~AsyncFileBuf()
+{
+    NS_LOG_FUNCTION(this);
+    if (IsOpen())
+    {
+        Close();
+    }
+}
+
+bool
+AsyncFileBuf::IsEnabled()
+{
+    BooleanValue enabled;
+    g_asyncTraceWriter.GetValue(enabled);
+    return enabled.Get();
+}
+
+bool
+AsyncFileBuf::Open(const std::string& filename, std::ios::openmode mode)
+{
+    NS_LOG_FUNCTION(this << filename << mode);
+    NS_ASSERT((mode & std::ios::in) == 0);
+    // Write each block with a single system call
+    m_file.pubsetbuf(nullptr, 0);
+    if (IsOpen() || !m_file.open(filename, mode | std::ios::out))
+    {
+        return false;
+    }
+    m_submitted = 0;
+    m_append = (mode & std::ios::app) != 0;
+    m_failed = false;
+    m_block.resize(BLOCK_SIZE);
+    setp(m_block.data(), m_block.data() + m_block.size());
+    AsyncFileWriter::Get().Attach(this);
+    return true;
+}
+
+bool
+AsyncFileBuf::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!IsOpen())
+    {
+        return false;
+    }
+    bool ok = Submit();
+    ok = Drain() && ok;
+    ok = m_file.close() != nullptr && ok;
+    AsyncFileWriter::Get().Detach(this);
+    setp(nullptr, nullptr);
+    return ok;
+}
+
+bool
+AsyncFileBuf::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+AsyncFileBuf::int_type
+AsyncFileBuf::overflow(int_type c)
+{
+    if (!IsOpen() || !Submit())
+    {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+void
+AsyncFileBuf::FlushAll()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    AsyncFileWriter::Get().FlushAll();
+}
+
+int
+AsyncFileBuf::sync()
+{
+    // The ascii traces flush each line, so flushing leaves the content
+    // in the block until it fills up, the file is closed or FlushAll()
+    // is called on a fatal error
+    return 0;
+}
+
+AsyncFileBuf::pos_type
+AsyncFileBuf::seekoff(off_type off, std::ios::seekdir dir, std::ios::openmode which)
+{
+    off_type current = m_submitted + (pptr() - pbase());
+    if (!IsOpen() || m_append || (which & std::ios::out) == 0 ||
+        (dir == std::ios::beg ? off : dir == std::ios::cur ? current + off : -1) != current)
+    {
+        return pos_type(off_type(-1));
+    }
+    return pos_type(current);
+}
+
+AsyncFileBuf::pos_type
+AsyncFileBuf::seekpos(pos_type pos, std::ios::openmode which)
+{
+    return seekoff(off_type(pos), std::ios::beg, which);
+}
+
+bool
+AsyncFileBuf::Submit()
+{
+    std::size_t size = pptr() - pbase();
+    if (size == 0)
+    {
+        return true;
+    }
+    m_submitted += size;
+    bool ok = AsyncFileWriter::Get().Submit(this, m_block, size);
+    setp(m_block.data(), m_block.data() + m_block.size());
+    return ok;
+}
+
+bool
+AsyncFileBuf::Drain()
+{
+    return AsyncFileWriter::Get().Drain(this);
+}
+
+AsyncFileStream::AsyncFileStream(const std::string& filename, std::ios::openmode mode)
+    : std::ostream(nullptr)
+{
+    NS_LOG_FUNCTION(this << filename << mode);
+    rdbuf(&m_buf);
+    if (!m_buf.Open(filename, mode))
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+AsyncFileStream::~AsyncFileStream()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_buf.IsOpen())
+    {
+        m_buf.Close();
+    }
+}
+
+bool
+AsyncFileStream::IsOpen() const
+{
+    return m_buf.IsOpen();
+}
+
+void
+AsyncFileStream::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_buf.Close())
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,153 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_STREAM_H
+#define ASYNC_FILE_STREAM_H
+
+#include <fstream>
+#include <ostream>
+#include <stdint.h>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup core
+ *
+ * \brief A stream buffer writing a file from a background thread
+ *
+ * The characters are copied into a block of the buffer, and each full
+ * block is handed over to a writer thread shared by all the buffers,
+ * which writes it to the file with a single system call.  The thread
+ * calling the buffer only blocks when the blocks waiting for the writer
+ * thread exceed the AsyncTraceBufferLimit global value, and on Close(),
+ * which waits until the whole content is written.  Flushing the stream
+ * does not hand the current block over, since the ascii traces flush
+ * each line; FatalImpl::FlushStreams() calls FlushAll() instead, so that
+ * the files are complete on a fatal error.
+ *
+ * The buffer only seeks to its current position, which lets a new file
+ * be rewound to its start before anything is written.
+ */
+class AsyncFileBuf : public std::streambuf
+{
+  public:
+    AsyncFileBuf();
+    ~AsyncFileBuf() override;
+
+    /**
+     * \returns true if the AsyncTraceWriter global value asks trace files
+     *          to be written by the background thread
+     */
+    static bool IsEnabled();
+
+    /**
+     * Hand the current block of all the open buffers over to the writer
+     * thread, and wait until it has written them.
+     */
+    static void FlushAll();
+
+    /**
+     * Open a file for writing.
+     *
+     * \param filename the name of the file
+     * \param mode the mode of the file, which must not include std::ios::in
+     * \returns true if the file was opened
+     */
+    bool Open(const std::string& filename, std::ios::openmode mode);
+
+    /**
+     * Wait until the content of the buffer is written, and close the file.
+     *
+     * \returns true if all the content was written
+     */
+    bool Close();
+
+    /**
+     * \returns true if the file is open
+     */
+    bool IsOpen() const;
+
+  protected:
+    int_type overflow(int_type c) override;
+    int sync() override;
+    pos_type seekoff(off_type off,
+                     std::ios::seekdir dir,
+                     std::ios::openmode which = std::ios::out) override;
+    pos_type seekpos(pos_type pos, std::ios::openmode which = std::ios::out) override;
+
+  private:
+    friend class AsyncFileWriter;
+
+    /**
+     * Hand the current block over to the writer thread and get a new one.
+     *
+     * \returns false if the writer thread failed to write to the file
+     */
+    bool Submit();
+
+    /**
+     * Wait until the writer thread has written all the blocks of the file.
+     *
+     * \returns false if the writer thread failed to write to the file
+     */
+    bool Drain();
+
+    std::filebuf m_file;       //!< the file, written by the writer thread while open
+    std::vector<char> m_block; //!< the block being filled
+    int64_t m_submitted;       //!< number of characters handed over to the writer thread
+    bool m_append;             //!< whether the file is open in append mode
+    uint32_t m_pending;        //!< number of blocks waiting for the writer thread
+    bool m_failed;             //!< whether the writer thread failed to write a block
+};
+
+/**
+ * \ingroup core
+ *
+ * \brief An output file stream writing through an AsyncFileBuf
+ */
+class AsyncFileStream : public std::ostream
+{
+  public:
+    /**
+     * Open a file for writing.
+     *
+     * \param filename the name of the file
+     * \param mode the mode of the file, which must not include std::ios::in
+     */
+    AsyncFileStream(const std::string& filename, std::ios::openmode mode);
+
+    ~AsyncFileStream() override;
+
+    /**
+     * \returns true if the file is open
+     */
+    bool IsOpen() const;
+
+    /**
+     * Wait until the content of the stream is written, and close the file.
+     */
+    void Close();
+
+  private:
+    AsyncFileBuf m_buf; //!< the stream buffer
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_STREAM_H */
@@ -20,11 +20,15 @@
 #include "default-simulator-impl.h"
 
 #include "assert.h"
+#include "enum.h"
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
 
+#include <chrono>
 #include <cmath>
+#include <fstream>
 
 /**
  * \file
@@ -48,7 +52,23 @@ DefaultSimulatorImpl::GetTypeId()
     static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
                             .SetParent<SimulatorImpl>()
                             .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+                            .AddConstructor<DefaultSimulatorImpl>()
+                            .AddAttribute("ProfileFile",
+                                          "The file to write the run time of the events to, "
+                                          "per event type and context, at Simulator::Destroy.  "
+                                          "The events are not profiled when empty.",
+                                          StringValue(""),
+                                          MakeStringAccessor(&DefaultSimulatorImpl::m_profileFile),
+                                          MakeStringChecker())
+                            .AddAttribute("ProfileFormat",
+                                          "The format of the event profile.",
+                                          EnumValue(EventProfiler::FOLDED),
+                                          MakeEnumAccessor<EventProfiler::Format>(
+                                              &DefaultSimulatorImpl::m_profileFormat),
+                                          MakeEnumChecker(EventProfiler::FOLDED,
+                                                          "Folded",
+                                                          EventProfiler::CSV,
+                                                          "Csv"));
     return tid;
 }
 
@@ -64,6 +84,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_eventCount = 0;
     m_eventsWithContextEmpty = true;
     m_mainThreadId = std::this_thread::get_id();
+    m_profileFormat = EventProfiler::FOLDED;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl()
@@ -100,6 +121,17 @@ DefaultSimulatorImpl::Destroy()
             ev->Invoke();
         }
     }
+
+    if (m_profiler)
+    {
+        std::ofstream os(m_profileFile);
+        if (!os.is_open())
+        {
+            NS_LOG_ERROR("Cannot open event profile file " << m_profileFile);
+        }
+        m_profiler->Write(os, m_profileFormat);
+        m_profiler = nullptr;
+    }
 }
 
 void
@@ -141,7 +173,20 @@ DefaultSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (m_profiler)
+    {
+        auto start = std::chrono::steady_clock::now();
+        next.impl->Invoke();
+        auto duration = std::chrono::steady_clock::now() - start;
+        m_profiler->Record(
+            next.impl,
+            next.key.m_context,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    }
+    else
+    {
+        next.impl->Invoke();
+    }
     next.impl->Unref();
 
     ProcessEventsWithContext();
@@ -189,6 +234,10 @@ DefaultSimulatorImpl::Run()
     NS_LOG_FUNCTION(this);
     // Set the current threadId as the main threadId
     m_mainThreadId = std::this_thread::get_id();
+    if (!m_profileFile.empty() && !m_profiler)
+    {
+        m_profiler = std::make_unique<EventProfiler>();
+    }
     ProcessEventsWithContext();
     m_stop = false;
 
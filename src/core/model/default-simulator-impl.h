@@ -20,10 +20,13 @@
 #ifndef DEFAULT_SIMULATOR_IMPL_H
 #define DEFAULT_SIMULATOR_IMPL_H
 
+#include "event-profiler.h"
 #include "simulator-impl.h"
 
 #include <list>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 
 /**
@@ -42,6 +45,11 @@ class Scheduler;
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * Setting the ProfileFile attribute enables the profiling of the events:
+ * the wall clock run time of each event is attributed to its type and
+ * context by an EventProfiler, whose report is written to the file at
+ * Simulator::Destroy.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -136,6 +144,13 @@ class DefaultSimulatorImpl : public SimulatorImpl
 
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
+
+    /** The file to write the event profile to, empty to disable profiling. */
+    std::string m_profileFile;
+    /** The format of the event profile. */
+    EventProfiler::Format m_profileFormat;
+    /** The event profiler, when profiling is enabled. */
+    std::unique_ptr<EventProfiler> m_profiler;
 };
 
 } // namespace ns3
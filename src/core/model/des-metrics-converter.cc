@@ -0,0 +1,286 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::DesMetricsConverter implementation.
+ */
+
+#include "des-metrics-converter.h"
+
+#include "des-metrics.h"
+#include "simulator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * Read a value from the trace.
+ *
+ * \tparam T \deduced The type of the value.
+ * \param [in,out] is The trace.
+ * \param [out] value The value.
+ * \returns \c true if the value was read.
+ */
+template <typename T>
+bool
+Read(std::istream& is, T& value)
+{
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/**
+ * Read a length prefixed string from the trace.
+ *
+ * \param [in,out] is The trace.
+ * \param [out] str The string.
+ * \returns \c true if the string was read.
+ */
+bool
+ReadString(std::istream& is, std::string& str)
+{
+    uint32_t length;
+    if (!Read(is, length))
+    {
+        return false;
+    }
+    str.resize(length);
+    return static_cast<bool>(is.read(str.data(), length));
+}
+
+/**
+ * Read the blocks of the trace.
+ *
+ * \tparam TypeFn \deduced Type of the type block callback.
+ * \tparam RecordFn \deduced Type of the record callback.
+ * \param [in,out] is The trace, positioned after the header.
+ * \param [in] onType Callback called with the id and name of each type.
+ * \param [in] onRecord Callback called with each record.
+ * \returns \c true if the whole trace was read.
+ */
+template <typename TypeFn, typename RecordFn>
+bool
+ReadBlocks(std::istream& is, TypeFn onType, RecordFn onRecord)
+{
+    uint32_t block[2];
+    std::vector<DesMetrics::Record> records;
+    while (Read(is, block))
+    {
+        if (block[0] == DesMetrics::TYPE)
+        {
+            uint32_t id;
+            std::string name(block[1], '\0');
+            if (!Read(is, id) || !is.read(name.data(), name.size()))
+            {
+                return false;
+            }
+            onType(id, name);
+        }
+        else if (block[0] == DesMetrics::RECORDS)
+        {
+            records.resize(block[1]);
+            if (!is.read(reinterpret_cast<char*>(records.data()),
+                         records.size() * sizeof(DesMetrics::Record)))
+            {
+                return false;
+            }
+            for (const auto& record : records)
+            {
+                onRecord(record);
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return is.eof();
+}
+
+/**
+ * Get the readable name of a type.
+ *
+ * \param [in] mangled The mangled name of the type.
+ * \returns The demangled name, or \p mangled if it cannot be demangled.
+ */
+std::string
+Demangle(const std::string& mangled)
+{
+    int status = 0;
+    char* name = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status != 0 || name == nullptr)
+    {
+        return mangled;
+    }
+    std::string demangled(name);
+    std::free(name);
+    return demangled;
+}
+
+/**
+ * Escape a string for JSON.
+ *
+ * \param [in] str The string.
+ * \returns The escaped string.
+ */
+std::string
+Escape(const std::string& str)
+{
+    std::string escaped;
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+/**
+ * Get the JSON form of a context, -1 for no context.
+ *
+ * \param [in] context The context.
+ * \returns The context as a signed integer.
+ */
+int64_t
+Context(uint32_t context)
+{
+    return context == Simulator::NO_CONTEXT ? -1 : static_cast<int64_t>(context);
+}
+
+} // unnamed namespace
+
+bool
+DesMetricsConverter::ReadHeader(std::istream& is)
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    return is.read(magic, sizeof(magic)) && std::memcmp(magic, "NS3DESM", 8) == 0 &&
+           Read(is, version) && version == 1 && Read(is, recordSize) &&
+           recordSize == sizeof(DesMetrics::Record) && Read(is, m_stepsPerSecond) &&
+           ReadString(is, m_modelName) && ReadString(is, m_captureDate) &&
+           ReadString(is, m_commandLine);
+}
+
+bool
+DesMetricsConverter::Convert(std::istream& is, std::ostream& os, Format format) const
+{
+    return format == JSON ? WriteJson(is, os) : WritePerfetto(is, os);
+}
+
+bool
+DesMetricsConverter::WriteJson(std::istream& is, std::ostream& os) const
+{
+    // Same layout as the JSON trace of DesMetrics
+    os << "{" << std::endl;
+    os << " \"simulator_name\" : \"ns-3\"," << std::endl;
+    os << " \"model_name\" : \"" << Escape(m_modelName) << "\"," << std::endl;
+    os << " \"capture_date\" : \"" << m_captureDate << "\"," << std::endl;
+    os << " \"command_line_arguments\" : \""
+       << (m_commandLine.empty() ? "[argv empty or not available]" : Escape(m_commandLine))
+       << "\"," << std::endl;
+    os << " \"events\" : [" << std::endl;
+    char separator = ' ';
+    bool ok = ReadBlocks(
+        is,
+        [](uint32_t, const std::string&) {},
+        [&os, &separator](const DesMetrics::Record& record) {
+            if (separator == ',')
+            {
+                os << separator << '\n';
+            }
+            os << "  [\"" << Context(record.sendCtx) << "\",\"" << record.sendTs << "\",\""
+               << Context(record.recvCtx) << "\",\"" << record.recvTs << "\"]";
+            separator = ',';
+        });
+    os << std::endl << " ]" << std::endl << "}" << std::endl;
+    return ok;
+}
+
+bool
+DesMetricsConverter::WritePerfetto(std::istream& is, std::ostream& os) const
+{
+    // First pass for the type names and the contexts
+    std::streampos blocks = is.tellg();
+    std::map<uint32_t, std::string> types;
+    std::set<int64_t> contexts;
+    if (!ReadBlocks(
+            is,
+            [&types](uint32_t id, const std::string& name) { types[id] = Demangle(name); },
+            [&contexts](const DesMetrics::Record& record) {
+                contexts.insert(Context(record.sendCtx));
+                contexts.insert(Context(record.recvCtx));
+            }))
+    {
+        return false;
+    }
+    is.clear();
+    is.seekg(blocks);
+
+    os << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"model\":\"" << Escape(m_modelName)
+       << "\",\"date\":\"" << m_captureDate << "\"},\"traceEvents\":[" << std::endl;
+    os << std::fixed << std::setprecision(3);
+    const char* separator = "";
+    for (auto context : contexts)
+    {
+        os << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << context
+           << ",\"args\":{\"name\":\""
+           << (context < 0 ? std::string("no context") : "context " + std::to_string(context))
+           << "\"}}";
+        separator = ",\n";
+    }
+
+    double usPerStep = 1e6 / m_stepsPerSecond;
+    uint64_t flow = 0;
+    bool ok = ReadBlocks(
+        is,
+        [](uint32_t, const std::string&) {},
+        [&](const DesMetrics::Record& record) {
+            auto type = types.find(record.type);
+            std::string name = type != types.end() ? Escape(type->second) : "event";
+            double sendTs = record.sendTs * usPerStep;
+            double recvTs = record.recvTs * usPerStep;
+            os << separator << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"ts\":" << recvTs
+               << ",\"dur\":0,\"pid\":0,\"tid\":" << Context(record.recvCtx)
+               << ",\"args\":{\"uid\":" << record.uid << "}}";
+            separator = ",\n";
+            ++flow;
+            os << separator << "{\"name\":\"schedule\",\"cat\":\"schedule\",\"ph\":\"s\",\"id\":"
+               << flow << ",\"ts\":" << sendTs << ",\"pid\":0,\"tid\":" << Context(record.sendCtx)
+               << "}";
+            os << separator << "{\"name\":\"schedule\",\"cat\":\"schedule\",\"ph\":\"f\","
+               << "\"bp\":\"e\",\"id\":" << flow << ",\"ts\":" << recvTs
+               << ",\"pid\":0,\"tid\":" << Context(record.recvCtx) << "}";
+        });
+    os << std::endl << "]}" << std::endl;
+    return ok;
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DESMETRICS_CONVERTER_H
+#define DESMETRICS_CONVERTER_H
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::DesMetricsConverter declaration.
+ */
+
+#include <istream>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * @ingroup simulator
+ *
+ * @brief Reader of the binary DesMetrics traces, which converts them to
+ * the DES Metrics JSON format written by DesMetrics itself, or to the
+ * Chrome trace event format displayed by Perfetto.
+ *
+ * This is the converter of the \c des-metrics-convert utility.
+ */
+class DesMetricsConverter
+{
+  public:
+    /** Output formats. */
+    enum Format
+    {
+        JSON,    //!< The DES Metrics JSON format
+        PERFETTO //!< The Chrome trace event format
+    };
+
+    /**
+     * Read and check the header of a binary trace.
+     *
+     * \param [in,out] is The trace.
+     * \returns \c true if the trace is a binary trace this converter can read.
+     */
+    bool ReadHeader(std::istream& is);
+
+    /**
+     * Convert the events of the trace.
+     *
+     * In the Chrome trace event format, each event is a slice of the
+     * thread of its context, named after its type, and a flow links the
+     * slice of the event which scheduled it, if any, to its own.
+     *
+     * \param [in,out] is The trace, positioned after the header.
+     * \param [in,out] os The output stream.
+     * \param [in] format The output format.
+     * \returns \c true if the whole trace was read.
+     */
+    bool Convert(std::istream& is, std::ostream& os, Format format) const;
+
+  private:
+    /**
+     * Write the trace in the DES Metrics JSON format.
+     *
+     * \param [in,out] is The trace, positioned after the header.
+     * \param [in,out] os The output stream.
+     * \returns \c true if the whole trace was read.
+     */
+    bool WriteJson(std::istream& is, std::ostream& os) const;
+    /**
+     * Write the trace in the Chrome trace event format.
+     *
+     * \param [in,out] is The trace, positioned after the header.
+     * \param [in,out] os The output stream.
+     * \returns \c true if the whole trace was read.
+     */
+    bool WritePerfetto(std::istream& is, std::ostream& os) const;
+
+    int64_t m_stepsPerSecond{0}; //!< Time resolution
+    std::string m_modelName;     //!< Name of the model
+    std::string m_captureDate;   //!< Date of the trace
+    std::string m_commandLine;   //!< Command line of the model
+
+}; // class DesMetricsConverter
+
+} // namespace ns3
+
+#endif /* DESMETRICS_CONVERTER_H */
@@ -25,9 +25,15 @@
 
 #include "des-metrics.h"
 
+#include "enum.h"
+#include "event-impl.h"
+#include "global-value.h"
 #include "simulator.h"
 #include "system-path.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <ctime> // time_t, time()
 #include <sstream>
 #include <string>
@@ -35,6 +41,16 @@
 namespace ns3
 {
 
+/**
+ * \ingroup simulator
+ * The format of the DES Metrics trace file.
+ */
+static GlobalValue g_desMetricsFormat =
+    GlobalValue("DesMetricsFormat",
+                "The format of the DES Metrics trace file",
+                EnumValue(DesMetrics::JSON),
+                MakeEnumChecker(DesMetrics::JSON, "Json", DesMetrics::BINARY, "Binary"));
+
 /* static */
 std::string DesMetrics::m_outputDir; // = "";
 
@@ -55,7 +71,11 @@ DesMetrics::Initialize(std::vector<std::string> args, std::string outDir /* = ""
         std::string arg0 = args[0];
         model_name = SystemPath::Split(arg0).back();
     }
-    std::string jsonFile = model_name + ".json";
+    EnumValue<Format> format;
+    g_desMetricsFormat.GetValue(format);
+    m_format = format.Get();
+
+    std::string jsonFile = model_name + (m_format == BINARY ? ".desm" : ".json");
     if (!outDir.empty())
     {
         DesMetrics::m_outputDir = outDir;
@@ -70,13 +90,20 @@ DesMetrics::Initialize(std::vector<std::string> args, std::string outDir /* = ""
     const char* date = ctime(&current_time);
     std::string capture_date(date, 24); // discard trailing newline from ctime
 
+    if (m_format == BINARY)
+    {
+        m_os.open(jsonFile, std::ios::binary);
+        WriteBinaryHeader(model_name, capture_date, args);
+        return;
+    }
+
     m_os.open(jsonFile);
     m_os << "{" << std::endl;
     m_os << " \"simulator_name\" : \"ns-3\"," << std::endl;
     m_os << " \"model_name\" : \"" << model_name << "\"," << std::endl;
     m_os << " \"capture_date\" : \"" << capture_date << "\"," << std::endl;
     m_os << " \"command_line_arguments\" : \"";
-    if (args.empty())
+    if (!args.empty())
     {
         for (std::size_t i = 0; i < args.size(); ++i)
         {
@@ -98,13 +125,172 @@ DesMetrics::Initialize(std::vector<std::string> args, std::string outDir /* = ""
 }
 
 void
-DesMetrics::Trace(const Time& now, const Time& delay)
+DesMetrics::WriteBinaryHeader(const std::string& modelName,
+                              const std::string& captureDate,
+                              const std::vector<std::string>& args)
 {
-    TraceWithContext(Simulator::GetContext(), now, delay);
+    std::string commandLine;
+    for (std::size_t i = 0; i < args.size(); ++i)
+    {
+        commandLine += (i > 0 ? " " : "") + args[i];
+    }
+
+    const char magic[8] = {'N', 'S', '3', 'D', 'E', 'S', 'M', '\0'};
+    uint32_t version = 1;
+    auto recordSize = static_cast<uint32_t>(sizeof(Record));
+    int64_t stepsPerSecond = Seconds(1).GetTimeStep();
+    m_os.write(magic, sizeof(magic));
+    m_os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    m_os.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+    m_os.write(reinterpret_cast<const char*>(&stepsPerSecond), sizeof(stepsPerSecond));
+    for (const auto& str : {modelName, captureDate, commandLine})
+    {
+        auto length = static_cast<uint32_t>(str.size());
+        m_os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        m_os.write(str.data(), length);
+    }
+
+    // A new file needs the names of the types already known
+    m_pendingTypes.clear();
+    for (const auto& [type, id] : m_types)
+    {
+        m_pendingTypes.push_back(type);
+    }
+    m_stopWriter = false;
+    m_writer = std::thread(&DesMetrics::Writer, this);
+}
+
+uint32_t
+DesMetrics::GetEventType(const EventImpl* event)
+{
+    if (event == nullptr)
+    {
+        return 0;
+    }
+    // Each thread caches the ids it has seen, the lock is only taken on a miss
+    static thread_local std::unordered_map<const std::type_info*, uint32_t> cache;
+    const std::type_info* type = &typeid(*event->GetTarget());
+    auto it = cache.find(type);
+    if (it != cache.end())
+    {
+        return it->second;
+    }
+    uint32_t id;
+    {
+        std::unique_lock lock{m_mutex};
+        auto [known, inserted] = m_types.emplace(type, m_types.size() + 1);
+        if (inserted)
+        {
+            m_pendingTypes.push_back(type);
+        }
+        id = known->second;
+    }
+    cache.emplace(type, id);
+    return id;
+}
+
+void
+DesMetrics::Append(const Record& record)
+{
+    static thread_local Ring* ring = nullptr;
+    if (ring == nullptr)
+    {
+        auto newRing = std::make_unique<Ring>();
+        newRing->records = std::make_unique<Record[]>(RING_SIZE);
+        ring = newRing.get();
+        std::unique_lock lock{m_mutex};
+        m_rings.push_back(std::move(newRing));
+    }
+
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    while (head - ring->tail.load(std::memory_order_acquire) == RING_SIZE)
+    {
+        // The ring is full: never drop a record, wait for the writer
+        m_writerCv.notify_one();
+        std::this_thread::yield();
+    }
+    ring->records[head & (RING_SIZE - 1)] = record;
+    ring->head.store(head + 1, std::memory_order_release);
+    if (((head + 1) & (RING_SIZE / 2 - 1)) == 0)
+    {
+        m_writerCv.notify_one();
+    }
 }
 
 void
-DesMetrics::TraceWithContext(uint32_t context, const Time& now, const Time& delay)
+DesMetrics::Writer()
+{
+    std::unique_lock lock{m_mutex};
+    while (!m_stopWriter)
+    {
+        m_writerCv.wait_for(lock, std::chrono::milliseconds(10));
+        lock.unlock();
+        Flush();
+        lock.lock();
+    }
+    lock.unlock();
+    Flush();
+}
+
+void
+DesMetrics::Flush()
+{
+    std::vector<const std::type_info*> types;
+    std::vector<std::pair<const std::type_info*, uint32_t>> names;
+    std::vector<Ring*> rings;
+    {
+        std::unique_lock lock{m_mutex};
+        for (auto type : m_pendingTypes)
+        {
+            names.emplace_back(type, m_types[type]);
+        }
+        m_pendingTypes.clear();
+        for (const auto& ring : m_rings)
+        {
+            rings.push_back(ring.get());
+        }
+    }
+
+    for (const auto& [type, id] : names)
+    {
+        uint32_t block[3] = {TYPE, static_cast<uint32_t>(std::strlen(type->name())), id};
+        m_os.write(reinterpret_cast<const char*>(block), sizeof(block));
+        m_os.write(type->name(), block[1]);
+    }
+    for (auto ring : rings)
+    {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        while (tail != head)
+        {
+            // Copy up to the end of the buffer, then from its start
+            uint64_t start = tail & (RING_SIZE - 1);
+            uint64_t count = std::min(head - tail, RING_SIZE - start);
+            uint32_t block[2] = {RECORDS, static_cast<uint32_t>(count)};
+            m_os.write(reinterpret_cast<const char*>(block), sizeof(block));
+            m_os.write(reinterpret_cast<const char*>(&ring->records[start]),
+                       count * sizeof(Record));
+            tail += count;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+}
+
+void
+DesMetrics::Trace(const Time& now,
+                  const Time& delay,
+                  const EventImpl* event /* = nullptr */,
+                  uint32_t uid /* = 0 */)
+{
+    TraceWithContext(Simulator::GetContext(), now, delay, event, uid);
+}
+
+void
+DesMetrics::TraceWithContext(uint32_t context,
+                             const Time& now,
+                             const Time& delay,
+                             const EventImpl* event /* = nullptr */,
+                             uint32_t uid /* = 0 */)
 {
     if (!m_initialized)
     {
@@ -112,6 +298,17 @@ DesMetrics::TraceWithContext(uint32_t context, const Time& now, const Time& dela
         Initialize(args);
     }
 
+    if (m_format == BINARY)
+    {
+        Append({now.GetTimeStep(),
+                (now + delay).GetTimeStep(),
+                Simulator::GetContext(),
+                context,
+                uid,
+                GetEventType(event)});
+        return;
+    }
+
     std::ostringstream ss;
     if (m_separator == ',')
     {
@@ -142,6 +339,26 @@ DesMetrics::~DesMetrics()
 void
 DesMetrics::Close()
 {
+    if (!m_initialized)
+    {
+        return;
+    }
+    if (m_format == BINARY)
+    {
+        if (m_writer.joinable())
+        {
+            {
+                std::unique_lock lock{m_mutex};
+                m_stopWriter = true;
+            }
+            m_writerCv.notify_one();
+            m_writer.join();
+        }
+        m_os.close();
+        m_initialized = false;
+        return;
+    }
+
     m_os << std::endl; // Finish the last event line
 
     m_os << " ]" << std::endl;
@@ -29,15 +29,23 @@
 #include "nstime.h"
 #include "singleton.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <stdint.h> // uint32_t
 #include <string>
+#include <thread>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
 {
 
+class EventImpl;
+
 /**
  * @ingroup simulator
  *
@@ -105,10 +113,72 @@ namespace ns3
  * \li Show the largest file, and total number of trace files: <br/>
  *   \code wc -l *.json | sort -n | tail -2 \endcode
  *
+ * <b> Binary traces </b>
+ *
+ * Formatting and writing a JSON record under a lock for every event
+ * slows a simulation down by an order of magnitude, and produces huge
+ * files.  Setting the \c DesMetricsFormat global value to \c Binary,
+ * for instance with
+ * \verbatim
+   $ ./ns3 run "my-script --DesMetricsFormat=Binary" \endverbatim
+ * writes a binary trace to a \c .desm file instead.  Each event is a
+ * fixed size record (DesMetrics::Record) holding the send and execution
+ * times, the source and destination contexts, the event uid and an id
+ * of the type of the event.  Each thread scheduling events appends the
+ * records to its own ring buffer, without any lock, and a background
+ * writer thread copies the rings to the file.
+ *
+ * The \c des-metrics-convert utility, built on DesMetricsConverter, turns
+ * a binary trace into the JSON format above, or into the Chrome trace
+ * event format, which [Perfetto](https://ui.perfetto.dev) and
+ * \c chrome://tracing display as a timeline of the events of each
+ * context, with an arrow from each event to the events it scheduled:
+ * \verbatim
+   $ ./build/utils/ns3-dev-des-metrics-convert-default --input=my-script.desm --format=perfetto \endverbatim
+ *
+ * The binary file starts with a header:
+ * \verbatim
+   char     magic[8];       // "NS3DESM" followed by a null character
+   uint32_t version;        // 1
+   uint32_t recordSize;     // sizeof (DesMetrics::Record)
+   int64_t  stepsPerSecond; // Time resolution
+   string   modelName;
+   string   captureDate;
+   string   commandLine; \endverbatim
+ * where each string is a \c uint32_t length followed by the characters.
+ * The header is followed by blocks, each made of a \c uint32_t tag
+ * (DesMetrics::BlockTag) and a \c uint32_t count, and then of either
+ * \c count records, or of a type id and a \c count long mangled type
+ * name.  All the values are in the byte order of the simulation host.
  */
 class DesMetrics : public Singleton<DesMetrics>
 {
   public:
+    /** Trace file formats. */
+    enum Format
+    {
+        JSON,  //!< One JSON record per event
+        BINARY //!< Binary records, written by a background thread
+    };
+
+    /** Tags of the blocks of a binary trace. */
+    enum BlockTag : uint32_t
+    {
+        RECORDS = 1, //!< A block of event records
+        TYPE = 2     //!< The name of an event type
+    };
+
+    /** An event in a binary trace. */
+    struct Record
+    {
+        int64_t sendTs;   //!< Time step the event was scheduled at
+        int64_t recvTs;   //!< Time step the event will run at
+        uint32_t sendCtx; //!< Context the event was scheduled from
+        uint32_t recvCtx; //!< Context the event will run in
+        uint32_t uid;     //!< Uid of the event, 0 if unknown
+        uint32_t type;    //!< Id of the type of the event, 0 if unknown
+    };
+
     /**
      * Open the DesMetrics trace file and print the header.
      *
@@ -125,8 +195,13 @@ class DesMetrics : public Singleton<DesMetrics>
      *
      * \param now [in] The local simulation time.
      * \param delay [in] The delay to the event.
+     * \param event [in] The event, if known.
+     * \param uid [in] The uid of the event, if known.
      */
-    void Trace(const Time& now, const Time& delay);
+    void Trace(const Time& now,
+               const Time& delay,
+               const EventImpl* event = nullptr,
+               uint32_t uid = 0);
 
     /**
      * Trace an event (with context) at the time it is scheduled.
@@ -134,8 +209,22 @@ class DesMetrics : public Singleton<DesMetrics>
      * \param context [in] The context (NodeId) which will receive the event.
      * \param now [in] The local simulation time.
      * \param delay [in] The delay to the event.
+     * \param event [in] The event, if known.
+     * \param uid [in] The uid of the event, if known.
+     */
+    void TraceWithContext(uint32_t context,
+                          const Time& now,
+                          const Time& delay,
+                          const EventImpl* event = nullptr,
+                          uint32_t uid = 0);
+
+    /**
+     * Close the trace file, for instance to read it back.
+     *
+     * The next event traced opens a new trace file in the last output
+     * directory, without command line arguments.
      */
-    void TraceWithContext(uint32_t context, const Time& now, const Time& delay);
+    void Close();
 
     /**
      * Destructor, closes the trace file.
@@ -143,8 +232,44 @@ class DesMetrics : public Singleton<DesMetrics>
     ~DesMetrics() override;
 
   private:
-    /** Close the output file. */
-    void Close();
+    /** Number of records of a ring buffer, a power of two. */
+    static constexpr uint64_t RING_SIZE = 1 << 16;
+
+    /** The ring buffer of records of a thread. */
+    struct Ring
+    {
+        std::unique_ptr<Record[]> records; //!< The records
+        std::atomic<uint64_t> head{0};     //!< Number of records written by the thread
+        std::atomic<uint64_t> tail{0};     //!< Number of records copied to the file
+    };
+
+    /**
+     * Write the header of a binary trace.
+     *
+     * \param [in] modelName The name of the model.
+     * \param [in] captureDate The date of the trace.
+     * \param [in] args Command line arguments.
+     */
+    void WriteBinaryHeader(const std::string& modelName,
+                           const std::string& captureDate,
+                           const std::vector<std::string>& args);
+    /**
+     * Append a record to the ring buffer of the calling thread.
+     *
+     * \param [in] record The record.
+     */
+    void Append(const Record& record);
+    /**
+     * Get the id of the type of an event, registering it on first use.
+     *
+     * \param [in] event The event.
+     * \returns The id of the type of the event, 0 if \p event is null.
+     */
+    uint32_t GetEventType(const EventImpl* event);
+    /** Body of the writer thread. */
+    void Writer();
+    /** Copy the pending type names and the content of the rings to the file. */
+    void Flush();
 
     /**
      * Cache the last-used output directory.
@@ -161,6 +286,17 @@ class DesMetrics : public Singleton<DesMetrics>
     /** Mutex to control access to the output file. */
     std::mutex m_mutex;
 
+    Format m_format{JSON}; //!< The format of the trace file.
+    /** The rings of all the threads, kept across trace files. */
+    std::vector<std::unique_ptr<Ring>> m_rings;
+    /** The ids of the event types. */
+    std::unordered_map<const std::type_info*, uint32_t> m_types;
+    /** Types not written to the file yet. */
+    std::vector<const std::type_info*> m_pendingTypes;
+    std::thread m_writer;               //!< The writer thread.
+    std::condition_variable m_writerCv; //!< Wakes the writer thread up.
+    bool m_stopWriter{false};           //!< Asks the writer thread to exit.
+
 }; // class DesMetrics
 
 } // namespace ns3
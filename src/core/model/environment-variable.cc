@@ -138,11 +138,22 @@ EnvironmentVariable::Instance()
     return instance;
 }
 
+/** Number of times the dictionaries were cleared. */
+static uint64_t g_generation = 0;
+
 /* static */
 void
 EnvironmentVariable::Clear()
 {
     Instance().clear();
+    ++g_generation;
+}
+
+/* static */
+uint64_t
+EnvironmentVariable::GetGeneration()
+{
+    return g_generation;
 }
 
 /* static */
@@ -27,10 +27,13 @@
  */
 
 #include <memory> // shared_ptr
+#include <stdint.h>
 #include <string>
 #include <unordered_map>
 #include <utility> // pair
 
+class EnvAttributeDefaultTestCase;
+
 namespace ns3
 {
 
@@ -189,6 +192,16 @@ class EnvironmentVariable
      */
     static bool Unset(const std::string& variable);
 
+    /**
+     * Get the number of times the cached dictionaries were cleared.
+     *
+     * Information derived from the environment variables can be cached
+     * until the number changes.
+     *
+     * \returns The number of times the cache was cleared.
+     */
+    static uint64_t GetGeneration();
+
     /**
      * \name Singleton
      *
@@ -219,8 +232,9 @@ class EnvironmentVariable
      */
     static DictionaryList& Instance();
 
-    // Test needs to clear the instance
+    // Tests need to clear the instance
     friend class tests::EnvVarTestCase;
+    friend class ::EnvAttributeDefaultTestCase;
 
     /** Clear the instance, forcing all new lookups. */
     static void Clear();
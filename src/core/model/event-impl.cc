@@ -21,6 +21,11 @@
 
 #include "log.h"
 
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +37,247 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/** Size granularity of the event pools. */
+constexpr std::size_t POOL_GRANULARITY = 16;
+/** Number of event pools; larger events are allocated from the heap. */
+constexpr std::size_t POOL_CLASSES = 16;
+/**
+ * Number of blocks carved at once from the heap, and moved at once
+ * between the pools of a thread and the shared depot.
+ */
+constexpr std::size_t POOL_BATCH = 256;
+
+/** A free block, linked to the next free block of its pool. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< Next free block
+};
+
+/**
+ * The event pools of a thread.
+ *
+ * A thread mostly frees the events it allocates; the events scheduled
+ * by a thread for another one, as done by the realtime and multithreaded
+ * simulators, end up in the pools of the thread which frees them, which
+ * hands them over to the depot when they accumulate.
+ */
+struct ThreadPools
+{
+    FreeBlock* head[POOL_CLASSES]{};          //!< First free block of each pool
+    std::size_t count[POOL_CLASSES]{};        //!< Number of free blocks of each pool
+    std::atomic<uint64_t> allocations{0};     //!< Number of events allocated
+    std::atomic<uint64_t> heapAllocations{0}; //!< Number of heap allocations
+    bool registered{false};                   //!< Whether the counters are registered
+};
+
+/** The shared state of the event pools. */
+struct Depot
+{
+    std::mutex mutex;                  //!< Protects the depot
+    FreeBlock* head[POOL_CLASSES]{};   //!< First free block of each pool
+    std::vector<ThreadPools*> threads; //!< Pools of the running threads
+    uint64_t allocations{0};           //!< Allocations of the exited threads
+    uint64_t heapAllocations{0};       //!< Heap allocations of the exited threads
+    std::vector<void*> slabs;          //!< Blocks carved from the heap, never released
+};
+
+/**
+ * Get the depot; it is never destroyed, as events may be released
+ * during static destruction.
+ * \returns The depot.
+ */
+Depot&
+GetDepot()
+{
+    static Depot* depot = new Depot;
+    return *depot;
+}
+
+/** The event pools of the calling thread. */
+thread_local ThreadPools g_pools;
+
+/**
+ * Increment a counter only written by its thread.
+ * \param [in,out] counter The counter.
+ */
+inline void
+Bump(std::atomic<uint64_t>& counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/**
+ * Detach the first blocks of a list.
+ *
+ * \param [in,out] head The first block of the list; the first block left on return.
+ * \param [in] n The maximum number of blocks to detach.
+ * \param [out] tail The last block detached.
+ * \returns The number of blocks detached.
+ */
+std::size_t
+Detach(FreeBlock*& head, std::size_t n, FreeBlock*& tail)
+{
+    std::size_t detached = 0;
+    tail = nullptr;
+    while (head && detached < n)
+    {
+        tail = head;
+        head = head->next;
+        ++detached;
+    }
+    if (tail)
+    {
+        tail->next = nullptr;
+    }
+    return detached;
+}
+
+/** Hands the pools of a thread over to the depot when the thread exits. */
+struct ThreadPoolsGuard
+{
+    ~ThreadPoolsGuard()
+    {
+        Depot& depot = GetDepot();
+        std::lock_guard lock(depot.mutex);
+        for (std::size_t i = 0; i < POOL_CLASSES; ++i)
+        {
+            FreeBlock* first = g_pools.head[i];
+            FreeBlock* tail;
+            Detach(g_pools.head[i], g_pools.count[i], tail);
+            g_pools.count[i] = 0;
+            if (tail)
+            {
+                tail->next = depot.head[i];
+                depot.head[i] = first;
+            }
+        }
+        depot.allocations += g_pools.allocations.load(std::memory_order_relaxed);
+        depot.heapAllocations += g_pools.heapAllocations.load(std::memory_order_relaxed);
+        g_pools.allocations.store(0, std::memory_order_relaxed);
+        g_pools.heapAllocations.store(0, std::memory_order_relaxed);
+        std::erase(depot.threads, &g_pools);
+    }
+};
+
+/** Register the counters of the calling thread. */
+void
+RegisterPools()
+{
+    // the guard is constructed once per thread, and never again once destroyed
+    static thread_local ThreadPoolsGuard guard;
+    g_pools.registered = true;
+    Depot& depot = GetDepot();
+    std::lock_guard lock(depot.mutex);
+    depot.threads.push_back(&g_pools);
+}
+
+/**
+ * Refill an empty pool of the calling thread, from the depot or from the heap.
+ * \param [in] pool The index of the pool.
+ */
+void
+RefillPool(std::size_t pool)
+{
+    Depot& depot = GetDepot();
+    std::lock_guard lock(depot.mutex);
+    if (depot.head[pool])
+    {
+        FreeBlock* first = depot.head[pool];
+        FreeBlock* tail;
+        g_pools.count[pool] = Detach(depot.head[pool], POOL_BATCH, tail);
+        g_pools.head[pool] = first;
+        return;
+    }
+    std::size_t blockSize = (pool + 1) * POOL_GRANULARITY;
+    auto slab = static_cast<char*>(::operator new(POOL_BATCH * blockSize));
+    depot.slabs.push_back(slab);
+    Bump(g_pools.heapAllocations);
+    for (std::size_t i = POOL_BATCH; i-- > 0;)
+    {
+        auto block = reinterpret_cast<FreeBlock*>(slab + i * blockSize);
+        block->next = g_pools.head[pool];
+        g_pools.head[pool] = block;
+    }
+    g_pools.count[pool] = POOL_BATCH;
+}
+
+/**
+ * Move a batch of blocks of a pool of the calling thread to the depot.
+ * \param [in] pool The index of the pool.
+ */
+void
+DrainPool(std::size_t pool)
+{
+    FreeBlock* first = g_pools.head[pool];
+    FreeBlock* tail;
+    g_pools.count[pool] -= Detach(g_pools.head[pool], POOL_BATCH, tail);
+    Depot& depot = GetDepot();
+    std::lock_guard lock(depot.mutex);
+    tail->next = depot.head[pool];
+    depot.head[pool] = first;
+}
+
+} // unnamed namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    if (!g_pools.registered)
+    {
+        RegisterPools();
+    }
+    Bump(g_pools.allocations);
+    std::size_t pool = (size - 1) / POOL_GRANULARITY;
+    if (pool >= POOL_CLASSES)
+    {
+        Bump(g_pools.heapAllocations);
+        return ::operator new(size);
+    }
+    if (!g_pools.head[pool])
+    {
+        RefillPool(pool);
+    }
+    FreeBlock* block = g_pools.head[pool];
+    g_pools.head[pool] = block->next;
+    --g_pools.count[pool];
+    return block;
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    std::size_t pool = (size - 1) / POOL_GRANULARITY;
+    if (pool >= POOL_CLASSES)
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto block = static_cast<FreeBlock*>(p);
+    block->next = g_pools.head[pool];
+    g_pools.head[pool] = block;
+    if (++g_pools.count[pool] > 2 * POOL_BATCH)
+    {
+        DrainPool(pool);
+    }
+}
+
+EventImpl::PoolStatistics
+EventImpl::GetPoolStatistics()
+{
+    Depot& depot = GetDepot();
+    std::lock_guard lock(depot.mutex);
+    PoolStatistics stats = {depot.allocations, depot.heapAllocations};
+    for (auto pools : depot.threads)
+    {
+        stats.allocations += pools->allocations.load(std::memory_order_relaxed);
+        stats.heapAllocations += pools->heapAllocations.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -67,4 +313,10 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+const EventImpl*
+EventImpl::GetTarget() const
+{
+    return this;
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -41,6 +42,12 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated from per-thread pools of fixed size blocks, one
+ * pool per multiple of 16 bytes up to 256 bytes, so scheduling and
+ * releasing an event does not usually reach the heap.  The pools keep
+ * the bound arguments and the captures of lambdas inline, and larger
+ * events are allocated from the heap as usual.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +73,45 @@ class EventImpl : public SimpleRefCount<EventImpl>
      * Checked by the simulation engine before calling Invoke().
      */
     bool IsCancelled();
+    /**
+     * Get the event doing the work of this one, to attribute its cost.
+     *
+     * \returns The wrapped event, for events which only invoke another
+     * one, such as the timers of TimerWheel, or this event.
+     */
+    virtual const EventImpl* GetTarget() const;
+
+    /** Allocation counters of the event pools. */
+    struct PoolStatistics
+    {
+        uint64_t allocations;     //!< Number of events allocated
+        uint64_t heapAllocations; //!< Number of heap allocations made by the pools
+    };
+
+    /**
+     * Get the allocation counters of the event pools, summed over all threads.
+     *
+     * The number of heap allocations avoided is
+     * `allocations - heapAllocations`.
+     *
+     * \returns The counters.
+     */
+    static PoolStatistics GetPoolStatistics();
+
+    /**
+     * Allocate an event from the pool of its size.
+     *
+     * \param [in] size The size of the event.
+     * \returns The memory of the event.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Return an event to the pool of its size.
+     *
+     * \param [in] p The memory of the event.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* p, std::size_t size);
 
   protected:
     /**
@@ -0,0 +1,173 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iterator>
+#include <map>
+#include <string>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventProfiler");
+
+namespace
+{
+
+/**
+ * \ingroup simulator
+ * Get the readable name of a type.
+ *
+ * \param [in] type The type.
+ * \returns The demangled name of the type, or its mangled name if it
+ * cannot be demangled.
+ */
+std::string
+Demangle(const std::type_info* type)
+{
+    int status = 0;
+    char* name = abi::__cxa_demangle(type->name(), nullptr, nullptr, &status);
+    if (status != 0 || name == nullptr)
+    {
+        return type->name();
+    }
+    std::string demangled(name);
+    std::free(name);
+    return demangled;
+}
+
+} // unnamed namespace
+
+EventProfiler::EventProfiler()
+    : m_table(1024, Entry{nullptr, 0, 0, 0}),
+      m_size(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+EventProfiler::Entry&
+EventProfiler::Find(const std::type_info* type, uint32_t context)
+{
+    std::size_t mask = m_table.size() - 1;
+    uint64_t key = reinterpret_cast<uintptr_t>(type) ^ (uint64_t(context) << 32);
+    std::size_t i = ((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+    while (m_table[i].type != nullptr &&
+           (m_table[i].type != type || m_table[i].context != context))
+    {
+        i = (i + 1) & mask;
+    }
+    return m_table[i];
+}
+
+void
+EventProfiler::Record(const EventImpl* event, uint32_t context, uint64_t nanoseconds)
+{
+    const std::type_info* type = &typeid(*event->GetTarget());
+    Entry* entry = &Find(type, context);
+    if (entry->type == nullptr)
+    {
+        if (2 * (m_size + 1) > m_table.size())
+        {
+            Grow();
+            entry = &Find(type, context);
+        }
+        entry->type = type;
+        entry->context = context;
+        ++m_size;
+    }
+    ++entry->count;
+    entry->nanoseconds += nanoseconds;
+}
+
+void
+EventProfiler::Grow()
+{
+    NS_LOG_FUNCTION(this << m_table.size());
+    std::vector<Entry> table(m_table.size() * 2, Entry{nullptr, 0, 0, 0});
+    table.swap(m_table);
+    for (const auto& entry : table)
+    {
+        if (entry.type != nullptr)
+        {
+            Find(entry.type, entry.context) = entry;
+        }
+    }
+}
+
+void
+EventProfiler::Write(std::ostream& os, Format format) const
+{
+    NS_LOG_FUNCTION(this << format);
+    std::vector<Entry> entries;
+    std::copy_if(m_table.begin(),
+                 m_table.end(),
+                 std::back_inserter(entries),
+                 [](const Entry& entry) { return entry.type != nullptr; });
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.nanoseconds > b.nanoseconds;
+    });
+
+    std::map<const std::type_info*, std::string> names;
+    if (format == CSV)
+    {
+        os << "event,context,count,nanoseconds" << std::endl;
+    }
+    for (const auto& entry : entries)
+    {
+        auto it = names.find(entry.type);
+        if (it == names.end())
+        {
+            it = names.emplace(entry.type, Demangle(entry.type)).first;
+        }
+        bool noContext = entry.context == Simulator::NO_CONTEXT;
+        if (format == CSV)
+        {
+            os << '"' << it->second << "\",";
+            if (!noContext)
+            {
+                os << entry.context;
+            }
+            os << ',' << entry.count << ',' << entry.nanoseconds << std::endl;
+        }
+        else
+        {
+            os << it->second << ';';
+            if (noContext)
+            {
+                os << "no context";
+            }
+            else
+            {
+                os << "context " << entry.context;
+            }
+            os << ' ' << entry.nanoseconds << std::endl;
+        }
+    }
+}
+
+} // namespace ns3
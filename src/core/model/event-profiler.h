@@ -0,0 +1,117 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include "event-impl.h"
+
+#include <ostream>
+#include <stdint.h>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ * \brief Attribute the run time of events to their type and context.
+ *
+ * The simulator records each event it runs with Record(), which adds the
+ * event and its wall clock run time to the totals of the dynamic type of
+ * the event and of its context.  The dynamic type of an event made by
+ * MakeEvent names the function or method signature and the bound
+ * arguments, or the lambda, it invokes.
+ *
+ * The totals are kept in an open addressing hash table indexed by the
+ * address of the `std::type_info` of the event, so recording an event
+ * costs a hash and a few additions: the table is only ever used by the
+ * thread running the events, and needs no lock.
+ *
+ * Write() prints the totals, in decreasing order of run time, either as
+ * folded stacks, the input format of flame graph tools such as
+ * [FlameGraph](https://github.com/brendangregg/FlameGraph):
+ * \verbatim
+   ns3::MakeEvent<...>::EventMemberImpl0;context 3 1234567 \endverbatim
+ * or as CSV, with the number of events:
+ * \verbatim
+   event,context,count,nanoseconds
+   "ns3::MakeEvent<...>::EventMemberImpl0",3,42,1234567 \endverbatim
+ */
+class EventProfiler
+{
+  public:
+    /** Report formats. */
+    enum Format
+    {
+        FOLDED, //!< Folded stacks, in nanoseconds
+        CSV     //!< Comma separated values
+    };
+
+    /** Constructor. */
+    EventProfiler();
+
+    /**
+     * Add an event to the totals of its type and context.
+     *
+     * \param [in] event The event.
+     * \param [in] context The context the event ran in.
+     * \param [in] nanoseconds The wall clock run time of the event.
+     */
+    void Record(const EventImpl* event, uint32_t context, uint64_t nanoseconds);
+
+    /**
+     * Print the totals.
+     *
+     * \param [in,out] os The output stream.
+     * \param [in] format The report format.
+     */
+    void Write(std::ostream& os, Format format) const;
+
+  private:
+    /** Totals of an event type in a context. */
+    struct Entry
+    {
+        const std::type_info* type; //!< The event type, null for a free entry
+        uint32_t context;           //!< The context
+        uint64_t count;             //!< Number of events
+        uint64_t nanoseconds;       //!< Total run time
+    };
+
+    /** Double the size of the table. */
+    void Grow();
+    /**
+     * Find the entry of a type and context.
+     *
+     * \param [in] type The event type.
+     * \param [in] context The context.
+     * \returns The entry, a free one if the type is not in the table yet.
+     */
+    Entry& Find(const std::type_info* type, uint32_t context);
+
+    std::vector<Entry> m_table; //!< Hash table, of a size power of two
+    std::size_t m_size;         //!< Number of entries in use
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -18,6 +18,7 @@
  */
 #include "fatal-impl.h"
 
+#include "async-file-stream.h"
 #include "log.h"
 
 #include <csignal>
@@ -187,6 +188,10 @@ void
 FlushStreams()
 {
     NS_LOG_FUNCTION_NOARGS();
+    /* The trace files written from a background thread do not hand their
+     * content over when flushed */
+    AsyncFileBuf::FlushAll();
+
     std::list<std::ostream*>** pl = PeekStreamList();
     if (*pl == nullptr)
     {
@@ -90,6 +90,9 @@ void UnregisterStream(std::ostream* stream);
  * skip the bad \c ostream* and continue to flush the next stream.
  * The function will then terminate raising \c SIGIOT (aka \c SIGABRT)
  *
+ * The files written from a background thread are written out first,
+ * see AsyncFileBuf::FlushAll().
+ *
  * DO NOT call this function until the program is ready to crash.
  */
 void FlushStreams();
@@ -0,0 +1,340 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+namespace
+{
+
+/**
+ * \ingroup scheduler
+ * Remove an event from an unsorted array of events.
+ *
+ * \param [in,out] events The events.
+ * \param [in] ev The event to remove.
+ * \returns \c true if the event was found.
+ */
+bool
+RemoveUnsorted(std::vector<Scheduler::Event>& events, const Scheduler::Event& ev)
+{
+    for (auto& other : events)
+    {
+        if (other.key.m_uid == ev.key.m_uid)
+        {
+            NS_ASSERT(other.impl == ev.impl);
+            other = events.back();
+            events.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // unnamed namespace
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LadderScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<LadderScheduler>();
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topStart(0),
+      m_topMin(0),
+      m_topMax(0),
+      m_nRungs(0),
+      m_bottomHead(0),
+      m_size(0)
+{
+    NS_LOG_FUNCTION(this);
+    // rungs are referenced while new ones are pushed
+    m_rungs.reserve(MAX_RUNGS);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    DoInsert(ev);
+    ++m_size;
+    if (m_bottomHead == m_bottom.size())
+    {
+        Refill();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_bottomHead < m_bottom.size());
+    return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_bottomHead < m_bottom.size());
+    Event ev = m_bottom[m_bottomHead++];
+    --m_size;
+    if (m_bottomHead == m_bottom.size() && m_size > 0)
+    {
+        Refill();
+    }
+    NS_LOG_DEBUG("remove " << ev.key.m_uid << " at " << ev.key.m_ts);
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    bool found = false;
+    if (ts >= m_topStart)
+    {
+        found = RemoveUnsorted(m_top, ev);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < m_nRungs; ++i)
+        {
+            Rung& rung = m_rungs[i];
+            if (ts >= rung.start + rung.current * rung.width)
+            {
+                found = RemoveUnsorted(rung.buckets[(ts - rung.start) / rung.width], ev);
+                rung.count -= found ? 1 : 0;
+                break;
+            }
+        }
+        if (!found)
+        {
+            auto it = std::lower_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev);
+            found = it != m_bottom.end() && it->key.m_uid == ev.key.m_uid;
+            if (found)
+            {
+                m_bottom.erase(it);
+            }
+        }
+    }
+    NS_ASSERT_MSG(found, "Event " << ev.key.m_uid << " not found");
+    --m_size;
+    if (m_bottomHead == m_bottom.size() && m_size > 0)
+    {
+        Refill();
+    }
+}
+
+void
+LadderScheduler::DoInsert(const Event& ev)
+{
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        if (m_top.empty())
+        {
+            m_topMin = ts;
+            m_topMax = ts;
+        }
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+        m_top.push_back(ev);
+        return;
+    }
+    // the rungs are finer and start earlier as the ladder goes down
+    for (std::size_t i = 0; i < m_nRungs; ++i)
+    {
+        Rung& rung = m_rungs[i];
+        if (ts >= rung.start + rung.current * rung.width)
+        {
+            rung.buckets[(ts - rung.start) / rung.width].push_back(ev);
+            ++rung.count;
+            return;
+        }
+    }
+    InsertBottom(ev);
+}
+
+void
+LadderScheduler::InsertBottom(const Event& ev)
+{
+    if (m_bottomHead >= 1024 && m_bottomHead * 2 >= m_bottom.size())
+    {
+        // reclaim the consumed events of a long lived bottom
+        m_bottom.erase(m_bottom.begin(), m_bottom.begin() + m_bottomHead);
+        m_bottomHead = 0;
+    }
+
+    auto first = m_bottom.begin() + m_bottomHead;
+    auto pos = std::upper_bound(first, m_bottom.end(), ev);
+    if (static_cast<std::size_t>(m_bottom.end() - pos) > BUCKET_THRESHOLD &&
+        m_nRungs < MAX_RUNGS && first->key.m_ts != m_bottom.back().key.m_ts)
+    {
+        // too many events to move: spread the bottom over a new rung
+        NS_LOG_LOGIC("bottom overflow, " << m_bottom.end() - first << " events");
+        uint64_t end = GetBottomEnd();
+        m_bottom.erase(m_bottom.begin(), first);
+        m_bottomHead = 0;
+        SpawnRung(m_bottom.front().key.m_ts, end, m_bottom);
+        DoInsert(ev);
+        return;
+    }
+    m_bottom.insert(pos, ev);
+}
+
+void
+LadderScheduler::Refill()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_bottomHead == m_bottom.size() && m_size > 0);
+    while (true)
+    {
+        if (m_nRungs == 0)
+        {
+            // a new epoch starts with the events of the top
+            NS_ASSERT(!m_top.empty());
+            NS_LOG_LOGIC("new epoch, " << m_top.size() << " events in [" << m_topMin << ", "
+                                       << m_topMax << "]");
+            m_topStart = m_topMax + 1;
+            if (m_top.size() <= BUCKET_THRESHOLD || m_topMin == m_topMax)
+            {
+                SetBottom(m_top);
+                return;
+            }
+            SpawnRung(m_topMin, m_topStart, m_top);
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        if (rung.count == 0)
+        {
+            --m_nRungs;
+            continue;
+        }
+        while (rung.buckets[rung.current].empty())
+        {
+            ++rung.current;
+        }
+        Bucket& bucket = rung.buckets[rung.current];
+        uint64_t start = rung.start + rung.current * rung.width;
+        ++rung.current;
+        rung.count -= bucket.size();
+
+        if (bucket.size() > BUCKET_THRESHOLD && m_nRungs < MAX_RUNGS)
+        {
+            auto [lo, hi] = std::minmax_element(
+                bucket.begin(),
+                bucket.end(),
+                [](const Event& a, const Event& b) { return a.key.m_ts < b.key.m_ts; });
+            if (lo->key.m_ts != hi->key.m_ts)
+            {
+                SpawnRung(lo->key.m_ts, start + rung.width, bucket);
+                continue;
+            }
+        }
+        SetBottom(bucket);
+        return;
+    }
+}
+
+void
+LadderScheduler::SpawnRung(uint64_t start, uint64_t end, Bucket& events)
+{
+    NS_LOG_FUNCTION(this << start << end << events.size());
+    NS_ASSERT(start < end && !events.empty() && m_nRungs < MAX_RUNGS);
+    if (m_nRungs == m_rungs.size())
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs++];
+    // about one event per bucket
+    uint64_t span = end - start;
+    rung.width = span / events.size() + (span % events.size() != 0 ? 1 : 0);
+    rung.nBuckets = (span - 1) / rung.width + 1;
+    rung.start = start;
+    rung.current = 0;
+    rung.count = events.size();
+    if (rung.buckets.size() < rung.nBuckets)
+    {
+        rung.buckets.resize(rung.nBuckets);
+    }
+    for (const auto& ev : events)
+    {
+        NS_ASSERT(ev.key.m_ts >= start && ev.key.m_ts < end);
+        rung.buckets[(ev.key.m_ts - start) / rung.width].push_back(ev);
+    }
+    events.clear();
+}
+
+void
+LadderScheduler::SetBottom(Bucket& bucket)
+{
+    if (!std::is_sorted(bucket.begin(), bucket.end()))
+    {
+        std::sort(bucket.begin(), bucket.end());
+    }
+    m_bottom.clear();
+    m_bottom.swap(bucket);
+    m_bottomHead = 0;
+}
+
+uint64_t
+LadderScheduler::GetBottomEnd() const
+{
+    if (m_nRungs == 0)
+    {
+        return m_topStart;
+    }
+    const Rung& rung = m_rungs[m_nRungs - 1];
+    return rung.start + rung.current * rung.width;
+}
+
+} // namespace ns3
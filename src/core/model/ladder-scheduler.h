@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng][Tang], with the linked lists of the original replaced
+ * by `std::vector`s of events.
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are kept in three tiers:
+ *
+ * - the top, an unsorted array of the events of future epochs, that is
+ *   of the events later than the span of the ladder;
+ * - the ladder, a stack of rungs.  A rung is an array of buckets of
+ *   equal width, each holding its events unsorted.  The first rung is
+ *   built from the whole top when an epoch starts, with about one bucket
+ *   per event; when a bucket of the last rung holds too many events to
+ *   be sorted cheaply, it is spread over a new, finer, rung;
+ * - the bottom, a sorted array holding the events of the bucket being
+ *   consumed, from which RemoveNext() pops.
+ *
+ * Only buckets of a few tens of events are ever sorted, so the events of a
+ * heavy-tailed distribution, such as many link events a few nanoseconds
+ * apart and sparse far away timers, all cost a constant time.  A bucket
+ * whose events share a single time stamp is moved to the bottom as a
+ * block, and needs no sorting at all when its events were scheduled in
+ * order.  The bucket arrays of consumed rungs are recycled, so a
+ * simulation in steady state does not allocate.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to the top or a bucket
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | The bottom is kept non-empty
+ * Remove()     | Linear          | Search within the top or a bucket
+ * RemoveNext() | ~Constant       | Sort small buckets only
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                                 | Reason
+ * :-------- | :------------------------------------- | :-----
+ * Overhead  | 104 bytes<br/>plus 24 bytes per bucket | `std::vector` per bucket
+ * Per Event | 0                                      | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** An array of events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        uint64_t start;              //!< Time stamp of the start of the first bucket
+        uint64_t width;              //!< Duration of a bucket, in dimensionless time units
+        std::size_t nBuckets;        //!< Number of buckets in use
+        std::size_t current;         //!< Index of the next bucket to consume
+        std::size_t count;           //!< Number of events in the rung
+        std::vector<Bucket> buckets; //!< Bucket storage, at least nBuckets long
+    };
+
+    /**
+     * Insert an event in the top, the ladder or the bottom.
+     *
+     * \param [in] ev The new Event.
+     */
+    void DoInsert(const Scheduler::Event& ev);
+    /**
+     * Insert an event in the sorted bottom.
+     *
+     * \param [in] ev The new Event.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+    /** Refill the bottom from the ladder, or from the top, if it is empty. */
+    void Refill();
+    /**
+     * Push a new rung spanning [start, end) and spread events over it.
+     *
+     * \param [in] start The time stamp of the start of the rung.
+     * \param [in] end The time stamp of the end of the rung.
+     * \param [in,out] events The events, all in [start, end); cleared on return.
+     */
+    void SpawnRung(uint64_t start, uint64_t end, Bucket& events);
+    /**
+     * Make a bucket the new bottom, sorting it if needed.
+     *
+     * \param [in,out] bucket The bucket, which receives the storage of the old bottom.
+     */
+    void SetBottom(Bucket& bucket);
+    /**
+     * Get the time stamp from which events are stored in the ladder or the top.
+     *
+     * \returns The start of the current bucket of the last rung, or the
+     * start of the top when the ladder is empty.
+     */
+    uint64_t GetBottomEnd() const;
+
+    /** Maximum number of events sorted at once into the bottom. */
+    static constexpr std::size_t BUCKET_THRESHOLD = 50;
+    /** Maximum number of rungs. */
+    static constexpr std::size_t MAX_RUNGS = 8;
+
+    Bucket m_top;              //!< Events of the future epochs, unsorted
+    uint64_t m_topStart;       //!< Time stamp of the start of the top
+    uint64_t m_topMin;         //!< Smallest time stamp in the top
+    uint64_t m_topMax;         //!< Largest time stamp in the top
+    std::vector<Rung> m_rungs; //!< Rung storage, the ladder is the first m_nRungs
+    std::size_t m_nRungs;      //!< Number of rungs in use
+    Bucket m_bottom;           //!< Events of the current bucket, sorted
+    std::size_t m_bottomHead;  //!< Index of the first event of the bottom
+    std::size_t m_size;        //!< Number of events in the queue
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
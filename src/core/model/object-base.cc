@@ -27,6 +27,9 @@
 
 #include "ns3/core-config.h"
 
+#include <memory>
+#include <vector>
+
 /**
  * \file
  * \ingroup object
@@ -70,6 +73,110 @@ ObjectBase::GetTypeId()
     return tid;
 }
 
+namespace
+{
+
+/**
+ * \ingroup object
+ * How ObjectBase::ConstructSelf sets an attribute by default.
+ */
+struct ConstructionStep
+{
+    TypeId tid;                        //!< The TypeId declaring the attribute
+    TypeId::AttributeInformation info; //!< The attribute
+    Ptr<const AttributeValue> value;   //!< Default value, null if it is invalid
+    bool validated;                    //!< The default value is valid for the checker
+    const char* where;                 //!< Where the default value comes from
+};
+
+/**
+ * \ingroup object
+ * The attributes of a TypeId and its parents, with their default values.
+ */
+struct ConstructionPlan
+{
+    uint64_t generation;                 //!< TypeId::GetAttributeGeneration when built
+    uint64_t envGeneration;              //!< EnvironmentVariable::GetGeneration when built
+    std::vector<ConstructionStep> steps; //!< The attributes
+};
+
+/**
+ * \ingroup object
+ * Get the construction plan of a TypeId, building it if the attributes
+ * or the environment variables changed since it was built.
+ *
+ * \param [in] tid The TypeId.
+ * \returns The construction plan.
+ */
+std::shared_ptr<const ConstructionPlan>
+GetConstructionPlan(TypeId tid)
+{
+    // plans are indexed by TypeId uid, and shared with the constructions
+    // in progress in case a nested construction rebuilds them
+#ifdef NS3_MTP
+    thread_local std::vector<std::shared_ptr<const ConstructionPlan>> plans;
+#else
+    static std::vector<std::shared_ptr<const ConstructionPlan>> plans;
+#endif
+    uint64_t generation = TypeId::GetAttributeGeneration();
+    uint64_t envGeneration = EnvironmentVariable::GetGeneration();
+    if (plans.size() <= tid.GetUid())
+    {
+        plans.resize(tid.GetUid() + 1);
+    }
+    if (plans[tid.GetUid()] && plans[tid.GetUid()]->generation == generation &&
+        plans[tid.GetUid()]->envGeneration == envGeneration)
+    {
+        return plans[tid.GetUid()];
+    }
+
+    NS_LOG_DEBUG("build construction plan of tid=" << tid.GetName());
+    auto plan = std::make_shared<ConstructionPlan>();
+    plan->generation = generation;
+    plan->envGeneration = envGeneration;
+    TypeId current = tid;
+    do // Do this tid and all parents
+    {
+        for (uint32_t i = 0; i < current.GetAttributeN(); i++)
+        {
+            ConstructionStep step{current, current.GetAttribute(i), nullptr, true, "initial value"};
+            if (step.info.flags & TypeId::ATTR_CONSTRUCT)
+            {
+                Ptr<const AttributeValue> value = step.info.initialValue;
+                auto [found, val] = EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT",
+                                                             current.GetAttributeFullName(i));
+                if (found)
+                {
+                    NS_LOG_DEBUG("found in environment: " << val);
+                    value = Create<StringValue>(val);
+                    step.where = "env var";
+                }
+                if (step.info.checker->GetValueTypeName() == "ns3::PointerValue" &&
+                    dynamic_cast<const StringValue*>(PeekPointer(value)))
+                {
+                    // Each object gets its own object parsed from the string,
+                    // e.g. a random variable, so the value is validated on
+                    // each construction
+                    step.value = value;
+                    step.validated = false;
+                }
+                else
+                {
+                    // Setting from initial value may fail, e.g. setting
+                    // ObjectVectorValue from "": the attribute is then left alone
+                    step.value = step.info.checker->CreateValidValue(*value);
+                }
+            }
+            plan->steps.push_back(step);
+        }
+        current = current.GetParent();
+    } while (current != ObjectBase::GetTypeId());
+    plans[tid.GetUid()] = plan;
+    return plan;
+}
+
+} // unnamed namespace
+
 ObjectBase::~ObjectBase()
 {
     NS_LOG_FUNCTION(this);
@@ -84,104 +191,70 @@ ObjectBase::NotifyConstructionCompleted()
 void
 ObjectBase::ConstructSelf(const AttributeConstructionList& attributes)
 {
-    // loop over the inheritance tree back to the Object base class.
+    // loop over the attributes of the inheritance tree back to the Object base class.
     NS_LOG_FUNCTION(this << &attributes);
-    TypeId tid = GetInstanceTypeId();
-    do // Do this tid and all parents
+    auto plan = GetConstructionPlan(GetInstanceTypeId());
+    bool hasArguments = attributes.Begin() != attributes.End();
+    for (const auto& step : plan->steps)
     {
-        // loop over all attributes in object type
-        NS_LOG_DEBUG("construct tid=" << tid.GetName() << ", params=" << tid.GetAttributeN());
-        for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+        const TypeId::AttributeInformation& info = step.info;
+        // is this attribute stored in this AttributeConstructionList instance ?
+        Ptr<const AttributeValue> value;
+        if (hasArguments)
         {
-            TypeId::AttributeInformation info = tid.GetAttribute(i);
-            NS_LOG_DEBUG("try to construct \"" << tid.GetName() << "::" << info.name << "\"");
-            // is this attribute stored in this AttributeConstructionList instance ?
-            Ptr<const AttributeValue> value = attributes.Find(info.checker);
-            std::string where = "argument";
+            value = attributes.Find(info.checker);
+        }
 
-            // See if this attribute should not be set here in the
-            // constructor.
-            if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+        // See if this attribute should not be set here in the
+        // constructor.
+        if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+        {
+            // Handle this attribute if it should not be
+            // set here.
+            if (!value)
             {
-                // Handle this attribute if it should not be
-                // set here.
-                if (!value)
-                {
-                    // Skip this attribute if it's not in the
-                    // AttributeConstructionList.
-                    NS_LOG_DEBUG("skipping, not settable at construction");
-                    continue;
-                }
-                else
-                {
-                    // This is an error because this attribute is not
-                    // settable in its constructor but is present in
-                    // the AttributeConstructionList.
-                    NS_FATAL_ERROR("Attribute name="
-                                   << info.name << " tid=" << tid.GetName()
-                                   << ": initial value cannot be set using attributes");
-                }
+                // Skip this attribute if it's not in the
+                // AttributeConstructionList.
+                continue;
             }
-
-            if (!value)
+            else
             {
-                NS_LOG_DEBUG("trying to set from environment variable NS_ATTRIBUTE_DEFAULT");
-                auto [found, val] =
-                    EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT", tid.GetAttributeFullName(i));
-                if (found)
-                {
-                    NS_LOG_DEBUG("found in environment: " << val);
-                    value = Create<StringValue>(val);
-                    where = "env var";
-                }
+                // This is an error because this attribute is not
+                // settable in its constructor but is present in
+                // the AttributeConstructionList.
+                NS_FATAL_ERROR("Attribute name=" << info.name << " tid=" << step.tid.GetName()
+                                                 << ": initial value cannot be set using attributes");
             }
+        }
 
-            bool initial{false};
-            if (!value)
+        if (value)
+        {
+            /*
+              DoSet may fail, for instance when `value` is a real
+              `PointerValue` containing 0 as the pointed-to address:
+              since value is not null (it just contains null) the
+              initial value is not used either.
+            */
+            if (DoSet(info.accessor, info.checker, *value))
             {
-                // This is guaranteed to exist
-                NS_LOG_DEBUG("falling back to initial value from tid");
-                value = info.initialValue;
-                where = "initial value";
-                initial = true;
+                NS_LOG_DEBUG("construct \"" << step.tid.GetName() << "::" << info.name
+                                            << "\" from argument");
             }
-
-            // We have a matching attribute value, if only from the initialValue
-            if (DoSet(info.accessor, info.checker, *value) || initial)
+        }
+        else if (step.value)
+        {
+            if (step.validated)
             {
-                // Setting from initial value may fail, e.g. setting
-                // ObjectVectorValue from ""
-                // That's ok, so we still report success since construction is complete
-                NS_LOG_DEBUG("construct \"" << tid.GetName() << "::" << info.name << "\" from "
-                                            << where);
+                info.accessor->Set(this, *step.value);
             }
             else
             {
-                /*
-                  One would think this is an error...
-
-                  but there are cases where `attributes.Find(info.checker)`
-                  returns a non-null value which still fails the `DoSet()` call.
-                  For example, `value` is sometimes a real `PointerValue`
-                  containing 0 as the pointed-to address.  Since value
-                  is not null (it just contains null) the initial
-                  value is not used, the DoSet fails, and we end up
-                  here.
-
-                  If we were adventurous we might try to fix this deep
-                  below DoSet, but there be dragons.
-                */
-                /*
-                NS_ASSERT_MSG(false,
-                              "Failed to set attribute '" << info.name << "' from '"
-                                                          << value->SerializeToString(info.checker)
-                                                          << "'");
-                */
+                DoSet(info.accessor, info.checker, *step.value);
             }
-
-        } // for i attributes
-        tid = tid.GetParent();
-    } while (tid != ObjectBase::GetTypeId());
+            NS_LOG_DEBUG("construct \"" << step.tid.GetName() << "::" << info.name << "\" from "
+                                        << step.where);
+        }
+    }
     NotifyConstructionCompleted();
 }
 
@@ -314,6 +314,11 @@ class ObjectBase
      * you should make sure that you invoke this method from
      * your most-derived constructor.
      *
+     * The default values, from the initial values of the attributes or
+     * the \c NS_ATTRIBUTE_DEFAULT environment variable, are resolved and
+     * validated once per TypeId and thread, and again only when
+     * TypeId::GetAttributeGeneration changes.
+     *
      * \param [in] attributes The attribute values used to initialize
      *        the member variables of this object's instance.
      */
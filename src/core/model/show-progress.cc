@@ -55,6 +55,7 @@ ShowProgress::ShowProgress(const Time interval /* = Seconds (1.0) */,
       m_printer(DefaultTimePrinter),
       m_os(&os),
       m_verbose(false),
+      m_report(),
       m_repCount(0)
 {
     NS_LOG_FUNCTION(this << interval);
@@ -98,6 +99,13 @@ ShowProgress::SetVerbose(bool verbose)
     m_verbose = verbose;
 }
 
+void
+ShowProgress::SetReportCallback(ReportCallback report)
+{
+    NS_LOG_FUNCTION(this);
+    m_report = report;
+}
+
 void
 ShowProgress::SetStream(std::ostream& os)
 {
@@ -139,6 +147,11 @@ ShowProgress::GiveFeedback(uint64_t nEvents, int64x64_t ratio, int64x64_t speed)
             << nEvents << " events processed" << std::endl
             << std::flush;
 
+    if (!m_report.IsNull())
+    {
+        m_report(*m_os, m_elapsed);
+    }
+
     // Restore stream state
     m_os->precision(precision);
     m_os->flags(flags);
@@ -27,6 +27,7 @@
  * ns3::ShowProgress declaration.
  */
 
+#include "callback.h"
 #include "event-id.h"
 #include "nstime.h"
 #include "system-wall-clock-ms.h"
@@ -132,6 +133,21 @@ class ShowProgress
      */
     void SetVerbose(bool verbose);
 
+    /**
+     * Callback signature for printing additional progress information.
+     * \param [in] os The output stream.
+     * \param [in] elapsed The wallclock time since the previous progress message.
+     */
+    typedef Callback<void, std::ostream&, Time> ReportCallback;
+
+    /**
+     * Set a callback invoked after each progress message,
+     * to print model-specific progress on the same stream.
+     *
+     * \param [in] report The callback; a null callback removes it.
+     */
+    void SetReportCallback(ReportCallback report);
+
   private:
     /**
      * Start the elapsed wallclock timestamp and print the start time.
@@ -188,10 +204,11 @@ class ShowProgress
     EventId m_event;                  //!< The next progress event.
     uint64_t m_eventCount;            //!< Simulator event count
 
-    TimePrinter m_printer; //!< The TimePrinter to use
-    std::ostream* m_os;    //!< The output stream to use.
-    bool m_verbose;        //!< Verbose mode flag
-    uint64_t m_repCount;   //!< Number of CheckProgress events
+    TimePrinter m_printer;   //!< The TimePrinter to use
+    std::ostream* m_os;      //!< The output stream to use.
+    bool m_verbose;          //!< Verbose mode flag
+    ReportCallback m_report; //!< Additional progress information
+    uint64_t m_repCount;     //!< Number of CheckProgress events
 
 }; // class ShowProgress
 
@@ -29,6 +29,7 @@
 #include "scheduler.h"
 #include "simulator-impl.h"
 #include "string.h"
+#include "timer-wheel.h"
 
 #include "ns3/core-config.h"
 
@@ -156,6 +157,7 @@ Simulator::Destroy()
     LogSetTimePrinter(nullptr);
     LogSetNodePrinter(nullptr);
     (*pimpl)->Destroy();
+    TimerWheel::Destroy();
     (*pimpl)->Unref();
     *pimpl = nullptr;
 }
@@ -236,7 +238,7 @@ void
 Simulator::ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* impl)
 {
 #ifdef ENABLE_DES_METRICS
-    DesMetrics::Get()->TraceWithContext(context, Now(), delay);
+    DesMetrics::Get()->TraceWithContext(context, Now(), delay, impl);
 #endif
     return GetImpl()->ScheduleWithContext(context, delay, impl);
 }
@@ -251,18 +253,24 @@ EventId
 Simulator::DoSchedule(const Time& time, EventImpl* impl)
 {
 #ifdef ENABLE_DES_METRICS
-    DesMetrics::Get()->Trace(Now(), time);
-#endif
+    EventId id = GetImpl()->Schedule(time, impl);
+    DesMetrics::Get()->Trace(Now(), time, impl, id.GetUid());
+    return id;
+#else
     return GetImpl()->Schedule(time, impl);
+#endif
 }
 
 EventId
 Simulator::DoScheduleNow(EventImpl* impl)
 {
 #ifdef ENABLE_DES_METRICS
-    DesMetrics::Get()->Trace(Now(), Time(0));
-#endif
+    EventId id = GetImpl()->ScheduleNow(impl);
+    DesMetrics::Get()->Trace(Now(), Time(0), impl, id.GetUid());
+    return id;
+#else
     return GetImpl()->ScheduleNow(impl);
+#endif
 }
 
 EventId
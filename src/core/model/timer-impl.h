@@ -23,6 +23,7 @@
 #include "fatal-error.h"
 #include "int-to-type.h"
 #include "simulator.h"
+#include "timer-wheel.h"
 #include "type-traits.h"
 
 /**
@@ -123,9 +124,9 @@ class TimerImpl
      * Schedule the callback for a future time.
      *
      * \param [in] delay The amount of time until the timer expires.
-     * \returns The scheduled EventId.
+     * \returns The id of the timer armed in the TimerWheel.
      */
-    virtual EventId Schedule(const Time& delay) = 0;
+    virtual TimerWheel::Id Schedule(const Time& delay) = 0;
     /** Invoke the expire function. */
     virtual void Invoke() = 0;
 };
@@ -272,9 +273,9 @@ MakeTimerImpl(IntToType<0>, FN fn)
         {
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_fn);
+            return TimerWheel::Schedule(delay, m_fn);
         }
 
         void Invoke() override
@@ -312,9 +313,9 @@ MakeTimerImpl(IntToType<1>, FN fn)
             m_a1 = a1;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_fn, m_a1);
+            return TimerWheel::Schedule(delay, m_fn, m_a1);
         }
 
         void Invoke() override
@@ -357,9 +358,9 @@ MakeTimerImpl(IntToType<2>, FN fn)
             m_a2 = a2;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_fn, m_a1, m_a2);
+            return TimerWheel::Schedule(delay, m_fn, m_a1, m_a2);
         }
 
         void Invoke() override
@@ -407,9 +408,9 @@ MakeTimerImpl(IntToType<3>, FN fn)
             m_a3 = a3;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_fn, m_a1, m_a2, m_a3);
+            return TimerWheel::Schedule(delay, m_fn, m_a1, m_a2, m_a3);
         }
 
         void Invoke() override
@@ -463,9 +464,9 @@ MakeTimerImpl(IntToType<4>, FN fn)
             m_a4 = a4;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_fn, m_a1, m_a2, m_a3, m_a4);
+            return TimerWheel::Schedule(delay, m_fn, m_a1, m_a2, m_a3, m_a4);
         }
 
         void Invoke() override
@@ -528,9 +529,9 @@ MakeTimerImpl(IntToType<5>, FN fn)
             m_a5 = a5;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5);
+            return TimerWheel::Schedule(delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5);
         }
 
         void Invoke() override
@@ -603,9 +604,9 @@ MakeTimerImpl(IntToType<6>, FN fn)
             m_a6 = a6;
         }
 
-        virtual EventId Schedule(const Time& delay)
+        virtual TimerWheel::Id Schedule(const Time& delay)
         {
-            return Simulator::Schedule(delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
+            return TimerWheel::Schedule(delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
         }
 
         virtual void Invoke()
@@ -697,9 +698,9 @@ MakeTimerImpl(IntToType<0>, MEM_PTR memPtr, OBJ_PTR objPtr)
         {
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_memPtr, m_objPtr);
+            return TimerWheel::Schedule(delay, m_memPtr, m_objPtr);
         }
 
         void Invoke() override
@@ -739,9 +740,9 @@ MakeTimerImpl(IntToType<1>, MEM_PTR memPtr, OBJ_PTR objPtr)
             m_a1 = a1;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_memPtr, m_objPtr, m_a1);
+            return TimerWheel::Schedule(delay, m_memPtr, m_objPtr, m_a1);
         }
 
         void Invoke() override
@@ -786,9 +787,9 @@ MakeTimerImpl(IntToType<2>, MEM_PTR memPtr, OBJ_PTR objPtr)
             m_a2 = a2;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_memPtr, m_objPtr, m_a1, m_a2);
+            return TimerWheel::Schedule(delay, m_memPtr, m_objPtr, m_a1, m_a2);
         }
 
         void Invoke() override
@@ -838,9 +839,9 @@ MakeTimerImpl(IntToType<3>, MEM_PTR memPtr, OBJ_PTR objPtr)
             m_a3 = a3;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3);
+            return TimerWheel::Schedule(delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3);
         }
 
         void Invoke() override
@@ -896,9 +897,9 @@ MakeTimerImpl(IntToType<4>, MEM_PTR memPtr, OBJ_PTR objPtr)
             m_a4 = a4;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4);
+            return TimerWheel::Schedule(delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4);
         }
 
         void Invoke() override
@@ -964,9 +965,9 @@ MakeTimerImpl(IntToType<5>, MEM_PTR memPtr, OBJ_PTR objPtr)
             m_a5 = a5;
         }
 
-        EventId Schedule(const Time& delay) override
+        TimerWheel::Id Schedule(const Time& delay) override
         {
-            return Simulator::Schedule(delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5);
+            return TimerWheel::Schedule(delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5);
         }
 
         void Invoke() override
@@ -1042,17 +1043,17 @@ MakeTimerImpl(IntToType<6>, MEM_PTR memPtr, OBJ_PTR objPtr)
             m_a6 = a6;
         }
 
-        virtual EventId Schedule(const Time& delay)
+        virtual TimerWheel::Id Schedule(const Time& delay)
         {
-            return Simulator::Schedule(delay,
-                                       m_memPtr,
-                                       m_objPtr,
-                                       m_a1,
-                                       m_a2,
-                                       m_a3,
-                                       m_a4,
-                                       m_a5,
-                                       m_a6);
+            return TimerWheel::Schedule(delay,
+                                        m_memPtr,
+                                        m_objPtr,
+                                        m_a1,
+                                        m_a2,
+                                        m_a3,
+                                        m_a4,
+                                        m_a5,
+                                        m_a6);
         }
 
         virtual void Invoke()
@@ -0,0 +1,593 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timer-wheel.h"
+
+#include "assert.h"
+#include "boolean.h"
+#include "global-value.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TimerWheel");
+
+namespace
+{
+
+/**
+ * \ingroup timer
+ * The wheels of all the contexts.
+ */
+struct WheelRegistry
+{
+    std::mutex mutex;                                 //!< Protects wheels
+    std::unordered_map<uint32_t, TimerWheel*> wheels; //!< The wheels, by context
+};
+
+/**
+ * \ingroup timer
+ * \returns The registry of the wheels, never deleted since wheels are not.
+ */
+WheelRegistry&
+GetRegistry()
+{
+    static WheelRegistry* registry = new WheelRegistry;
+    return *registry;
+}
+
+/**
+ * \ingroup timer
+ * Whether the timers are armed in the wheels.
+ */
+GlobalValue g_timerWheelEnabled =
+    GlobalValue("TimerWheelEnabled",
+                "Arm ns3::Timer, Watchdog and the TCP timers in a TimerWheel",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
+/**
+ * \ingroup timer
+ * The value of g_timerWheelEnabled for the current simulation, or -1 until
+ * it is read.
+ */
+std::atomic<int> g_timerWheelState{-1};
+
+} // unnamed namespace
+
+TimerWheel::Id::Id()
+    : m_entry(nullptr),
+      m_event()
+{
+}
+
+TimerWheel::Id::Id(const EventId& event)
+    : m_entry(nullptr),
+      m_event(event)
+{
+}
+
+TimerWheel::Id::Id(const Ptr<Entry>& entry)
+    : m_entry(entry),
+      m_event()
+{
+}
+
+TimerWheel::Id::operator EventId() const
+{
+    if (!m_entry)
+    {
+        return m_event;
+    }
+    if (m_entry->expired)
+    {
+        return EventId();
+    }
+    // a timer still in the wheel expires after all the events of its time step
+    uint32_t uid =
+        m_entry->pprev != nullptr ? std::numeric_limits<uint32_t>::max() : m_entry->uid;
+    return EventId(Ptr<EventImpl>(PeekPointer(m_entry)),
+                   m_entry->ts,
+                   m_entry->wheel->m_context,
+                   uid);
+}
+
+void
+TimerWheel::Id::Cancel()
+{
+    if (!m_entry)
+    {
+        m_event.Cancel();
+        return;
+    }
+    if (m_entry->pprev != nullptr)
+    {
+        TimerWheel* wheel = m_entry->wheel;
+        wheel->Unlink(PeekPointer(m_entry));
+        ++wheel->m_stats.cancelled;
+    }
+    m_entry->Cancel();
+}
+
+void
+TimerWheel::Id::Remove()
+{
+    Cancel();
+}
+
+bool
+TimerWheel::Id::IsExpired() const
+{
+    if (!m_entry)
+    {
+        return m_event.IsExpired();
+    }
+    return m_entry->expired || m_entry->IsCancelled();
+}
+
+bool
+TimerWheel::Id::IsRunning() const
+{
+    return !IsExpired();
+}
+
+uint64_t
+TimerWheel::Id::GetTs() const
+{
+    return m_entry ? m_entry->ts : m_event.GetTs();
+}
+
+Time
+TimerWheel::Id::GetDelayLeft() const
+{
+    if (!m_entry)
+    {
+        return Simulator::GetDelayLeft(m_event);
+    }
+    if (IsExpired())
+    {
+        return TimeStep(0);
+    }
+    return TimeStep(m_entry->ts - Simulator::Now().GetTimeStep());
+}
+
+TimerWheel::Entry::Entry(TimerWheel* wheel, EventImpl* event, uint64_t ts, uint64_t seq)
+    : wheel(wheel),
+      event(event),
+      ts(ts),
+      seq(seq),
+      uid(EventId::UID::INVALID),
+      expired(false),
+      next(nullptr),
+      pprev(nullptr),
+      slot(0)
+{
+}
+
+TimerWheel::Entry::~Entry()
+{
+    event->Unref();
+}
+
+const EventImpl*
+TimerWheel::Entry::GetTarget() const
+{
+    return event->GetTarget();
+}
+
+void
+TimerWheel::Entry::Notify()
+{
+    expired = true;
+    event->Invoke();
+}
+
+TimerWheel::TimerWheel(uint32_t context)
+    : m_slots{},
+      m_occupied{},
+      m_count{},
+      m_context(context),
+      m_size(0),
+      m_current(0),
+      m_seq(0),
+      m_tick(),
+      m_tickTs(0),
+      m_expiring(),
+      m_stats{}
+{
+    NS_LOG_FUNCTION(this << context);
+}
+
+TimerWheel*
+TimerWheel::Get()
+{
+    // each thread caches the wheels of the contexts it runs, and the last one
+    thread_local std::unordered_map<uint32_t, TimerWheel*> wheels;
+    thread_local uint32_t lastContext = 0;
+    thread_local TimerWheel* last = nullptr;
+    uint32_t context = Simulator::GetContext();
+    if (last != nullptr && lastContext == context)
+    {
+        return last;
+    }
+    TimerWheel*& wheel = wheels[context];
+    if (wheel == nullptr)
+    {
+        WheelRegistry& registry = GetRegistry();
+        std::unique_lock lock{registry.mutex};
+        TimerWheel*& shared = registry.wheels[context];
+        if (shared == nullptr)
+        {
+            shared = new TimerWheel(context);
+        }
+        wheel = shared;
+    }
+    lastContext = context;
+    last = wheel;
+    return wheel;
+}
+
+bool
+TimerWheel::IsEnabled()
+{
+    int state = g_timerWheelState.load(std::memory_order_relaxed);
+    if (state < 0)
+    {
+        BooleanValue enabled;
+        g_timerWheelEnabled.GetValue(enabled);
+        state = enabled.Get() ? 1 : 0;
+        g_timerWheelState.store(state, std::memory_order_relaxed);
+    }
+    return state == 1;
+}
+
+TimerWheel::Id
+TimerWheel::Schedule(const Time& delay, EventImpl* event)
+{
+    if (!IsEnabled())
+    {
+        return Id(Simulator::Schedule(delay, Ptr<EventImpl>(event, false)));
+    }
+    return Get()->DoSchedule(delay, event);
+}
+
+TimerWheel::Statistics
+TimerWheel::GetStatistics()
+{
+    Statistics stats{};
+    WheelRegistry& registry = GetRegistry();
+    std::unique_lock lock{registry.mutex};
+    for (const auto& [context, wheel] : registry.wheels)
+    {
+        stats.scheduled += wheel->m_stats.scheduled;
+        stats.cancelled += wheel->m_stats.cancelled;
+        stats.handedOff += wheel->m_stats.handedOff;
+        stats.ticks += wheel->m_stats.ticks;
+    }
+    return stats;
+}
+
+void
+TimerWheel::Destroy()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    WheelRegistry& registry = GetRegistry();
+    std::unique_lock lock{registry.mutex};
+    for (const auto& [context, wheel] : registry.wheels)
+    {
+        wheel->Reset();
+    }
+    // the next simulation reads TimerWheelEnabled again
+    g_timerWheelState.store(-1, std::memory_order_relaxed);
+}
+
+TimerWheel::Id
+TimerWheel::DoSchedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(!delay.IsStrictlyNegative(), "TimerWheel::Schedule(): Negative delay");
+    NS_ASSERT(Simulator::GetContext() == m_context);
+    uint64_t now = Simulator::Now().GetTimeStep();
+    Ptr<Entry> entry = Create<Entry>(this, event, now + delay.GetTimeStep(), m_seq++);
+    ++m_stats.scheduled;
+    Advance(now >> TICK_SHIFT);
+    // the reference held by the wheel, then by the simulator
+    entry->Ref();
+    Insert(PeekPointer(entry));
+    if (entry->pprev != nullptr)
+    {
+        ScheduleTick();
+    }
+    return Id(entry);
+}
+
+void
+TimerWheel::Insert(Entry* entry)
+{
+    uint64_t tick = entry->ts >> TICK_SHIFT;
+    if (tick <= m_current)
+    {
+        HandOff(entry);
+        return;
+    }
+    uint64_t delta = tick - m_current;
+    uint32_t level;
+    uint32_t slot;
+    if (delta < FIRST_SLOTS)
+    {
+        level = 0;
+        slot = tick & (FIRST_SLOTS - 1);
+        m_occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+    }
+    else
+    {
+        level = LEVELS;
+        slot = OVERFLOW_SLOT;
+        for (uint32_t l = 1; l < LEVELS; ++l)
+        {
+            uint32_t shift = FIRST_BITS + l * LEVEL_BITS;
+            if (delta < (uint64_t(1) << shift))
+            {
+                level = l;
+                slot = FIRST_SLOTS + (l - 1) * LEVEL_SLOTS +
+                       ((tick >> (shift - LEVEL_BITS)) & (LEVEL_SLOTS - 1));
+                break;
+            }
+        }
+    }
+    Entry*& head = m_slots[slot];
+    entry->next = head;
+    entry->pprev = &head;
+    if (head != nullptr)
+    {
+        head->pprev = &entry->next;
+    }
+    head = entry;
+    entry->slot = slot;
+    ++m_count[level];
+    ++m_size;
+}
+
+void
+TimerWheel::Unlink(Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    NS_ASSERT(entry->pprev != nullptr);
+    uint32_t slot = entry->slot;
+    *entry->pprev = entry->next;
+    if (entry->next != nullptr)
+    {
+        entry->next->pprev = entry->pprev;
+    }
+    entry->next = nullptr;
+    entry->pprev = nullptr;
+    uint32_t level = slot < FIRST_SLOTS      ? 0
+                     : slot < OVERFLOW_SLOT ? 1 + (slot - FIRST_SLOTS) / LEVEL_SLOTS
+                                            : LEVELS;
+    if (level == 0 && m_slots[slot] == nullptr)
+    {
+        m_occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    }
+    --m_count[level];
+    --m_size;
+    entry->Unref();
+}
+
+void
+TimerWheel::HandOff(Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry << entry->ts);
+    uint64_t now = Simulator::Now().GetTimeStep();
+    NS_ASSERT(entry->ts >= now);
+    ++m_stats.handedOff;
+    // the wheel only runs in its context: hand over the reference of the wheel
+    EventId id = Simulator::Schedule(TimeStep(entry->ts - now), Ptr<EventImpl>(entry, false));
+    entry->uid = id.GetUid();
+}
+
+void
+TimerWheel::Advance(uint64_t tick)
+{
+    while (m_current < tick)
+    {
+        if (m_size == 0)
+        {
+            m_current = tick;
+            return;
+        }
+        m_current = std::min(FindNext(m_current + 1), tick);
+        if ((m_current & (FIRST_SLOTS - 1)) == 0)
+        {
+            // a new turn of the first level: cascade the upper levels
+            for (uint32_t l = 1; l <= LEVELS; ++l)
+            {
+                if (l == LEVELS)
+                {
+                    Cascade(OVERFLOW_SLOT);
+                    break;
+                }
+                uint32_t index =
+                    (m_current >> (FIRST_BITS + (l - 1) * LEVEL_BITS)) & (LEVEL_SLOTS - 1);
+                Cascade(FIRST_SLOTS + (l - 1) * LEVEL_SLOTS + index);
+                if (index != 0)
+                {
+                    break;
+                }
+            }
+        }
+        Expire(m_current & (FIRST_SLOTS - 1));
+    }
+}
+
+void
+TimerWheel::Cascade(uint32_t slot)
+{
+    Entry* entry = m_slots[slot];
+    while (entry != nullptr)
+    {
+        Entry* next = entry->next;
+        // keep the reference of the wheel while moving the timer
+        entry->Ref();
+        Unlink(entry);
+        Insert(entry);
+        entry = next;
+    }
+}
+
+void
+TimerWheel::Expire(uint32_t slot)
+{
+    if (m_slots[slot] == nullptr)
+    {
+        return;
+    }
+    m_expiring.clear();
+    for (Entry* entry = m_slots[slot]; entry != nullptr; entry = entry->next)
+    {
+        m_expiring.push_back(entry);
+    }
+    // timers sharing an expiration time run in the order they were armed
+    std::sort(m_expiring.begin(), m_expiring.end(), [](const Entry* a, const Entry* b) {
+        return a->seq < b->seq;
+    });
+    for (auto entry : m_expiring)
+    {
+        if (entry->IsCancelled())
+        {
+            // cancelled through a conversion to EventId
+            Unlink(entry);
+            continue;
+        }
+        entry->Ref();
+        Unlink(entry);
+        HandOff(entry);
+    }
+    m_expiring.clear();
+}
+
+uint64_t
+TimerWheel::FindNext(uint64_t tick) const
+{
+    uint64_t turnEnd = (tick | (FIRST_SLOTS - 1)) + 1;
+    if (m_count[0] == 0)
+    {
+        return turnEnd;
+    }
+    for (uint32_t slot = tick & (FIRST_SLOTS - 1); slot < FIRST_SLOTS; slot = (slot | 63) + 1)
+    {
+        uint64_t bits = m_occupied[slot / 64] >> (slot % 64);
+        if (bits != 0)
+        {
+            return tick + (slot - (tick & (FIRST_SLOTS - 1))) + std::countr_zero(bits);
+        }
+    }
+    return turnEnd;
+}
+
+void
+TimerWheel::ScheduleTick()
+{
+    if (m_size == 0)
+    {
+        return;
+    }
+    uint64_t next = std::numeric_limits<uint64_t>::max();
+    if (m_count[0] > 0)
+    {
+        next = FindNext(m_current + 1);
+        if ((next & (FIRST_SLOTS - 1)) == 0)
+        {
+            // the occupied slots are in the next turn
+            next = FindNext(next);
+        }
+    }
+    for (uint32_t l = 1; l <= LEVELS; ++l)
+    {
+        if (m_count[l] == 0)
+        {
+            continue;
+        }
+        uint32_t shift = FIRST_BITS + (l - 1) * LEVEL_BITS;
+        uint64_t first = ((m_current >> shift) + 1) << shift;
+        if (l == LEVELS)
+        {
+            // the overflow list cascades with the first slot of the last level
+            next = std::min(next, first);
+            continue;
+        }
+        for (uint32_t index = 0; index < LEVEL_SLOTS; ++index)
+        {
+            if (m_slots[FIRST_SLOTS + (l - 1) * LEVEL_SLOTS + index] != nullptr)
+            {
+                uint64_t distance = (index - (first >> shift)) & (LEVEL_SLOTS - 1);
+                next = std::min(next, first + (distance << shift));
+            }
+        }
+    }
+
+    uint64_t ts = next << TICK_SHIFT;
+    if (m_tick.IsRunning() && m_tickTs <= ts)
+    {
+        return;
+    }
+    m_tick.Cancel();
+    m_tickTs = ts;
+    m_tick = Simulator::Schedule(TimeStep(ts) - Simulator::Now(), &TimerWheel::Tick, this);
+}
+
+void
+TimerWheel::Tick()
+{
+    NS_LOG_FUNCTION(this);
+    ++m_stats.ticks;
+    Advance(Simulator::Now().GetTimeStep() >> TICK_SHIFT);
+    ScheduleTick();
+}
+
+void
+TimerWheel::Reset()
+{
+    NS_LOG_FUNCTION(this);
+    for (uint32_t slot = 0; slot <= OVERFLOW_SLOT; ++slot)
+    {
+        while (m_slots[slot] != nullptr)
+        {
+            Entry* entry = m_slots[slot];
+            entry->Cancel();
+            Unlink(entry);
+        }
+    }
+    NS_ASSERT(m_size == 0);
+    m_current = 0;
+    m_tick = EventId();
+    m_tickTs = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,383 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "event-id.h"
+#include "event-impl.h"
+#include "make-event.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <array>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel declaration and template implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timing wheel for timers which are often
+ * cancelled or rearmed before they expire.
+ *
+ * A timeout, such as a retransmission timer, is usually rearmed or
+ * cancelled long before it expires.  Scheduled with Simulator::Schedule,
+ * each of these timers leaves a cancelled event in the scheduler until
+ * its time stamp comes up.  Scheduled with TimerWheel::Schedule, the
+ * timer is instead linked in a slot of a wheel, from which cancelling it
+ * unlinks it in constant time.
+ *
+ * The wheel is made of four levels, after the timer wheel of the Linux
+ * kernel.  A slot of the first level lasts one tick of 2^20 time steps,
+ * which is about a millisecond with the default nanosecond resolution;
+ * a slot of each of the following levels lasts as long as the whole
+ * level before it.  Timers further away than the last level are kept in
+ * an overflow list.  When the wheel reaches the slot of a timer, the
+ * timer is handed to the simulator, which runs it at its exact
+ * expiration time.  Timers armed to expire within the current tick are
+ * handed to the simulator at once.
+ *
+ * The wheel advances with a single tick event in the simulator,
+ * scheduled at the start of the next occupied slot, so at most one event
+ * per occupied slot is ever scheduled, whatever the number of timers
+ * armed and cancelled in it.
+ *
+ * Each context owns a wheel, which only its events arm, advance and
+ * hand over, so that the wheels of the nodes of different partitions of
+ * a multithreaded simulation never share any state.  The wheels are
+ * emptied by Simulator::Destroy, after the destroy events have run.
+ *
+ * The wheel is only used when the global value TimerWheelEnabled is set,
+ * before the first timer of the simulation is armed.  Otherwise,
+ * TimerWheel::Schedule schedules the timer in the simulator.  Timers
+ * sharing their expiration time run in the order they were armed in both
+ * cases.  However, since a timer is given its place in the scheduler
+ * when it is handed over, a timer armed in the wheel runs after the
+ * events scheduled for the same time step before the hand over, even if
+ * it was armed before them.  This changes the order of ns3::Timer,
+ * Watchdog and the TCP timers relative to other events of the same time
+ * step, which is why the wheel is opt-in.
+ */
+class TimerWheel
+{
+  private:
+    class Entry;
+
+  public:
+    /**
+     * \ingroup timer
+     * \brief An identifier for timers armed with TimerWheel::Schedule.
+     *
+     * A TimerWheel::Id is used as an EventId, and is always in a valid
+     * state, even when no timer was assigned to it.  It is constructed
+     * from, and converted to, an EventId, so that code written for timers
+     * scheduled in the simulator keeps working unchanged.
+     */
+    class Id
+    {
+      public:
+        /** Default constructor, the timer is expired. */
+        Id();
+        /**
+         * Constructor from an event scheduled in the simulator.
+         *
+         * \param [in] event The event.
+         */
+        Id(const EventId& event);
+        /**
+         * Conversion to an EventId, which may be cancelled but not removed
+         * while the timer is in the wheel.
+         *
+         * \returns The timer as an EventId.
+         */
+        operator EventId() const;
+        /**
+         * Cancel the timer.  A timer still in the wheel is removed from
+         * it, a timer already handed to the simulator is cancelled.
+         */
+        void Cancel();
+        /** Cancel the timer, as Cancel(). */
+        void Remove();
+        /**
+         * \returns \c true if the timer has run or was cancelled.
+         */
+        bool IsExpired() const;
+        /**
+         * \returns \c true if the timer has neither run nor been cancelled.
+         */
+        bool IsRunning() const;
+        /**
+         * \returns The absolute expiration time of the timer, in time steps.
+         */
+        uint64_t GetTs() const;
+        /**
+         * \returns The time left before the timer expires, or zero if it
+         * is expired.
+         */
+        Time GetDelayLeft() const;
+
+      private:
+        friend class TimerWheel;
+        /**
+         * Constructor from an armed timer.
+         *
+         * \param [in] entry The timer.
+         */
+        Id(const Ptr<Entry>& entry);
+
+        Ptr<Entry> m_entry; //!< The timer, if armed in a wheel
+        EventId m_event;    //!< The timer, if scheduled in the simulator
+    };
+
+    /** Activity counters of the wheel of a thread. */
+    struct Statistics
+    {
+        uint64_t scheduled; //!< Timers armed
+        uint64_t cancelled; //!< Timers cancelled while in the wheel
+        uint64_t handedOff; //!< Timers handed to the simulator
+        uint64_t ticks;     //!< Tick events run
+    };
+
+    /**
+     * Arm a timer to expire after \p delay.
+     *
+     * We leverage SFINAE to discard this overload if the second argument is
+     * convertible to EventImpl * or is a function pointer.
+     *
+     * \tparam FUNC \deduced Template type for the function to invoke.
+     * \tparam Ts \deduced Argument types.
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] f The function to invoke.
+     * \param [in] args Arguments to pass to MakeEvent.
+     * \returns The id of the timer.
+     */
+    template <typename FUNC,
+              std::enable_if_t<!std::is_convertible_v<FUNC, EventImpl*>, int> = 0,
+              std::enable_if_t<!std::is_function_v<std::remove_pointer_t<FUNC>>, int> = 0,
+              typename... Ts>
+    static Id Schedule(const Time& delay, FUNC f, Ts&&... args);
+
+    /**
+     * Arm a timer to expire after \p delay.
+     *
+     * \tparam Us \deduced Formal function argument types.
+     * \tparam Ts \deduced Actual function argument types.
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] f The function to invoke.
+     * \param [in] args Arguments to pass to the invoked function.
+     * \returns The id of the timer.
+     */
+    template <typename... Us, typename... Ts>
+    static Id Schedule(const Time& delay, void (*f)(Us...), Ts&&... args);
+
+    /**
+     * Arm a timer to expire after \p delay.
+     *
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] event The event to run, whose ownership is taken.
+     * \returns The id of the timer.
+     */
+    static Id Schedule(const Time& delay, EventImpl* event);
+
+    /**
+     * \returns \c true if the timers are armed in the wheel, as set by the
+     * global value TimerWheelEnabled.
+     */
+    static bool IsEnabled();
+
+    /**
+     * \returns The activity counters of the wheels of all the contexts.
+     */
+    static Statistics GetStatistics();
+
+  private:
+    /** A timer, linked in a slot of the wheel until it is handed over. */
+    class Entry : public EventImpl
+    {
+      public:
+        /**
+         * Constructor.
+         *
+         * \param [in] wheel The wheel the timer is armed in.
+         * \param [in] event The event to run, whose ownership is taken.
+         * \param [in] ts The expiration time, in time steps.
+         * \param [in] seq The arming sequence number.
+         */
+        Entry(TimerWheel* wheel, EventImpl* event, uint64_t ts, uint64_t seq);
+        /** Destructor. */
+        ~Entry() override;
+        // Inherited
+        const EventImpl* GetTarget() const override;
+
+        TimerWheel* wheel; //!< The wheel the timer is armed in
+        EventImpl* event;  //!< The event to run
+        uint64_t ts;       //!< Expiration time, in time steps
+        uint64_t seq;      //!< Arming sequence number
+        uint32_t uid;      //!< Uid of the event in the simulator, once handed over
+        bool expired;      //!< Whether the event has run
+        Entry* next;       //!< Next timer of the slot
+        Entry** pprev;     //!< Link to this timer in the slot, null when not in the wheel
+        uint32_t slot;     //!< Index of the slot in m_slots
+
+      protected:
+        void Notify() override;
+    };
+
+    /** Number of time steps of a tick, as a power of two. */
+    static constexpr uint32_t TICK_SHIFT = 20;
+    /** Number of slots of the first level, as a power of two. */
+    static constexpr uint32_t FIRST_BITS = 8;
+    /** Number of slots of each of the other levels, as a power of two. */
+    static constexpr uint32_t LEVEL_BITS = 6;
+    /** Number of levels. */
+    static constexpr uint32_t LEVELS = 4;
+    /** Number of slots of the first level. */
+    static constexpr uint32_t FIRST_SLOTS = 1 << FIRST_BITS;
+    /** Number of slots of each of the other levels. */
+    static constexpr uint32_t LEVEL_SLOTS = 1 << LEVEL_BITS;
+    /** Index of the overflow list in m_slots. */
+    static constexpr uint32_t OVERFLOW_SLOT = FIRST_SLOTS + (LEVELS - 1) * LEVEL_SLOTS;
+
+    friend class Simulator;
+
+    /**
+     * Constructor.  Wheels are never deleted, so that the threads may
+     * cache them.
+     *
+     * \param [in] context The context of the wheel.
+     */
+    TimerWheel(uint32_t context);
+
+    /**
+     * \returns The wheel of the current context.
+     */
+    static TimerWheel* Get();
+    /** Empty the wheels of all threads, called by Simulator::Destroy. */
+    static void Destroy();
+
+    /**
+     * Arm a timer.
+     *
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] event The event to run, whose ownership is taken.
+     * \returns The id of the timer.
+     */
+    Id DoSchedule(const Time& delay, EventImpl* event);
+    /**
+     * Link a timer in its slot, or hand it over if it expires within the
+     * current tick.
+     *
+     * \param [in] entry The timer.
+     */
+    void Insert(Entry* entry);
+    /**
+     * Unlink a timer from its slot.
+     *
+     * \param [in] entry The timer.
+     */
+    void Unlink(Entry* entry);
+    /**
+     * Schedule the event of a timer in the simulator.
+     *
+     * \param [in] entry The timer.
+     */
+    void HandOff(Entry* entry);
+    /**
+     * Move the wheel forward to a tick, running all the slots before it.
+     *
+     * \param [in] tick The new current tick.
+     */
+    void Advance(uint64_t tick);
+    /**
+     * Re-insert the timers of a slot of an upper level, or of the overflow
+     * list, in the lower levels.
+     *
+     * \param [in] slot The index of the slot in m_slots.
+     */
+    void Cascade(uint32_t slot);
+    /**
+     * Hand over the timers of a slot of the first level.
+     *
+     * \param [in] slot The index of the slot.
+     */
+    void Expire(uint32_t slot);
+    /**
+     * Get the first occupied slot of the first level from a tick, up to
+     * the end of the current turn of the first level.
+     *
+     * \param [in] tick The tick to search from.
+     * \returns The tick of the occupied slot, or the first tick of the next turn.
+     */
+    uint64_t FindNext(uint64_t tick) const;
+    /** Schedule the tick event for the next tick needing work. */
+    void ScheduleTick();
+    /** Run the tick event. */
+    void Tick();
+    /** Empty the wheel, cancelling all its timers. */
+    void Reset();
+
+    /** Slot list heads: the first level, the other levels, then the overflow list. */
+    std::array<Entry*, OVERFLOW_SLOT + 1> m_slots;
+    /** Occupancy bitmap of the slots of the first level. */
+    std::array<uint64_t, FIRST_SLOTS / 64> m_occupied;
+    std::array<uint32_t, LEVELS + 1> m_count; //!< Number of timers per level and overflow
+    uint32_t m_context;                       //!< Context of the events of the wheel
+    uint64_t m_size;                          //!< Number of timers in the wheel
+    uint64_t m_current;                       //!< Current tick
+    uint64_t m_seq;                           //!< Next arming sequence number
+    EventId m_tick;                           //!< The tick event
+    uint64_t m_tickTs;                        //!< Time stamp of the tick event
+    std::vector<Entry*> m_expiring;           //!< Timers of the slot being expired
+    Statistics m_stats;                       //!< Activity counters
+};
+
+} // namespace ns3
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3
+{
+
+template <typename FUNC,
+          std::enable_if_t<!std::is_convertible_v<FUNC, EventImpl*>, int>,
+          std::enable_if_t<!std::is_function_v<std::remove_pointer_t<FUNC>>, int>,
+          typename... Ts>
+TimerWheel::Id
+TimerWheel::Schedule(const Time& delay, FUNC f, Ts&&... args)
+{
+    return Schedule(delay, MakeEvent(f, std::forward<Ts>(args)...));
+}
+
+template <typename... Us, typename... Ts>
+TimerWheel::Id
+TimerWheel::Schedule(const Time& delay, void (*f)(Us...), Ts&&... args)
+{
+    return Schedule(delay, MakeEvent(f, std::forward<Ts>(args)...));
+}
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
@@ -93,7 +93,7 @@ Timer::GetDelayLeft() const
     switch (GetState())
     {
     case Timer::RUNNING:
-        return Simulator::GetDelayLeft(m_event);
+        return m_event.GetDelayLeft();
     case Timer::EXPIRED:
         return TimeStep(0);
     case Timer::SUSPENDED:
@@ -182,7 +182,7 @@ Timer::Suspend()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(IsRunning());
-    m_delayLeft = Simulator::GetDelayLeft(m_event);
+    m_delayLeft = m_event.GetDelayLeft();
     if (m_flags & CANCEL_ON_DESTROY)
     {
         m_event.Cancel();
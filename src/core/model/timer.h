@@ -19,10 +19,10 @@
 #ifndef TIMER_H
 #define TIMER_H
 
-#include "event-id.h"
 #include "fatal-error.h"
 #include "int-to-type.h"
 #include "nstime.h"
+#include "timer-wheel.h"
 
 /**
  * \file
@@ -68,6 +68,12 @@ class TimerImpl;
  * management policies. These policies are specified at construction time
  * and cannot be changed after.
  *
+ * With the global value TimerWheelEnabled set, the timer is armed in the
+ * TimerWheel, so that cancelling or rescheduling it leaves no event
+ * behind in the simulator.  It then expires after the events scheduled
+ * for the same time step before the wheel handed it to the simulator,
+ * see TimerWheel.
+ *
  * \see Watchdog for a simpler interface for a watchdog timer.
  */
 class Timer
@@ -248,8 +254,8 @@ class Timer
     int m_flags;
     /** The delay configured for this Timer. */
     Time m_delay;
-    /** The future event scheduled to expire the timer. */
-    EventId m_event;
+    /** The timer armed with TimerWheel::Schedule to expire the timer. */
+    TimerWheel::Id m_event;
     /**
      * The timer implementation, which contains the bound callback
      * function and arguments.
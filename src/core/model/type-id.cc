@@ -28,6 +28,10 @@
 #include <sstream>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 /**
  * \file
  * \ingroup object
@@ -172,6 +176,11 @@ class IidManager : public Singleton<IidManager>
      * \returns The total number.
      */
     uint16_t GetRegisteredN() const;
+    /**
+     * Get the number of changes to the attributes of all the type ids.
+     * \returns The number of changes.
+     */
+    uint64_t GetAttributeGeneration() const;
     /**
      * Get a type id by index.
      *
@@ -344,6 +353,13 @@ class IidManager : public Singleton<IidManager>
     /** The by-hash index. */
     hashmap_t m_hashmap;
 
+    /** Count of the attributes added and initial values set. */
+#ifdef NS3_MTP
+    std::atomic<uint64_t> m_attributeGeneration{1};
+#else
+    uint64_t m_attributeGeneration{1};
+#endif
+
     /** IidManager constants. */
     enum
     {
@@ -614,6 +630,12 @@ IidManager::GetRegisteredN() const
     return static_cast<uint16_t>(m_information.size());
 }
 
+uint64_t
+IidManager::GetAttributeGeneration() const
+{
+    return m_attributeGeneration;
+}
+
 uint16_t
 IidManager::GetRegistered(uint16_t i) const
 {
@@ -686,6 +708,7 @@ IidManager::AddAttribute(uint16_t uid,
     info.supportLevel = supportLevel;
     info.supportMsg = supportMsg;
     information->attributes.push_back(info);
+    ++m_attributeGeneration;
     NS_LOG_LOGIC(IIDL << information->attributes.size() - 1);
 }
 
@@ -698,6 +721,7 @@ IidManager::SetAttributeInitialValue(uint16_t uid,
     IidInformation* information = LookupInformation(uid);
     NS_ASSERT(i < information->attributes.size());
     information->attributes[i].initialValue = initialValue;
+    ++m_attributeGeneration;
 }
 
 std::size_t
@@ -875,6 +899,12 @@ TypeId::LookupByHashFailSafe(hash_t hash, TypeId* tid)
     return true;
 }
 
+uint64_t
+TypeId::GetAttributeGeneration()
+{
+    return IidManager::Get()->GetAttributeGeneration();
+}
+
 uint16_t
 TypeId::GetRegisteredN()
 {
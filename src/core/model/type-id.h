@@ -171,6 +171,16 @@ class TypeId
      * \returns The TypeId instance whose index is \c i.
      */
     static TypeId GetRegistered(uint16_t i);
+    /**
+     * Get the number of changes to the Attributes of all the TypeIds.
+     *
+     * The number changes whenever an Attribute is added or its initial
+     * value is set, by Config::SetDefault or Config::Reset for instance,
+     * so that information derived from the Attributes can be cached.
+     *
+     * \returns The number of changes so far.
+     */
+    static uint64_t GetAttributeGeneration();
 
     /**
      * Constructor.
@@ -54,9 +54,15 @@ Watchdog::Ping(Time delay)
     m_end = std::max(m_end, end);
     if (m_event.IsRunning())
     {
-        return;
+        if (!TimerWheel::IsEnabled() ||
+            m_event.GetTs() == static_cast<uint64_t>(m_end.GetTimeStep()))
+        {
+            return;
+        }
+        // rearming is cheap in the timer wheel
+        m_event.Cancel();
     }
-    m_event = Simulator::Schedule(m_end - Now(), &Watchdog::Expire, this);
+    m_event = TimerWheel::Schedule(m_end - Now(), &Watchdog::Expire, this);
 }
 
 void
@@ -69,7 +75,7 @@ Watchdog::Expire()
     }
     else
     {
-        m_event = Simulator::Schedule(m_end - Now(), &Watchdog::Expire, this);
+        m_event = TimerWheel::Schedule(m_end - Now(), &Watchdog::Expire, this);
     }
 }
 
@@ -19,8 +19,8 @@
 #ifndef WATCHDOG_H
 #define WATCHDOG_H
 
-#include "event-id.h"
 #include "nstime.h"
+#include "timer-wheel.h"
 
 /**
  * \file
@@ -51,6 +51,11 @@ class TimerImpl;
  * If you don't ping the watchdog sufficiently often, it triggers its
  * listening function.
  *
+ * With the global value TimerWheelEnabled set, the watchdog is armed in
+ * the TimerWheel, and rearmed directly when it is lengthened.  It then
+ * expires after the events scheduled for the same time step before the
+ * wheel handed it to the simulator, see TimerWheel.
+ *
  * \see Timer for a more sophisticated general purpose timer.
  */
 class Watchdog
@@ -116,8 +121,8 @@ class Watchdog
      * function and arguments.
      */
     TimerImpl* m_impl;
-    /** The future event scheduled to expire the timer. */
-    EventId m_event;
+    /** The timer armed with TimerWheel::Schedule to expire the watchdog. */
+    TimerWheel::Id m_event;
     /** The absolute time when the timer will expire. */
     Time m_end;
 };
@@ -20,6 +20,7 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/enum.h"
+#include "ns3/environment-variable.h"
 #include "ns3/integer.h"
 #include "ns3/nstime.h"
 #include "ns3/object-factory.h"
@@ -1315,6 +1316,97 @@ RandomVariableStreamAttributeTestCase::DoRun()
     ok = p->SetAttributeFailSafe("TestRandom",
                                  StringValue("ns3::ConstantRandomVariable[Constant=1.0]"));
     NS_TEST_ASSERT_MSG_EQ(ok, true, "Could not SetAttributeFailSafe() a ConstantRandomVariable");
+
+    //
+    // Each object gets its own random variable from the default value
+    //
+    auto q = CreateObject<AttributeObjectTest>();
+    PointerValue pRandom;
+    PointerValue qRandom;
+    p = CreateObject<AttributeObjectTest>();
+    p->GetAttribute("TestRandom", pRandom);
+    q->GetAttribute("TestRandom", qRandom);
+    NS_TEST_ASSERT_MSG_NE(pRandom.Get<RandomVariableStream>(),
+                          qRandom.Get<RandomVariableStream>(),
+                          "Objects share the random variable of a default value");
+}
+
+/**
+ * \ingroup attribute-tests
+ *
+ * \brief Test case for the default values of Attributes taken from the
+ * NS_ATTRIBUTE_DEFAULT environment variable.
+ */
+class EnvAttributeDefaultTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param description The TestCase description.
+     */
+    EnvAttributeDefaultTestCase(std::string description);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Set the NS_ATTRIBUTE_DEFAULT environment variable, and forget its
+     * cached value.
+     * \param [in] found Whether the variable is set.
+     * \param [in] value The value of the variable.
+     */
+    static void SetEnvironment(bool found, const std::string& value);
+
+    /**
+     * Get the default value of the TestInt16 Attribute of a new object.
+     * \returns The value.
+     */
+    static int64_t GetDefault();
+};
+
+EnvAttributeDefaultTestCase::EnvAttributeDefaultTestCase(std::string description)
+    : TestCase(description)
+{
+}
+
+void
+EnvAttributeDefaultTestCase::SetEnvironment(bool found, const std::string& value)
+{
+    if (found)
+    {
+        EnvironmentVariable::Set("NS_ATTRIBUTE_DEFAULT", value);
+    }
+    else
+    {
+        EnvironmentVariable::Unset("NS_ATTRIBUTE_DEFAULT");
+    }
+    EnvironmentVariable::Clear();
+}
+
+int64_t
+EnvAttributeDefaultTestCase::GetDefault()
+{
+    IntegerValue value;
+    CreateObject<AttributeObjectTest>()->GetAttribute("TestInt16", value);
+    return value.Get();
+}
+
+void
+EnvAttributeDefaultTestCase::DoRun()
+{
+    auto [found, original] = EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT");
+
+    SetEnvironment(true, "ns3::AttributeObjectTest::TestInt16=3");
+    NS_TEST_EXPECT_MSG_EQ(GetDefault(), 3, "Default value not taken from the environment");
+
+    // Objects of the same type created after a change of the environment
+    SetEnvironment(true, "ns3::AttributeObjectTest::TestInt16=4");
+    NS_TEST_EXPECT_MSG_EQ(GetDefault(), 4, "Default value not updated from the environment");
+
+    SetEnvironment(false, "");
+    NS_TEST_EXPECT_MSG_EQ(GetDefault(), -2, "Default value still taken from the environment");
+
+    SetEnvironment(found, original);
 }
 
 /**
@@ -2105,6 +2197,9 @@ AttributesTestSuite::AttributesTestSuite()
     AddTestCase(
         new RandomVariableStreamAttributeTestCase("Check Attributes of type RandomVariableStream"),
         TestCase::QUICK);
+    AddTestCase(new EnvAttributeDefaultTestCase(
+                    "Check default values of Attributes from NS_ATTRIBUTE_DEFAULT"),
+                TestCase::QUICK);
     AddTestCase(new ObjectVectorAttributeTestCase("Check Attributes of type ObjectVectorValue"),
                 TestCase::QUICK);
     AddTestCase(new ObjectMapAttributeTestCase("Check Attributes of type ObjectMapValue"),
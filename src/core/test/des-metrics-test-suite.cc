@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/des-metrics-converter.h"
+#include "ns3/des-metrics.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-path.h"
+#include "ns3/test.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup des-metrics-tests
+ * DesMetrics test suite
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup des-metrics-tests DesMetrics test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup des-metrics-tests
+ * Write the same events in a binary trace and in a JSON one, and check
+ * that DesMetricsConverter turns the binary trace into the JSON one.
+ */
+class DesMetricsConvertTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    DesMetricsConvertTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Trace the events of a simulation.
+     *
+     * \param [in] format The trace format, Json or Binary.
+     * \returns The name of the trace file.
+     */
+    std::string Replay(const std::string& format);
+
+    /**
+     * An event, which traces a few more.
+     *
+     * \param [in] n The number of the event.
+     */
+    static void Event(uint32_t n);
+
+    /**
+     * Split a trace in lines, without the capture date, which differs
+     * between the traces.
+     *
+     * \param [in,out] is The trace.
+     * \returns The lines.
+     */
+    static std::vector<std::string> GetLines(std::istream& is);
+};
+
+DesMetricsConvertTestCase::DesMetricsConvertTestCase()
+    : TestCase("Convert a binary trace to the JSON format")
+{
+}
+
+void
+DesMetricsConvertTestCase::Event(uint32_t n)
+{
+    DesMetrics* metrics = DesMetrics::Get();
+    metrics->Trace(Simulator::Now(), MilliSeconds(n));
+    metrics->TraceWithContext(n % 3, Simulator::Now(), MicroSeconds(n));
+    metrics->TraceWithContext(Simulator::NO_CONTEXT, Simulator::Now(), NanoSeconds(n));
+}
+
+std::string
+DesMetricsConvertTestCase::Replay(const std::string& format)
+{
+    std::string dir = CreateTempDirFilename("");
+    Config::SetGlobal("DesMetricsFormat", StringValue(format));
+    DesMetrics::Get()->Initialize({"des-metrics-test", "--events=100"}, dir);
+    for (uint32_t n = 0; n < 100; n++)
+    {
+        if (n % 4 == 0)
+        {
+            Simulator::Schedule(MilliSeconds(n), &DesMetricsConvertTestCase::Event, n);
+        }
+        else
+        {
+            Simulator::ScheduleWithContext(n % 4,
+                                           MilliSeconds(n),
+                                           &DesMetricsConvertTestCase::Event,
+                                           n);
+        }
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    DesMetrics::Get()->Close();
+    Config::SetGlobal("DesMetricsFormat", StringValue("Json"));
+    return SystemPath::Append(dir,
+                              format == "Binary" ? "des-metrics-test.desm"
+                                                 : "des-metrics-test.json");
+}
+
+std::vector<std::string>
+DesMetricsConvertTestCase::GetLines(std::istream& is)
+{
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(is, line))
+    {
+        if (line.find("\"capture_date\"") == std::string::npos)
+        {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+void
+DesMetricsConvertTestCase::DoRun()
+{
+    std::string jsonFile = Replay("Json");
+    std::string binaryFile = Replay("Binary");
+
+    std::ifstream json(jsonFile);
+    NS_TEST_ASSERT_MSG_EQ(json.is_open(), true, "No JSON trace");
+    std::vector<std::string> expected = GetLines(json);
+    // Three traced events for each of the 100 events, and the header
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(expected.size(), 300, "Events missing from the JSON trace");
+
+    std::ifstream binary(binaryFile, std::ios::binary);
+    NS_TEST_ASSERT_MSG_EQ(binary.is_open(), true, "No binary trace");
+    DesMetricsConverter converter;
+    NS_TEST_ASSERT_MSG_EQ(converter.ReadHeader(binary), true, "Wrong binary header");
+    std::streampos blocks = binary.tellg();
+    std::stringstream converted;
+    NS_TEST_ASSERT_MSG_EQ(converter.Convert(binary, converted, DesMetricsConverter::JSON),
+                          true,
+                          "Truncated binary trace");
+    std::vector<std::string> lines = GetLines(converted);
+    NS_TEST_ASSERT_MSG_EQ(lines.size(), expected.size(), "Different number of lines");
+    for (std::size_t i = 0; i < lines.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(lines[i], expected[i], "Different line " << i);
+    }
+
+    // The Chrome trace has a slice per event
+    binary.clear();
+    binary.seekg(blocks);
+    std::ostringstream perfetto;
+    NS_TEST_ASSERT_MSG_EQ(converter.Convert(binary, perfetto, DesMetricsConverter::PERFETTO),
+                          true,
+                          "Truncated binary trace");
+    std::string trace = perfetto.str();
+    std::size_t slices = 0;
+    for (auto pos = trace.find("\"ph\":\"X\""); pos != std::string::npos;
+         pos = trace.find("\"ph\":\"X\"", pos + 1))
+    {
+        slices++;
+    }
+    // The events are the lines between the header and the closing lines
+    NS_TEST_EXPECT_MSG_EQ(slices, expected.size() - 7, "Wrong number of slices");
+
+    std::remove(jsonFile.c_str());
+    std::remove(binaryFile.c_str());
+}
+
+/**
+ * \ingroup des-metrics-tests
+ * DesMetrics test suite
+ */
+class DesMetricsTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    DesMetricsTestSuite();
+};
+
+DesMetricsTestSuite::DesMetricsTestSuite()
+    : TestSuite("des-metrics")
+{
+    AddTestCase(new DesMetricsConvertTestCase);
+}
+
+/**
+ * \ingroup des-metrics-tests
+ * DesMetricsTestSuite instance variable.
+ */
+static DesMetricsTestSuite g_desMetricsTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -17,13 +17,24 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "ns3/calendar-scheduler.h"
+#include "ns3/enum.h"
+#include "ns3/event-profiler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator-impl.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -211,6 +222,234 @@ SimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_destroy, true, "Event should have run");
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the order of the events removed from a scheduler, against
+ * a reference std::set, with a heavy-tailed distribution of time stamps.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check the order of events with " + schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    auto rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+
+    std::set<Scheduler::Event> expected;
+    std::vector<Scheduler::Event> pending; // to draw events to remove
+    uint64_t now = 0;
+    uint32_t uid = 0;
+
+    auto insert = [&]() {
+        // mostly events a few ns away, some within 100 us, a few up to 200 ms
+        double u = rng->GetValue();
+        uint64_t delay = rng->GetInteger(0, u < 0.9 ? 10 : (u < 0.98 ? 100000 : 200000000));
+        Scheduler::Event ev = {nullptr, {now + delay, uid++, 0}};
+        scheduler->Insert(ev);
+        expected.insert(ev);
+        pending.push_back(ev);
+    };
+    auto removeNext = [&]() {
+        Scheduler::Event ev = scheduler->RemoveNext();
+        NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid, expected.begin()->key.m_uid, "Wrong event order");
+        NS_TEST_ASSERT_MSG_EQ(ev.key.m_ts, expected.begin()->key.m_ts, "Wrong event time");
+        expected.erase(expected.begin());
+        now = ev.key.m_ts;
+    };
+
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        insert();
+    }
+    for (uint32_t i = 0; i < 100000; ++i)
+    {
+        double u = rng->GetValue();
+        if (u < 0.5)
+        {
+            insert();
+        }
+        else if (u < 0.95)
+        {
+            removeNext();
+        }
+        else if (!pending.empty())
+        {
+            std::size_t index = rng->GetInteger(0, pending.size() - 1);
+            Scheduler::Event ev = pending[index];
+            pending[index] = pending.back();
+            pending.pop_back();
+            if (expected.erase(ev) == 1)
+            {
+                scheduler->Remove(ev);
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), expected.empty(), "Wrong scheduler size");
+        if (!expected.empty())
+        {
+            NS_TEST_ASSERT_MSG_EQ(scheduler->PeekNext().key.m_uid,
+                                  expected.begin()->key.m_uid,
+                                  "Wrong next event");
+        }
+    }
+    while (!expected.empty())
+    {
+        removeNext();
+    }
+    NS_TEST_EXPECT_MSG_EQ(scheduler->IsEmpty(), true, "Scheduler should be empty");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the events are recycled by the event pools.
+ */
+class SimulatorEventPoolTestCase : public TestCase
+{
+  public:
+    SimulatorEventPoolTestCase();
+    void DoRun() override;
+
+  private:
+    /** Reschedule itself until the count is exhausted. */
+    void Hop();
+
+    uint32_t m_hops; //!< Number of events left to schedule.
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase()
+    : TestCase("Check that events are allocated from the event pools"),
+      m_hops(0)
+{
+}
+
+void
+SimulatorEventPoolTestCase::Hop()
+{
+    if (--m_hops > 0)
+    {
+        Simulator::Schedule(NanoSeconds(1), &SimulatorEventPoolTestCase::Hop, this);
+        uint32_t hops = m_hops;
+        Simulator::Schedule(NanoSeconds(2), [hops]() { NS_ASSERT(hops > 0); });
+    }
+}
+
+void
+SimulatorEventPoolTestCase::DoRun()
+{
+    EventImpl::PoolStatistics before = EventImpl::GetPoolStatistics();
+    m_hops = 10000;
+    Simulator::Schedule(NanoSeconds(1), &SimulatorEventPoolTestCase::Hop, this);
+    Simulator::Run();
+    Simulator::Destroy();
+    EventImpl::PoolStatistics after = EventImpl::GetPoolStatistics();
+
+    uint64_t allocations = after.allocations - before.allocations;
+    uint64_t heapAllocations = after.heapAllocations - before.heapAllocations;
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(allocations, 2 * 10000 - 1, "Wrong number of allocations");
+    NS_TEST_EXPECT_MSG_LT(heapAllocations, 10, "Events were not recycled");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the event profile of DefaultSimulatorImpl.
+ */
+class SimulatorProfileTestCase : public TestCase
+{
+  public:
+    SimulatorProfileTestCase();
+    void DoRun() override;
+
+  private:
+    /** Event to profile. */
+    void Foo();
+};
+
+SimulatorProfileTestCase::SimulatorProfileTestCase()
+    : TestCase("Check the per event type profile")
+{
+}
+
+void
+SimulatorProfileTestCase::Foo()
+{
+}
+
+void
+SimulatorProfileTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("profile.csv");
+    ObjectFactory factory("ns3::DefaultSimulatorImpl");
+    factory.Set("ProfileFile", StringValue(filename));
+    factory.Set("ProfileFormat", EnumValue(EventProfiler::CSV));
+    Simulator::SetImplementation(factory.Create<SimulatorImpl>());
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        Simulator::Schedule(MicroSeconds(i), &SimulatorProfileTestCase::Foo, this);
+        Simulator::ScheduleWithContext(7, MicroSeconds(i), &SimulatorProfileTestCase::Foo, this);
+    }
+    Simulator::ScheduleWithContext(7, Seconds(1), [] {});
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::ifstream is(filename);
+    NS_TEST_ASSERT_MSG_EQ(is.is_open(), true, "The profile was not written");
+    std::string line;
+    std::getline(is, line);
+    NS_TEST_EXPECT_MSG_EQ(line, "event,context,count,nanoseconds", "Wrong header");
+    uint32_t foo = 0;
+    uint32_t fooContext = 0;
+    uint32_t lambda = 0;
+    while (std::getline(is, line))
+    {
+        std::size_t end = line.rfind('"');
+        std::string event = line.substr(0, end + 1);
+        std::string rest = line.substr(end + 2);
+        if (event.find("SimulatorProfileTestCase::*") != std::string::npos)
+        {
+            if (rest.substr(0, rest.find(',')).empty())
+            {
+                ++foo;
+                NS_TEST_EXPECT_MSG_EQ(rest.substr(0, 4), ",10,", "Wrong count without context");
+            }
+            else
+            {
+                ++fooContext;
+                NS_TEST_EXPECT_MSG_EQ(rest.substr(0, 5), "7,10,", "Wrong count with context");
+            }
+        }
+        else if (event.find("lambda") != std::string::npos)
+        {
+            ++lambda;
+            NS_TEST_EXPECT_MSG_EQ(rest.substr(0, 4), "7,1,", "Wrong lambda count");
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(foo, 1, "Method events without context not reported once");
+    NS_TEST_EXPECT_MSG_EQ(fooContext, 1, "Method events with context not reported once");
+    NS_TEST_EXPECT_MSG_EQ(lambda, 1, "Lambda event not reported once");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -730,6 +969,18 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+
+        for (const auto& tid : {HeapScheduler::GetTypeId(),
+                                CalendarScheduler::GetTypeId(),
+                                LadderScheduler::GetTypeId()})
+        {
+            factory.SetTypeId(tid);
+            AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        }
+        AddTestCase(new SimulatorEventPoolTestCase(), TestCase::QUICK);
+        AddTestCase(new SimulatorProfileTestCase(), TestCase::QUICK);
     }
 };
 
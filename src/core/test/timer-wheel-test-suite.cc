@@ -0,0 +1,347 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/global-value.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/timer-wheel.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup timer
+ * \ingroup timer-tests
+ * TimerWheel test suite.
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup timer-tests
+ * Check that timers run at their exact expiration time, in the order
+ * they were armed, and never once cancelled.
+ */
+class TimerWheelExpireTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    TimerWheelExpireTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Arm a timer, maybe from a timer.
+     *
+     * \param [in] delay The delay of the timer.
+     */
+    void Arm(Time delay);
+    /**
+     * Function run by the timers.
+     *
+     * \param [in] i The index of the timer.
+     */
+    void Expire(uint32_t i);
+
+    /** A timer. */
+    struct Timer
+    {
+        TimerWheel::Id id; //!< The timer
+        Time expiration;   //!< Expected expiration time
+        bool expired;      //!< Whether the timer ran
+        bool cancelled;    //!< Whether the timer was cancelled
+    };
+
+    std::vector<Timer> m_timers;            //!< The timers, in arming order
+    uint32_t m_last;                        //!< Index of the last timer run
+    Time m_lastTime;                        //!< Time of the last timer run
+    Ptr<UniformRandomVariable> m_random;    //!< Source of delays and choices
+    Ptr<ExponentialRandomVariable> m_delay; //!< Delay scale, in nanoseconds
+};
+
+TimerWheelExpireTestCase::TimerWheelExpireTestCase()
+    : TestCase("Check that timers expire at the right time and in order")
+{
+}
+
+void
+TimerWheelExpireTestCase::Arm(Time delay)
+{
+    uint32_t i = m_timers.size();
+    m_timers.push_back({TimerWheel::Schedule(delay, &TimerWheelExpireTestCase::Expire, this, i),
+                        Simulator::Now() + delay,
+                        false,
+                        false});
+}
+
+void
+TimerWheelExpireTestCase::Expire(uint32_t i)
+{
+    Timer& timer = m_timers[i];
+    NS_TEST_EXPECT_MSG_EQ(timer.id.IsExpired(), true, "Timer " << i << " should be expired");
+    NS_TEST_EXPECT_MSG_EQ(timer.expired, false, "Timer " << i << " ran twice");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), timer.expiration, "Timer " << i << " ran late");
+    if (Simulator::Now() == m_lastTime)
+    {
+        NS_TEST_EXPECT_MSG_GT(i, m_last, "Timer " << i << " ran out of order");
+    }
+    timer.expired = true;
+    m_last = i;
+    m_lastTime = Simulator::Now();
+
+    // rearm a few timers, cancel a few others and arm new ones
+    if (m_timers.size() < 50000)
+    {
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t j = m_random->GetInteger(0, m_timers.size() - 1);
+            if (m_timers[j].id.IsRunning())
+            {
+                m_timers[j].id.Cancel();
+                m_timers[j].cancelled = true;
+                if (m_random->GetValue() < 0.5)
+                {
+                    Arm(m_timers[j].expiration - Simulator::Now() + NanoSeconds(1));
+                }
+            }
+        }
+        Arm(NanoSeconds(static_cast<uint64_t>(m_delay->GetValue())));
+        Arm(NanoSeconds(static_cast<uint64_t>(m_delay->GetValue())));
+    }
+}
+
+void
+TimerWheelExpireTestCase::DoRun()
+{
+    m_random = CreateObject<UniformRandomVariable>();
+    m_random->SetStream(1);
+    m_delay = CreateObject<ExponentialRandomVariable>();
+    m_delay->SetAttribute("Mean", DoubleValue(1e8));
+    m_delay->SetStream(2);
+    m_last = 0;
+    m_lastTime = Seconds(-1);
+    GlobalValue::Bind("TimerWheelEnabled", BooleanValue(true));
+
+    // delays of every level of the wheel and of the overflow list
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        Arm(NanoSeconds(i * 1000));
+        Arm(MilliSeconds(i * 10));
+        Arm(Seconds(i * 3));
+        Arm(Seconds(i * 900));
+        Arm(Hours(i));
+    }
+    // timers sharing their expiration time
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        Arm(MilliSeconds(500));
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    GlobalValue::Bind("TimerWheelEnabled", BooleanValue(false));
+
+    for (std::size_t i = 0; i < m_timers.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_timers[i].id.IsExpired(), true, "Timer " << i << " not expired");
+        NS_TEST_EXPECT_MSG_NE(m_timers[i].expired,
+                              m_timers[i].cancelled,
+                              "Timer " << i << " should either run or be cancelled");
+    }
+}
+
+/**
+ * \ingroup timer-tests
+ * Check that cancelled timers leave no event in the simulator.
+ */
+class TimerWheelCancelTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    TimerWheelCancelTestCase();
+
+  private:
+    void DoRun() override;
+    /** Rearm the timer, as a retransmission timer on every acknowledgment. */
+    void Rearm();
+
+    TimerWheel::Id m_timer; //!< The timer
+    uint32_t m_rearms;      //!< Number of rearms left
+};
+
+TimerWheelCancelTestCase::TimerWheelCancelTestCase()
+    : TestCase("Check that cancelled timers are removed from the wheel")
+{
+}
+
+void
+TimerWheelCancelTestCase::Rearm()
+{
+    m_timer.Cancel();
+    m_timer = TimerWheel::Schedule(Seconds(1), [] {});
+    if (--m_rearms > 0)
+    {
+        Simulator::Schedule(MicroSeconds(10), &TimerWheelCancelTestCase::Rearm, this);
+    }
+}
+
+void
+TimerWheelCancelTestCase::DoRun()
+{
+    m_rearms = 10000;
+    GlobalValue::Bind("TimerWheelEnabled", BooleanValue(true));
+    TimerWheel::Statistics before = TimerWheel::GetStatistics();
+    Simulator::Schedule(MicroSeconds(10), &TimerWheelCancelTestCase::Rearm, this);
+    Simulator::Run();
+    TimerWheel::Statistics after = TimerWheel::GetStatistics();
+    uint64_t events = Simulator::GetEventCount();
+    Simulator::Destroy();
+    GlobalValue::Bind("TimerWheelEnabled", BooleanValue(false));
+
+    NS_TEST_ASSERT_MSG_EQ(after.scheduled - before.scheduled, 10000, "Wrong number of timers");
+    NS_TEST_ASSERT_MSG_EQ(after.cancelled - before.cancelled, 9999, "Wrong number of cancels");
+    NS_TEST_ASSERT_MSG_EQ(after.handedOff - before.handedOff, 1, "Wrong number of expirations");
+    // the rearms, the expiration of the last timer and a few ticks
+    NS_TEST_ASSERT_MSG_LT(events, 10000 + 1 + 10, "Too many events in the simulator");
+}
+
+/**
+ * \ingroup timer-tests
+ * Check that the wheel is opt-in, that the timers convert to and from
+ * EventId, and that each context has its own wheel.
+ */
+class TimerWheelCompatibilityTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    TimerWheelCompatibilityTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Arm a timer checking that it runs in the context it was armed in.
+     *
+     * \param [in] delay The delay of the timer.
+     */
+    void ArmInContext(Time delay);
+
+    uint32_t m_expired; //!< Number of timers run in their context
+};
+
+TimerWheelCompatibilityTestCase::TimerWheelCompatibilityTestCase()
+    : TestCase("Check the opt-in wheel, the conversions to EventId and the contexts")
+{
+}
+
+void
+TimerWheelCompatibilityTestCase::ArmInContext(Time delay)
+{
+    uint32_t context = Simulator::GetContext();
+    TimerWheel::Schedule(delay, [this, context]() {
+        NS_TEST_EXPECT_MSG_EQ(Simulator::GetContext(), context, "Timer run in another context");
+        ++m_expired;
+    });
+}
+
+void
+TimerWheelCompatibilityTestCase::DoRun()
+{
+    bool run = false;
+    auto expire = [&run]() { run = true; };
+
+    // disabled by default: the timers are scheduled in the simulator
+    TimerWheel::Statistics before = TimerWheel::GetStatistics();
+    TimerWheel::Id id = TimerWheel::Schedule(Seconds(1), expire);
+    NS_TEST_EXPECT_MSG_EQ(TimerWheel::GetStatistics().scheduled,
+                          before.scheduled,
+                          "Timer armed in a wheel by default");
+    EventId event = id;
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetDelayLeft(event), Seconds(1), "Wrong event of the timer");
+    event.Cancel();
+    NS_TEST_EXPECT_MSG_EQ(id.IsExpired(), true, "Timer not cancelled through its EventId");
+    id = Simulator::Schedule(Seconds(2), expire);
+    NS_TEST_EXPECT_MSG_EQ(id.IsRunning(), true, "Event lost by the conversion");
+    NS_TEST_EXPECT_MSG_EQ(id.GetDelayLeft(), Seconds(2), "Wrong delay of the converted event");
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(run, true, "Converted event not run");
+    Simulator::Destroy();
+
+    // enabled: the EventId of a timer follows it in the wheel
+    GlobalValue::Bind("TimerWheelEnabled", BooleanValue(true));
+    run = false;
+    id = TimerWheel::Schedule(Seconds(1), expire);
+    event = id;
+    NS_TEST_EXPECT_MSG_EQ(event.IsRunning(), true, "Wrong EventId of the armed timer");
+    NS_TEST_EXPECT_MSG_EQ(event.GetTs(), id.GetTs(), "Wrong time stamp of the EventId");
+    event.Cancel();
+    NS_TEST_EXPECT_MSG_EQ(id.IsExpired(), true, "Timer not cancelled through its EventId");
+    // the EventId of a timer handed over to the simulator, just before it runs
+    TimerWheel::Id handedOver = TimerWheel::Schedule(Seconds(3), []() {});
+    bool running = false;
+    Simulator::Schedule(Seconds(3) - NanoSeconds(1), [&event, &handedOver, &running]() {
+        event = handedOver;
+        running = event.IsRunning();
+    });
+    m_expired = 0;
+    for (uint32_t context = 1; context <= 3; ++context)
+    {
+        Simulator::ScheduleWithContext(context,
+                                       MilliSeconds(context),
+                                       &TimerWheelCompatibilityTestCase::ArmInContext,
+                                       this,
+                                       Seconds(context));
+    }
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(run, false, "Cancelled timer run");
+    NS_TEST_EXPECT_MSG_EQ(running, true, "EventId of a handed over timer not running");
+    NS_TEST_EXPECT_MSG_EQ(event.IsExpired(), true, "EventId of an expired timer still running");
+    NS_TEST_EXPECT_MSG_EQ(m_expired, 3, "Timers of the contexts not run");
+    Simulator::Destroy();
+    GlobalValue::Bind("TimerWheelEnabled", BooleanValue(false));
+}
+
+/**
+ * \ingroup timer-tests
+ * TimerWheel test suite.
+ */
+class TimerWheelTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    TimerWheelTestSuite()
+        : TestSuite("timer-wheel")
+    {
+        AddTestCase(new TimerWheelExpireTestCase());
+        AddTestCase(new TimerWheelCancelTestCase());
+        AddTestCase(new TimerWheelCompatibilityTestCase());
+    }
+};
+
+/**
+ * \ingroup timer-tests
+ * TimerWheelTestSuite instance variable.
+ */
+static TimerWheelTestSuite g_timerWheelTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
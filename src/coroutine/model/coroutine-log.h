@@ -0,0 +1,42 @@
+
+
+#ifndef NS3_COROUTINE_LOG_H
+#define NS3_COROUTINE_LOG_H
+
+#include <ns3/log.h>
+
+/**
+ * @brief Log a message to a log component found by name, like NS_LOG, for the code of the coroutine based modules
+ * which is not in the translation unit of its component, e.g. templates in headers.
+ *
+ * The component is looked up once per call site, and the message is only evaluated when the level is enabled, so
+ * expensive arguments, e.g. demangled type names, cost nothing when the component is disabled. As with the NS_LOG
+ * macros, the calls are compiled out when NS3_LOG_ENABLE is not defined, as in optimized builds.
+ */
+#ifdef NS3_LOG_ENABLE
+
+#define COROUTINE_LOG(name, level, msg)                                                                                \
+    do {                                                                                                               \
+        static ns3::LogComponent &g_log = ns3::GetLogComponent(name);                                                  \
+        NS_LOG(level, msg);                                                                                            \
+    } while (false)
+
+#else // NS3_LOG_ENABLE
+
+#define COROUTINE_LOG(name, level, msg) NS_LOG_NOOP_INTERNAL(msg)
+
+#endif // NS3_LOG_ENABLE
+
+#define COROUTINE_LOG_ERROR(name, msg) COROUTINE_LOG(name, ns3::LOG_ERROR, msg)
+
+#define COROUTINE_LOG_WARN(name, msg) COROUTINE_LOG(name, ns3::LOG_WARN, msg)
+
+#define COROUTINE_LOG_DEBUG(name, msg) COROUTINE_LOG(name, ns3::LOG_DEBUG, msg)
+
+#define COROUTINE_LOG_INFO(name, msg) COROUTINE_LOG(name, ns3::LOG_INFO, msg)
+
+#define COROUTINE_LOG_FUNCTION(name, msg) COROUTINE_LOG(name, ns3::LOG_FUNCTION, msg)
+
+#define COROUTINE_LOG_LOGIC(name, msg) COROUTINE_LOG(name, ns3::LOG_LOGIC, msg)
+
+#endif // NS3_COROUTINE_LOG_H
@@ -25,8 +25,20 @@ ns3::CoroutineSocket::CoroutineSocket(CoroutineSocket &&s) :
         pendingSend(std::exchange(s.pendingSend, {})),
         pendingReceive(std::exchange(s.pendingReceive, {})),
         cache(std::exchange(s.cache, nullptr)),
-        cacheLimit(s.cacheLimit) {
+        cacheLimit(s.cacheLimit),
+        flowNetwork(std::exchange(s.flowNetwork, nullptr)),
+        flowLocal(s.flowLocal),
+        flowPeer(s.flowPeer),
+        flowTo(s.flowTo),
+        packetLevel(s.packetLevel),
+        flowState(std::exchange(s.flowState, nullptr)) {
     registerCallbacks();
+    if (flowState) {
+        flowState->socket = this;
+    }
+    if (flowNetwork) {
+        flowNetwork->attach(flowLocal, flowPeer, this);
+    }
 };
 
 ns3::CoroutineSocket &ns3::CoroutineSocket::operator=(ns3::CoroutineSocket &&s) {
@@ -44,7 +56,25 @@ ns3::CoroutineSocket &ns3::CoroutineSocket::operator=(ns3::CoroutineSocket &&s)
     pendingReceive = std::exchange(s.pendingReceive, {});
     cache = std::exchange(s.cache, nullptr);
     cacheLimit = s.cacheLimit;
+    if (flowNetwork) {
+        flowNetwork->detach(flowLocal, flowPeer, this);
+    }
+    flowNetwork = std::exchange(s.flowNetwork, nullptr);
+    flowLocal = s.flowLocal;
+    flowPeer = s.flowPeer;
+    flowTo = s.flowTo;
+    packetLevel = s.packetLevel;
+    if (flowState) {
+        flowState->socket = nullptr;
+    }
+    flowState = std::exchange(s.flowState, nullptr);
+    if (flowState) {
+        flowState->socket = this;
+    }
     registerCallbacks();
+    if (flowNetwork) {
+        flowNetwork->attach(flowLocal, flowPeer, this);
+    }
     return *this;
 }
 
@@ -99,6 +129,52 @@ void ns3::CoroutineSocket::onClose(NS3Error error) {
     }
 }
 
+void ns3::CoroutineSocket::startFlow() {
+    auto &[packet, _] = flowState->pending.front();
+    // the socket may be moved or destroyed before the flow ends
+    auto onEnd = [state = flowState](bool congested) {
+        return [state, congested](auto sent) {
+            if (state->socket) {
+                state->socket->onFlowEnd(sent, congested);
+            }
+        };
+    };
+    flowNetwork->start(socket->GetNode()->GetId(), flowTo, packet->GetSize(), onEnd(false), onEnd(true));
+}
+
+void ns3::CoroutineSocket::onFlowEnd(std::size_t sent, bool congested) {
+    auto [packet, operation] = std::move(flowState->pending.front());
+    flowState->pending.pop_front();
+    if (sent > 0) {
+        tx_size += sent;
+        auto latency = flowNetwork->latency(socket->GetNode()->GetId(), flowTo);
+        flowNetwork->transmit(flowPeer, flowLocal);
+        Simulator::ScheduleWithContext(flowTo, latency, [network = flowNetwork, local = flowPeer, peer = flowLocal,
+                fragment = packet->CreateFragment(0, sent)]() {
+            network->deliver(local, peer, fragment);
+        });
+    }
+    if (congested) {
+        // the rest of this data and the data queued after it are sent at packet level, in order
+        packetLevel = true;
+        auto queued = std::exchange(flowState->pending, {});
+        operation.terminate(sent);
+        for (auto &[_, next]: queued) {
+            next.terminate(std::size_t{0});
+        }
+        return;
+    }
+    if (!flowState->pending.empty()) {
+        startFlow();
+    }
+    operation.terminate(sent);
+}
+
+void ns3::CoroutineSocket::deliver(NS3Packet data) {
+    cache->AddAtEnd(data);
+    onReceive();
+}
+
 ns3::CoroutineSocket::AcceptOperation ns3::CoroutineSocket::accept() {
     if (connected || closed || !socket) {
         co_return std::make_tuple(CoroutineSocket{}, Address{}, NS3Error::ERROR_BADF);
@@ -149,6 +225,21 @@ ns3::CoroutineSocket::SendOperation ns3::CoroutineSocket::send(NS3Packet packet)
     }
     SendOperation operation;
     auto size = packet->GetSize();
+    if (socket && flowNetwork && !packetLevel) {
+        // flow level, the data is transmitted as one flow at a time in the order of the sends
+        auto transmitted = makeCoroutineOperation<std::size_t>();
+        flowState->pending.emplace_back(packet, transmitted);
+        if (flowState->pending.size() == 1) {
+            startFlow();
+        }
+        auto sent = co_await transmitted;
+        if (sent >= size) {
+            co_return std::make_tuple((size_t) size, NS3Error::ERROR_NOTERROR);
+        }
+        packet->RemoveAtStart(sent);
+        auto [rest, error] = co_await send(packet);
+        co_return std::make_tuple(sent + rest, error);
+    }
     if (!socket) {
         // loopback
         operation = makeCoroutineOperation(
@@ -243,6 +334,17 @@ ns3::CoroutineSocket::ReceiveOperation ns3::CoroutineSocket::receive(std::size_t
     } else {
         operation = makeCoroutineOperation(
                 [size, data, this]() {
+                    if (cache->GetSize() > 0 && !isClosed() && !isBlocked()) {
+                        // data delivered by the flow network comes before the data received at packet level
+                        auto required = size <= 0 ? cache->GetSize() : size - data->GetSize();
+                        auto received = std::min(required, (std::size_t) cache->GetSize());
+                        data->AddAtEnd(cache->CreateFragment(0, received));
+                        cache->RemoveAtStart(received);
+                        rx_size += received;
+                        if (data->GetSize() >= size) {
+                            return true;
+                        }
+                    }
                     do {
                         if (isClosed()) {
                             return true;
@@ -250,6 +352,10 @@ ns3::CoroutineSocket::ReceiveOperation ns3::CoroutineSocket::receive(std::size_t
                         if (isBlocked() || socket->GetRxAvailable() <= 0) {
                             return false;
                         }
+                        if (flowNetwork && flowNetwork->inTransit(flowLocal, flowPeer)) {
+                            // the data received at packet level was sent after the flows still on their way
+                            return false;
+                        }
                         std::size_t required = size <= 0 ? socket->GetRxAvailable() : size - data->GetSize();
                         auto packet = socket->Recv(required, 0);
                         if (packet == nullptr) {
@@ -278,6 +384,31 @@ ns3::CoroutineSocket::ReceiveOperation ns3::CoroutineSocket::receive(std::size_t
     co_return result;
 }
 
+ns3::CoroutineSocket::NS3Error ns3::CoroutineSocket::useFlowNetwork(const std::shared_ptr<FlowNetwork> &network, FlowNetwork::EndpointID local, FlowNetwork::EndpointID peer) {
+    if (!socket || closed) {
+        return NS3Error::ERROR_BADF;
+    }
+    Address address;
+    if (socket->GetPeerName(address) != 0) {
+        return socket->GetErrno();
+    }
+    if (!InetSocketAddress::IsMatchingType(address)) {
+        return NS3Error::ERROR_AFNOSUPPORT;
+    }
+    flowTo = network->locate(InetSocketAddress::ConvertFrom(address).GetIpv4());
+    if (flowNetwork) {
+        flowNetwork->detach(flowLocal, flowPeer, this);
+    }
+    flowNetwork = network;
+    flowLocal = local;
+    flowPeer = peer;
+    if (!flowState) {
+        flowState = std::make_shared<FlowState>(FlowState{this, {}});
+    }
+    flowNetwork->attach(local, peer, this);
+    return NS3Error::ERROR_NOTERROR;
+}
+
 ns3::CoroutineSocket::NS3Error ns3::CoroutineSocket::close() noexcept {
     if (!(connected || listening) || !socket || closed) {
         return NS3Error::ERROR_NOTERROR;
@@ -363,5 +494,11 @@ void ns3::CoroutineSocket::clearCallbacks() noexcept {
 
 ns3::CoroutineSocket::~CoroutineSocket() noexcept {
     clearCallbacks();
+    if (flowState) {
+        flowState->socket = nullptr;
+    }
+    if (flowNetwork) {
+        flowNetwork->detach(flowLocal, flowPeer, this);
+    }
 }
 
@@ -5,11 +5,13 @@
 
 #include <deque>
 #include <functional>
+#include <memory>
 #include <tuple>
 
 #include <ns3/core-module.h>
 #include <ns3/network-module.h>
 
+#include "flow-network.h"
 #include "operation.h"
 
 namespace ns3 {
@@ -28,6 +30,18 @@ namespace ns3 {
         using SendOperationQueue = std::deque<SendOperation>;
         using ReceiveOperation = CoroutineOperation<std::tuple<NS3Packet, NS3Error>>;
         using ReceiveOperationQueue = std::deque<ReceiveOperation>;
+        using FlowOperationQueue = std::deque<std::tuple<NS3Packet, CoroutineOperation<std::size_t>>>;
+
+        /**
+         * The flows waiting to be transmitted, shared with the callbacks of the flow in progress so that it ends on
+         * the socket which owns it, even after a move.
+         */
+        struct FlowState {
+            CoroutineSocket *socket;
+            FlowOperationQueue pending;
+        };
+
+        friend class FlowNetwork;
 
         NS3Socket socket;
         bool blocked = false;
@@ -45,6 +59,13 @@ namespace ns3 {
         size_t tx_size = 0;
         size_t rx_size = 0;
 
+        std::shared_ptr<FlowNetwork> flowNetwork;
+        FlowNetwork::EndpointID flowLocal = 0;
+        FlowNetwork::EndpointID flowPeer = 0;
+        FlowNetwork::NodeID flowTo = 0;
+        bool packetLevel = false;
+        std::shared_ptr<FlowState> flowState;
+
         void registerCallbacks() noexcept;
 
         void clearCallbacks() noexcept;
@@ -59,6 +80,12 @@ namespace ns3 {
 
         void onClose(NS3Error error);
 
+        void startFlow();
+
+        void onFlowEnd(std::size_t sent, bool congested);
+
+        void deliver(NS3Packet data);
+
     public:
         /**
          * Loopback socket
@@ -93,6 +120,14 @@ namespace ns3 {
 
         NS3Error closeReceive() noexcept;
 
+        /**
+         * Transmit the data sent on the connected socket as flows of a flow-level network model, until one of them
+         * is congested: the socket then switches to packet level for good.
+         * @param local endpoint of this socket in the network
+         * @param peer endpoint of the connected socket, which has to use the network with the endpoints swapped
+         */
+        NS3Error useFlowNetwork(const std::shared_ptr<FlowNetwork> &network, FlowNetwork::EndpointID local, FlowNetwork::EndpointID peer);
+
         size_t txBytes() const noexcept;
 
         size_t rxBytes() const noexcept;
@@ -117,6 +152,10 @@ namespace ns3 {
             return listening;
         }
 
+        inline bool isPacketLevel() const noexcept {
+            return !flowNetwork || packetLevel;
+        }
+
         virtual ~CoroutineSocket() noexcept;
     };
 }
@@ -0,0 +1,276 @@
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+
+#include <ns3/core-module.h>
+#include <ns3/internet-module.h>
+#include <ns3/network-module.h>
+
+#include "coroutine-socket.h"
+#include "flow-network.h"
+
+ns3::FlowNetwork::FlowNetwork(double congestionThreshold) noexcept: congestionThreshold(congestionThreshold) {}
+
+std::shared_ptr<ns3::FlowNetwork> ns3::FlowNetwork::fromTopology(double congestionThreshold) {
+    auto network = std::make_shared<FlowNetwork>(congestionThreshold);
+    for (auto node = NodeList::Begin(); node != NodeList::End(); ++node) {
+        for (std::size_t i = 0; i < (*node)->GetNDevices(); ++i) {
+            auto device = (*node)->GetDevice(i);
+            auto channel = device->GetChannel();
+            if (!channel || channel->GetNDevices() != 2) {
+                continue;
+            }
+            auto peer = channel->GetDevice(0) == device ? channel->GetDevice(1) : channel->GetDevice(0);
+            DataRateValue rate;
+            if (!device->GetAttributeFailSafe("DataRate", rate)) {
+                continue;
+            }
+            TimeValue delay;
+            channel->GetAttributeFailSafe("Delay", delay);
+            network->addLink((*node)->GetId(), peer->GetNode()->GetId(), rate.Get(), delay.Get());
+        }
+    }
+    return network;
+}
+
+ns3::FlowNetwork::LinkID ns3::FlowNetwork::addLink(NodeID from, NodeID to, DataRate rate, Time latency) {
+    links.push_back(Link{from, to, rate.GetBitRate() / 8.0, latency});
+    adjacency[from].push_back(links.size() - 1);
+    paths.clear();
+    return links.size() - 1;
+}
+
+const std::vector<ns3::FlowNetwork::LinkID> &ns3::FlowNetwork::path(NodeID from, NodeID to) {
+    auto key = std::make_pair(from, to);
+    if (auto found = paths.find(key); found != paths.end()) {
+        return found->second;
+    }
+    // breadth first search, the link through which each node is reached first
+    std::unordered_map<NodeID, LinkID> via;
+    std::deque<NodeID> queue{from};
+    while (!queue.empty() && !via.contains(to)) {
+        auto node = queue.front();
+        queue.pop_front();
+        for (auto link: adjacency[node]) {
+            auto next = links[link].to;
+            if (next != from && !via.contains(next)) {
+                via[next] = link;
+                queue.push_back(next);
+            }
+        }
+    }
+    if (from != to && !via.contains(to)) {
+        throw std::domain_error("FlowNetwork: no path from node " + std::to_string(from) + " to node " + std::to_string(to));
+    }
+    std::vector<LinkID> result;
+    for (auto node = to; node != from; node = links[via[node]].from) {
+        result.push_back(via[node]);
+    }
+    std::reverse(result.begin(), result.end());
+    return paths.emplace(key, std::move(result)).first->second;
+}
+
+ns3::Time ns3::FlowNetwork::latency(NodeID from, NodeID to) {
+    Time result;
+    for (auto link: path(from, to)) {
+        result += links[link].latency;
+    }
+    return result;
+}
+
+ns3::FlowNetwork::NodeID ns3::FlowNetwork::locate(Ipv4Address address) {
+    if (!nodes.contains(address)) {
+        // nodes and addresses may have been added since the last lookup
+        for (auto node = NodeList::Begin(); node != NodeList::End(); ++node) {
+            auto ipv4 = (*node)->GetObject<Ipv4>();
+            if (!ipv4) {
+                continue;
+            }
+            for (uint32_t i = 0; i < ipv4->GetNInterfaces(); ++i) {
+                for (uint32_t j = 0; j < ipv4->GetNAddresses(i); ++j) {
+                    nodes[ipv4->GetAddress(i, j).GetLocal()] = (*node)->GetId();
+                }
+            }
+        }
+    }
+    auto found = nodes.find(address);
+    if (found == nodes.end()) {
+        throw std::domain_error("FlowNetwork: no node has the address of a flow");
+    }
+    return found->second;
+}
+
+ns3::FlowNetwork::FlowID ns3::FlowNetwork::start(NodeID from, NodeID to, std::size_t size, TransmitCallback onTransmitted, TransmitCallback onCongested) {
+    advance();
+    auto &route = path(from, to);
+    double bottleneck = std::numeric_limits<double>::infinity();
+    for (auto link: route) {
+        bottleneck = std::min(bottleneck, links[link].capacity);
+    }
+    auto id = nextFlow++;
+    flows.emplace(id, Flow{size, (double) size, 0, bottleneck, route, std::move(onTransmitted), std::move(onCongested)});
+    auto congested = allocate();
+    reschedule();
+    for (auto &flow: congested) {
+        flow.onCongested(flow.size - (std::size_t) std::ceil(flow.remaining));
+    }
+    return id;
+}
+
+double ns3::FlowNetwork::rate(FlowID id) const {
+    return flows.at(id).rate;
+}
+
+std::size_t ns3::FlowNetwork::activeFlows() const noexcept {
+    return flows.size();
+}
+
+void ns3::FlowNetwork::advance() {
+    auto now = Simulator::Now();
+    auto elapsed = (now - lastUpdate).GetSeconds();
+    for (auto &flow: flows | std::views::values) {
+        flow.remaining = std::max(0.0, flow.remaining - flow.rate * elapsed);
+    }
+    lastUpdate = now;
+}
+
+std::vector<ns3::FlowNetwork::Flow> ns3::FlowNetwork::allocate() {
+    std::vector<Flow> congested;
+    bool changed = true;
+    while (changed) {
+        // progressive filling: the flows of the link with the smallest fair share get that share, until all the
+        // flows have a rate
+        std::vector<double> capacity(links.size());
+        std::vector<std::size_t> count(links.size(), 0);
+        std::vector<Flow *> unallocated;
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            capacity[i] = links[i].capacity;
+        }
+        for (auto &flow: flows | std::views::values) {
+            if (flow.path.empty()) {
+                flow.rate = std::numeric_limits<double>::infinity();
+                continue;
+            }
+            for (auto link: flow.path) {
+                ++count[link];
+            }
+            unallocated.push_back(&flow);
+        }
+        while (!unallocated.empty()) {
+            LinkID bottleneck = 0;
+            double share = std::numeric_limits<double>::infinity();
+            for (std::size_t i = 0; i < links.size(); ++i) {
+                if (count[i] > 0 && capacity[i] / count[i] < share) {
+                    bottleneck = i;
+                    share = capacity[i] / count[i];
+                }
+            }
+            std::erase_if(unallocated, [&](Flow *flow) {
+                if (std::find(flow->path.begin(), flow->path.end(), bottleneck) == flow->path.end()) {
+                    return false;
+                }
+                flow->rate = share;
+                for (auto link: flow->path) {
+                    capacity[link] = std::max(0.0, capacity[link] - share);
+                    --count[link];
+                }
+                return true;
+            });
+        }
+        // the congested flows leave the model, and free their share for the others
+        changed = false;
+        for (auto flow = flows.begin(); flow != flows.end();) {
+            if (flow->second.rate < congestionThreshold * flow->second.bottleneck) {
+                congested.push_back(std::move(flow->second));
+                flow = flows.erase(flow);
+                changed = true;
+            } else {
+                ++flow;
+            }
+        }
+    }
+    return congested;
+}
+
+void ns3::FlowNetwork::reschedule() {
+    completion.Cancel();
+    double next = std::numeric_limits<double>::infinity();
+    for (auto &flow: flows | std::views::values) {
+        if (flow.rate > 0) {
+            next = std::min(next, flow.remaining / flow.rate);
+        }
+    }
+    if (std::isfinite(next)) {
+        // rounded up, so that the flow has no byte left
+        completion = Simulator::Schedule(NanoSeconds(std::ceil(next * 1e9)), &FlowNetwork::onCompletion, this);
+    }
+}
+
+void ns3::FlowNetwork::onCompletion() {
+    advance();
+    std::vector<Flow> transmitted;
+    for (auto flow = flows.begin(); flow != flows.end();) {
+        if (flow->second.remaining < 1.0) {
+            transmitted.push_back(std::move(flow->second));
+            flow = flows.erase(flow);
+        } else {
+            ++flow;
+        }
+    }
+    auto congested = allocate();
+    reschedule();
+    for (auto &flow: transmitted) {
+        flow.onTransmitted(flow.size);
+    }
+    for (auto &flow: congested) {
+        flow.onCongested(flow.size - (std::size_t) std::ceil(flow.remaining));
+    }
+}
+
+void ns3::FlowNetwork::attach(EndpointID local, EndpointID peer, CoroutineSocket *socket) {
+    auto key = std::make_pair(local, peer);
+    endpoints[key] = socket;
+    if (auto found = undelivered.find(key); found != undelivered.end()) {
+        auto data = std::move(found->second);
+        undelivered.erase(found);
+        if (auto count = transit.find(key); count != transit.end() && (count->second -= data.size()) == 0) {
+            transit.erase(count);
+        }
+        for (auto &packet: data) {
+            socket->deliver(packet);
+        }
+    }
+}
+
+void ns3::FlowNetwork::detach(EndpointID local, EndpointID peer, const CoroutineSocket *socket) noexcept {
+    auto found = endpoints.find(std::make_pair(local, peer));
+    if (found != endpoints.end() && found->second == socket) {
+        endpoints.erase(found);
+    }
+}
+
+void ns3::FlowNetwork::transmit(EndpointID local, EndpointID peer) {
+    ++transit[std::make_pair(local, peer)];
+}
+
+bool ns3::FlowNetwork::inTransit(EndpointID local, EndpointID peer) const noexcept {
+    return transit.contains(std::make_pair(local, peer));
+}
+
+void ns3::FlowNetwork::deliver(EndpointID local, EndpointID peer, NS3Packet data) {
+    auto key = std::make_pair(local, peer);
+    if (auto found = endpoints.find(key); found != endpoints.end()) {
+        // no longer in transit when the socket resumes its receptions
+        if (auto count = transit.find(key); count != transit.end() && --count->second == 0) {
+            transit.erase(count);
+        }
+        found->second->deliver(data);
+    } else {
+        undelivered[key].push_back(data);
+    }
+}
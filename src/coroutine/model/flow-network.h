@@ -0,0 +1,167 @@
+
+
+#ifndef NS3_COROUTINE_FLOW_NETWORK_H
+#define NS3_COROUTINE_FLOW_NETWORK_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ns3/core-module.h>
+#include <ns3/network-module.h>
+
+namespace ns3 {
+
+    class CoroutineSocket;
+
+    /**
+     * @brief FlowNetwork is a flow-level model of a network, on which CoroutineSocket transmits data as fluid flows
+     * instead of packets.
+     *
+     * The network is a set of directed links with a capacity and a latency, and a flow follows the path with the
+     * fewest links between two nodes. Whenever a flow starts or ends, the rates of all the active flows are computed
+     * anew as the max-min fair allocation of the capacities of the links, and a single event is scheduled for the
+     * next flow to end. A flow ends when its last byte is transmitted, and its data reaches the other end of the
+     * path after the latencies of the links.
+     *
+     * A flow whose rate falls below the congestion threshold, a fraction of the capacity of the slowest link of its
+     * path, leaves the model: the bytes transmitted so far are delivered, and its socket sends the rest and all
+     * its later data at packet level. The model does not account for the bandwidth of the flows at packet level.
+     *
+     * The model drives the sockets of all the nodes directly, so it is only meant for sequential simulations.
+     */
+    class FlowNetwork {
+    public:
+        using NodeID = std::uint32_t;
+        using LinkID = std::size_t;
+        using FlowID = std::uint64_t;
+        using EndpointID = std::uint64_t;
+        /**
+         * Called with the number of bytes of a flow transmitted
+         */
+        using TransmitCallback = std::function<void(std::size_t)>;
+
+    private:
+        using NS3Packet = Ptr<Packet>;
+        using Endpoint = std::pair<EndpointID, EndpointID>;
+
+        struct Link {
+            NodeID from;
+            NodeID to;
+            double capacity; // bytes per second
+            Time latency;
+        };
+
+        struct Flow {
+            std::size_t size;
+            double remaining; // bytes
+            double rate; // bytes per second
+            double bottleneck; // capacity of the slowest link of the path, bytes per second
+            std::vector<LinkID> path; // a copy, the cache of the paths is cleared when a link is added
+            TransmitCallback onTransmitted;
+            TransmitCallback onCongested;
+        };
+
+        double congestionThreshold;
+        std::vector<Link> links;
+        std::unordered_map<NodeID, std::vector<LinkID>> adjacency;
+        std::map<std::pair<NodeID, NodeID>, std::vector<LinkID>> paths;
+        std::map<Ipv4Address, NodeID> nodes;
+        std::map<FlowID, Flow> flows;
+        FlowID nextFlow = 0;
+        Time lastUpdate;
+        EventId completion;
+        std::map<Endpoint, CoroutineSocket *> endpoints;
+        std::map<Endpoint, std::deque<NS3Packet>> undelivered;
+        std::map<Endpoint, std::size_t> transit;
+
+        void advance();
+
+        std::vector<Flow> allocate();
+
+        void reschedule();
+
+        void onCompletion();
+
+    public:
+        /**
+         * @param congestionThreshold fraction of the capacity of the slowest link of its path below which the rate of
+         * a flow switches it to packet level, 0 to never switch
+         */
+        explicit FlowNetwork(double congestionThreshold) noexcept;
+
+        FlowNetwork(const FlowNetwork &) = delete;
+
+        FlowNetwork &operator=(const FlowNetwork &) = delete;
+
+        /**
+         * Build the model of the links of all the nodes created so far: each channel with two devices gives a link
+         * in each direction, whose capacity is the DataRate attribute of the transmitting device and latency the
+         * Delay attribute of the channel.
+         */
+        static std::shared_ptr<FlowNetwork> fromTopology(double congestionThreshold);
+
+        LinkID addLink(NodeID from, NodeID to, DataRate rate, Time latency);
+
+        /**
+         * @return links of the path with the fewest links between two nodes
+         * @throw std::domain_error if there is no such path
+         */
+        const std::vector<LinkID> &path(NodeID from, NodeID to);
+
+        Time latency(NodeID from, NodeID to);
+
+        /**
+         * @return node owning an IPv4 address
+         * @throw std::domain_error if no node has the address
+         */
+        NodeID locate(Ipv4Address address);
+
+        /**
+         * Start a flow, which either calls onTransmitted once all its bytes are transmitted, or onCongested with the
+         * number of bytes transmitted when it switches to packet level.
+         */
+        FlowID start(NodeID from, NodeID to, std::size_t size, TransmitCallback onTransmitted, TransmitCallback onCongested);
+
+        /**
+         * @return current rate of an active flow, in bytes per second
+         */
+        double rate(FlowID id) const;
+
+        std::size_t activeFlows() const noexcept;
+
+        /**
+         * Register the socket of endpoint local connected to endpoint peer, delivering the data sent to it so far.
+         */
+        void attach(EndpointID local, EndpointID peer, CoroutineSocket *socket);
+
+        /**
+         * Unregister the socket of endpoint local connected to endpoint peer, if it is still the registered one.
+         */
+        void detach(EndpointID local, EndpointID peer, const CoroutineSocket *socket) noexcept;
+
+        /**
+         * Count data on its way to the socket of endpoint local connected to endpoint peer, until it is delivered.
+         */
+        void transmit(EndpointID local, EndpointID peer);
+
+        /**
+         * @return whether data is on its way to the socket of endpoint local connected to endpoint peer, or kept until
+         * the socket is attached: the socket must not receive the data sent after it at packet level before it
+         */
+        bool inTransit(EndpointID local, EndpointID peer) const noexcept;
+
+        /**
+         * Deliver data counted by transmit to the socket of endpoint local connected to endpoint peer, or keep it
+         * until the socket is attached.
+         */
+        void deliver(EndpointID local, EndpointID peer, NS3Packet data);
+    };
+}
+
+#endif //NS3_COROUTINE_FLOW_NETWORK_H
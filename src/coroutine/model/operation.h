@@ -26,6 +26,9 @@ namespace ns3 {
             std::optional<std::exception_ptr> exception;
             std::vector<std::function<void(std::optional<R> &, std::optional<std::exception_ptr> &)>> continuations;
 
+            // Not an aggregate, which would be initialized from the arguments of the coroutine.
+            Promise() noexcept = default;
+
             constexpr std::suspend_never initial_suspend() const noexcept {
                 return {};
             }
@@ -266,6 +269,9 @@ namespace ns3 {
             std::optional<std::exception_ptr> exception;
             std::vector<std::function<void(std::optional<std::exception_ptr> &)>> continuations;
 
+            // Not an aggregate, which would be initialized from the arguments of the coroutine.
+            Promise() noexcept = default;
+
             constexpr std::suspend_never initial_suspend() const noexcept {
                 return {};
             }
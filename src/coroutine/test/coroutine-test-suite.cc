@@ -0,0 +1,338 @@
+
+
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ns3/core-module.h>
+#include <ns3/internet-module.h>
+#include <ns3/network-module.h>
+
+#include "ns3/coroutine-log.h"
+#include "ns3/coroutine-socket.h"
+#include "ns3/flow-network.h"
+#include "ns3/operation.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("CoroutineTestSuite");
+
+    /**
+     * @brief Check that COROUTINE_LOG only evaluates its message when the level of the component is enabled.
+     */
+    class CoroutineLogTestCase : public TestCase {
+    private:
+        std::size_t evaluated = 0;
+
+        std::string message();
+
+        void DoRun() override;
+
+    public:
+        CoroutineLogTestCase();
+    };
+
+    CoroutineLogTestCase::CoroutineLogTestCase() : TestCase("Log messages evaluated only when enabled") {}
+
+    std::string CoroutineLogTestCase::message() {
+        ++evaluated;
+        return "evaluated message";
+    }
+
+    void CoroutineLogTestCase::DoRun() {
+        LogComponentDisable("CoroutineTestSuite", LOG_LEVEL_ALL);
+        COROUTINE_LOG_ERROR("CoroutineTestSuite", message());
+        COROUTINE_LOG_DEBUG("CoroutineTestSuite", message());
+        NS_TEST_EXPECT_MSG_EQ(evaluated, 0, "Message evaluated while the component is disabled");
+
+#ifdef NS3_LOG_ENABLE
+        std::ostringstream output;
+        auto buffer = std::clog.rdbuf(output.rdbuf());
+        LogComponentEnable("CoroutineTestSuite", LOG_LEVEL_LOGIC);
+        COROUTINE_LOG_LOGIC("CoroutineTestSuite", message());
+        COROUTINE_LOG_DEBUG("CoroutineTestSuite", message());
+        LogComponentDisable("CoroutineTestSuite", LOG_LEVEL_ALL);
+        std::clog.rdbuf(buffer);
+        NS_TEST_EXPECT_MSG_EQ(evaluated, 1, "Message not evaluated only at the enabled levels");
+        NS_TEST_EXPECT_MSG_NE(output.str().find("evaluated message"), std::string::npos, "Message not logged");
+#endif
+    }
+
+    /**
+     * @brief Check that the result of a coroutine does not depend on its arguments, which once initialized its
+     * promise.
+     */
+    class CoroutineOperationArgumentsTestCase : public TestCase {
+    private:
+        static CoroutineOperation<uint64_t> identity(uint64_t value);
+
+        static CoroutineOperation<uint64_t> chain(uint32_t depth, CoroutineOperation<uint64_t> leaf);
+
+        void DoRun() override;
+
+    public:
+        CoroutineOperationArgumentsTestCase();
+    };
+
+    CoroutineOperationArgumentsTestCase::CoroutineOperationArgumentsTestCase() : TestCase("Coroutines with arguments") {}
+
+    CoroutineOperation<uint64_t> CoroutineOperationArgumentsTestCase::identity(uint64_t value) {
+        co_return value;
+    }
+
+    CoroutineOperation<uint64_t> CoroutineOperationArgumentsTestCase::chain(uint32_t depth,
+                                                                           CoroutineOperation<uint64_t> leaf) {
+        if (depth == 0) {
+            co_return co_await leaf;
+        }
+        co_return co_await chain(depth - 1, leaf) + 1;
+    }
+
+    void CoroutineOperationArgumentsTestCase::DoRun() {
+        for (uint64_t value: {0, 1, 42}) {
+            auto operation = identity(value);
+            NS_TEST_ASSERT_MSG_EQ(operation.done(), true, "Coroutine not done");
+            NS_TEST_EXPECT_MSG_EQ(operation.result(), value, "Wrong coroutine result");
+        }
+
+        auto leaf = makeCoroutineOperation<uint64_t>();
+        auto operation = chain(3, leaf);
+        NS_TEST_EXPECT_MSG_EQ(operation.done(), false, "Chain done before its leaf");
+        leaf.terminate(10);
+        NS_TEST_ASSERT_MSG_EQ(operation.done(), true, "Chain not done after its leaf");
+        NS_TEST_EXPECT_MSG_EQ(operation.result(), 13, "Wrong chain result");
+    }
+
+    /**
+     * @brief Check the max-min fair rates of the flows of a FlowNetwork, and the times at which they end.
+     *
+     * Three flows share two links, 0 to 1 at 300 bytes/s and 1 to 2 at 100 bytes/s: the two flows through the
+     * second link get half of it each, and the flow only through the first link the rest of the first.
+     */
+    class FlowNetworkFairnessTestCase : public TestCase {
+    private:
+        std::vector<std::optional<Time>> ends;
+
+        void DoRun() override;
+
+    public:
+        FlowNetworkFairnessTestCase();
+    };
+
+    FlowNetworkFairnessTestCase::FlowNetworkFairnessTestCase() : TestCase("Max-min fair rates of the flows") {}
+
+    void FlowNetworkFairnessTestCase::DoRun() {
+        FlowNetwork network{0};
+        network.addLink(0, 1, DataRate("2400bps"), MilliSeconds(1));
+        network.addLink(1, 2, DataRate("800bps"), MilliSeconds(2));
+        NS_TEST_EXPECT_MSG_EQ(network.latency(0, 2), MilliSeconds(3), "Wrong latency of the path");
+
+        ends.assign(3, std::nullopt);
+        auto onEnd = [this](std::size_t flow, std::size_t size) {
+            return [this, flow, size](std::size_t sent) {
+                NS_TEST_EXPECT_MSG_EQ(sent, size, "Flow not fully transmitted");
+                ends[flow] = Simulator::Now();
+            };
+        };
+        auto onCongested = [](std::size_t) { NS_FATAL_ERROR("Flow congested without a threshold"); };
+        auto through = network.start(0, 2, 100, onEnd(0, 100), onCongested);
+        auto last = network.start(1, 2, 100, onEnd(1, 100), onCongested);
+        auto first = network.start(0, 1, 1000, onEnd(2, 1000), onCongested);
+        NS_TEST_EXPECT_MSG_EQ_TOL(network.rate(through), 50, 1e-9, "Wrong rate of the flow through both links");
+        NS_TEST_EXPECT_MSG_EQ_TOL(network.rate(last), 50, 1e-9, "Wrong rate of the flow through the second link");
+        NS_TEST_EXPECT_MSG_EQ_TOL(network.rate(first), 250, 1e-9, "Wrong rate of the flow through the first link");
+
+        // the routes of the active flows survive the paths recomputed for a new link
+        network.addLink(2, 3, DataRate("800bps"), MilliSeconds(1));
+        NS_TEST_EXPECT_MSG_EQ(network.path(0, 3).size(), 3, "Wrong path through the new link");
+
+        Simulator::Run();
+        Simulator::Destroy();
+
+        NS_TEST_EXPECT_MSG_EQ(network.activeFlows(), 0, "Flows still active");
+        for (auto &end: ends) {
+            NS_TEST_ASSERT_MSG_EQ(end.has_value(), true, "Flow did not end");
+        }
+        NS_TEST_EXPECT_MSG_EQ(*ends[0], Seconds(2), "Wrong end of the flow through both links");
+        NS_TEST_EXPECT_MSG_EQ(*ends[1], Seconds(2), "Wrong end of the flow through the second link");
+        // 500 bytes left at 2s, then transmitted at the whole capacity of the first link
+        NS_TEST_EXPECT_MSG_EQ_TOL(ends[2]->GetSeconds(), 2 + 500.0 / 300, 1e-8, "Wrong end of the last flow");
+    }
+
+    /**
+     * @brief Check that the flows below the congestion threshold leave the model with the bytes they transmitted.
+     */
+    class FlowNetworkCongestionTestCase : public TestCase {
+    private:
+        void DoRun() override;
+
+    public:
+        FlowNetworkCongestionTestCase();
+    };
+
+    FlowNetworkCongestionTestCase::FlowNetworkCongestionTestCase() : TestCase("Congested flows leave the model") {}
+
+    void FlowNetworkCongestionTestCase::DoRun() {
+        FlowNetwork network{0.6};
+        network.addLink(0, 1, DataRate("800bps"), MilliSeconds(1));
+
+        std::vector<std::size_t> congested;
+        auto onTransmitted = [](std::size_t) { NS_FATAL_ERROR("Congested flow transmitted"); };
+        auto onCongested = [&congested](std::size_t sent) { congested.push_back(sent); };
+        network.start(0, 1, 1000, onTransmitted, onCongested);
+        // the second flow halves the rate of the first one, below the threshold
+        Simulator::Schedule(Seconds(1), [&]() { network.start(0, 1, 1000, onTransmitted, onCongested); });
+        Simulator::Run();
+        Simulator::Destroy();
+
+        NS_TEST_ASSERT_MSG_EQ(congested.size(), 2, "Wrong number of congested flows");
+        NS_TEST_EXPECT_MSG_EQ(congested[0], 100, "Wrong bytes transmitted by the first flow");
+        NS_TEST_EXPECT_MSG_EQ(congested[1], 0, "Wrong bytes transmitted by the second flow");
+        NS_TEST_EXPECT_MSG_EQ(network.activeFlows(), 0, "Congested flows still active");
+    }
+
+    /**
+     * @brief Transfer data between two CoroutineSocket over TCP with a FlowNetwork, and check that it arrives
+     * complete and in order, whether it is transmitted as flows only or switches to packet level midway.
+     *
+     * The latency of the flows is longer than that of the packets, so that the data sent at packet level after a
+     * switch reaches the receiver before the data of the flows. The client socket is moved while its flow is in
+     * progress, which must end on the socket it was moved to.
+     */
+    class CoroutineSocketFlowTestCase : public TestCase {
+    private:
+        static constexpr std::uint16_t port = 9;
+        static constexpr std::size_t size = 10000;
+
+        bool congest;
+        std::vector<std::uint8_t> received;
+        std::size_t sent = 0;
+        bool packetLevel = false;
+        Time end;
+
+        CoroutineOperation<void> serve(Ptr<Node> node, std::shared_ptr<FlowNetwork> network);
+
+        CoroutineOperation<void> connect(Ptr<Node> node, Ipv4Address address, std::shared_ptr<FlowNetwork> network);
+
+        void DoRun() override;
+
+    public:
+        /**
+         * @param congest whether to congest the flow of the data with another one
+         */
+        explicit CoroutineSocketFlowTestCase(bool congest);
+    };
+
+    CoroutineSocketFlowTestCase::CoroutineSocketFlowTestCase(bool congest) :
+            TestCase(congest ? "Socket switching from flows to packets" : "Socket transmitting flows"),
+            congest(congest) {}
+
+    CoroutineOperation<void> CoroutineSocketFlowTestCase::serve(Ptr<Node> node, std::shared_ptr<FlowNetwork> network) {
+        CoroutineSocket listener{node, TcpSocketFactory::GetTypeId()};
+        listener.bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+        auto accepted = std::move(co_await listener.accept());
+        auto &[socket, address, error] = accepted;
+        NS_TEST_EXPECT_MSG_EQ(error, Socket::ERROR_NOTERROR, "Accept failed");
+        socket.useFlowNetwork(network, 1, 0);
+        auto [data, status] = co_await socket.receive(size);
+        NS_TEST_EXPECT_MSG_EQ(status, Socket::ERROR_NOTERROR, "Receive failed");
+        received.resize(data->GetSize());
+        data->CopyData(received.data(), received.size());
+        end = Simulator::Now();
+    }
+
+    CoroutineOperation<void> CoroutineSocketFlowTestCase::connect(Ptr<Node> node, Ipv4Address address,
+                                                                  std::shared_ptr<FlowNetwork> network) {
+        auto socket = std::make_unique<CoroutineSocket>(node, TcpSocketFactory::GetTypeId());
+        socket->bind(InetSocketAddress(Ipv4Address::GetAny(), 0));
+        auto error = co_await socket->connect(InetSocketAddress(address, port));
+        NS_TEST_EXPECT_MSG_EQ(error, Socket::ERROR_NOTERROR, "Connect failed");
+        socket->useFlowNetwork(network, 0, 1);
+
+        std::vector<std::uint8_t> data(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = i % 251;
+        }
+        auto operation = socket->send(Create<Packet>(data.data(), data.size()));
+        if (!congest) {
+            // only the flow in progress refers to the socket
+            *socket = CoroutineSocket{std::move(*socket)};
+        }
+        auto [count, status] = co_await operation;
+        NS_TEST_EXPECT_MSG_EQ(status, Socket::ERROR_NOTERROR, "Send failed");
+        sent = count;
+        packetLevel = socket->isPacketLevel();
+    }
+
+    void CoroutineSocketFlowTestCase::DoRun() {
+        NodeContainer nodes;
+        nodes.Create(2);
+        SimpleNetDeviceHelper link;
+        link.SetDeviceAttribute("DataRate", DataRateValue(DataRate("8Mbps")));
+        link.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+        link.SetNetDevicePointToPointMode(true);
+        auto devices = link.Install(nodes);
+        InternetStackHelper internet;
+        internet.Install(nodes);
+        Ipv4AddressHelper addresses{"10.1.1.0", "255.255.255.0"};
+        auto interfaces = addresses.Assign(devices);
+
+        NS_TEST_ASSERT_MSG_EQ(FlowNetwork::fromTopology(0)->latency(0, 1), MilliSeconds(1), "Wrong model of the link");
+        auto network = std::make_shared<FlowNetwork>(0.6);
+        network->addLink(0, 1, DataRate("8Mbps"), MilliSeconds(5));
+        network->addLink(1, 0, DataRate("8Mbps"), MilliSeconds(5));
+
+        std::optional<CoroutineOperation<void>> server;
+        std::optional<CoroutineOperation<void>> client;
+        Simulator::ScheduleWithContext(1, Seconds(0), [&]() { server = serve(nodes.Get(1), network); });
+        Simulator::ScheduleWithContext(0, Seconds(0), [&]() {
+            client = connect(nodes.Get(0), interfaces.GetAddress(1), network);
+        });
+        if (congest) {
+            // another flow halves the rate of the one of the data
+            Simulator::ScheduleWithContext(0, MicroSeconds(5500), [&]() {
+                network->start(0, 1, size, [](auto) {}, [](auto) {});
+            });
+        }
+        Simulator::Stop(Seconds(10));
+        Simulator::Run();
+
+        NS_TEST_EXPECT_MSG_EQ(sent, size, "Wrong number of bytes sent");
+        NS_TEST_EXPECT_MSG_EQ(packetLevel, congest, "Wrong transmission mode");
+        NS_TEST_ASSERT_MSG_EQ(received.size(), size, "Wrong number of bytes received");
+        for (std::size_t i = 0; i < size; ++i) {
+            NS_TEST_ASSERT_MSG_EQ(std::uint32_t{received[i]}, i % 251, "Data received out of order");
+        }
+        if (!congest) {
+            // the connection is established after a round trip of about 2ms, then a single flow transmits the data
+            // at the rate of the link in 10ms, and reaches the server after the latency of the flows
+            NS_TEST_EXPECT_MSG_EQ_TOL(end.GetSeconds(), 17e-3, 0.5e-3, "Wrong end of the flow");
+        }
+
+        server.reset();
+        client.reset();
+        Simulator::Destroy();
+    }
+
+    /**
+     * @brief Coroutine test suite
+     */
+    class CoroutineTestSuite : public TestSuite {
+    public:
+        CoroutineTestSuite();
+    };
+
+    CoroutineTestSuite::CoroutineTestSuite() : TestSuite("coroutine", UNIT) {
+        AddTestCase(new CoroutineLogTestCase, TestCase::QUICK);
+        AddTestCase(new CoroutineOperationArgumentsTestCase, TestCase::QUICK);
+        AddTestCase(new FlowNetworkFairnessTestCase, TestCase::QUICK);
+        AddTestCase(new FlowNetworkCongestionTestCase, TestCase::QUICK);
+        AddTestCase(new CoroutineSocketFlowTestCase(false), TestCase::QUICK);
+        AddTestCase(new CoroutineSocketFlowTestCase(true), TestCase::QUICK);
+    }
+
+    static CoroutineTestSuite g_coroutineTestSuite; //!< Static variable for test initialization
+}
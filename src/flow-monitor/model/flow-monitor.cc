@@ -80,7 +80,13 @@ FlowMonitor::GetTypeId()
                 ("The minimum inter-arrival time that is considered a flow interruption."),
                 TimeValue(Seconds(0.5)),
                 MakeTimeAccessor(&FlowMonitor::m_flowInterruptionsMinTime),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("SamplingRate",
+                          ("The fraction of the packets of each flow which are monitored, "
+                           "picked pseudo-randomly from their flow and packet ids."),
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&FlowMonitor::m_samplingRate),
+                          MakeDoubleChecker<double>(0.0, 1.0));
     return tid;
 }
 
@@ -91,7 +97,10 @@ FlowMonitor::GetInstanceTypeId() const
 }
 
 FlowMonitor::FlowMonitor()
-    : m_enabled(false)
+    : m_packetTable(1024, NO_PACKET),
+      m_nTrackedPackets(0),
+      m_lossWheelStart(0),
+      m_enabled(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -111,6 +120,11 @@ FlowMonitor::DoDispose()
         m_flowProbes[i]->Dispose();
         m_flowProbes[i] = nullptr;
     }
+    m_trackedPackets.clear();
+    m_freePackets.clear();
+    m_packetTable.assign(1024, NO_PACKET);
+    m_nTrackedPackets = 0;
+    m_lossWheel.clear();
     Object::DoDispose();
 }
 
@@ -143,6 +157,169 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
     }
 }
 
+bool
+FlowMonitor::IsSampled(FlowId flowId, FlowPacketId packetId) const
+{
+    if (m_samplingRate >= 1.0)
+    {
+        return true;
+    }
+    uint64_t key = (uint64_t(flowId) << 32) | packetId;
+    return ((key * 0x9e3779b97f4a7c15ULL) >> 32) < m_samplingRate * 4294967296.0;
+}
+
+std::size_t
+FlowMonitor::FindPosition(FlowId flowId, FlowPacketId packetId) const
+{
+    std::size_t mask = m_packetTable.size() - 1;
+    uint64_t key = (uint64_t(flowId) << 32) | packetId;
+    std::size_t i = ((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+    while (m_packetTable[i] != NO_PACKET &&
+           (m_trackedPackets[m_packetTable[i]].flowId != flowId ||
+            m_trackedPackets[m_packetTable[i]].packetId != packetId))
+    {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+uint32_t
+FlowMonitor::FindTrackedPacket(FlowId flowId, FlowPacketId packetId) const
+{
+    return m_packetTable[FindPosition(flowId, packetId)];
+}
+
+uint32_t
+FlowMonitor::AddTrackedPacket(FlowId flowId, FlowPacketId packetId)
+{
+    if (2 * (m_nTrackedPackets + 1) > m_packetTable.size())
+    {
+        GrowPacketTable();
+    }
+    uint32_t slot;
+    if (m_freePackets.empty())
+    {
+        slot = m_trackedPackets.size();
+        m_trackedPackets.emplace_back();
+    }
+    else
+    {
+        slot = m_freePackets.back();
+        m_freePackets.pop_back();
+    }
+    TrackedPacket& tracked = m_trackedPackets[slot];
+    tracked.flowId = flowId;
+    tracked.packetId = packetId;
+    tracked.prev = NO_PACKET;
+    tracked.next = NO_PACKET;
+    tracked.period = NO_PERIOD;
+    m_packetTable[FindPosition(flowId, packetId)] = slot;
+    ++m_nTrackedPackets;
+    return slot;
+}
+
+void
+FlowMonitor::RemoveTrackedPacket(uint32_t slot)
+{
+    UnlinkLossCheck(slot);
+    std::size_t mask = m_packetTable.size() - 1;
+    std::size_t i = FindPosition(m_trackedPackets[slot].flowId, m_trackedPackets[slot].packetId);
+    NS_ASSERT(m_packetTable[i] == slot);
+    m_packetTable[i] = NO_PACKET;
+    // Move back the following entries which may no longer be found
+    // past the new hole, as linear probing requires
+    for (std::size_t j = (i + 1) & mask; m_packetTable[j] != NO_PACKET; j = (j + 1) & mask)
+    {
+        const TrackedPacket& moved = m_trackedPackets[m_packetTable[j]];
+        uint64_t key = (uint64_t(moved.flowId) << 32) | moved.packetId;
+        std::size_t home = ((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            m_packetTable[i] = m_packetTable[j];
+            m_packetTable[j] = NO_PACKET;
+            i = j;
+        }
+    }
+    m_freePackets.push_back(slot);
+    --m_nTrackedPackets;
+}
+
+void
+FlowMonitor::GrowPacketTable()
+{
+    NS_LOG_FUNCTION(this << m_packetTable.size());
+    std::vector<uint32_t> table(m_packetTable.size() * 2, NO_PACKET);
+    table.swap(m_packetTable);
+    for (uint32_t slot : table)
+    {
+        if (slot != NO_PACKET)
+        {
+            m_packetTable[FindPosition(m_trackedPackets[slot].flowId,
+                                       m_trackedPackets[slot].packetId)] = slot;
+        }
+    }
+}
+
+int64_t
+FlowMonitor::GetLossPeriod(Time time) const
+{
+    int64_t interval = PERIODIC_CHECK_INTERVAL.GetTimeStep();
+    return (time.GetTimeStep() + interval - 1) / interval;
+}
+
+void
+FlowMonitor::LinkLossCheck(uint32_t slot, int64_t period)
+{
+    if (m_lossWheel.empty())
+    {
+        m_lossWheelStart = period;
+    }
+    while (period < m_lossWheelStart)
+    {
+        m_lossWheel.push_front(NO_PACKET);
+        --m_lossWheelStart;
+    }
+    if (period - m_lossWheelStart >= int64_t(m_lossWheel.size()))
+    {
+        m_lossWheel.resize(period - m_lossWheelStart + 1, NO_PACKET);
+    }
+    uint32_t& head = m_lossWheel[period - m_lossWheelStart];
+    TrackedPacket& tracked = m_trackedPackets[slot];
+    tracked.prev = NO_PACKET;
+    tracked.next = head;
+    tracked.period = period;
+    if (head != NO_PACKET)
+    {
+        m_trackedPackets[head].prev = slot;
+    }
+    head = slot;
+}
+
+void
+FlowMonitor::UnlinkLossCheck(uint32_t slot)
+{
+    TrackedPacket& tracked = m_trackedPackets[slot];
+    if (tracked.period == NO_PERIOD)
+    {
+        return;
+    }
+    if (tracked.prev != NO_PACKET)
+    {
+        m_trackedPackets[tracked.prev].next = tracked.next;
+    }
+    else
+    {
+        m_lossWheel[tracked.period - m_lossWheelStart] = tracked.next;
+    }
+    if (tracked.next != NO_PACKET)
+    {
+        m_trackedPackets[tracked.next].prev = tracked.prev;
+    }
+    tracked.prev = NO_PACKET;
+    tracked.next = NO_PACKET;
+    tracked.period = NO_PERIOD;
+}
+
 void
 FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
                            uint32_t flowId,
@@ -155,17 +332,28 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
+    FlowStats& stats = GetStatsForFlow(flowId);
+    if (!IsSampled(flowId, packetId))
+    {
+        return;
+    }
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
+    uint32_t slot = FindTrackedPacket(flowId, packetId);
+    if (slot == NO_PACKET)
+    {
+        slot = AddTrackedPacket(flowId, packetId);
+    }
+    TrackedPacket& tracked = m_trackedPackets[slot];
     tracked.firstSeenTime = now;
     tracked.lastSeenTime = tracked.firstSeenTime;
     tracked.timesForwarded = 0;
+    UnlinkLossCheck(slot);
+    LinkLossCheck(slot, GetLossPeriod(now + m_maxPerHopDelay));
     NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
                                                                  << packetId << ").");
 
     probe->AddPacketStats(flowId, packetSize, Seconds(0));
 
-    FlowStats& stats = GetStatsForFlow(flowId);
     stats.txBytes += packetSize;
     stats.txPackets++;
     if (stats.txPackets == 1)
@@ -187,19 +375,25 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    auto tracked = m_trackedPackets.find(key);
-    if (tracked == m_trackedPackets.end())
+    if (!IsSampled(flowId, packetId))
+    {
+        return;
+    }
+    uint32_t slot = FindTrackedPacket(flowId, packetId);
+    if (slot == NO_PACKET)
     {
         NS_LOG_WARN("Received packet forward report (flowId="
                     << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
         return;
     }
 
-    tracked->second.timesForwarded++;
-    tracked->second.lastSeenTime = Simulator::Now();
+    // The packet stays in its loss check bucket, which checks its last
+    // seen time and moves it further if it is not due yet
+    TrackedPacket& tracked = m_trackedPackets[slot];
+    tracked.timesForwarded++;
+    tracked.lastSeenTime = Simulator::Now();
 
-    Time delay = (Simulator::Now() - tracked->second.firstSeenTime);
+    Time delay = (Simulator::Now() - tracked.firstSeenTime);
     probe->AddPacketStats(flowId, packetSize, delay);
 }
 
@@ -215,8 +409,12 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked == m_trackedPackets.end())
+    if (!IsSampled(flowId, packetId))
+    {
+        return;
+    }
+    uint32_t slot = FindTrackedPacket(flowId, packetId);
+    if (slot == NO_PACKET)
     {
         NS_LOG_WARN("Received packet last-tx report (flowId="
                     << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
@@ -224,7 +422,7 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
     }
 
     Time now = Simulator::Now();
-    Time delay = (now - tracked->second.firstSeenTime);
+    Time delay = (now - m_trackedPackets[slot].firstSeenTime);
     probe->AddPacketStats(flowId, packetSize, delay);
 
     FlowStats& stats = GetStatsForFlow(flowId);
@@ -263,12 +461,12 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         }
     }
     stats.timeLastRxPacket = now;
-    stats.timesForwarded += tracked->second.timesForwarded;
+    stats.timesForwarded += m_trackedPackets[slot].timesForwarded;
 
     NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
                                                                   << packetId << ").");
 
-    m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
+    RemoveTrackedPacket(slot); // we don't need to track this packet anymore
 }
 
 void
@@ -284,6 +482,10 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
+    if (!IsSampled(flowId, packetId))
+    {
+        return;
+    }
 
     probe->AddPacketDropStats(flowId, packetSize, reasonCode);
 
@@ -299,14 +501,14 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked != m_trackedPackets.end())
+    uint32_t slot = FindTrackedPacket(flowId, packetId);
+    if (slot != NO_PACKET)
     {
         // we don't need to track this packet anymore
         // FIXME: this will not necessarily be true with broadcast/multicast
         NS_LOG_DEBUG("ReportDrop: removing tracked packet (flowId=" << flowId << ", packetId="
                                                                     << packetId << ").");
-        m_trackedPackets.erase(tracked);
+        RemoveTrackedPacket(slot);
     }
 }
 
@@ -321,23 +523,65 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
 {
     NS_LOG_FUNCTION(this << maxDelay.As(Time::S));
     Time now = Simulator::Now();
+    std::vector<uint32_t> lost;
 
-    for (auto iter = m_trackedPackets.begin(); iter != m_trackedPackets.end();)
+    if (maxDelay < m_maxPerHopDelay)
     {
-        if (now - iter->second.lastSeenTime >= maxDelay)
+        // The packets are linked in the buckets of m_maxPerHopDelay,
+        // which are too late for this check
+        for (uint32_t slot : m_packetTable)
         {
-            // packet is considered lost, add it to the loss statistics
-            auto flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
-
-            // we won't track it anymore
-            m_trackedPackets.erase(iter++);
+            if (slot != NO_PACKET && now - m_trackedPackets[slot].lastSeenTime >= maxDelay)
+            {
+                lost.push_back(slot);
+            }
         }
-        else
+    }
+    else
+    {
+        // Empty the buckets due by now: the packets not seen for maxDelay
+        // are lost, the others are linked in the bucket they are due in
+        std::vector<uint32_t> recheck;
+        int64_t current = GetLossPeriod(now);
+        while (!m_lossWheel.empty() && m_lossWheelStart <= current)
         {
-            iter++;
+            uint32_t slot = m_lossWheel.front();
+            m_lossWheel.pop_front();
+            ++m_lossWheelStart;
+            while (slot != NO_PACKET)
+            {
+                TrackedPacket& tracked = m_trackedPackets[slot];
+                uint32_t next = tracked.next;
+                tracked.prev = NO_PACKET;
+                tracked.next = NO_PACKET;
+                tracked.period = NO_PERIOD;
+                if (now - tracked.lastSeenTime >= maxDelay)
+                {
+                    lost.push_back(slot);
+                }
+                else
+                {
+                    recheck.push_back(slot);
+                }
+                slot = next;
+            }
         }
+        for (uint32_t slot : recheck)
+        {
+            LinkLossCheck(slot,
+                          GetLossPeriod(m_trackedPackets[slot].lastSeenTime + m_maxPerHopDelay));
+        }
+    }
+
+    for (uint32_t slot : lost)
+    {
+        // packet is considered lost, add it to the loss statistics
+        auto flow = m_flowStats.find(m_trackedPackets[slot].flowId);
+        NS_ASSERT(flow != m_flowStats.end());
+        flow->second.lostPackets++;
+
+        // we won't track it anymore
+        RemoveTrackedPacket(slot);
     }
 }
 
@@ -29,6 +29,8 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 
+#include <cstdint>
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -47,6 +49,14 @@ namespace ns3
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * The packets in flight are tracked in a pool of slots indexed by an
+ * open addressing hash table, and the slots are linked in a wheel of
+ * one second buckets by the time they are due to be considered lost, so
+ * the periodic loss check only visits the packets which are due.  With
+ * the SamplingRate attribute lower than 1, only a pseudo-random sample
+ * of the packets of each flow is monitored, and all the statistics
+ * describe that sample; every flow still gets its FlowStats, empty when
+ * none of its packets was sampled.
  */
 class FlowMonitor : public Object
 {
@@ -285,19 +295,33 @@ class FlowMonitor : public Object
     /// Structure to represent a single tracked packet data
     struct TrackedPacket
     {
+        FlowId flowId;           //!< flow of the packet
+        FlowPacketId packetId;   //!< identifier of the packet in its flow
+        uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+        uint32_t prev;           //!< previous packet in the loss check bucket
+        uint32_t next;           //!< next packet in the loss check bucket
+        int64_t period;          //!< loss check bucket, NO_PERIOD if none
         Time firstSeenTime;      //!< absolute time when the packet was first seen by a probe
         Time lastSeenTime;       //!< absolute time when the packet was last seen by a probe
-        uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
     };
 
+    /// No tracked packet
+    static constexpr uint32_t NO_PACKET = UINT32_MAX;
+    /// Not in a loss check bucket
+    static constexpr int64_t NO_PERIOD = -1;
+
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
 
-    /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
-    TrackedPacketMap m_trackedPackets; //!< Tracked packets
-    Time m_maxPerHopDelay;             //!< Minimum per-hop delay
-    FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
+    std::vector<TrackedPacket> m_trackedPackets; //!< Pool of tracked packets
+    std::vector<uint32_t> m_freePackets;         //!< Free slots of the pool
+    std::vector<uint32_t> m_packetTable;         //!< Hash table of the slots, NO_PACKET if empty
+    uint32_t m_nTrackedPackets;                  //!< Number of tracked packets
+    std::deque<uint32_t> m_lossWheel;            //!< First packet of each loss check bucket
+    int64_t m_lossWheelStart;                    //!< Period of the first loss check bucket
+    Time m_maxPerHopDelay;                       //!< Minimum per-hop delay
+    double m_samplingRate;                       //!< Fraction of the packets monitored
+    FlowProbeContainer m_flowProbes;             //!< all the FlowProbes
 
     // note: this is needed only for serialization
     std::list<Ptr<FlowClassifier>> m_classifiers; //!< the FlowClassifiers
@@ -318,6 +342,48 @@ class FlowMonitor : public Object
 
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
+
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet ID
+    /// \returns true if the packet is in the monitored sample
+    bool IsSampled(FlowId flowId, FlowPacketId packetId) const;
+
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet ID
+    /// \returns the position of the packet in the hash table, or of the
+    /// empty entry where it would be
+    std::size_t FindPosition(FlowId flowId, FlowPacketId packetId) const;
+
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet ID
+    /// \returns the slot of the tracked packet, or NO_PACKET
+    uint32_t FindTrackedPacket(FlowId flowId, FlowPacketId packetId) const;
+
+    /// Start tracking a packet, which must not be tracked yet
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet ID
+    /// \returns the slot of the packet
+    uint32_t AddTrackedPacket(FlowId flowId, FlowPacketId packetId);
+
+    /// Stop tracking a packet
+    /// \param slot the slot of the packet
+    void RemoveTrackedPacket(uint32_t slot);
+
+    /// Double the size of the hash table
+    void GrowPacketTable();
+
+    /// \param time an absolute time
+    /// \returns the loss check bucket of the packets due at that time
+    int64_t GetLossPeriod(Time time) const;
+
+    /// Link a packet in a loss check bucket
+    /// \param slot the slot of the packet
+    /// \param period the loss check bucket
+    void LinkLossCheck(uint32_t slot, int64_t period);
+
+    /// Unlink a packet from its loss check bucket, if any
+    /// \param slot the slot of the packet
+    void UnlinkLossCheck(uint32_t slot);
 };
 
 } // namespace ns3
@@ -177,6 +177,17 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
     return true;
 }
 
+std::size_t
+Ipv4FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t ports = (uint64_t(tuple.protocol) << 32) | (uint32_t(tuple.sourcePort) << 16) |
+                     tuple.destinationPort;
+    uint64_t key = Ipv4AddressHash()(tuple.sourceAddress);
+    key = (key * 0x9e3779b97f4a7c15ULL) ^ Ipv4AddressHash()(tuple.destinationAddress);
+    key = (key * 0x9e3779b97f4a7c15ULL) ^ ports;
+    return (key * 0x9e3779b97f4a7c15ULL) >> 32;
+}
+
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow(FlowId flowId) const
 {
@@ -221,8 +232,12 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     Indent(os, indent);
     os << "<Ipv4FlowClassifier>\n";
 
+    // Sort the flows by tuple, for a stable output
+    std::vector<std::pair<FiveTuple, FlowId>> flows(m_flowMap.begin(), m_flowMap.end());
+    std::sort(flows.begin(), flows.end());
+
     indent += 2;
-    for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
+    for (auto iter = flows.begin(); iter != flows.end(); iter++)
     {
         Indent(os, indent);
         os << "<Flow flowId=\"" << iter->second << "\""
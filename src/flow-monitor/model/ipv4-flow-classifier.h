@@ -26,6 +26,7 @@
 
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -49,6 +50,14 @@ class Ipv4FlowClassifier : public FlowClassifier
         uint16_t destinationPort;       //!< Destination port
     };
 
+    /// Hash function of the FiveTuple, to index the flows
+    struct FiveTupleHash
+    {
+        /// \param tuple the FiveTuple to hash
+        /// \returns the hash of the FiveTuple
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
     Ipv4FlowClassifier();
 
     /// \brief try to classify the packet into flow-id and packet-id
@@ -94,9 +103,9 @@ class Ipv4FlowClassifier : public FlowClassifier
 
   private:
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
+    std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
     /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+    std::unordered_map<FlowId, FlowPacketId> m_flowPktIdMap;
     /// Map FlowIds to (DSCP value, packet count) pairs
     std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>> m_flowDscpMap;
 };
@@ -178,6 +178,17 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
     return true;
 }
 
+std::size_t
+Ipv6FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t ports = (uint64_t(tuple.protocol) << 32) | (uint32_t(tuple.sourcePort) << 16) |
+                     tuple.destinationPort;
+    uint64_t key = Ipv6AddressHash()(tuple.sourceAddress);
+    key = (key * 0x9e3779b97f4a7c15ULL) ^ Ipv6AddressHash()(tuple.destinationAddress);
+    key = (key * 0x9e3779b97f4a7c15ULL) ^ ports;
+    return (key * 0x9e3779b97f4a7c15ULL) >> 32;
+}
+
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow(FlowId flowId) const
 {
@@ -222,8 +233,12 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     Indent(os, indent);
     os << "<Ipv6FlowClassifier>\n";
 
+    // Sort the flows by tuple, for a stable output
+    std::vector<std::pair<FiveTuple, FlowId>> flows(m_flowMap.begin(), m_flowMap.end());
+    std::sort(flows.begin(), flows.end());
+
     indent += 2;
-    for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
+    for (auto iter = flows.begin(); iter != flows.end(); iter++)
     {
         Indent(os, indent);
         os << "<Flow flowId=\"" << iter->second << "\""
@@ -27,6 +27,7 @@
 
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -50,6 +51,14 @@ class Ipv6FlowClassifier : public FlowClassifier
         uint16_t destinationPort;       //!< Destination port
     };
 
+    /// Hash function of the FiveTuple, to index the flows
+    struct FiveTupleHash
+    {
+        /// \param tuple the FiveTuple to hash
+        /// \returns the hash of the FiveTuple
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
     Ipv6FlowClassifier();
 
     /// \brief try to classify the packet into flow-id and packet-id
@@ -95,9 +104,9 @@ class Ipv6FlowClassifier : public FlowClassifier
 
   private:
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
+    std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
     /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+    std::unordered_map<FlowId, FlowPacketId> m_flowPktIdMap;
     /// Map FlowIds to (DSCP value, packet count) pairs
     std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>> m_flowDscpMap;
 };
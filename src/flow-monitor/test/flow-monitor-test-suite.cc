@@ -0,0 +1,438 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/double.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup flow-monitor-tests
+ * FlowMonitor test suite.
+ */
+
+/**
+ * \ingroup flow-monitor
+ * \defgroup flow-monitor-tests FlowMonitor tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-tests
+ *
+ * \brief A probe which only reports what the tests tell it to.
+ */
+class TestFlowProbe : public FlowProbe
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param monitor the FlowMonitor to report to
+     */
+    TestFlowProbe(Ptr<FlowMonitor> monitor)
+        : FlowProbe(monitor)
+    {
+    }
+};
+
+/**
+ * \ingroup flow-monitor-tests
+ *
+ * \brief Insert and remove the tracked packets around the end of the
+ * table, where the linear probing wraps around, and while the table grows.
+ */
+class FlowMonitorPacketTableTestCase : public TestCase
+{
+  public:
+    FlowMonitorPacketTableTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \param flowId the flow id
+     * \param packetId the packet id
+     * \returns the home position of the packet in the initial table of 1024 entries
+     */
+    static uint32_t GetHome(uint32_t flowId, uint32_t packetId);
+};
+
+FlowMonitorPacketTableTestCase::FlowMonitorPacketTableTestCase()
+    : TestCase("Tracked packet table wraparound and growth")
+{
+}
+
+uint32_t
+FlowMonitorPacketTableTestCase::GetHome(uint32_t flowId, uint32_t packetId)
+{
+    uint64_t key = (uint64_t(flowId) << 32) | packetId;
+    return ((key * 0x9e3779b97f4a7c15ULL) >> 32) & 1023;
+}
+
+void
+FlowMonitorPacketTableTestCase::DoRun()
+{
+    Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor>();
+    Ptr<FlowProbe> probe = CreateObject<TestFlowProbe>(monitor);
+    monitor->StartRightNow();
+
+    // Packets whose home is one of the last two positions, which spill
+    // over to the start of the table, then packets whose home is there
+    std::vector<uint32_t> packets;
+    std::vector<uint32_t> starts;
+    for (uint32_t packetId = 0; packets.size() < 6 || starts.size() < 4; packetId++)
+    {
+        uint32_t home = GetHome(1, packetId);
+        if (home >= 1022 && packets.size() < 6)
+        {
+            packets.push_back(packetId);
+        }
+        else if (home <= 1 && starts.size() < 4)
+        {
+            starts.push_back(packetId);
+        }
+    }
+    packets.insert(packets.end(), starts.begin(), starts.end());
+    for (uint32_t packetId : packets)
+    {
+        monitor->ReportFirstTx(probe, 1, packetId, 100);
+    }
+
+    // Removing the first packets moves back the following ones across
+    // the end of the table, which must all still be found
+    monitor->ReportDrop(probe, 1, packets[0], 100, 0);
+    monitor->ReportDrop(probe, 1, packets[1], 100, 0);
+    for (std::size_t i = packets.size(); i > 2; i--)
+    {
+        monitor->ReportLastRx(probe, 1, packets[i - 1], 100);
+    }
+    // The packets removed are no longer found
+    monitor->ReportLastRx(probe, 1, packets[0], 100);
+    monitor->ReportLastRx(probe, 1, packets[packets.size() - 1], 100);
+
+    const FlowMonitor::FlowStats& wrapped = monitor->GetFlowStats().at(1);
+    NS_TEST_EXPECT_MSG_EQ(wrapped.txPackets, packets.size(), "Wrong packets transmitted");
+    NS_TEST_EXPECT_MSG_EQ(wrapped.lostPackets, 2, "Wrong packets dropped");
+    NS_TEST_EXPECT_MSG_EQ(wrapped.rxPackets,
+                          packets.size() - 2,
+                          "Packets not found across the end of the table");
+
+    // Enough packets to grow the table a few times, removed in an order
+    // unrelated to the insertion one
+    const uint32_t nPackets = 5000;
+    for (uint32_t packetId = 0; packetId < nPackets; packetId++)
+    {
+        monitor->ReportFirstTx(probe, 2, packetId, 100);
+    }
+    for (uint32_t packetId = 0; packetId < nPackets; packetId += 2)
+    {
+        monitor->ReportLastRx(probe, 2, packetId, 100);
+    }
+    for (uint32_t packetId = nPackets - 1; packetId < nPackets; packetId -= 2)
+    {
+        monitor->ReportLastRx(probe, 2, packetId, 100);
+    }
+    NS_TEST_EXPECT_MSG_EQ(monitor->GetFlowStats().at(2).rxPackets,
+                          nPackets,
+                          "Packets not found after growth");
+    // The packets received are no longer found
+    for (uint32_t packetId = 0; packetId < nPackets; packetId += 7)
+    {
+        monitor->ReportLastRx(probe, 2, packetId, 100);
+    }
+    NS_TEST_EXPECT_MSG_EQ(monitor->GetFlowStats().at(2).rxPackets,
+                          nPackets,
+                          "Removed packets found after growth");
+
+    // No packet is left tracked
+    monitor->CheckForLostPackets(Seconds(0));
+    NS_TEST_EXPECT_MSG_EQ(monitor->GetFlowStats().at(1).lostPackets, 2, "Packet left tracked");
+    NS_TEST_EXPECT_MSG_EQ(monitor->GetFlowStats().at(2).lostPackets, 0, "Packet left tracked");
+
+    monitor->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup flow-monitor-tests
+ *
+ * \brief Detect the lost packets through the periodic check of the loss
+ * wheel, with the forwarded packets checked again later.
+ */
+class FlowMonitorLossTestCase : public TestCase
+{
+  public:
+    FlowMonitorLossTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check the number of packets lost so far.
+     *
+     * \param expected the expected number of lost packets
+     */
+    void CheckLost(uint32_t expected);
+
+    Ptr<FlowMonitor> m_monitor; //!< the monitor under test
+};
+
+FlowMonitorLossTestCase::FlowMonitorLossTestCase()
+    : TestCase("Loss detection through the loss wheel")
+{
+}
+
+void
+FlowMonitorLossTestCase::CheckLost(uint32_t expected)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_monitor->GetFlowStats().at(1).lostPackets,
+                          expected,
+                          "Wrong lost packets at " << Simulator::Now().As(Time::S));
+}
+
+void
+FlowMonitorLossTestCase::DoRun()
+{
+    m_monitor = CreateObjectWithAttributes<FlowMonitor>("MaxPerHopDelay",
+                                                        TimeValue(Seconds(2)));
+    Ptr<FlowProbe> probe = CreateObject<TestFlowProbe>(m_monitor);
+    m_monitor->StartRightNow();
+
+    // Packets 0-9 are sent at 0.1s, 0-3 are received, 4-5 are forwarded
+    // at 1.5s and 6-9 are never seen again
+    for (uint32_t packetId = 0; packetId < 10; packetId++)
+    {
+        Simulator::Schedule(Seconds(0.1),
+                            &FlowMonitor::ReportFirstTx,
+                            m_monitor,
+                            probe,
+                            1,
+                            packetId,
+                            100);
+    }
+    for (uint32_t packetId = 0; packetId < 4; packetId++)
+    {
+        Simulator::Schedule(Seconds(1),
+                            &FlowMonitor::ReportLastRx,
+                            m_monitor,
+                            probe,
+                            1,
+                            packetId,
+                            100);
+    }
+    for (uint32_t packetId = 4; packetId < 6; packetId++)
+    {
+        Simulator::Schedule(Seconds(1.5),
+                            &FlowMonitor::ReportForwarding,
+                            m_monitor,
+                            probe,
+                            1,
+                            packetId,
+                            100);
+    }
+
+    // The packets are due 2s after they were last seen, and found by the
+    // check of the period they are due in
+    Simulator::Schedule(Seconds(2.5), &FlowMonitorLossTestCase::CheckLost, this, 0);
+    Simulator::Schedule(Seconds(3.5), &FlowMonitorLossTestCase::CheckLost, this, 4);
+    Simulator::Schedule(Seconds(4.5), &FlowMonitorLossTestCase::CheckLost, this, 6);
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    const FlowMonitor::FlowStats& stats = m_monitor->GetFlowStats().at(1);
+    NS_TEST_EXPECT_MSG_EQ(stats.txPackets, 10, "Wrong packets transmitted");
+    NS_TEST_EXPECT_MSG_EQ(stats.rxPackets, 4, "Wrong packets received");
+    NS_TEST_EXPECT_MSG_EQ(stats.lostPackets, 6, "Wrong packets lost");
+
+    m_monitor->Dispose();
+    m_monitor = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup flow-monitor-tests
+ *
+ * \brief Compare the statistics of a sample of the packets to the ones of
+ * all the packets, and check that the flows are reported even when none
+ * of their packets is sampled.
+ */
+class FlowMonitorSamplingTestCase : public TestCase
+{
+  public:
+    FlowMonitorSamplingTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Report the same packets to a monitor: every tenth packet is dropped,
+     * the others are received after a delay of flowId milliseconds.
+     *
+     * \param samplingRate the sampling rate of the monitor
+     * \returns the monitor
+     */
+    Ptr<FlowMonitor> Replay(double samplingRate);
+
+    /**
+     * Report the transmission of a packet, and its drop or reception.
+     *
+     * \param monitor the monitor
+     * \param probe the probe
+     * \param flowId the flow id
+     * \param packetId the packet id
+     */
+    static void Send(Ptr<FlowMonitor> monitor,
+                     Ptr<FlowProbe> probe,
+                     uint32_t flowId,
+                     uint32_t packetId);
+
+    static constexpr uint32_t N_FLOWS = 4;      //!< Number of flows
+    static constexpr uint32_t N_PACKETS = 2000; //!< Number of packets per flow
+};
+
+FlowMonitorSamplingTestCase::FlowMonitorSamplingTestCase()
+    : TestCase("Sampled statistics match the unsampled ones")
+{
+}
+
+void
+FlowMonitorSamplingTestCase::Send(Ptr<FlowMonitor> monitor,
+                                  Ptr<FlowProbe> probe,
+                                  uint32_t flowId,
+                                  uint32_t packetId)
+{
+    monitor->ReportFirstTx(probe, flowId, packetId, 1000);
+    if (packetId % 10 == 0)
+    {
+        Simulator::Schedule(MilliSeconds(flowId),
+                            &FlowMonitor::ReportDrop,
+                            monitor,
+                            probe,
+                            flowId,
+                            packetId,
+                            1000,
+                            0);
+    }
+    else
+    {
+        Simulator::Schedule(MilliSeconds(flowId),
+                            &FlowMonitor::ReportLastRx,
+                            monitor,
+                            probe,
+                            flowId,
+                            packetId,
+                            1000);
+    }
+}
+
+Ptr<FlowMonitor>
+FlowMonitorSamplingTestCase::Replay(double samplingRate)
+{
+    Ptr<FlowMonitor> monitor =
+        CreateObjectWithAttributes<FlowMonitor>("SamplingRate", DoubleValue(samplingRate));
+    Ptr<FlowProbe> probe = CreateObject<TestFlowProbe>(monitor);
+    monitor->StartRightNow();
+    for (uint32_t packetId = 0; packetId < N_PACKETS; packetId++)
+    {
+        for (uint32_t flowId = 1; flowId <= N_FLOWS; flowId++)
+        {
+            Simulator::Schedule(MicroSeconds(100 * packetId),
+                                &FlowMonitorSamplingTestCase::Send,
+                                monitor,
+                                probe,
+                                flowId,
+                                packetId);
+        }
+    }
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    monitor->StopRightNow();
+    // The statistics outlive the probes
+    monitor->Dispose();
+    Simulator::Destroy();
+    return monitor;
+}
+
+void
+FlowMonitorSamplingTestCase::DoRun()
+{
+    Ptr<FlowMonitor> all = Replay(1.0);
+    Ptr<FlowMonitor> sampled = Replay(0.5);
+    Ptr<FlowMonitor> none = Replay(0.0);
+
+    for (uint32_t flowId = 1; flowId <= N_FLOWS; flowId++)
+    {
+        const FlowMonitor::FlowStats& allStats = all->GetFlowStats().at(flowId);
+        NS_TEST_ASSERT_MSG_EQ(allStats.txPackets, N_PACKETS, "Wrong packets transmitted");
+        NS_TEST_ASSERT_MSG_EQ(allStats.lostPackets, N_PACKETS / 10, "Wrong packets lost");
+
+        // The sample holds about half the packets, and the same delay and
+        // loss ratio
+        NS_TEST_ASSERT_MSG_EQ(sampled->GetFlowStats().count(flowId),
+                              1,
+                              "Sampled flow not reported");
+        const FlowMonitor::FlowStats& stats = sampled->GetFlowStats().at(flowId);
+        NS_TEST_EXPECT_MSG_EQ_TOL(double(stats.txPackets) / allStats.txPackets,
+                                  0.5,
+                                  0.05,
+                                  "Sample not proportional to the sampling rate");
+        NS_TEST_EXPECT_MSG_EQ(stats.txBytes, stats.txPackets * 1000, "Wrong bytes transmitted");
+        NS_TEST_EXPECT_MSG_EQ(stats.rxPackets + stats.lostPackets,
+                              stats.txPackets,
+                              "Sampled packets neither received nor lost");
+        NS_TEST_EXPECT_MSG_EQ_TOL(double(stats.lostPackets) / stats.txPackets,
+                                  double(allStats.lostPackets) / allStats.txPackets,
+                                  0.03,
+                                  "Sampled loss ratio differs");
+        NS_TEST_EXPECT_MSG_EQ(stats.delaySum / stats.rxPackets,
+                              allStats.delaySum / allStats.rxPackets,
+                              "Sampled mean delay differs");
+
+        // None of the packets is sampled, but the flow is still reported
+        NS_TEST_ASSERT_MSG_EQ(none->GetFlowStats().count(flowId), 1, "Unsampled flow not reported");
+        const FlowMonitor::FlowStats& empty = none->GetFlowStats().at(flowId);
+        NS_TEST_EXPECT_MSG_EQ(empty.txPackets, 0, "Unsampled packets transmitted");
+        NS_TEST_EXPECT_MSG_EQ(empty.rxPackets, 0, "Unsampled packets received");
+        NS_TEST_EXPECT_MSG_EQ(empty.lostPackets, 0, "Unsampled packets lost");
+    }
+}
+
+/**
+ * \ingroup flow-monitor-tests
+ *
+ * \brief FlowMonitor test suite.
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+  public:
+    FlowMonitorTestSuite();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite()
+    : TestSuite("flow-monitor", UNIT)
+{
+    AddTestCase(new FlowMonitorPacketTableTestCase(), TestCase::QUICK);
+    AddTestCase(new FlowMonitorLossTestCase(), TestCase::QUICK);
+    AddTestCase(new FlowMonitorSamplingTestCase(), TestCase::QUICK);
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite; //!< Static variable for test initialization
@@ -18,16 +18,233 @@
  */
 #include "ipv4-global-routing-helper.h"
 
+#include "ns3/channel.h"
+#include "ns3/global-route-manager.h"
 #include "ns3/global-router-interface.h"
+#include "ns3/hash.h"
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/ipv4-list-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("GlobalRoutingHelper");
 
+namespace
+{
+
+/// Magic number of a routing snapshot.
+const char SNAPSHOT_MAGIC[8] = "NS3GRSN";
+/// Version of the routing snapshot format.
+const uint32_t SNAPSHOT_VERSION = 1;
+
+/**
+ * Hash everything the global routes depend on: the nodes, the links
+ * between their devices, their IPv4 interfaces and their injected routes.
+ *
+ * \returns the hash of the topology
+ */
+uint64_t
+HashTopology()
+{
+    std::vector<uint32_t> values;
+    values.push_back(NodeList::GetNNodes());
+    values.push_back(Simulator::GetSystemId());
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<Node> node = *i;
+        values.push_back(node->GetId());
+        values.push_back(node->GetSystemId());
+        values.push_back(node->GetNDevices());
+        for (uint32_t j = 0; j < node->GetNDevices(); ++j)
+        {
+            Ptr<Channel> channel = node->GetDevice(j)->GetChannel();
+            values.push_back(channel ? channel->GetNDevices() : 0);
+            for (std::size_t k = 0; channel && k < channel->GetNDevices(); ++k)
+            {
+                Ptr<NetDevice> device = channel->GetDevice(k);
+                values.push_back(device->GetNode()->GetId());
+                values.push_back(device->GetIfIndex());
+            }
+        }
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        values.push_back(ipv4 ? ipv4->GetNInterfaces() : 0);
+        for (uint32_t j = 0; ipv4 && j < ipv4->GetNInterfaces(); ++j)
+        {
+            values.push_back(ipv4->GetNetDevice(j)->GetIfIndex());
+            values.push_back(ipv4->IsUp(j));
+            values.push_back(ipv4->IsForwarding(j));
+            values.push_back(ipv4->GetMetric(j));
+            values.push_back(ipv4->GetNAddresses(j));
+            for (uint32_t k = 0; k < ipv4->GetNAddresses(j); ++k)
+            {
+                values.push_back(ipv4->GetAddress(j, k).GetLocal().Get());
+                values.push_back(ipv4->GetAddress(j, k).GetMask().Get());
+            }
+        }
+        Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
+        values.push_back(router ? router->GetNInjectedRoutes() + 1 : 0);
+        for (uint32_t j = 0; router && j < router->GetNInjectedRoutes(); ++j)
+        {
+            Ipv4RoutingTableEntry* route = router->GetInjectedRoute(j);
+            values.push_back(route->GetDest().Get());
+            values.push_back(route->GetDestNetworkMask().Get());
+            values.push_back(route->GetGateway().Get());
+            values.push_back(route->GetInterface());
+        }
+    }
+    return Hash64(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint32_t));
+}
+
+/**
+ * Get the global routing protocol of the nodes routed by this system.
+ *
+ * \param node the node
+ * \returns the global routing protocol of the node, or null
+ */
+Ptr<Ipv4GlobalRouting>
+GetGlobalRouting(Ptr<Node> node)
+{
+    Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
+    if (!router || node->GetSystemId() != Simulator::GetSystemId())
+    {
+        return nullptr;
+    }
+    return router->GetRoutingProtocol();
+}
+
+/**
+ * Get the name of the snapshot file of this system.  Each rank of a
+ * distributed simulation only routes its own nodes, and keeps their routes
+ * in a file of its own.
+ *
+ * \param snapshot the name of the snapshot
+ * \returns the name of the snapshot file
+ */
+std::string
+GetSnapshotFilename(const std::string& snapshot)
+{
+    uint32_t systemId = Simulator::GetSystemId();
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        if ((*i)->GetSystemId() != systemId)
+        {
+            return snapshot + "." + std::to_string(systemId);
+        }
+    }
+    return snapshot;
+}
+
+/**
+ * Restore the routes of all the nodes from a routing snapshot.
+ *
+ * \param snapshot the name of the snapshot file
+ * \param key the hash of the topology
+ * \returns true if the snapshot matches the topology and was read
+ */
+bool
+ReadSnapshot(const std::string& snapshot, uint64_t key)
+{
+    std::ifstream is(snapshot, std::ios::binary);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint32_t version;
+    uint64_t snapshotKey;
+    uint32_t nNodes;
+    if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+        !is.read(reinterpret_cast<char*>(&version), sizeof(version)) ||
+        version != SNAPSHOT_VERSION ||
+        !is.read(reinterpret_cast<char*>(&snapshotKey), sizeof(snapshotKey)) ||
+        snapshotKey != key || !is.read(reinterpret_cast<char*>(&nNodes), sizeof(nNodes)))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        uint32_t id;
+        if (!is.read(reinterpret_cast<char*>(&id), sizeof(id)) || id >= NodeList::GetNNodes())
+        {
+            return false;
+        }
+        Ptr<Ipv4GlobalRouting> routing = GetGlobalRouting(NodeList::GetNode(id));
+        if (!routing || !routing->DeserializeRoutes(is))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Write the routes of all the nodes to a routing snapshot.
+ *
+ * \param snapshot the name of the snapshot file
+ * \param key the hash of the topology
+ */
+void
+WriteSnapshot(const std::string& snapshot, uint64_t key)
+{
+    std::vector<Ptr<Node>> nodes;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        if (GetGlobalRouting(*i))
+        {
+            nodes.push_back(*i);
+        }
+    }
+    // Written to a temporary file of a unique name and renamed, so that
+    // concurrent runs of a sweep never read or write a partial snapshot
+    std::string temporary = snapshot + ".XXXXXX";
+    int fd = mkstemp(temporary.data());
+    if (fd < 0)
+    {
+        NS_LOG_WARN("Unable to write the routing snapshot " << snapshot);
+        return;
+    }
+    // mkstemp creates the file readable by its owner only
+    mode_t mask = umask(0);
+    umask(mask);
+    fchmod(fd, 0666 & ~mask);
+    close(fd);
+    {
+        std::ofstream os(temporary, std::ios::binary | std::ios::trunc);
+        uint32_t nNodes = nodes.size();
+        os.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        os.write(reinterpret_cast<const char*>(&SNAPSHOT_VERSION), sizeof(SNAPSHOT_VERSION));
+        os.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        os.write(reinterpret_cast<const char*>(&nNodes), sizeof(nNodes));
+        for (const auto& node : nodes)
+        {
+            uint32_t id = node->GetId();
+            os.write(reinterpret_cast<const char*>(&id), sizeof(id));
+            GetGlobalRouting(node)->SerializeRoutes(os);
+        }
+        if (!os)
+        {
+            NS_LOG_WARN("Unable to write the routing snapshot " << snapshot);
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+    if (std::rename(temporary.c_str(), snapshot.c_str()) != 0)
+    {
+        NS_LOG_WARN("Unable to write the routing snapshot " << snapshot);
+        std::remove(temporary.c_str());
+    }
+}
+
+} // unnamed namespace
+
 Ipv4GlobalRoutingHelper::Ipv4GlobalRoutingHelper()
 {
 }
@@ -66,6 +283,23 @@ Ipv4GlobalRoutingHelper::PopulateRoutingTables()
     std::cout << "init routes end" << std::endl;
 }
 
+void
+Ipv4GlobalRoutingHelper::PopulateRoutingTables(const std::string& snapshot)
+{
+    NS_LOG_FUNCTION(snapshot);
+    uint64_t key = HashTopology();
+    std::string filename = GetSnapshotFilename(snapshot);
+    if (ReadSnapshot(filename, key))
+    {
+        NS_LOG_INFO("Restored the routes from " << filename);
+        return;
+    }
+    // Drop the routes of a snapshot which failed to read halfway
+    GlobalRouteManager::DeleteGlobalRoutes();
+    PopulateRoutingTables();
+    WriteSnapshot(filename, key);
+}
+
 void
 Ipv4GlobalRoutingHelper::RecomputeRoutingTables()
 {
@@ -23,6 +23,8 @@
 
 #include "ns3/node-container.h"
 
+#include <string>
+
 namespace ns3
 {
 
@@ -76,6 +78,31 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      *
      */
     static void PopulateRoutingTables();
+    /**
+     * \brief Initialize the routing tables of the nodes from a routing
+     * snapshot, or build them and write the snapshot.
+     *
+     * The snapshot is a versioned binary file holding the global routes
+     * of every node of this system, keyed by a hash of the topology: the
+     * nodes, the links between their devices, the addresses, metrics and
+     * state of their IPv4 interfaces, and the routes injected into their
+     * GlobalRouter.  If the file holds a snapshot of the same topology,
+     * the routes are restored from it, and neither the routing database
+     * nor the SPF computations are built.  Otherwise, this function does
+     * what PopulateRoutingTables() does, then writes the snapshot to the
+     * file, so that repeated runs of the same topology, such as the runs
+     * of a parameter sweep, build the routes only once.
+     *
+     * In a distributed simulation, each system only routes its own nodes:
+     * the snapshot of a system is kept in the file of the given name
+     * followed by a dot and the system id.
+     *
+     * The topology must be complete, with all the addresses assigned,
+     * when this function is called.
+     *
+     * \param snapshot the name of the snapshot file
+     */
+    static void PopulateRoutingTables(const std::string& snapshot);
     /**
      * \brief Remove all routes that were previously installed in a prior call
      * to either PopulateRoutingTables() or RecomputeRoutingTables(), and
@@ -30,6 +30,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -339,6 +340,75 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
     NS_ASSERT(false);
 }
 
+void
+Ipv4GlobalRouting::SerializeRoutes(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this);
+    // Each list is written as its size followed by the destination,
+    // mask, gateway and interface of each route, in host byte order
+    for (const auto* routes : {&m_hostRoutes, &m_networkRoutes, &m_ASexternalRoutes})
+    {
+        std::vector<uint32_t> fields;
+        fields.reserve(1 + 4 * routes->size());
+        fields.push_back(routes->size());
+        for (const auto* route : *routes)
+        {
+            fields.push_back(route->GetDest().Get());
+            fields.push_back(route->GetDestNetworkMask().Get());
+            fields.push_back(route->GetGateway().Get());
+            fields.push_back(route->GetInterface());
+        }
+        os.write(reinterpret_cast<const char*>(fields.data()), fields.size() * sizeof(uint32_t));
+    }
+}
+
+bool
+Ipv4GlobalRouting::DeserializeRoutes(std::istream& is)
+{
+    NS_LOG_FUNCTION(this);
+    for (auto* routes : {&m_hostRoutes, &m_networkRoutes, &m_ASexternalRoutes})
+    {
+        uint32_t size;
+        if (!is.read(reinterpret_cast<char*>(&size), sizeof(size)))
+        {
+            return false;
+        }
+        // Read in batches, so that the size of a corrupt list makes the
+        // read fail at the end of the stream instead of being allocated
+        std::vector<uint32_t> fields;
+        for (uint32_t done = 0; done < size;)
+        {
+            uint32_t batch = std::min<uint32_t>(size - done, 1024);
+            fields.resize(4 * std::size_t(batch));
+            if (!is.read(reinterpret_cast<char*>(fields.data()), fields.size() * sizeof(uint32_t)))
+            {
+                return false;
+            }
+            for (std::size_t i = 0; i < fields.size(); i += 4)
+            {
+                auto route = new Ipv4RoutingTableEntry();
+                if (routes == &m_hostRoutes)
+                {
+                    *route = Ipv4RoutingTableEntry::CreateHostRouteTo(Ipv4Address(fields[i]),
+                                                                      Ipv4Address(fields[i + 2]),
+                                                                      fields[i + 3]);
+                }
+                else
+                {
+                    *route =
+                        Ipv4RoutingTableEntry::CreateNetworkRouteTo(Ipv4Address(fields[i]),
+                                                                    Ipv4Mask(fields[i + 1]),
+                                                                    Ipv4Address(fields[i + 2]),
+                                                                    fields[i + 3]);
+                }
+                routes->push_back(route);
+            }
+            done += batch;
+        }
+    }
+    return true;
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams(int64_t stream)
 {
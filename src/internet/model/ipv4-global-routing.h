@@ -27,7 +27,9 @@
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 
+#include <istream>
 #include <list>
+#include <ostream>
 #include <stdint.h>
 
 namespace ns3
@@ -222,6 +224,23 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      */
     void RemoveRoute(uint32_t i);
 
+    /**
+     * \brief Write the unicast routes of the table to a routing snapshot.
+     *
+     * \param os The output stream, opened in binary mode.
+     *
+     * \see Ipv4GlobalRoutingHelper::PopulateRoutingTables(const std::string&)
+     */
+    void SerializeRoutes(std::ostream& os) const;
+
+    /**
+     * \brief Add the unicast routes written by SerializeRoutes() to the table.
+     *
+     * \param is The input stream, opened in binary mode.
+     * \return true if all the routes were read.
+     */
+    bool DeserializeRoutes(std::istream& is);
+
     /**
      * Assign a fixed random variable stream number to the random variables
      * used by this model.  Return the number of streams (possibly zero) that
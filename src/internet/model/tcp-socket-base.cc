@@ -1438,14 +1438,14 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
         NS_LOG_LOGIC(this << " Enter zerowindow persist state");
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         NS_LOG_LOGIC("Schedule persist timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
                      << (Simulator::Now() + m_persistTimeout).GetSeconds());
         m_persistEvent =
-            Simulator::Schedule(m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
-        NS_ASSERT(m_persistTimeout == Simulator::GetDelayLeft(m_persistEvent));
+            TimerWheel::Schedule(m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
+        NS_ASSERT(m_persistTimeout == m_persistEvent.GetDelayLeft());
     }
 
     // TCP state machine code in different process functions
@@ -2716,7 +2716,7 @@ TcpSocketBase::DoPeerClose()
         m_dataRetrCount = m_dataRetries; // prevent endless FINs
         NS_LOG_LOGIC("TcpSocketBase " << this << " scheduling LATO1");
         Time lastRto = m_rtt->GetEstimate() + Max(m_clockGranularity, m_rtt->GetVariation() * 4);
-        m_lastAckEvent = Simulator::Schedule(lastRto, &TcpSocketBase::LastAckTimeout, this);
+        m_lastAckEvent = TimerWheel::Schedule(lastRto, &TcpSocketBase::LastAckTimeout, this);
     }
 }
 
@@ -2732,7 +2732,7 @@ TcpSocketBase::Destroy()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2748,7 +2748,7 @@ TcpSocketBase::Destroy6()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2882,7 +2882,7 @@ TcpSocketBase::SendEmptyPacket(uint8_t flags)
         NS_LOG_LOGIC("Schedule retransmission timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
                      << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+        m_retxEvent = TimerWheel::Schedule(m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
     }
 }
 
@@ -3237,7 +3237,7 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
         NS_LOG_LOGIC(this << " SendDataPacket Schedule ReTxTimeout at time "
                           << Simulator::Now().GetSeconds() << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxEvent = TimerWheel::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
 
     m_txTrace(p, header, this);
@@ -3649,10 +3649,10 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
         {
             m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
             m_delAckEvent =
-                Simulator::Schedule(m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
+                TimerWheel::Schedule(m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
             NS_LOG_LOGIC(
                 this << " scheduled delayed ACK at "
-                     << (Simulator::Now() + Simulator::GetDelayLeft(m_delAckEvent)).GetSeconds());
+                     << (Simulator::Now() + m_delAckEvent.GetDelayLeft()).GetSeconds());
         }
     }
 }
@@ -3728,7 +3728,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         // On receiving a "New" ack we restart retransmission timer .. RFC 6298
         // RFC 6298, clause 2.4
@@ -3738,7 +3738,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
         NS_LOG_LOGIC(this << " Schedule ReTxTimeout at time " << Simulator::Now().GetSeconds()
                           << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxEvent = TimerWheel::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
 
     // Note the highest ACK and tell app to send more
@@ -3757,7 +3757,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // No retransmit timer if no data to retransmit
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
     }
 }
@@ -3929,7 +3929,7 @@ TcpSocketBase::LastAckTimeout()
         SendEmptyPacket(TcpHeader::FIN | TcpHeader::ACK);
         NS_LOG_LOGIC("TcpSocketBase " << this << " rescheduling LATO1");
         Time lastRto = m_rtt->GetEstimate() + Max(m_clockGranularity, m_rtt->GetVariation() * 4);
-        m_lastAckEvent = Simulator::Schedule(lastRto, &TcpSocketBase::LastAckTimeout, this);
+        m_lastAckEvent = TimerWheel::Schedule(lastRto, &TcpSocketBase::LastAckTimeout, this);
     }
 }
 
@@ -3992,7 +3992,7 @@ TcpSocketBase::PersistTimeout()
     NS_LOG_LOGIC("Schedule persist timeout at time "
                  << Simulator::Now().GetSeconds() << " to expire at time "
                  << (Simulator::Now() + m_persistTimeout).GetSeconds());
-    m_persistEvent = Simulator::Schedule(m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
+    m_persistEvent = TimerWheel::Schedule(m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
 }
 
 void
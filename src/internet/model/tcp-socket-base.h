@@ -28,6 +28,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/node.h"
 #include "ns3/sequence-number.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/timer.h"
 #include "ns3/traced-value.h"
 
@@ -1276,11 +1277,13 @@ class TcpSocketBase : public TcpSocket
 
   protected:
     // Counters and events
-    EventId m_retxEvent{};     //!< Retransmission event
-    EventId m_lastAckEvent{};  //!< Last ACK timeout event
-    EventId m_delAckEvent{};   //!< Delayed ACK timeout event
-    EventId m_persistEvent{};  //!< Persist event: Send 1 byte to probe for a non-zero Rx window
-    EventId m_timewaitEvent{}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
+    TimerWheel::Id m_retxEvent{};    //!< Retransmission event
+    TimerWheel::Id m_lastAckEvent{}; //!< Last ACK timeout event
+    TimerWheel::Id m_delAckEvent{};  //!< Delayed ACK timeout event
+    TimerWheel::Id m_persistEvent{}; //!< Persist event: Send 1 byte to probe for a non-zero Rx
+                                     //!< window
+    EventId m_timewaitEvent{};       //!< TIME_WAIT expiration event: Move this socket to CLOSED
+                                     //!< state
 
     // ACK management
     uint32_t m_dupAckCount{0};    //!< Dupack counter
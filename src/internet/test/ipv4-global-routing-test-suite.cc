@@ -16,6 +16,7 @@
 #include "ns3/boolean.h"
 #include "ns3/bridge-helper.h"
 #include "ns3/config.h"
+#include "ns3/global-route-manager.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -37,10 +38,15 @@
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
 #include "ns3/string.h"
+#include "ns3/system-path.h"
 #include "ns3/test.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
 #include <vector>
 
 using namespace ns3;
@@ -1311,6 +1317,172 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting snapshot test
+ *
+ * Builds the routes of the two link topology into a snapshot, restores
+ * them from it, and checks that a change of the topology invalidates it
+ * and that a corrupt snapshot is rebuilt.
+ */
+class SnapshotTest : public TestCase
+{
+  public:
+    void DoSetup() override;
+    void DoRun() override;
+    SnapshotTest();
+
+  private:
+    /**
+     * \param node the node
+     * \returns the destination, gateway and interface of each global route of the node
+     */
+    std::vector<uint32_t> GetRoutes(uint32_t node) const;
+
+    /**
+     * \param filename the name of a file
+     * \returns the content of the file
+     */
+    std::string ReadFile(const std::string& filename) const;
+
+    NodeContainer m_nodes; //!< Nodes used in the test.
+};
+
+SnapshotTest::SnapshotTest()
+    : TestCase("Global routing restored from a routing snapshot")
+{
+}
+
+void
+SnapshotTest::DoSetup()
+{
+    m_nodes.Create(3);
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer net = simpleHelper.Install(m_nodes.Get(0), channel);
+    net.Add(simpleHelper.Install(m_nodes.Get(1), channel));
+
+    Ptr<SimpleChannel> channel2 = CreateObject<SimpleChannel>();
+    NetDeviceContainer net2 = simpleHelper.Install(m_nodes.Get(1), channel2);
+    net2.Add(simpleHelper.Install(m_nodes.Get(2), channel2));
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.252");
+    ipv4.Assign(net);
+    ipv4.SetBase("10.1.2.0", "255.255.255.252");
+    ipv4.Assign(net2);
+}
+
+std::vector<uint32_t>
+SnapshotTest::GetRoutes(uint32_t node) const
+{
+    Ptr<Ipv4RoutingProtocol> protocol =
+        m_nodes.Get(node)->GetObject<Ipv4L3Protocol>()->GetRoutingProtocol();
+    Ptr<Ipv4GlobalRouting> routing = protocol->GetObject<Ipv4GlobalRouting>();
+    std::vector<uint32_t> routes;
+    for (uint32_t i = 0; i < routing->GetNRoutes(); ++i)
+    {
+        Ipv4RoutingTableEntry* route = routing->GetRoute(i);
+        routes.push_back(route->GetDest().Get());
+        routes.push_back(route->GetGateway().Get());
+        routes.push_back(route->GetInterface());
+    }
+    return routes;
+}
+
+std::string
+SnapshotTest::ReadFile(const std::string& filename) const
+{
+    std::ifstream is(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+}
+
+void
+SnapshotTest::DoRun()
+{
+    std::string snapshot = CreateTempDirFilename("global-routes.snapshot");
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables(snapshot);
+    std::string written = ReadFile(snapshot);
+    NS_TEST_ASSERT_MSG_EQ(written.empty(), false, "Error-- no snapshot written");
+
+    std::vector<std::vector<uint32_t>> built;
+    for (uint32_t i = 0; i < m_nodes.GetN(); ++i)
+    {
+        built.push_back(GetRoutes(i));
+    }
+    NS_TEST_ASSERT_MSG_EQ(built[1].size(), 12, "Error-- wrong number of routes");
+
+    GlobalRouteManager::DeleteGlobalRoutes();
+    NS_TEST_ASSERT_MSG_EQ(GetRoutes(1).size(), 0, "Error-- routes not deleted");
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables(snapshot);
+    for (uint32_t i = 0; i < m_nodes.GetN(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ((GetRoutes(i) == built[i]), true, "Error-- wrong restored routes");
+    }
+    NS_TEST_ASSERT_MSG_EQ((ReadFile(snapshot) == written),
+                          true,
+                          "Error-- snapshot of the same topology rewritten");
+
+    // Shared with the other runs, like any output file
+    struct stat status;
+    NS_TEST_ASSERT_MSG_EQ(stat(snapshot.c_str(), &status), 0, "Error-- no snapshot");
+    mode_t mask = umask(0);
+    umask(mask);
+    NS_TEST_EXPECT_MSG_EQ((status.st_mode & 0777), (0666 & ~mask), "Error-- wrong snapshot mode");
+
+    // A huge route count in a truncated snapshot: the routes are rebuilt
+    // Magic, version, key, number of nodes and id of the first node
+    std::size_t sizeOffset = 8 + 4 + 8 + 4 + 4;
+    std::string corrupt = written.substr(0, sizeOffset + 8);
+    uint32_t size = 0xffffffff;
+    std::memcpy(corrupt.data() + sizeOffset, &size, sizeof(size));
+    std::ofstream(snapshot, std::ios::binary | std::ios::trunc) << corrupt;
+    GlobalRouteManager::DeleteGlobalRoutes();
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables(snapshot);
+    NS_TEST_ASSERT_MSG_EQ((GetRoutes(1) == built[1]), true, "Error-- wrong rebuilt routes");
+    NS_TEST_ASSERT_MSG_EQ((ReadFile(snapshot) == written),
+                          true,
+                          "Error-- corrupt snapshot not rewritten");
+
+    // A different metric gives different routes: the snapshot is rebuilt
+    GlobalRouteManager::DeleteGlobalRoutes();
+    m_nodes.Get(1)->GetObject<Ipv4>()->SetMetric(1, 5);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables(snapshot);
+    NS_TEST_ASSERT_MSG_EQ((ReadFile(snapshot) != written), true, "Error-- stale snapshot used");
+    NS_TEST_ASSERT_MSG_EQ(GetRoutes(1).size(), 12, "Error-- wrong number of routes");
+
+    // With the nodes of another system, this system keeps its own snapshot
+    written = ReadFile(snapshot);
+    GlobalRouteManager::DeleteGlobalRoutes();
+    CreateObject<Node>(1);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables(snapshot);
+    NS_TEST_ASSERT_MSG_EQ(ReadFile(snapshot + ".0").empty(),
+                          false,
+                          "Error-- no snapshot of the system written");
+    NS_TEST_ASSERT_MSG_EQ((ReadFile(snapshot) == written),
+                          true,
+                          "Error-- snapshot of a single system overwritten");
+    NS_TEST_ASSERT_MSG_EQ(GetRoutes(1).size(), 12, "Error-- wrong number of routes");
+
+    // The temporary files are all renamed
+    for (const auto& file : SystemPath::ReadFiles(CreateTempDirFilename("")))
+    {
+        NS_TEST_EXPECT_MSG_EQ(file.find("global-routes.snapshot."),
+                              (file == "global-routes.snapshot.0" ? 0 : std::string::npos),
+                              "Error-- temporary file " << file << " left");
+    }
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1333,6 +1505,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new SnapshotTest, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
@@ -1,6 +1,5 @@
 
 
-#include <format>
 #include <vector>
 #include <unordered_map>
 
@@ -9,6 +8,8 @@
 #include "mpi-application.h"
 #include "mpi-util.h"
 
+NS_LOG_COMPONENT_DEFINE("MPIApplication");
+
 ns3::MPIApplication::MPIApplication(ns3::MPIRankIDType rankID, std::map<ns3::MPIRankIDType, Address> &&addresses, std::map<Address, ns3::MPIRankIDType> &&ranks, std::queue<std::function<CoroutineOperation<void>(MPIApplication &)>> &&functions) noexcept:
         MPIApplication(rankID, std::move(addresses), std::move(ranks), std::move(functions), std::mt19937::default_seed ^ rankID) {}
 
@@ -39,7 +40,10 @@ void ns3::MPIApplication::StopApplication() {
 }
 
 ns3::CoroutineOperation<void> ns3::MPIApplication::run() {
-    std::cout << "mpi application of rank " << rankID << " total functions: " << functions.size() << std::endl;
+    NS_LOG_INFO("mpi application of rank " << rankID << " total functions: " << functions.size());
+    if (progress) {
+        progress->SetTotal(rankID, functions.size());
+    }
     auto start = ns3::Now();
     while (!functions.empty()) {
         if (!running) {
@@ -47,10 +51,13 @@ ns3::CoroutineOperation<void> ns3::MPIApplication::run() {
         }
         co_await functions.front()(*this);
         functions.pop();
-        std::cout << "mpi application of rank " << rankID << " remaining functions: " << functions.size() << " now time: " << ns3::Now() << std::endl;
+        if (progress) {
+            progress->Complete(rankID);
+        }
+        NS_LOG_DEBUG("mpi application of rank " << rankID << " remaining functions: " << functions.size() << " now time: " << ns3::Now());
     }
     auto end = ns3::Now();
-    std::cout << "mpi application of rank " << rankID << " start time: " << start << ", end time: " << end << std::endl;
+    NS_LOG_INFO("mpi application of rank " << rankID << " start time: " << start << ", end time: " << end);
     running = false;
 }
 
@@ -88,6 +95,14 @@ ns3::CoroutineOperation<std::unordered_map<ns3::MPIRankIDType, std::shared_ptr<n
     co_return std::move(sockets);
 }
 
+void ns3::MPIApplication::SetFlowNetwork(std::shared_ptr<FlowNetwork> network) noexcept {
+    flowNetwork = std::move(network);
+}
+
+void ns3::MPIApplication::SetProgress(std::shared_ptr<MPIProgress> progress) noexcept {
+    this->progress = std::move(progress);
+}
+
 ns3::CoroutineOperation<void> ns3::MPIApplication::Initialize(size_t mtu_size) {
     if (status != Status::INITIAL) {
         throw std::runtime_error("MPIApplication::Init() should only be called once");
@@ -95,6 +110,13 @@ ns3::CoroutineOperation<void> ns3::MPIApplication::Initialize(size_t mtu_size) {
     auto cache_limit = mtu_size * 100;
     std::unordered_map<MPIRankIDType, std::shared_ptr<CoroutineSocket>> selfSockets;
     std::unordered_map<MPIRankIDType, std::shared_ptr<CoroutineSocket>> worldSockets = std::move(co_await connect(cache_limit, rankID, GetNode(), addresses, ranks));
+    if (flowNetwork) {
+        for (auto &[rank, socket]: worldSockets) {
+            if (socket->useFlowNetwork(flowNetwork, rankID, rank) != Socket::ERROR_NOTERROR) {
+                throw std::runtime_error("MPIApplication::Initialize() failed to use the flow network");
+            }
+        }
+    }
     worldSockets[rankID] = std::make_shared<CoroutineSocket>(cache_limit); // loopback
     selfSockets[rankID] = std::make_shared<CoroutineSocket>(cache_limit); // loopback
     NS_ASSERT_MSG(selfSockets.size() == 1, "self sockets size is not correct");
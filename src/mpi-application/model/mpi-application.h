@@ -18,6 +18,7 @@
 #include <ns3/network-module.h>
 
 #include "mpi-communicator.h"
+#include "mpi-progress.h"
 
 namespace ns3 {
     using MPIRequestIDType = uint64_t;
@@ -48,6 +49,8 @@ namespace ns3 {
         std::queue<MPIFunction> functions;
         std::shared_ptr<std::mt19937> randomEngine;
         std::unordered_map<MPICommunicatorIDType, MPICommunicator> communicators;
+        std::shared_ptr<FlowNetwork> flowNetwork;
+        std::shared_ptr<MPIProgress> progress;
 
         static CoroutineOperation<std::unordered_map<MPIRankIDType, std::shared_ptr<CoroutineSocket>>> connect(size_t cache_limit, MPIRankIDType rankID, NS3Node node, const std::map<MPIRankIDType, Address> &addresses, const std::map<Address, MPIRankIDType> &ranks);
 
@@ -94,6 +97,17 @@ namespace ns3 {
 
         CoroutineOperation<void> run();
 
+        /**
+         * @brief Transmit the data between the ranks as flows of a flow-level network model, until they congest it.
+         * All the ranks have to share the network, which must be set before Initialize.
+         */
+        void SetFlowNetwork(std::shared_ptr<FlowNetwork> network) noexcept;
+
+        /**
+         * @brief Count the functions completed by this rank in a progress report shared by all the ranks.
+         */
+        void SetProgress(std::shared_ptr<MPIProgress> progress) noexcept;
+
         CoroutineOperation<void> Initialize(size_t mtu_size = 1492);
 
         void Finalize();
@@ -15,6 +15,10 @@ using NS3Error = ns3::Socket::SocketErrno;
 
 // this is just used to test all the templates can be deduced properly
 ns3::CoroutineOperation<void> ns3::MPICommunicator::templateTest() {
+    // initializer lists are kept out of the co_await expressions, which gcc fails to compile
+    std::vector<int> vector{1, 2, 3, 4, 5};
+    std::unordered_map<MPIRankIDType, int> data{{1, 5}, {2, 6}};
+    std::unordered_map<MPIRankIDType, std::tuple<int>> fakeParameters{{1, 1}, {2, 3}};
     co_await Send(RawPacket, 0, Create<Packet>(0));
     co_await Send(FakePacket, 0, 1024);
     co_await Send(0, 0);
@@ -28,69 +32,31 @@ ns3::CoroutineOperation<void> ns3::MPICommunicator::templateTest() {
     co_await SendRecv<int, int>(FakePacket, 0, 1, {}, {});
     co_await SendRecv<std::vector<int>, std::vector<int>>(FakePacket, 0, 1, std::tuple{1}, std::tuple{2});
     co_await SendRecv<std::vector<int>, std::vector<int>>(FakePacket, 0, 1, std::make_tuple(1), std::make_tuple(2));
-    co_await Gather(0, std::vector<int>{1, 2, 3, 4, 5});
+    co_await Gather(0, vector);
     co_await Gather<std::vector<int>>(FakePacket, 0, 16);
-    co_await Gather<std::vector<int>>(FakePacket, 0,
-                                      std::unordered_map<MPIRankIDType, std::tuple<int>>{
-                                              {1, 1},
-                                              {2, 3},
-                                      });
+    co_await Gather<std::vector<int>>(FakePacket, 0, fakeParameters);
     co_await AllGather(1);
     co_await AllGather<int>(FakePacket);
-    co_await AllGather<std::vector<int>>(FakePacket,
-                                         std::unordered_map<MPIRankIDType, std::tuple<int>>{
-                                                 {1, 1},
-                                                 {2, 3},
-                                         });
-    co_await Scatter(0, std::unordered_map<MPIRankIDType, int>{
-            {1, 5},
-            {2, 6},
-    });
+    co_await AllGather<std::vector<int>>(FakePacket, fakeParameters);
+    co_await Scatter(0, data);
     co_await Scatter<std::vector<int>>(FakePacket, 0, 5);
-    co_await Scatter<std::vector<int>>(FakePacket, 0, std::unordered_map<MPIRankIDType, std::tuple<int>>{
-            {1, 1},
-            {2, 3},
-    });
+    co_await Scatter<std::vector<int>>(FakePacket, 0, fakeParameters);
     co_await Broadcast(0, std::optional<int>{1});
     co_await Broadcast<std::vector<int>>(FakePacket, 0, 16);
     co_await Reduce<MPIOperator::MAX>(0, 1);
     co_await Reduce<MPIOperator::SUM>(0, 1);
     co_await Reduce<std::vector<int>>(FakePacket, 0, 16);
-    co_await ReduceScatter<MPIOperator::SUM>(std::unordered_map<MPIRankIDType, int>{
-            {1, 5},
-            {2, 6},
-    });
-    co_await ReduceScatter<std::vector<int>>(FakePacket, std::unordered_map<MPIRankIDType, std::tuple<int>>{
-            {1, 1},
-            {2, 3},
-    });
+    co_await ReduceScatter<MPIOperator::SUM>(data);
+    co_await ReduceScatter<std::vector<int>>(FakePacket, fakeParameters);
     co_await Barrier();
     co_await AllReduce<MPIOperator::MAX>(1);
     co_await AllReduce<MPIOperator::SUM>(1);
     co_await AllReduce<std::vector<int>>(FakePacket, 16);
     co_await RingAllReduce<uint8_t>(FakePacket, 1024);
-    co_await AllToAll(std::unordered_map<MPIRankIDType, int>{
-            {1, 5},
-            {2, 6},
-    });
-    co_await AllToAll<int, short>(std::unordered_map<MPIRankIDType, int>{
-            {1, 5},
-            {2, 6},
-    });
-    co_await AllToAll<std::vector<int>>(FakePacket, std::unordered_map<MPIRankIDType, std::tuple<int>>{
-            {1, 1},
-            {2, 3},
-    }, std::unordered_map<MPIRankIDType, std::tuple<int>>{
-            {1, 1},
-            {2, 3},
-    });
-    co_await AllToAll<std::vector<int>, std::vector<short>>(FakePacket, std::unordered_map<MPIRankIDType, std::tuple<int>>{
-            {1, 1},
-            {2, 3},
-    }, std::unordered_map<MPIRankIDType, std::tuple<int>>{
-            {1, 1},
-            {2, 3},
-    });
+    co_await AllToAll(data);
+    co_await AllToAll<int, short>(data);
+    co_await AllToAll<std::vector<int>>(FakePacket, fakeParameters, fakeParameters);
+    co_await AllToAll<std::vector<int>, std::vector<short>>(FakePacket, fakeParameters, fakeParameters);
 }
 
 ns3::MPICommunicator::MPICommunicator(ns3::MPIRankIDType rankID, const std::shared_ptr<std::mt19937> &randomEngine, std::unordered_map<MPIRankIDType, std::shared_ptr<CoroutineSocket>> &&sockets) noexcept:
@@ -103,7 +69,7 @@ ns3::MPICommunicator::MPICommunicator(ns3::MPIRankIDType rankID, const std::shar
 }
 
 ns3::CoroutineOperation<void> ns3::MPICommunicator::Send(MPIRawPacket, MPIRankIDType rank, NS3Packet packet) {
-    NS_LOG_DEBUG(std::format("{} send raw data of size {} to rank {}", rankID, packet->GetSize(), rank));
+    NS_LOG_DEBUG(rankID << " send raw data of size " << packet->GetSize() << " to rank " << rank);
     auto &socket = *sockets[rank];
     auto [size, error] = co_await socket.send(packet);
     if (error != NS3Error::ERROR_NOTERROR) {
@@ -112,12 +78,12 @@ ns3::CoroutineOperation<void> ns3::MPICommunicator::Send(MPIRawPacket, MPIRankID
 }
 
 ns3::CoroutineOperation<void> ns3::MPICommunicator::Send(MPIFakePacket, MPIRankIDType rank, std::size_t size) {
-    NS_LOG_DEBUG(std::format("{} send fake data of size {} to rank {}", rankID, size, rank));
+    NS_LOG_DEBUG(rankID << " send fake data of size " << size << " to rank " << rank);
     co_await Send(RawPacket, rank, Create<Packet>(size));
 }
 
 ns3::CoroutineOperation<NS3Packet> ns3::MPICommunicator::Recv(MPIRawPacket, MPIRankIDType rank, std::size_t size) {
-    NS_LOG_DEBUG(std::format("{} receive raw data of size{} from rank {}", rankID, size, rank));
+    NS_LOG_DEBUG(rankID << " receive raw data of size " << size << " from rank " << rank);
     auto &socket = *sockets[rank];
     auto [packet, error] = co_await socket.receive(size);
     if (error != NS3Error::ERROR_NOTERROR) {
@@ -127,12 +93,12 @@ ns3::CoroutineOperation<NS3Packet> ns3::MPICommunicator::Recv(MPIRawPacket, MPIR
 }
 
 ns3::CoroutineOperation<void> ns3::MPICommunicator::Recv(MPIFakePacket, MPIRankIDType rank, std::size_t size) {
-    NS_LOG_DEBUG(std::format("{} receive fake data of size {} from rank {}", rankID, size, rank));
+    NS_LOG_DEBUG(rankID << " receive fake data of size " << size << " from rank " << rank);
     co_await Recv(RawPacket, rank, size);
 }
 
 ns3::CoroutineOperation<void> ns3::MPICommunicator::Barrier() {
-    NS_LOG_DEBUG(std::format("{} barrier", rankID));
+    NS_LOG_DEBUG(rankID << " barrier");
     std::vector<CoroutineOperation<void>> operations;
     for (auto rank: sockets | std::ranges::views::keys) {
         operations.push_back(Gather(rank, rankID).then(discard<std::unordered_map<MPIRankIDType, MPIRankIDType>>));
@@ -164,7 +130,7 @@ void ns3::MPICommunicator::Close() {
     for (auto &socket: sockets | std::ranges::views::values) {
         auto error = socket->close();
         if (error != NS3Error::ERROR_NOTERROR) {
-            throw std::domain_error(std::format("communicator {}::error when closing socket", rankID));
+            throw std::domain_error("communicator " + std::to_string(rankID) + "::error when closing socket");
         }
     }
 }
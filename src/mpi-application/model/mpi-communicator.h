@@ -69,14 +69,14 @@ namespace ns3 {
 
         template<MPIWritable T>
         CoroutineOperation<void> Send(MPIRankIDType rank, T data) {
-            logDebug(logName, std::format("{} send data of type {} to rank {}", rankID, getTypename<T>(), rank));
+            COROUTINE_LOG_DEBUG(logName, rankID << " send data of type " << getTypename<T>() << " to rank " << rank);
             co_await MPIObjectWriter<T>{}(*sockets[rank], std::move(data));
         }
 
         template<typename T, typename ...U>
         requires MPIFakeWritable<T, U...>
         CoroutineOperation<void> Send(MPIFakePacket p, MPIRankIDType rank, U ...u) {
-            logDebug(logName, std::format("{} send fake data of type {} to rank {}, fake parameters: {}", rankID, getTypename<T>(), rank, to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " send fake data of type " << getTypename<T>() << " to rank " << rank << ", fake parameters: " << to_string(u...));
             co_await MPIObjectWriter<T>{}(*sockets[rank], p, std::move(u)...);
         }
 
@@ -86,20 +86,20 @@ namespace ns3 {
 
         template<MPIReadable T>
         CoroutineOperation<T> Recv(MPIRankIDType rank) {
-            logDebug(logName, std::format("{} recv data of type {} from rank {}", rankID, getTypename<T>(), rank));
+            COROUTINE_LOG_DEBUG(logName, rankID << " recv data of type " << getTypename<T>() << " from rank " << rank);
             co_return std::move(co_await MPIObjectReader<T>{}(*sockets[rank]));
         }
 
         template<typename T, typename ...U>
         requires MPIFakeReadable<T, U...>
         CoroutineOperation<void> Recv(MPIFakePacket p, MPIRankIDType rank, U ...u) {
-            logDebug(logName, std::format("{} recv fake data of type {} from rank {}, fake parameters: {}", rankID, getTypename<T>(), rank, to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " recv fake data of type " << getTypename<T>() << " from rank " << rank << ", fake parameters: " << to_string(u...));
             co_await MPIObjectReader<T>{}(*sockets[rank], p, std::move(u)...);
         }
 
         template<MPIWritable S, MPIReadable R=S>
         CoroutineOperation<R> SendRecv(MPIRankIDType destination, S data, MPIRankIDType source) {
-            logDebug(logName, std::format("{} send data of type {} to rank {} and recv data of type {} from rank {}", rankID, getTypename<S>(), destination, getTypename<R>(), source));
+            COROUTINE_LOG_DEBUG(logName, rankID << " send data of type " << getTypename<S>() << " to rank " << destination << " and recv data of type " << getTypename<R>() << " from rank " << source);
             auto oS = Send(destination, std::move(data));
             auto oR = Recv<R>(source);
             co_await oS;
@@ -109,7 +109,7 @@ namespace ns3 {
         template<typename S, typename R, typename ...US, typename ...UR>
         requires MPIFakeWritable<S, US...> and MPIFakeReadable<R, UR...>
         CoroutineOperation<void> SendRecv(MPIFakePacket p, MPIRankIDType destination, MPIRankIDType source, const std::tuple<US...> &uS, const std::tuple<UR...> &uR) {
-            logDebug(logName, std::format("{} send fake data of type {} to rank {} and recv fake data of type {} from rank {}, fake parameters S: {}, fake parameters R: {}", rankID, getTypename<S>(), destination, getTypename<R>(), source, to_string(uS), to_string(uR)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " send fake data of type " << getTypename<S>() << " to rank " << destination << " and recv fake data of type " << getTypename<R>() << " from rank " << source << ", fake parameters S: " << to_string(uS) << ", fake parameters R: " << to_string(uR));
             auto oS = std::apply([this, &p, &destination](auto &&...args) { return this->Send<S>(p, destination, std::forward<decltype(args)>(args)...); }, uS);
             auto oR = std::apply([this, &p, &source](auto &&...args) { return this->Recv<R>(p, source, std::forward<decltype(args)>(args)...); }, uR);
             co_await oS;
@@ -118,7 +118,7 @@ namespace ns3 {
 
         template<MPIObject T>
         CoroutineOperation<std::unordered_map<MPIRankIDType, T>> Gather(MPIRankIDType root, T data) {
-            logDebug(logName, std::format("{} gather data of type {} to rank {}", rankID, getTypename<T>(), root));
+            COROUTINE_LOG_DEBUG(logName, rankID << " gather data of type " << getTypename<T>() << " to rank " << root);
             std::unordered_map<MPIRankIDType, T> result;
             auto o = Send(root, std::move(data));
             if (rankID == root) {
@@ -141,7 +141,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> Gather(MPIFakePacket p, MPIRankIDType root, U ...u) {
-            logDebug(logName, std::format("{} gather fake data of type {} to rank {}, fake parameters: ", rankID, getTypename<T>(), root, to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " gather fake data of type " << getTypename<T>() << " to rank " << root << ", fake parameters: " << to_string(u...));
             std::unordered_map<MPIRankIDType, T> result;
             auto o = Send<T>(p, root, u...);
             if (rankID == root) {
@@ -159,7 +159,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> Gather(MPIFakePacket p, MPIRankIDType root, const std::unordered_map<MPIRankIDType, std::tuple<U...>> &u) {
-            logDebug(logName, std::format("{} gather fake data of type {} to rank {}", rankID, getTypename<T>(), root));
+            COROUTINE_LOG_DEBUG(logName, rankID << " gather fake data of type " << getTypename<T>() << " to rank " << root);
             std::unordered_map<MPIRankIDType, T> result;
             auto o = std::apply([this, &p, &root](auto &&...args) { return this->Send<T>(p, root, std::forward<decltype(args)>(args)...); }, u.at(rankID));
             if (rankID == root) {
@@ -176,7 +176,7 @@ namespace ns3 {
 
         template<MPIObject T>
         CoroutineOperation<std::unordered_map<MPIRankIDType, T>> AllGather(T data) {
-            logDebug(logName, std::format("{} all gather data of type {}", rankID, getTypename<T>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all gather data of type " << getTypename<T>());
             std::unordered_map<MPIRankIDType, CoroutineOperation<std::unordered_map<MPIRankIDType, T>>> operations;
             for (auto rank: sockets | std::ranges::views::keys) {
                 operations[rank] = Gather(rank, data);
@@ -190,7 +190,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> AllGather(MPIFakePacket p, U ...u) {
-            logDebug(logName, std::format("{} all gather fake data of type {}, fake parameters: {}", rankID, getTypename<T>(), to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all gather fake data of type " << getTypename<T>() << ", fake parameters: " << to_string(u...));
             std::vector<CoroutineOperation<void>> operations;
             for (auto rank: sockets | std::ranges::views::keys) {
                 operations.push_back(Gather<T>(p, rank, u...));
@@ -203,7 +203,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> AllGather(MPIFakePacket p, const std::unordered_map<MPIRankIDType, std::tuple<U...>> &u) {
-            logDebug(logName, std::format("{} all gather fake data of type {}, fake parameters omitted", rankID, getTypename<T>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all gather fake data of type " << getTypename<T>() << ", fake parameters omitted");
             std::vector<CoroutineOperation<void>> operations;
             for (auto rank: sockets | std::ranges::views::keys) {
                 operations.push_back(Gather<T>(p, rank, u));
@@ -215,7 +215,7 @@ namespace ns3 {
 
         template<MPIObject T>
         CoroutineOperation<T> Scatter(MPIRankIDType root, const std::unordered_map<MPIRankIDType, T> &data) {
-            logDebug(logName, std::format("{} scatter data of type {} from rank {}", rankID, getTypename<T>(), root));
+            COROUTINE_LOG_DEBUG(logName, rankID << " scatter data of type " << getTypename<T>() << " from rank " << root);
             auto o = Recv<T>(root);
             if (rankID == root) {
                 std::vector<CoroutineOperation<void>> operations;
@@ -232,7 +232,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> Scatter(MPIFakePacket p, MPIRankIDType root, U ...u) {
-            logDebug(logName, std::format("{} scatter fake data of type {} from rank {}, fake parameters: {}", rankID, getTypename<T>(), root, to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " scatter fake data of type " << getTypename<T>() << " from rank " << root << ", fake parameters: " << to_string(u...));
             auto o = Recv<T>(p, root, u...);
             if (rankID == root) {
                 std::vector<CoroutineOperation<void>> operations;
@@ -249,7 +249,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> Scatter(MPIFakePacket p, MPIRankIDType root, const std::unordered_map<MPIRankIDType, std::tuple<U...>> &u) {
-            logDebug(logName, std::format("{} scatter fake data of type {} from rank {}, fake parameters omitted", rankID, getTypename<T>(), root));
+            COROUTINE_LOG_DEBUG(logName, rankID << " scatter fake data of type " << getTypename<T>() << " from rank " << root << ", fake parameters omitted");
             auto o = std::apply([this, &p, &root](auto &&...args) { return this->Recv<T>(p, root, std::forward<decltype(args)>(args)...); }, u.at(rankID));
             if (rankID == root) {
                 std::vector<CoroutineOperation<void>> operations;
@@ -265,7 +265,7 @@ namespace ns3 {
 
         template<MPIObject T>
         CoroutineOperation<T> Broadcast(MPIRankIDType root, const std::optional<T> &data) {
-            logDebug(logName, std::format("{} broadcast data of type {} from rank {}", rankID, getTypename<T>(), root));
+            COROUTINE_LOG_DEBUG(logName, rankID << " broadcast data of type " << getTypename<T>() << " from rank " << root);
             auto o = Recv<T>(root);
             if (rankID == root) {
                 std::vector<CoroutineOperation<void>> operations;
@@ -282,7 +282,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> Broadcast(MPIFakePacket p, MPIRankIDType root, U ...u) {
-            logDebug(logName, std::format("{} broadcast fake data of type {} from rank {}, fake parameters: {}", rankID, getTypename<T>(), root, to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " broadcast fake data of type " << getTypename<T>() << " from rank " << root << ", fake parameters: " << to_string(u...));
             auto o = Recv<T>(p, root, u...);
             if (rankID == root) {
                 std::vector<CoroutineOperation<void>> operations;
@@ -301,7 +301,7 @@ namespace ns3 {
         template<MPIOperator O, MPIObject T, typename ...U>
         requires MPIOperatorApplicable<O, T, U...>
         CoroutineOperation<std::optional<std::decay_t<T>>> Reduce(MPIRankIDType root, T data, U ...u) {
-            logDebug(logName, std::format("{} reduce data of type {} at rank {}, parameters: {}", rankID, getTypename<T>(), root, to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " reduce data of type " << getTypename<T>() << " at rank " << root << ", parameters: " << to_string(u...));
             std::unordered_map<MPIRankIDType, T> result = co_await Gather(root, std::move(data));
             if (rankID == root) {
                 co_return MPIOperatorImplementation<O, T>{}(result | std::views::values, std::move(u)...);
@@ -312,14 +312,14 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> Reduce(MPIFakePacket p, MPIRankIDType root, U ...u) {
-            logDebug(logName, std::format("{} reduce fake data of type {} at rank {}, fake parameters: {}", rankID, getTypename<T>(), root, to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " reduce fake data of type " << getTypename<T>() << " at rank " << root << ", fake parameters: " << to_string(u...));
             co_await Gather<T>(p, root, std::move(u)...);
         }
 
         template<MPIOperator O, MPIObject T, typename ...P>
         requires MPIOperatorApplicable<O, T, P...>
         CoroutineOperation<T> ReduceScatter(const std::unordered_map<MPIRankIDType, T> &data, P ...p) {
-            logDebug(logName, std::format("{} reduce scatter data of type {}", rankID, getTypename<T>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " reduce scatter data of type " << getTypename<T>());
             std::unordered_map<MPIRankIDType, CoroutineOperation<T>> operations;
             for (auto &[rank, d]: data) {
                 operations[rank] = Reduce<O>(rank, d, p...).then([](auto &&o) { return o.value(); });
@@ -333,7 +333,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> ReduceScatter(MPIFakePacket p, const std::unordered_map<MPIRankIDType, std::tuple<U...>> &u) {
-            logDebug(logName, std::format("{} reduce scatter fake data of type {}, fake parameters omitted", rankID, getTypename<T>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " reduce scatter fake data of type " << getTypename<T>() << ", fake parameters omitted");
             std::vector<CoroutineOperation<void>> operations;
             for (auto &[rank, u_]: u) {
                 operations.push_back(std::apply([this, &p, &rank](auto &&...args) { return this->Reduce<T>(p, rank, std::forward<decltype(args)>(args)...); }, u_));
@@ -345,7 +345,7 @@ namespace ns3 {
 
         template<MPIObject T>
         CoroutineOperation<MPIRankIDType> Elect(T votes) {
-            logDebug(logName, std::format("{} is electing", rankID));
+            COROUTINE_LOG_DEBUG(logName, rankID << " is electing");
             std::unordered_map<MPIRankIDType, CoroutineOperation<std::unordered_map<MPIRankIDType, T>>> operations;
             for (auto rank: sockets | std::ranges::views::keys) {
                 operations[rank] = Gather(rank, std::move(votes));
@@ -359,7 +359,7 @@ namespace ns3 {
         template<MPIOperator O, MPIObject T, typename ...U>
         requires MPIOperatorApplicable<O, T, U...>
         CoroutineOperation<std::decay_t<T>> AllReduce(T data, U ...u) {
-            logDebug(logName, std::format("{} all reduce data of type {}", rankID, getTypename<T>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all reduce data of type " << getTypename<T>());
             MPIRankIDType root = co_await Elect(voteGenerator(*randomEngine));
             auto result = co_await Reduce<O, T>(root, std::move(data), std::move(u)...);
             co_return std::move(co_await Broadcast(root, std::move(result)));
@@ -368,7 +368,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> AllReduce(MPIFakePacket p, U ...u) {
-            logDebug(logName, std::format("{} all reduce fake data of type {}, fake parameters: {}", rankID, getTypename<T>(), to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all reduce fake data of type " << getTypename<T>() << ", fake parameters: " << to_string(u...));
             MPIRankIDType root = co_await Elect(voteGenerator(*randomEngine));
             co_await Reduce<T>(p, root, u...);
             co_await Broadcast<T>(p, root, u...);
@@ -377,7 +377,7 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<std::vector<T>, std::size_t, U...>
         CoroutineOperation<void> RingAllReduce(MPIFakePacket p, std::size_t size, U ...u) {
-            logDebug(logName, std::format("{} ring all reduce fake data of type {}, size: {}, fake parameters: {}", rankID, getTypename<T>(), size, to_string(u...)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " ring all reduce fake data of type " << getTypename<T>() << ", size: " << size << ", fake parameters: " << to_string(u...));
             auto partition = std::ceil(1.0 * size / GroupSize());
             auto ranks_sorted = ranks;
             std::sort(ranks_sorted.begin(), ranks_sorted.end());
@@ -414,7 +414,7 @@ namespace ns3 {
 
         template<MPIWritable S, MPIReadable R>
         CoroutineOperation<std::unordered_map<MPIRankIDType, R>> AllToAll(const std::unordered_map<MPIRankIDType, S> &data) {
-            logDebug(logName, std::format("{} all to all data of type S: {} and type R: {}", rankID, getTypename<S>(), getTypename<R>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all to all data of type S: " << getTypename<S>() << " and type R: " << getTypename<R>());
             std::vector<CoroutineOperation<void>> sendOperations;
             std::unordered_map<MPIRankIDType, CoroutineOperation<R>> recvOperations;
             for (auto &[rank, s]: data) {
@@ -433,14 +433,14 @@ namespace ns3 {
 
         template<MPIObject T>
         CoroutineOperation<std::unordered_map<MPIRankIDType, T>> AllToAll(const std::unordered_map<MPIRankIDType, T> &data) {
-            logDebug(logName, std::format("{} all to all data of type {}", rankID, getTypename<T>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all to all data of type " << getTypename<T>());
             return AllToAll<T, T>(data);
         }
 
         template<typename S, typename R, typename ...US, typename ...UR>
         requires MPIFakeWritable<S, US...> and MPIFakeReadable<R, UR...>
         CoroutineOperation<void> AllToAll(MPIFakePacket p, const std::unordered_map<MPIRankIDType, std::tuple<US...>> &uS, const std::unordered_map<MPIRankIDType, std::tuple<UR...>> &uR) {
-            logDebug(logName, std::format("{} all to all fake data of type S: {} and type R: {}, fake parameters omitted", rankID, getTypename<S>(), getTypename<R>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all to all fake data of type S: " << getTypename<S>() << " and type R: " << getTypename<R>() << ", fake parameters omitted");
             std::vector<CoroutineOperation<void>> operations;
             for (auto &[rank, u]: uS) {
                 operations.push_back(std::apply([this, &p, &rank](auto &&...args) { return this->Send<S>(p, rank, std::forward<decltype(args)>(args)...); }, u));
@@ -456,7 +456,7 @@ namespace ns3 {
         template<typename S, typename R, typename ...US, typename ...UR>
         requires MPIFakeWritable<S, US...> and MPIFakeReadable<R, UR...>
         CoroutineOperation<void> AllToAll(MPIFakePacket p, const std::tuple<US...> &uS, const std::tuple<UR...> &uR) {
-            logDebug(logName, std::format("{} all to all fake data of type S: {} and type R: {}, fake parameters S: {}, fake parameters R: {}", rankID, getTypename<S>(), getTypename<R>(), to_string(uS), to_string(uR)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all to all fake data of type S: " << getTypename<S>() << " and type R: " << getTypename<R>() << ", fake parameters S: " << to_string(uS) << ", fake parameters R: " << to_string(uR));
             std::unordered_map<MPIRankIDType, std::tuple<US...>> uSMap;
             std::unordered_map<MPIRankIDType, std::tuple<UR...>> uRMap;
             for (auto rank: sockets | std::ranges::views::keys) {
@@ -469,14 +469,14 @@ namespace ns3 {
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> AllToAll(MPIFakePacket p, const std::unordered_map<MPIRankIDType, std::tuple<U...>> &uS, const std::unordered_map<MPIRankIDType, std::tuple<U...>> &uR) {
-            logDebug(logName, std::format("{} all to all fake data of type {}", rankID, getTypename<T>()));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all to all fake data of type " << getTypename<T>());
             return AllToAll<T, T>(p, uS, uR);
         }
 
         template<typename T, typename ...U>
         requires MPIFakeObject<T, U...>
         CoroutineOperation<void> AllToAll(MPIFakePacket p, const std::tuple<U...> &uS, const std::tuple<U...> &uR) {
-            logDebug(logName, std::format("{} all to all fake data of type {}, fake parameters S: {}, fake parameters R: {}", rankID, getTypename<T>(), to_string(uS), to_string(uR)));
+            COROUTINE_LOG_DEBUG(logName, rankID << " all to all fake data of type " << getTypename<T>() << ", fake parameters S: " << to_string(uS) << ", fake parameters R: " << to_string(uR));
             std::unordered_map<MPIRankIDType, std::tuple<U...>> uSMap;
             std::unordered_map<MPIRankIDType, std::tuple<U...>> uRMap;
             for (auto rank: sockets | std::ranges::views::keys) {
@@ -10,6 +10,8 @@
 #include <filesystem>
 #include <algorithm>
 
+NS_LOG_COMPONENT_DEFINE("MPIFunctions");
+
 #pragma pack (1)    //取消结构体字节对齐， #pragma pack () 则恢复原来的字节对齐规则
 #define DUMPI_ANY_TAG -1
 #define DUMPI_STATUS_IGNORE nullptr
@@ -131,7 +133,23 @@ std::vector<dumpi_status> get_statuses(std::fstream &fp, uint8_t config_mask) {
     return statuses;
 }
 
-std::queue<ns3::MPIFunction> ns3::parse_trace(std::filesystem::path trace_path) {
+/*
+ * add the bytes of a point-to-point send to traffic[dest], if traffic is not null
+ */
+static void add_traffic(std::vector<uint64_t> *traffic, dumpi_dest dest, int count, dumpi_datatype datatype) {
+    if (traffic == nullptr || dest < 0 || count <= 0) {
+        return;
+    }
+    if ((size_t) dest >= traffic->size()) {
+        traffic->resize(dest + 1, 0);
+    }
+    (*traffic)[dest] += (uint64_t) count * type_mapping(datatype, []<typename T>() {
+        return sizeof(T);
+    });
+}
+
+static std::queue<ns3::MPIFunction> parse_trace_file(std::filesystem::path trace_path, std::vector<uint64_t> *traffic) {
+    using namespace ns3;
     std::queue<MPIFunction> mpi_functions;
     std::fstream fp;
     fp.open(trace_path, std::ios::in);
@@ -153,7 +171,7 @@ std::queue<ns3::MPIFunction> ns3::parse_trace(std::filesystem::path trace_path)
         // printf("entering at walltime %d.%09d, cputime %d.%09d seconds in thread %d\n",
             //    wall.start.sec, wall.start.nsec, cpu.start.sec, cpu.start.nsec, thread);
         mpi_functions.emplace([mpi_function](auto &) -> CoroutineOperation<void> {
-            std::cout << "mpi function type: " << mpi_function << std::endl;
+            NS_LOG_DEBUG("mpi function type: " << mpi_function);
             co_return;
         });
         switch (mpi_function) {
@@ -231,6 +249,7 @@ std::queue<ns3::MPIFunction> ns3::parse_trace(std::filesystem::path trace_path)
                 get32(fp);  // tag用不到
                 dumpi_comm comm = get16(fp);
                 dumpi_request request = get32(fp);
+                add_traffic(traffic, dest, count, datatype);
 
                 mpi_functions.emplace([comm, datatype, dest, request, count](ns3::MPIApplication &application) -> ns3::CoroutineOperation<void> {
                     auto &c = application.communicator(comm);
@@ -247,6 +266,7 @@ std::queue<ns3::MPIFunction> ns3::parse_trace(std::filesystem::path trace_path)
                 dumpi_dest dest = get32(fp);
                 get32(fp);  //tag用不到
                 dumpi_comm comm = get16(fp);
+                add_traffic(traffic, dest, count, datatype);
 
                 mpi_functions.emplace([comm, datatype, dest, count](ns3::MPIApplication &application) -> ns3::CoroutineOperation<void> {
                     auto &c = application.communicator(comm);
@@ -624,6 +644,7 @@ std::queue<ns3::MPIFunction> ns3::parse_trace(std::filesystem::path trace_path)
                 get32(fp);  //recv_tag用不到
                 dumpi_comm comm = get16(fp);
                 get_statuses(fp, config_mask);
+                add_traffic(traffic, dest, send_count, send_type);
 
                 mpi_functions.emplace([comm, send_count, send_type, dest, recv_count, source, recv_type](ns3::MPIApplication &application) -> ns3::CoroutineOperation<void> {
                       auto &c = application.communicator(comm);
@@ -1034,6 +1055,14 @@ std::queue<ns3::MPIFunction> ns3::parse_trace(std::filesystem::path trace_path)
     return mpi_functions;
 }
 
+std::queue<ns3::MPIFunction> ns3::parse_trace(std::filesystem::path trace_path) {
+    return parse_trace_file(trace_path, nullptr);
+}
+
+std::queue<ns3::MPIFunction> ns3::parse_trace(std::filesystem::path trace_path, std::vector<uint64_t> &traffic) {
+    return parse_trace_file(trace_path, &traffic);
+}
+
 std::vector<std::queue<ns3::MPIFunction>> ns3::parse_traces(std::filesystem::path trace_dir) {
     std::vector<std::filesystem::path> trace_file_names;
     for (auto &p: std::filesystem::directory_iterator(trace_dir)) {
@@ -1045,4 +1074,18 @@ std::vector<std::queue<ns3::MPIFunction>> ns3::parse_traces(std::filesystem::pat
         q.push_back(ns3::parse_trace(path));
     }
     return q;
-}
\ No newline at end of file
+}
+
+std::vector<std::vector<uint64_t>> ns3::parse_traffic_matrix(std::filesystem::path trace_dir) {
+    std::vector<std::filesystem::path> trace_file_names;
+    for (auto &p: std::filesystem::directory_iterator(trace_dir)) {
+        trace_file_names.push_back(p.path());
+    }
+    std::sort(trace_file_names.begin(), trace_file_names.end());
+    std::vector<std::vector<uint64_t>> matrix(trace_file_names.size());
+    for (size_t i = 0; i < trace_file_names.size(); i++) {
+        parse_trace_file(trace_file_names[i], &matrix[i]);
+        matrix[i].resize(std::max(matrix[i].size(), trace_file_names.size()), 0);
+    }
+    return matrix;
+}
@@ -334,10 +334,23 @@ namespace ns3 {
      */
     std::queue<ns3::MPIFunction> parse_trace(std::filesystem::path trace_path);
 
+    /*
+     * parse trace, also adding to traffic[dest] the bytes sent to each dest
+     * rank by MPI_Send, MPI_Isend and MPI_Sendrecv
+     */
+    std::queue<ns3::MPIFunction> parse_trace(std::filesystem::path trace_path, std::vector<uint64_t> &traffic);
+
     std::queue<ns3::MPIFunction> parse_trace(std::filesystem::path trace_dir, MPIRankIDType rank_id);
 
     std::vector<std::queue<ns3::MPIFunction>> parse_traces(std::filesystem::path trace_dir);
 
+    /*
+     * communication matrix of the traces of a directory, one trace file per rank:
+     * matrix[i][j] is the number of bytes rank i sends to rank j with point-to-point
+     * operations; dest ranks are taken as MPI_COMM_WORLD ranks
+     */
+    std::vector<std::vector<uint64_t>> parse_traffic_matrix(std::filesystem::path trace_dir);
+
     struct MPI_Alltoall {
         int sendcount;
         dumpi_datatype sendtype;
@@ -0,0 +1,85 @@
+
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+
+#include "mpi-progress.h"
+
+ns3::MPIProgress::MPIProgress(std::size_t ranks, Time interval, std::ostream &os, std::size_t slowest) :
+        counters(ranks),
+        slowest(slowest),
+        lastEvents(Simulator::GetEventCount()),
+        progress(std::make_unique<ShowProgress>(interval, os)) {
+    progress->SetReportCallback(MakeCallback(&MPIProgress::Report, this));
+}
+
+void ns3::MPIProgress::SetTotal(MPIRankIDType rank, std::uint64_t total) {
+    counters.at(rank).total = total;
+}
+
+const ns3::MPIProgress::Counter &ns3::MPIProgress::GetCounter(MPIRankIDType rank) const {
+    return counters.at(rank);
+}
+
+std::uint64_t ns3::MPIProgress::GetCompleted() const noexcept {
+    return std::accumulate(counters.begin(), counters.end(), std::uint64_t{0}, [](auto sum, const Counter &counter) {
+        return sum + counter.completed;
+    });
+}
+
+std::uint64_t ns3::MPIProgress::GetTotal() const noexcept {
+    return std::accumulate(counters.begin(), counters.end(), std::uint64_t{0}, [](auto sum, const Counter &counter) {
+        return sum + counter.total;
+    });
+}
+
+void ns3::MPIProgress::Report(std::ostream &os, Time elapsed) {
+    auto completed = GetCompleted();
+    auto total = GetTotal();
+    auto events = Simulator::GetEventCount();
+    auto seconds = elapsed.GetSeconds();
+    auto functionRate = seconds > 0 ? static_cast<double>(completed - lastCompleted) / seconds : 0.0;
+    auto eventRate = seconds > 0 ? static_cast<double>(events - lastEvents) / seconds : 0.0;
+    lastCompleted = completed;
+    lastEvents = events;
+
+    auto precision = os.precision();
+    auto flags = os.flags();
+    os.setf(std::ios::fixed, std::ios::floatfield);
+    os << std::setprecision(1) << "mpi progress at " << Simulator::Now().As(Time::S) << ": " << completed << "/" << total
+       << " functions (" << functionRate << " functions/s, " << eventRate << " events/s), eta: ";
+    if (completed >= total) {
+        os << "done";
+    } else if (functionRate > 0) {
+        os << static_cast<double>(total - completed) / functionRate << "s";
+    } else {
+        os << "unknown";
+    }
+
+    // the slowest ranks are the unfinished ones with the lowest fraction of their functions completed
+    std::vector<MPIRankIDType> ranks;
+    for (MPIRankIDType rank = 0; rank < counters.size(); ++rank) {
+        if (counters[rank].completed < counters[rank].total) {
+            ranks.push_back(rank);
+        }
+    }
+    auto count = std::min(slowest, ranks.size());
+    std::partial_sort(ranks.begin(), ranks.begin() + count, ranks.end(), [this](auto a, auto b) {
+        return static_cast<long double>(counters[a].completed) * counters[b].total <
+               static_cast<long double>(counters[b].completed) * counters[a].total;
+    });
+    if (count > 0) {
+        os << ", slowest ranks:";
+        for (std::size_t i = 0; i < count; ++i) {
+            auto &counter = counters[ranks[i]];
+            os << " " << ranks[i] << " (" << counter.completed << "/" << counter.total << ")";
+        }
+    }
+    os << std::endl;
+
+    os.precision(precision);
+    os.flags(flags);
+}
+
+ns3::MPIProgress::~MPIProgress() = default;
@@ -0,0 +1,78 @@
+
+
+#ifndef NS3_MPI_PROGRESS_H
+#define NS3_MPI_PROGRESS_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <ns3/core-module.h>
+
+#include "mpi-protocol-trait.h"
+
+namespace ns3 {
+
+    /**
+     * @brief MPIProgress counts the trace functions completed by each rank, and periodically reports the progress of
+     * the whole replay.
+     *
+     * The counters of all the ranks are kept in a single array shared by their MPIApplication, which only increments
+     * the counter of its rank when a function completes. The report reuses the wall clock timer of ShowProgress: after
+     * its line with the simulated time, the aggregate functions per second, the events per second, an estimated time
+     * to complete the replay and the slowest ranks are printed.
+     */
+    class MPIProgress {
+    public:
+        struct Counter {
+            std::uint64_t completed = 0;
+            std::uint64_t total = 0;
+        };
+
+    private:
+        std::vector<Counter> counters;
+        std::size_t slowest;
+        std::uint64_t lastCompleted = 0;
+        std::uint64_t lastEvents = 0;
+        std::unique_ptr<ShowProgress> progress;
+
+        void Report(std::ostream &os, Time elapsed);
+
+    public:
+        /**
+         * @brief Start reporting the progress of the ranks, about every interval of wall clock time.
+         * @param ranks the number of ranks
+         * @param interval the target wall clock interval between reports
+         * @param os the stream to report on
+         * @param slowest the number of slowest ranks to report
+         */
+        explicit MPIProgress(std::size_t ranks, Time interval = Seconds(1.0), std::ostream &os = std::cout, std::size_t slowest = 3);
+
+        MPIProgress(const MPIProgress &progress) = delete;
+
+        MPIProgress &operator=(const MPIProgress &progress) = delete;
+
+        /**
+         * @brief Set the number of functions a rank has to complete.
+         */
+        void SetTotal(MPIRankIDType rank, std::uint64_t total);
+
+        /**
+         * @brief Count a function completed by a rank.
+         */
+        void Complete(MPIRankIDType rank) noexcept {
+            ++counters[rank].completed;
+        }
+
+        const Counter &GetCounter(MPIRankIDType rank) const;
+
+        std::uint64_t GetCompleted() const noexcept;
+
+        std::uint64_t GetTotal() const noexcept;
+
+        ~MPIProgress();
+    };
+}
+
+#endif // NS3_MPI_PROGRESS_H
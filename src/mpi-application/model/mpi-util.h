@@ -134,40 +134,6 @@ namespace ns3 {
 
     Address addressWithPort(const Address &address, uint16_t port);
 
-    inline void log(const std::string &name, LogLevel level, const std::string &message) noexcept {
-        LogComponent &g_log = GetLogComponent(name);
-        NS_LOG(level, message);
-    }
-
-    [[maybe_unused]] inline void logError(const std::string &name, const std::string &message) noexcept {
-        log(name, LOG_ERROR, message);
-    }
-
-    [[maybe_unused]] inline void logWarn(const std::string &name, const std::string &message) noexcept {
-        log(name, LOG_WARN, message);
-    }
-
-    [[maybe_unused]] inline void logInfo(const std::string &name, const std::string &message) noexcept {
-        log(name, LOG_INFO, message);
-    }
-
-    [[maybe_unused]] inline void logFunction(const std::string &name, const std::string &message) noexcept {
-        log(name, LOG_FUNCTION, message);
-    }
-
-    [[maybe_unused]] inline void logLogic(const std::string &name, const std::string &message) noexcept {
-        log(name, LOG_LOGIC, message);
-    }
-
-    [[maybe_unused]] inline void logDebug(const std::string &name, const std::string &message) noexcept {
-        log(name, LOG_DEBUG, message);
-    }
-
-    template<typename T, typename ...S>
-    std::string to_string(const T &t, const S &...s) {
-        return std::format("{}, {}", std::to_string(t), to_string(s...));
-    }
-
     template<typename T>
     std::string to_string(const T &t) {
         return std::to_string(t);
@@ -177,6 +143,11 @@ namespace ns3 {
         return "";
     }
 
+    template<typename T, typename ...S>
+    std::string to_string(const T &t, const S &...s) {
+        return std::to_string(t) + ", " + to_string(s...);
+    }
+
     template<typename... T>
     std::string to_string(const std::tuple<T...> &t) {
         return std::apply([](const auto &...args) { return to_string(args...); }, t);
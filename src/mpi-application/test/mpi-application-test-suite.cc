@@ -0,0 +1,193 @@
+
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ns3/core-module.h>
+#include <ns3/coroutine-module.h>
+#include <ns3/internet-module.h>
+#include <ns3/network-module.h>
+
+#include "ns3/mpi-application.h"
+#include "ns3/mpi-progress.h"
+
+namespace ns3 {
+
+    /**
+     * @brief Check the counters of MPIProgress, and its periodic report through the ReportCallback of ShowProgress.
+     *
+     * Rank 0 completes a function per millisecond of simulated time, each taking about a millisecond of wall clock
+     * time, rank 1 completes none and rank 2 has no function.
+     */
+    class MPIProgressTestCase : public TestCase {
+    private:
+        static constexpr std::uint64_t functions = 100;
+
+        std::unique_ptr<MPIProgress> progress;
+
+        void complete();
+
+        void DoRun() override;
+
+    public:
+        MPIProgressTestCase();
+    };
+
+    MPIProgressTestCase::MPIProgressTestCase() : TestCase("Counters and periodic report of MPIProgress") {}
+
+    void MPIProgressTestCase::complete() {
+        progress->Complete(0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    void MPIProgressTestCase::DoRun() {
+        std::ostringstream os;
+        progress = std::make_unique<MPIProgress>(3, MilliSeconds(10), os, 2);
+        progress->SetTotal(0, functions);
+        progress->SetTotal(1, functions);
+        NS_TEST_EXPECT_MSG_EQ(progress->GetTotal(), 2 * functions, "Wrong total of the functions");
+        NS_TEST_EXPECT_MSG_EQ(progress->GetCompleted(), 0, "Functions completed before the replay");
+
+        for (std::uint64_t i = 0; i < functions; ++i) {
+            Simulator::Schedule(MilliSeconds(i), &MPIProgressTestCase::complete, this);
+        }
+        Simulator::Stop(MilliSeconds(functions));
+        Simulator::Run();
+
+        NS_TEST_EXPECT_MSG_EQ(progress->GetCounter(0).completed, functions, "Wrong functions completed by rank 0");
+        NS_TEST_EXPECT_MSG_EQ(progress->GetCounter(1).completed, 0, "Wrong functions completed by rank 1");
+        NS_TEST_EXPECT_MSG_EQ(progress->GetCounter(2).total, 0, "Wrong total of rank 2");
+        NS_TEST_EXPECT_MSG_EQ(progress->GetCompleted(), functions, "Wrong functions completed");
+
+        // each report follows the line of ShowProgress, with rank 1 as the slowest rank, then rank 0 until it is
+        // done, and never rank 2
+        auto report = os.str();
+        NS_TEST_EXPECT_MSG_NE(report.find("mpi progress at "), std::string::npos, "No periodic report");
+        NS_TEST_EXPECT_MSG_NE(report.find(" functions/s, "), std::string::npos, "No rate of the functions");
+        NS_TEST_EXPECT_MSG_NE(report.find(", slowest ranks: 1 (0/100) 0 ("), std::string::npos,
+                              "Wrong slowest ranks");
+        NS_TEST_EXPECT_MSG_EQ(report.find(" 2 (0/0)"), std::string::npos, "Rank without functions reported");
+
+        progress.reset();
+        Simulator::Destroy();
+    }
+
+    /**
+     * @brief Replay the same send and receive between two ranks with and without a FlowNetwork, and check that the
+     * network is a drop-in replacement for the packets under MPICommunicator: the data received is the same, only
+     * sooner, since a flow transmits it at the rate of the link from the start.
+     */
+    class MPIFlowNetworkTestCase : public TestCase {
+    private:
+        static constexpr std::uint16_t port = 10000;
+        static constexpr std::size_t count = 10000;
+
+        std::vector<int> received;
+        Time end;
+
+        void run(bool flows);
+
+        void DoRun() override;
+
+    public:
+        MPIFlowNetworkTestCase();
+    };
+
+    MPIFlowNetworkTestCase::MPIFlowNetworkTestCase() : TestCase("FlowNetwork under MPICommunicator") {}
+
+    void MPIFlowNetworkTestCase::run(bool flows) {
+        NodeContainer nodes;
+        nodes.Create(2);
+        SimpleNetDeviceHelper link;
+        link.SetDeviceAttribute("DataRate", DataRateValue(DataRate("8Mbps")));
+        link.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+        link.SetNetDevicePointToPointMode(true);
+        auto devices = link.Install(nodes);
+        InternetStackHelper internet;
+        internet.Install(nodes);
+        Ipv4AddressHelper helper{"10.1.1.0", "255.255.255.0"};
+        auto interfaces = helper.Assign(devices);
+
+        std::map<MPIRankIDType, Address> addresses;
+        std::map<Address, MPIRankIDType> ranks;
+        for (MPIRankIDType rank = 0; rank < 2; ++rank) {
+            addresses[rank] = InetSocketAddress(interfaces.GetAddress(rank), port);
+            ranks[interfaces.GetAddress(rank)] = rank;
+        }
+
+        std::vector<std::queue<MPIFunction>> functions(2);
+        for (auto &queue: functions) {
+            queue.emplace([](MPIApplication &application) -> CoroutineOperation<void> {
+                co_await application.Initialize();
+            });
+        }
+        functions[0].emplace([](MPIApplication &application) -> CoroutineOperation<void> {
+            std::vector<int> data(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                data[i] = static_cast<int>(i * i);
+            }
+            co_await application.communicator(WORLD_COMMUNICATOR).Send(1, std::move(data));
+        });
+        functions[1].emplace([this](MPIApplication &application) -> CoroutineOperation<void> {
+            received = std::move(co_await application.communicator(WORLD_COMMUNICATOR).Recv<std::vector<int>>(0));
+            end = Simulator::Now();
+        });
+        // the sockets are closed once both ranks are done
+        for (auto &queue: functions) {
+            queue.emplace([](MPIApplication &application) -> CoroutineOperation<void> {
+                co_await application.communicator(WORLD_COMMUNICATOR).Barrier();
+                application.Finalize();
+            });
+        }
+
+        auto network = FlowNetwork::fromTopology(0);
+        for (MPIRankIDType rank = 0; rank < 2; ++rank) {
+            auto application = CreateObject<MPIApplication>(rank, addresses, ranks, std::move(functions[rank]));
+            if (flows) {
+                application->SetFlowNetwork(network);
+            }
+            nodes.Get(rank)->AddApplication(application);
+            application->SetStartTime(Seconds(0));
+        }
+        Simulator::Stop(Seconds(10));
+        Simulator::Run();
+        Simulator::Destroy();
+    }
+
+    void MPIFlowNetworkTestCase::DoRun() {
+        run(false);
+        auto packets = std::move(received);
+        auto packetEnd = end;
+        run(true);
+
+        NS_TEST_ASSERT_MSG_EQ(packets.size(), count, "Wrong data received at packet level");
+        NS_TEST_ASSERT_MSG_EQ(received.size(), count, "Wrong data received as flows");
+        for (std::size_t i = 0; i < count; ++i) {
+            NS_TEST_ASSERT_MSG_EQ(received[i], packets[i], "Different data received as flows");
+        }
+        NS_TEST_EXPECT_MSG_LT(end, packetEnd, "Flows not faster than the packets");
+        // the 40000 bytes of the data take 40ms at the rate of the link
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(end, MilliSeconds(40), "Data received faster than the link");
+    }
+
+    /**
+     * @brief MPI application test suite
+     */
+    class MPIApplicationTestSuite : public TestSuite {
+    public:
+        MPIApplicationTestSuite();
+    };
+
+    MPIApplicationTestSuite::MPIApplicationTestSuite() : TestSuite("mpi-application", UNIT) {
+        AddTestCase(new MPIProgressTestCase, TestCase::QUICK);
+        AddTestCase(new MPIFlowNetworkTestCase, TestCase::QUICK);
+    }
+
+    static MPIApplicationTestSuite g_mpiApplicationTestSuite; //!< Static variable for test initialization
+}
@@ -377,7 +377,10 @@ DistributedSimulatorImpl::Run()
         if (nextTime > m_grantedTime || IsLocalFinished())
         {
             // Can't process next event, calculate a new LBTS
-            // First receive any pending messages
+            // First send the packets batched during this window,
+            // so that they are accounted in the tx count
+            GrantedTimeWindowMpiInterface::FlushSendBuffers();
+            // Then receive any pending messages
             GrantedTimeWindowMpiInterface::ReceiveMessages();
             // reset next time
             nextTime = Next();
@@ -29,6 +29,7 @@
 #include "mpi-interface.h"
 #include "mpi-receiver.h"
 
+#include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/net-device.h"
 #include "ns3/node-list.h"
@@ -37,6 +38,7 @@
 #include "ns3/simulator-impl.h"
 #include "ns3/simulator.h"
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <list>
@@ -49,27 +51,31 @@ NS_LOG_COMPONENT_DEFINE("GrantedTimeWindowMpiInterface");
 
 NS_OBJECT_ENSURE_REGISTERED(GrantedTimeWindowMpiInterface);
 
+/**
+ * Size of the header of a packet record in a frame: receive time,
+ * destination node, destination device and packet size.
+ */
+const uint32_t FRAME_RECORD_HEADER_SIZE = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+
 SentBuffer::SentBuffer()
 {
-    m_buffer = nullptr;
     m_request = MPI_REQUEST_NULL;
 }
 
 SentBuffer::~SentBuffer()
 {
-    delete[] m_buffer;
 }
 
-uint8_t*
+std::vector<uint8_t>&
 SentBuffer::GetBuffer()
 {
     return m_buffer;
 }
 
 void
-SentBuffer::SetBuffer(uint8_t* buffer)
+SentBuffer::SetBuffer(std::vector<uint8_t>&& buffer)
 {
-    m_buffer = buffer;
+    m_buffer = std::move(buffer);
 }
 
 MPI_Request*
@@ -85,6 +91,10 @@ bool GrantedTimeWindowMpiInterface::g_mpiInitCalled = false;
 uint32_t GrantedTimeWindowMpiInterface::g_rxCount = 0;
 uint32_t GrantedTimeWindowMpiInterface::g_txCount = 0;
 std::list<SentBuffer> GrantedTimeWindowMpiInterface::g_pendingTx;
+std::vector<std::vector<uint8_t>> GrantedTimeWindowMpiInterface::g_txFrames;
+std::vector<std::vector<uint8_t>> GrantedTimeWindowMpiInterface::g_bufferPool;
+std::vector<int> GrantedTimeWindowMpiInterface::g_rxIndices;
+std::vector<MPI_Status> GrantedTimeWindowMpiInterface::g_rxStatuses;
 
 MPI_Request* GrantedTimeWindowMpiInterface::g_requests;
 char** GrantedTimeWindowMpiInterface::g_pRxBuffers;
@@ -112,6 +122,10 @@ GrantedTimeWindowMpiInterface::Destroy()
     delete[] g_requests;
 
     g_pendingTx.clear();
+    g_txFrames.clear();
+    g_bufferPool.clear();
+    g_rxIndices.clear();
+    g_rxStatuses.clear();
 }
 
 uint32_t
@@ -192,14 +206,17 @@ GrantedTimeWindowMpiInterface::Enable(MPI_Comm communicator)
     g_size = mpiSize;
 
     g_enabled = true;
+    g_txFrames.assign(g_size, std::vector<uint8_t>());
+    g_rxIndices.resize(g_size);
+    g_rxStatuses.resize(g_size);
     // Post a non-blocking receive for all peers
     g_pRxBuffers = new char*[g_size];
     g_requests = new MPI_Request[g_size];
     for (uint32_t i = 0; i < GetSize(); ++i)
     {
-        g_pRxBuffers[i] = new char[MAX_MPI_MSG_SIZE];
+        g_pRxBuffers[i] = new char[MAX_MPI_FRAME_SIZE];
         MPI_Irecv(g_pRxBuffers[i],
-                  MAX_MPI_MSG_SIZE,
+                  MAX_MPI_FRAME_SIZE,
                   MPI_CHAR,
                   MPI_ANY_SOURCE,
                   0,
@@ -216,37 +233,87 @@ GrantedTimeWindowMpiInterface::SendPacket(Ptr<Packet> p,
 {
     NS_LOG_FUNCTION(this << p << rxTime.GetTimeStep() << node << dev);
 
-    SentBuffer sendBuf;
-    g_pendingTx.push_back(sendBuf);
-    auto i = g_pendingTx.rbegin(); // Points to the last element
+    // Find the system id for the destination node
+    Ptr<Node> destNode = NodeList::GetNode(node);
+    uint32_t nodeSysId = destNode->GetSystemId();
 
+    // Records are 8-byte aligned in the frame
     uint32_t serializedSize = p->GetSerializedSize();
-    auto buffer = new uint8_t[serializedSize + 16];
-    i->SetBuffer(buffer);
-    // Add the time, dest node and dest device
+    uint32_t recordSize = (FRAME_RECORD_HEADER_SIZE + serializedSize + 7) & ~7U;
+    NS_ABORT_MSG_IF(recordSize > MAX_MPI_FRAME_SIZE,
+                    "Packet of " << serializedSize << " bytes does not fit in an MPI frame");
+
+    std::vector<uint8_t>* frame = &g_txFrames[nodeSysId];
+    if (frame->size() + recordSize > MAX_MPI_FRAME_SIZE)
+    {
+        FlushSendBuffer(nodeSysId);
+    }
+    if (frame->capacity() == 0)
+    {
+        if (!g_bufferPool.empty())
+        {
+            *frame = std::move(g_bufferPool.back());
+            g_bufferPool.pop_back();
+            frame->clear();
+        }
+        frame->reserve(MAX_MPI_FRAME_SIZE);
+    }
+
+    std::size_t offset = frame->size();
+    frame->resize(offset + recordSize);
+    uint8_t* record = frame->data() + offset;
+
+    // Add the time, dest node, dest device and size
     uint64_t t = rxTime.GetInteger();
-    auto pTime = reinterpret_cast<uint64_t*>(buffer);
-    *pTime++ = t;
-    auto pData = reinterpret_cast<uint32_t*>(pTime);
-    *pData++ = node;
-    *pData++ = dev;
+    std::memcpy(record, &t, sizeof(t));
+    record += sizeof(t);
+    std::memcpy(record, &node, sizeof(node));
+    record += sizeof(node);
+    std::memcpy(record, &dev, sizeof(dev));
+    record += sizeof(dev);
+    std::memcpy(record, &serializedSize, sizeof(serializedSize));
+    record += sizeof(serializedSize);
     // Serialize the packet
-    p->Serialize(reinterpret_cast<uint8_t*>(pData), serializedSize);
+    p->Serialize(record, serializedSize);
+}
 
-    // Find the system id for the destination node
-    Ptr<Node> destNode = NodeList::GetNode(node);
-    uint32_t nodeSysId = destNode->GetSystemId();
+void
+GrantedTimeWindowMpiInterface::FlushSendBuffer(uint32_t rank)
+{
+    NS_LOG_FUNCTION(rank);
 
-    MPI_Isend(reinterpret_cast<void*>(i->GetBuffer()),
-              serializedSize + 16,
+    std::vector<uint8_t>& frame = g_txFrames[rank];
+    if (frame.empty())
+    {
+        return;
+    }
+
+    g_pendingTx.emplace_back();
+    SentBuffer& sendBuf = g_pendingTx.back();
+    sendBuf.SetBuffer(std::move(frame));
+    frame.clear();
+
+    MPI_Isend(reinterpret_cast<void*>(sendBuf.GetBuffer().data()),
+              sendBuf.GetBuffer().size(),
               MPI_CHAR,
-              nodeSysId,
+              rank,
               0,
               g_communicator,
-              (i->GetRequest()));
+              sendBuf.GetRequest());
     g_txCount++;
 }
 
+void
+GrantedTimeWindowMpiInterface::FlushSendBuffers()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    for (uint32_t rank = 0; rank < g_txFrames.size(); ++rank)
+    {
+        FlushSendBuffer(rank);
+    }
+}
+
 void
 GrantedTimeWindowMpiInterface::ReceiveMessages()
 {
@@ -255,31 +322,67 @@ GrantedTimeWindowMpiInterface::ReceiveMessages()
     // Poll the non-block reads to see if data arrived
     while (true)
     {
-        int flag = 0;
-        int index = 0;
-        MPI_Status status;
-
-        MPI_Testany(MpiInterface::GetSize(), g_requests, &index, &flag, &status);
-        if (!flag)
+        int outCount = 0;
+
+        MPI_Testsome(MpiInterface::GetSize(),
+                     g_requests,
+                     &outCount,
+                     g_rxIndices.data(),
+                     g_rxStatuses.data());
+        if (outCount == 0 || outCount == MPI_UNDEFINED)
         {
             break; // No more messages
         }
-        int count;
-        MPI_Get_count(&status, MPI_CHAR, &count);
-        g_rxCount++; // Count this receive
 
+        for (int i = 0; i < outCount; ++i)
+        {
+            int index = g_rxIndices[i];
+            int count;
+            MPI_Get_count(&g_rxStatuses[i], MPI_CHAR, &count);
+            g_rxCount++; // Count this receive
+
+            UnpackFrame(reinterpret_cast<uint8_t*>(g_pRxBuffers[index]), count);
+
+            // Re-queue the next read
+            MPI_Irecv(g_pRxBuffers[index],
+                      MAX_MPI_FRAME_SIZE,
+                      MPI_CHAR,
+                      MPI_ANY_SOURCE,
+                      0,
+                      g_communicator,
+                      &g_requests[index]);
+        }
+    }
+}
+
+void
+GrantedTimeWindowMpiInterface::UnpackFrame(const uint8_t* frame, uint32_t size)
+{
+    NS_LOG_FUNCTION(frame << size);
+
+    const uint8_t* end = frame + size;
+    while (frame < end)
+    {
         // Get the meta data first
-        auto pTime = reinterpret_cast<uint64_t*>(g_pRxBuffers[index]);
-        uint64_t time = *pTime++;
-        auto pData = reinterpret_cast<uint32_t*>(pTime);
-        uint32_t node = *pData++;
-        uint32_t dev = *pData++;
+        uint64_t time;
+        uint32_t node;
+        uint32_t dev;
+        uint32_t count;
+        const uint8_t* record = frame;
+        std::memcpy(&time, record, sizeof(time));
+        record += sizeof(time);
+        std::memcpy(&node, record, sizeof(node));
+        record += sizeof(node);
+        std::memcpy(&dev, record, sizeof(dev));
+        record += sizeof(dev);
+        std::memcpy(&count, record, sizeof(count));
+        record += sizeof(count);
+        frame += (FRAME_RECORD_HEADER_SIZE + count + 7) & ~7U;
+        NS_ASSERT(frame <= end);
 
         Time rxTime(time);
 
-        count -= sizeof(time) + sizeof(node) + sizeof(dev);
-
-        Ptr<Packet> p = Create<Packet>(reinterpret_cast<uint8_t*>(pData), count, true);
+        Ptr<Packet> p = Create<Packet>(record, count, true);
 
         // Find the correct node/device to schedule receive event
         Ptr<Node> pNode = NodeList::GetNode(node);
@@ -303,15 +406,6 @@ GrantedTimeWindowMpiInterface::ReceiveMessages()
                                        &MpiReceiver::Receive,
                                        pMpiRec,
                                        p);
-
-        // Re-queue the next read
-        MPI_Irecv(g_pRxBuffers[index],
-                  MAX_MPI_MSG_SIZE,
-                  MPI_CHAR,
-                  MPI_ANY_SOURCE,
-                  0,
-                  g_communicator,
-                  &g_requests[index]);
     }
 }
 
@@ -329,7 +423,11 @@ GrantedTimeWindowMpiInterface::TestSendComplete()
         auto current = i; // Save current for erasing
         i++;              // Advance to next
         if (flag)
-        { // This message is complete
+        { // This message is complete, keep its buffer for the next frames
+            if (g_bufferPool.size() < g_size)
+            {
+                g_bufferPool.push_back(std::move(current->GetBuffer()));
+            }
             g_pendingTx.erase(current);
         }
     }
@@ -35,6 +35,7 @@
 #include <list>
 #include <mpi.h>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -45,13 +46,20 @@ namespace ns3
  */
 const uint32_t MAX_MPI_MSG_SIZE = 2000;
 
+/**
+ * maximum size of a frame packing the packets sent
+ * to one remote rank during a granted time window
+ */
+const uint32_t MAX_MPI_FRAME_SIZE = 65536;
+
 /**
  * \ingroup mpi
  *
  * \brief Tracks non-blocking sends
  *
  * This class is used to keep track of the asynchronous non-blocking
- * sends that have been posted.
+ * sends that have been posted.  The buffer is taken from, and given
+ * back to, the pool of frame buffers of GrantedTimeWindowMpiInterface.
  */
 class SentBuffer
 {
@@ -60,21 +68,21 @@ class SentBuffer
     ~SentBuffer();
 
     /**
-     * \return pointer to sent buffer
+     * \return the sent buffer
      */
-    uint8_t* GetBuffer();
+    std::vector<uint8_t>& GetBuffer();
     /**
-     * \param buffer pointer to sent buffer
+     * \param buffer sent buffer, its content is moved
      */
-    void SetBuffer(uint8_t* buffer);
+    void SetBuffer(std::vector<uint8_t>&& buffer);
     /**
      * \return MPI request
      */
     MPI_Request* GetRequest();
 
   private:
-    uint8_t* m_buffer;     /**< The buffer. */
-    MPI_Request m_request; /**< The MPI request handle. */
+    std::vector<uint8_t> m_buffer; /**< The buffer. */
+    MPI_Request m_request;         /**< The MPI request handle. */
 };
 
 class Packet;
@@ -88,6 +96,13 @@ class DistributedSimulatorImpl;
  * Implements the interface used by the singleton parallel controller
  * to interface between NS3 and the communications layer being
  * used for inter-task packet transfers.
+ *
+ * Packets sent to a remote rank are not sent right away: they are
+ * appended to a frame for that rank, and the frames are sent with one
+ * MPI message each at the end of the granted time window (or when a
+ * frame is full).  Remote ranks only look for messages when
+ * synchronizing, so this does not delay the delivery of any packet.
+ * The tx and rx counts used to detect transient messages count frames.
  */
 class GrantedTimeWindowMpiInterface : public ParallelCommunicationInterface, Object
 {
@@ -118,10 +133,26 @@ class GrantedTimeWindowMpiInterface : public ParallelCommunicationInterface, Obj
      */
     friend ns3::DistributedSimulatorImpl;
 
+    /**
+     * Send the frames holding the packets sent during the current
+     * granted time window.  Must be called before computing the LBTS.
+     */
+    static void FlushSendBuffers();
+    /**
+     * Send the frame for a remote rank, if not empty
+     * \param rank the remote rank
+     */
+    static void FlushSendBuffer(uint32_t rank);
     /**
      * Check for received messages complete
      */
     static void ReceiveMessages();
+    /**
+     * Schedule the receive events for all the packets packed in a frame
+     * \param frame the received frame
+     * \param size size of the frame in bytes
+     */
+    static void UnpackFrame(const uint8_t* frame, uint32_t size);
     /**
      * Check for completed sends
      */
@@ -140,10 +171,10 @@ class GrantedTimeWindowMpiInterface : public ParallelCommunicationInterface, Obj
     /** Size of the MPI COM_WORLD group. */
     static uint32_t g_size;
 
-    /** Total packets received. */
+    /** Total frames received. */
     static uint32_t g_rxCount;
 
-    /** Total packets sent. */
+    /** Total frames sent. */
     static uint32_t g_txCount;
 
     /** Has this interface been enabled. */
@@ -164,6 +195,18 @@ class GrantedTimeWindowMpiInterface : public ParallelCommunicationInterface, Obj
     /** List of pending non-blocking sends. */
     static std::list<SentBuffer> g_pendingTx;
 
+    /** Frames being filled, one per remote rank. */
+    static std::vector<std::vector<uint8_t>> g_txFrames;
+
+    /** Buffers of completed sends, reused for the next frames. */
+    static std::vector<std::vector<uint8_t>> g_bufferPool;
+
+    /** Indices of the completed receives, for MPI_Testsome. */
+    static std::vector<int> g_rxIndices;
+
+    /** Status of the completed receives, for MPI_Testsome. */
+    static std::vector<MPI_Status> g_rxStatuses;
+
     /** MPI communicator being used for ns-3 tasks. */
     static MPI_Comm g_communicator;
 
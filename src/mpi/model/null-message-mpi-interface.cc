@@ -31,6 +31,7 @@
 #include "remote-channel-bundle-manager.h"
 #include "remote-channel-bundle.h"
 
+#include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/net-device.h"
 #include "ns3/node-list.h"
@@ -38,6 +39,7 @@
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <list>
@@ -64,13 +66,13 @@ class NullMessageSentBuffer
     ~NullMessageSentBuffer();
 
     /**
-     * \return pointer to sent buffer
+     * \return the sent buffer
      */
-    uint8_t* GetBuffer();
+    std::vector<uint8_t>& GetBuffer();
     /**
-     * \param buffer pointer to sent buffer
+     * \param buffer sent buffer, its content is moved
      */
-    void SetBuffer(uint8_t* buffer);
+    void SetBuffer(std::vector<uint8_t>&& buffer);
     /**
      * \return MPI request
      */
@@ -80,7 +82,7 @@ class NullMessageSentBuffer
     /**
      * Buffer for send.
      */
-    uint8_t* m_buffer;
+    std::vector<uint8_t> m_buffer;
 
     /**
      * MPI request posted for the send.
@@ -89,32 +91,48 @@ class NullMessageSentBuffer
 };
 
 /**
- * maximum MPI message size for easy
- * buffer creation
+ * maximum MPI message size, hence size of the
+ * frames packing the packets sent to one rank
  */
-const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 2000;
+const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 65536;
+
+/**
+ * Size of the header of a frame: guarantee time, flags and
+ * number of packets.
+ */
+const uint32_t FRAME_HEADER_SIZE = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+/** Offset of the number of packets in the header of a frame. */
+const uint32_t FRAME_COUNT_OFFSET = sizeof(uint64_t) + sizeof(uint32_t);
+
+/**
+ * Size of the header of a packet record in a frame: receive time,
+ * destination node, destination device and packet size.
+ */
+const uint32_t FRAME_RECORD_HEADER_SIZE = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+
+/** Frame flag asking the receiver for a new guarantee time. */
+const uint32_t FRAME_FLAG_REQUEST = 1;
 
 NullMessageSentBuffer::NullMessageSentBuffer()
 {
-    m_buffer = nullptr;
     m_request = MPI_REQUEST_NULL;
 }
 
 NullMessageSentBuffer::~NullMessageSentBuffer()
 {
-    delete[] m_buffer;
 }
 
-uint8_t*
+std::vector<uint8_t>&
 NullMessageSentBuffer::GetBuffer()
 {
     return m_buffer;
 }
 
 void
-NullMessageSentBuffer::SetBuffer(uint8_t* buffer)
+NullMessageSentBuffer::SetBuffer(std::vector<uint8_t>&& buffer)
 {
-    m_buffer = buffer;
+    m_buffer = std::move(buffer);
 }
 
 MPI_Request*
@@ -130,6 +148,9 @@ bool NullMessageMpiInterface::g_enabled = false;
 bool NullMessageMpiInterface::g_mpiInitCalled = false;
 
 std::list<NullMessageSentBuffer> NullMessageMpiInterface::g_pendingTx;
+std::vector<std::vector<uint8_t>> NullMessageMpiInterface::g_txFrames;
+std::vector<std::vector<uint8_t>> NullMessageMpiInterface::g_bufferPool;
+uint32_t NullMessageMpiInterface::g_guaranteeRequests = 0;
 
 MPI_Comm NullMessageMpiInterface::g_communicator = MPI_COMM_WORLD;
 bool NullMessageMpiInterface::g_freeCommunicator = false;
@@ -234,6 +255,8 @@ NullMessageMpiInterface::InitializeSendReceiveBuffers()
     NS_ASSERT(g_enabled);
 
     g_numNeighbors = RemoteChannelBundleManager::Size();
+    g_txFrames.assign(g_size, std::vector<uint8_t>());
+    g_guaranteeRequests = 0;
 
     // Post a non-blocking receive for all peers
     g_requests = new MPI_Request[g_numNeighbors];
@@ -268,38 +291,54 @@ NullMessageMpiInterface::SendPacket(Ptr<Packet> p, const Time& rxTime, uint32_t
     Ptr<Node> destNode = NodeList::GetNode(node);
     uint32_t nodeSysId = destNode->GetSystemId();
 
-    NullMessageSentBuffer sendBuf;
-    g_pendingTx.push_back(sendBuf);
-    auto iter = g_pendingTx.rbegin(); // Points to the last element
-
+    // Records are 8-byte aligned in the frame
     uint32_t serializedSize = p->GetSerializedSize();
-    uint32_t bufferSize = serializedSize + (2 * sizeof(uint64_t)) + (2 * sizeof(uint32_t));
-    auto buffer = new uint8_t[bufferSize];
-    iter->SetBuffer(buffer);
-    // Add the time, dest node and dest device
-    uint64_t t = rxTime.GetInteger();
-    auto pTime = reinterpret_cast<uint64_t*>(buffer);
-    *pTime++ = t;
+    uint32_t recordSize = (FRAME_RECORD_HEADER_SIZE + serializedSize + 7) & ~7U;
+    NS_ABORT_MSG_IF(FRAME_HEADER_SIZE + recordSize > NULL_MESSAGE_MAX_MPI_MSG_SIZE,
+                    "Packet of " << serializedSize << " bytes does not fit in an MPI frame");
 
-    Time guarantee_update =
-        NullMessageSimulatorImpl::GetInstance()->CalculateGuaranteeTime(nodeSysId);
-    *pTime++ = guarantee_update.GetTimeStep();
+    std::vector<uint8_t>& frame = g_txFrames[nodeSysId];
+    if (frame.size() + recordSize > NULL_MESSAGE_MAX_MPI_MSG_SIZE)
+    {
+        // Send the full frame now; its guarantee time postpones the next Null Message
+        NullMessageSimulatorImpl* simulator = NullMessageSimulatorImpl::GetInstance();
+        Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(nodeSysId);
+        SendFrame(simulator->CalculateGuaranteeTime(nodeSysId), bundle, 0);
+        simulator->RescheduleNullMessageEvent(bundle);
+    }
+    if (frame.empty())
+    {
+        if (!g_bufferPool.empty())
+        {
+            frame = std::move(g_bufferPool.back());
+            g_bufferPool.pop_back();
+            frame.clear();
+        }
+        frame.reserve(NULL_MESSAGE_MAX_MPI_MSG_SIZE);
+        frame.resize(FRAME_HEADER_SIZE, 0);
+    }
 
-    auto pData = reinterpret_cast<uint32_t*>(pTime);
-    *pData++ = node;
-    *pData++ = dev;
-    // Serialize the packet
-    p->Serialize(reinterpret_cast<uint8_t*>(pData), serializedSize);
+    std::size_t offset = frame.size();
+    frame.resize(offset + recordSize);
+    uint8_t* record = frame.data() + offset;
 
-    MPI_Isend(reinterpret_cast<void*>(iter->GetBuffer()),
-              bufferSize,
-              MPI_CHAR,
-              nodeSysId,
-              0,
-              g_communicator,
-              (iter->GetRequest()));
+    // Add the time, dest node, dest device and size
+    uint64_t t = rxTime.GetInteger();
+    std::memcpy(record, &t, sizeof(t));
+    record += sizeof(t);
+    std::memcpy(record, &node, sizeof(node));
+    record += sizeof(node);
+    std::memcpy(record, &dev, sizeof(dev));
+    record += sizeof(dev);
+    std::memcpy(record, &serializedSize, sizeof(serializedSize));
+    record += sizeof(serializedSize);
+    // Serialize the packet
+    p->Serialize(record, serializedSize);
 
-    NullMessageSimulatorImpl::GetInstance()->RescheduleNullMessageEvent(nodeSysId);
+    uint32_t packets;
+    std::memcpy(&packets, frame.data() + FRAME_COUNT_OFFSET, sizeof(packets));
+    ++packets;
+    std::memcpy(frame.data() + FRAME_COUNT_OFFSET, &packets, sizeof(packets));
 }
 
 void
@@ -308,33 +347,144 @@ NullMessageMpiInterface::SendNullMessage(const Time& guarantee_update,
 {
     NS_LOG_FUNCTION(guarantee_update.GetTimeStep() << bundle);
 
-    NS_ASSERT(g_enabled);
+    SendFrame(guarantee_update, bundle, 0);
+}
+
+void
+NullMessageMpiInterface::SendGuaranteeRequests(const Time& nextTime)
+{
+    NS_LOG_FUNCTION(nextTime.GetTimeStep());
+
+    NullMessageSimulatorImpl* simulator = NullMessageSimulatorImpl::GetInstance();
+    for (uint32_t rank = 0; rank < g_txFrames.size(); ++rank)
+    {
+        Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
+        if (!bundle || bundle->IsRequestPending() || bundle->GetGuaranteeTime() >= nextTime)
+        {
+            continue;
+        }
+        bundle->SetRequestPending(true);
+        SendFrame(simulator->CalculateGuaranteeTime(rank), bundle, FRAME_FLAG_REQUEST);
+    }
+}
+
+void
+NullMessageMpiInterface::AnswerGuaranteeRequests()
+{
+    if (g_guaranteeRequests == 0)
+    {
+        return;
+    }
+
+    NS_LOG_FUNCTION_NOARGS();
+
+    NullMessageSimulatorImpl* simulator = NullMessageSimulatorImpl::GetInstance();
+    for (uint32_t rank = 0; rank < g_txFrames.size(); ++rank)
+    {
+        Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
+        if (bundle && bundle->IsGuaranteeRequested())
+        {
+            // Not sent while it does not advance the guarantee time
+            SendFrame(simulator->CalculateGuaranteeTime(rank), bundle, 0);
+        }
+    }
+}
+
+void
+NullMessageMpiInterface::FlushSendBuffers()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    NullMessageSimulatorImpl* simulator = NullMessageSimulatorImpl::GetInstance();
+    for (uint32_t rank = 0; rank < g_txFrames.size(); ++rank)
+    {
+        if (!g_txFrames[rank].empty())
+        {
+            SendFrame(simulator->CalculateGuaranteeTime(rank),
+                      RemoteChannelBundleManager::Find(rank),
+                      0);
+        }
+    }
+}
+
+void
+NullMessageMpiInterface::SendFrame(const Time& guaranteeUpdate,
+                                   Ptr<RemoteChannelBundle> bundle,
+                                   uint32_t flags)
+{
+    NS_LOG_FUNCTION(guaranteeUpdate.GetTimeStep() << bundle << flags);
 
-    NullMessageSentBuffer sendBuf;
-    g_pendingTx.push_back(sendBuf);
-    auto iter = g_pendingTx.rbegin(); // Points to the last element
-
-    uint32_t bufferSize = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
-    auto buffer = new uint8_t[bufferSize];
-    iter->SetBuffer(buffer);
-    // Add the time, dest node and dest device
-    auto pTime = reinterpret_cast<uint64_t*>(buffer);
-    *pTime++ = 0;
-    *pTime++ = guarantee_update.GetInteger();
-    auto pData = reinterpret_cast<uint32_t*>(pTime);
-    *pData++ = 0;
-    *pData++ = 0;
+    NS_ASSERT(g_enabled);
+    NS_ASSERT(bundle);
 
     // Find the system id for the destination MPI rank
     uint32_t nodeSysId = bundle->GetSystemId();
+    std::vector<uint8_t>& frame = g_txFrames[nodeSysId];
+    uint32_t packets = 0;
+    if (!frame.empty())
+    {
+        std::memcpy(&packets, frame.data() + FRAME_COUNT_OFFSET, sizeof(packets));
+    }
 
-    MPI_Isend(reinterpret_cast<void*>(iter->GetBuffer()),
-              bufferSize,
+    NullMessageStatistics& statistics = bundle->GetStatistics();
+    bool advance = guaranteeUpdate > bundle->GetSentGuaranteeTime();
+    if (packets == 0 && !advance && !(flags & FRAME_FLAG_REQUEST))
+    {
+        // The remote task already knows this guarantee time
+        statistics.suppressed++;
+        return;
+    }
+
+    if (frame.empty())
+    {
+        if (!g_bufferPool.empty())
+        {
+            frame = std::move(g_bufferPool.back());
+            g_bufferPool.pop_back();
+            frame.clear();
+        }
+        frame.resize(FRAME_HEADER_SIZE, 0);
+    }
+    uint64_t guarantee = guaranteeUpdate.GetInteger();
+    std::memcpy(frame.data(), &guarantee, sizeof(guarantee));
+    std::memcpy(frame.data() + sizeof(guarantee), &flags, sizeof(flags));
+
+    g_pendingTx.emplace_back();
+    NullMessageSentBuffer& sendBuf = g_pendingTx.back();
+    sendBuf.SetBuffer(std::move(frame));
+    frame.clear();
+
+    MPI_Isend(reinterpret_cast<void*>(sendBuf.GetBuffer().data()),
+              sendBuf.GetBuffer().size(),
               MPI_CHAR,
               nodeSysId,
               0,
               g_communicator,
-              (iter->GetRequest()));
+              sendBuf.GetRequest());
+
+    if (packets > 0)
+    {
+        statistics.dataMessages++;
+        statistics.packets += packets;
+    }
+    else
+    {
+        statistics.nullMessages++;
+    }
+    if (flags & FRAME_FLAG_REQUEST)
+    {
+        statistics.requests++;
+    }
+
+    if (advance)
+    {
+        bundle->SetSentGuaranteeTime(guaranteeUpdate);
+    }
+    if ((advance || packets > 0) && bundle->IsGuaranteeRequested())
+    {
+        bundle->SetGuaranteeRequested(false);
+        g_guaranteeRequests--;
+    }
 }
 
 void
@@ -392,52 +542,10 @@ NullMessageMpiInterface::ReceiveMessages(bool blocking)
             int count;
             MPI_Get_count(&status, MPI_CHAR, &count);
 
-            // Get the meta data first
-            auto pTime = reinterpret_cast<uint64_t*>(g_pRxBuffers[index]);
-            uint64_t time = *pTime++;
-            uint64_t guaranteeUpdate = *pTime++;
-
-            auto pData = reinterpret_cast<uint32_t*>(pTime);
-            uint32_t node = *pData++;
-            uint32_t dev = *pData++;
-
-            Time rxTime(time);
-
-            // rxtime == 0 means this is a Null Message
-            if (rxTime > Time(0))
-            {
-                count -= sizeof(time) + sizeof(guaranteeUpdate) + sizeof(node) + sizeof(dev);
-
-                Ptr<Packet> p = Create<Packet>(reinterpret_cast<uint8_t*>(pData), count, true);
-
-                // Find the correct node/device to schedule receive event
-                Ptr<Node> pNode = NodeList::GetNode(node);
-                Ptr<MpiReceiver> pMpiRec = nullptr;
-                uint32_t nDevices = pNode->GetNDevices();
-                for (uint32_t i = 0; i < nDevices; ++i)
-                {
-                    Ptr<NetDevice> pThisDev = pNode->GetDevice(i);
-                    if (pThisDev->GetIfIndex() == dev)
-                    {
-                        pMpiRec = pThisDev->GetObject<MpiReceiver>();
-                        break;
-                    }
-                }
-                NS_ASSERT(pNode && pMpiRec);
-
-                // Schedule the rx event
-                Simulator::ScheduleWithContext(pNode->GetId(),
-                                               rxTime - Simulator::Now(),
-                                               &MpiReceiver::Receive,
-                                               pMpiRec,
-                                               p);
-            }
-
-            // Update guarantee time for both packet receives and Null Messages.
             Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(status.MPI_SOURCE);
             NS_ASSERT(bundle);
 
-            bundle->SetGuaranteeTime(Time(guaranteeUpdate));
+            UnpackFrame(reinterpret_cast<uint8_t*>(g_pRxBuffers[index]), count, bundle);
 
             // Re-queue the next read
             MPI_Irecv(g_pRxBuffers[index],
@@ -456,6 +564,81 @@ NullMessageMpiInterface::ReceiveMessages(bool blocking)
     } while (!stop);
 }
 
+void
+NullMessageMpiInterface::UnpackFrame(const uint8_t* frame,
+                                     uint32_t size,
+                                     Ptr<RemoteChannelBundle> bundle)
+{
+    NS_LOG_FUNCTION(frame << size << bundle);
+
+    NS_ASSERT(size >= FRAME_HEADER_SIZE);
+
+    // Get the frame header first
+    uint64_t guaranteeUpdate;
+    uint32_t flags;
+    uint32_t packets;
+    std::memcpy(&guaranteeUpdate, frame, sizeof(guaranteeUpdate));
+    std::memcpy(&flags, frame + sizeof(guaranteeUpdate), sizeof(flags));
+    std::memcpy(&packets, frame + FRAME_COUNT_OFFSET, sizeof(packets));
+
+    const uint8_t* record = frame + FRAME_HEADER_SIZE;
+    for (uint32_t i = 0; i < packets; ++i)
+    {
+        uint64_t time;
+        uint32_t node;
+        uint32_t dev;
+        uint32_t count;
+        const uint8_t* data = record;
+        std::memcpy(&time, data, sizeof(time));
+        data += sizeof(time);
+        std::memcpy(&node, data, sizeof(node));
+        data += sizeof(node);
+        std::memcpy(&dev, data, sizeof(dev));
+        data += sizeof(dev);
+        std::memcpy(&count, data, sizeof(count));
+        data += sizeof(count);
+        record += (FRAME_RECORD_HEADER_SIZE + count + 7) & ~7U;
+        NS_ASSERT(record <= frame + size);
+
+        Time rxTime(time);
+
+        Ptr<Packet> p = Create<Packet>(data, count, true);
+
+        // Find the correct node/device to schedule receive event
+        Ptr<Node> pNode = NodeList::GetNode(node);
+        Ptr<MpiReceiver> pMpiRec = nullptr;
+        uint32_t nDevices = pNode->GetNDevices();
+        for (uint32_t j = 0; j < nDevices; ++j)
+        {
+            Ptr<NetDevice> pThisDev = pNode->GetDevice(j);
+            if (pThisDev->GetIfIndex() == dev)
+            {
+                pMpiRec = pThisDev->GetObject<MpiReceiver>();
+                break;
+            }
+        }
+        NS_ASSERT(pNode && pMpiRec);
+
+        // Schedule the rx event
+        Simulator::ScheduleWithContext(pNode->GetId(),
+                                       rxTime - Simulator::Now(),
+                                       &MpiReceiver::Receive,
+                                       pMpiRec,
+                                       p);
+    }
+
+    // Update guarantee time for both packet receives and Null Messages.
+    bundle->SetGuaranteeTime(Max(bundle->GetGuaranteeTime(), Time(guaranteeUpdate)));
+    bundle->SetRequestPending(false);
+    bundle->GetStatistics().received++;
+
+    if ((flags & FRAME_FLAG_REQUEST) && !bundle->IsGuaranteeRequested())
+    {
+        bundle->SetGuaranteeRequested(true);
+        g_guaranteeRequests++;
+    }
+}
+
 void
 NullMessageMpiInterface::TestSendComplete()
 {
@@ -472,7 +655,11 @@ NullMessageMpiInterface::TestSendComplete()
         auto current = iter; // Save current for erasing
         ++iter;              // Advance to next
         if (flag)
-        { // This message is complete
+        { // This message is complete, keep its buffer for the next frames
+            if (g_bufferPool.size() < g_numNeighbors)
+            {
+                g_bufferPool.push_back(std::move(current->GetBuffer()));
+            }
             g_pendingTx.erase(current);
         }
     }
@@ -505,6 +692,9 @@ NullMessageMpiInterface::Disable()
         delete[] g_requests;
 
         g_pendingTx.clear();
+        g_txFrames.clear();
+        g_bufferPool.clear();
+        g_guaranteeRequests = 0;
 
         if (g_freeCommunicator)
         {
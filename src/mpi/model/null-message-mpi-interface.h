@@ -33,6 +33,7 @@
 
 #include <list>
 #include <mpi.h>
+#include <vector>
 
 namespace ns3
 {
@@ -47,6 +48,13 @@ class Packet;
  *
  * \brief Interface between ns-3 and MPI for the Null Message
  * distributed simulation implementation.
+ *
+ * Packets sent to a remote task are appended to a frame for that task.
+ * The frame is sent, with one MPI message carrying the current guarantee
+ * time, when a Null Message is due, when this task blocks, when the
+ * remote task requests a new guarantee time, or when the frame is full.
+ * Null Messages which would not advance the guarantee time of the
+ * remote task are not sent.
  */
 class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
 {
@@ -94,12 +102,50 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
      *
      * \param [in] bundle The bundle of links between two ranks.
      *
-     * \internal The Null Message MPI buffer format uses the same packet
-     * metadata format as sending a normal packet with the time,
-     * destination node, and destination device set to zero.  Using the
-     * same packet metadata simplifies receive logic.
+     * The packets batched for the remote task are sent in the same
+     * message.  Nothing is sent when there are no such packets and the
+     * guarantee time does not exceed the last one sent.
      */
     static void SendNullMessage(const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle);
+    /**
+     * \brief Ask the remote tasks holding back the next event for a new
+     * guarantee time.
+     *
+     * A request is sent to each bundle whose guarantee time is before
+     * the next event, unless one is already outstanding.
+     *
+     * \param [in] nextTime The time of the next event of this task.
+     */
+    static void SendGuaranteeRequests(const Time& nextTime);
+    /**
+     * Send a new guarantee time to the remote tasks which requested one,
+     * as soon as it exceeds the last guarantee time sent to them.
+     */
+    static void AnswerGuaranteeRequests();
+    /**
+     * Send the frames holding the packets batched for remote tasks.
+     */
+    static void FlushSendBuffers();
+    /**
+     * \brief Send the frame for a remote task, with a guarantee time.
+     *
+     * \param [in] guaranteeUpdate Lower bound time on the next
+     * possible event from this MPI task to the remote MPI task.
+     * \param [in] bundle The bundle of links between the two ranks.
+     * \param [in] flags The frame flags.
+     */
+    static void SendFrame(const Time& guaranteeUpdate,
+                          Ptr<RemoteChannelBundle> bundle,
+                          uint32_t flags);
+    /**
+     * Schedule the receive events for the packets of a frame, and update
+     * the guarantee time of the bundle it came from.
+     *
+     * \param [in] frame The received frame.
+     * \param [in] size Size of the frame in bytes.
+     * \param [in] bundle The bundle of the sending task.
+     */
+    static void UnpackFrame(const uint8_t* frame, uint32_t size, Ptr<RemoteChannelBundle> bundle);
     /**
      * Non-blocking check for received messages complete.  Will
      * receive all messages that are queued up locally.
@@ -161,6 +207,15 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
     /** List of pending non-blocking sends. */
     static std::list<NullMessageSentBuffer> g_pendingTx;
 
+    /** Frames being filled, one per remote rank. */
+    static std::vector<std::vector<uint8_t>> g_txFrames;
+
+    /** Buffers of completed sends, reused for the next frames. */
+    static std::vector<std::vector<uint8_t>> g_bufferPool;
+
+    /** Number of bundles whose remote task requested a new guarantee time. */
+    static uint32_t g_guaranteeRequests;
+
     /** MPI communicator being used for ns-3 tasks. */
     static MPI_Comm g_communicator;
 
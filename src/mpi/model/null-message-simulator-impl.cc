@@ -31,6 +31,7 @@
 #include "remote-channel-bundle.h"
 
 #include <ns3/assert.h>
+#include <ns3/boolean.h>
 #include <ns3/channel.h>
 #include <ns3/double.h>
 #include <ns3/event-impl.h>
@@ -67,7 +68,12 @@ NullMessageSimulatorImpl::GetTypeId()
                           "Null Message scheduler tuning parameter",
                           DoubleValue(1.0),
                           MakeDoubleAccessor(&NullMessageSimulatorImpl::m_schedulerTune),
-                          MakeDoubleChecker<double>(0.01, 1.0));
+                          MakeDoubleChecker<double>(0.01, 1.0))
+            .AddAttribute("LazyNullMessages",
+                          "Only send Null Messages to the tasks blocked waiting for them",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NullMessageSimulatorImpl::m_lazyNullMessages),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -79,6 +85,7 @@ NullMessageSimulatorImpl::NullMessageSimulatorImpl()
     m_systemCount = MpiInterface::GetSize();
 
     m_stop = false;
+    m_inEvent = false;
     m_uid = EventId::UID::VALID;
     m_currentUid = EventId::UID::INVALID;
     m_currentTs = 0;
@@ -239,13 +246,21 @@ NullMessageSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
+    m_inEvent = true;
     next.impl->Invoke();
+    m_inEvent = false;
     next.impl->Unref();
 }
 
 bool
 NullMessageSimulatorImpl::IsFinished() const
 {
+    // Without periodic Null Message events, the queue may be empty while
+    // packets from remote tasks are still to come.
+    if (m_lazyNullMessages && RemoteChannelBundleManager::Size() > 0)
+    {
+        return m_stop;
+    }
     return m_events->IsEmpty() || m_stop;
 }
 
@@ -254,7 +269,10 @@ NullMessageSimulatorImpl::Next() const
 {
     NS_LOG_FUNCTION(this);
 
-    NS_ASSERT(!m_events->IsEmpty());
+    if (m_events->IsEmpty())
+    {
+        return GetMaximumSimulationTime();
+    }
 
     Scheduler::Event ev = m_events->PeekNext();
     return TimeStep(ev.key.m_ts);
@@ -265,6 +283,11 @@ NullMessageSimulatorImpl::ScheduleNullMessageEvent(Ptr<RemoteChannelBundle> bund
 {
     NS_LOG_FUNCTION(this << bundle);
 
+    if (m_lazyNullMessages)
+    {
+        return;
+    }
+
     Time delay(m_schedulerTune * bundle->GetDelay().GetTimeStep());
 
     bundle->SetEventId(Simulator::Schedule(delay,
@@ -278,6 +301,11 @@ NullMessageSimulatorImpl::RescheduleNullMessageEvent(Ptr<RemoteChannelBundle> bu
 {
     NS_LOG_FUNCTION(this << bundle);
 
+    if (m_lazyNullMessages)
+    {
+        return;
+    }
+
     Simulator::Cancel(bundle->GetEventId());
 
     Time delay(m_schedulerTune * bundle->GetDelay().GetTimeStep());
@@ -321,10 +349,21 @@ NullMessageSimulatorImpl::Run()
         }
         else
         {
-            // Block until packet or Null Message has been received.
+            // Send the packets batched for remote tasks, ask the tasks
+            // holding back the next event for a new guarantee time, and
+            // block until packet or Null Message has been received.
+            NullMessageMpiInterface::FlushSendBuffers();
+            if (m_lazyNullMessages)
+            {
+                NullMessageMpiInterface::SendGuaranteeRequests(nextTime);
+            }
             HandleArrivingMessagesBlocking();
         }
+
+        NullMessageMpiInterface::AnswerGuaranteeRequests();
     }
+
+    NullMessageMpiInterface::FlushSendBuffers();
 }
 
 void
@@ -562,7 +601,8 @@ NullMessageSimulatorImpl::CalculateGuaranteeTime(uint32_t nodeSysId)
     Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(nodeSysId);
     NS_ASSERT(bundle);
 
-    return Min(NullMessageSimulatorImpl::GetInstance()->Next(), GetSafeTime()) + bundle->GetDelay();
+    Time next = m_inEvent ? Now() : Next();
+    return Min(next, GetSafeTime()) + bundle->GetDelay();
 }
 
 void
@@ -582,4 +622,49 @@ NullMessageSimulatorImpl::GetInstance()
     NS_ASSERT(g_instance != nullptr);
     return g_instance;
 }
+
+NullMessageStatistics
+NullMessageSimulatorImpl::GetStatistics() const
+{
+    return RemoteChannelBundleManager::GetStatistics();
+}
+
+NullMessageStatistics
+NullMessageSimulatorImpl::GetStatistics(uint32_t systemId) const
+{
+    Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(systemId);
+    return bundle ? bundle->GetStatistics() : NullMessageStatistics();
+}
+
+double
+NullMessageStatistics::GetNullToDataRatio() const
+{
+    if (dataMessages == 0)
+    {
+        return nullMessages;
+    }
+    return static_cast<double>(nullMessages) / dataMessages;
+}
+
+NullMessageStatistics&
+NullMessageStatistics::operator+=(const NullMessageStatistics& other)
+{
+    nullMessages += other.nullMessages;
+    dataMessages += other.dataMessages;
+    packets += other.packets;
+    suppressed += other.suppressed;
+    requests += other.requests;
+    received += other.received;
+    return *this;
+}
+
+std::ostream&
+operator<<(std::ostream& out, const NullMessageStatistics& stats)
+{
+    out << "null messages " << stats.nullMessages << ", data messages " << stats.dataMessages
+        << ", packets " << stats.packets << ", suppressed " << stats.suppressed << ", requests "
+        << stats.requests << ", received " << stats.received << ", null to data ratio "
+        << stats.GetNullToDataRatio();
+    return out;
+}
 } // namespace ns3
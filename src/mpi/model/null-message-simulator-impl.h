@@ -42,6 +42,47 @@ class NullMessageEvent;
 class NullMessageMpiInterface;
 class RemoteChannelBundle;
 
+/**
+ * \ingroup mpi
+ *
+ * \brief Counts of the messages exchanged with one or all remote ranks
+ * by the Null Message synchronization.
+ *
+ * Every message carries a guarantee time; data messages also carry
+ * the packets sent to the remote rank since the previous message.
+ */
+struct NullMessageStatistics
+{
+    uint64_t nullMessages{0}; //!< Messages sent without packets
+    uint64_t dataMessages{0}; //!< Messages sent with packets
+    uint64_t packets{0};      //!< Packets sent in data messages
+    uint64_t suppressed{0};   //!< Null messages not sent as they carried no new guarantee
+    uint64_t requests{0};     //!< Null messages sent to request a new guarantee
+    uint64_t received{0};     //!< Messages received
+
+    /**
+     * \return the number of null messages sent per data message sent,
+     * or the number of null messages sent if no data message was sent
+     */
+    double GetNullToDataRatio() const;
+
+    /**
+     * Add the counts of another set of statistics.
+     * \param [in] other The statistics to add.
+     * \return This statistics.
+     */
+    NullMessageStatistics& operator+=(const NullMessageStatistics& other);
+};
+
+/**
+ * Output the statistics.
+ *
+ * \param [in,out] out The stream.
+ * \param [in] stats The statistics to print.
+ * \return The stream.
+ */
+std::ostream& operator<<(std::ostream& out, const NullMessageStatistics& stats);
+
 /**
  * \ingroup mpi
  *
@@ -91,6 +132,19 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      */
     static NullMessageSimulatorImpl* GetInstance();
 
+    /**
+     * \return the message counts of this rank, summed over all remote ranks
+     *
+     * Valid until Simulator::Destroy.
+     */
+    NullMessageStatistics GetStatistics() const;
+
+    /**
+     * \param [in] systemId The remote rank.
+     * \return the message counts of this rank with one remote rank
+     */
+    NullMessageStatistics GetStatistics(uint32_t systemId) const;
+
   private:
     friend class NullMessageEvent;
     friend class NullMessageMpiInterface;
@@ -120,7 +174,8 @@ class NullMessageSimulatorImpl : public SimulatorImpl
     void ProcessOneEvent();
 
     /**
-     * \return next local event time.
+     * \return next local event time, or the maximum simulation time
+     * if there is none.
      */
     Time Next() const;
 
@@ -168,6 +223,8 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      * Calculate the guarantee time for incoming RemoteChannelBundle
      * from task nodeSysId.  No message should arrive from task
      * nodeSysId with a receive time less than the guarantee time.
+     * While an event runs, it may still send packets, so the guarantee
+     * is based on the current time rather than on the next event.
      */
     Time CalculateGuaranteeTime(uint32_t systemId);
 
@@ -187,6 +244,8 @@ class NullMessageSimulatorImpl : public SimulatorImpl
     DestroyEvents m_destroyEvents;
     /** Flag calling for the end of the simulation. */
     bool m_stop;
+    /** Whether an event is being invoked. */
+    bool m_inEvent;
     /** The event priority queue. */
     Ptr<Scheduler> m_events;
 
@@ -227,6 +286,15 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      */
     double m_schedulerTune;
 
+    /**
+     * Whether Null Messages are only sent on demand.  When false, a
+     * Null Message is sent for each bundle every m_schedulerTune times
+     * its delay.  When true, a task blocked by the guarantee time of a
+     * bundle requests a new one from the remote task, which answers as
+     * soon as its guarantee time has advanced.
+     */
+    bool m_lazyNullMessages;
+
     /** Singleton instance. */
     static NullMessageSimulatorImpl* g_instance;
 };
@@ -103,6 +103,19 @@ RemoteChannelBundleManager::GetSafeTime()
     return safeTime;
 }
 
+NullMessageStatistics
+RemoteChannelBundleManager::GetStatistics()
+{
+    NullMessageStatistics statistics;
+
+    for (auto kv = g_remoteChannelBundles.begin(); kv != g_remoteChannelBundles.end(); ++kv)
+    {
+        statistics += kv->second->GetStatistics();
+    }
+
+    return statistics;
+}
+
 void
 RemoteChannelBundleManager::Destroy()
 {
@@ -27,6 +27,8 @@
 #ifndef NS3_REMOTE_CHANNEL_BUNDLE_MANAGER
 #define NS3_REMOTE_CHANNEL_BUNDLE_MANAGER
 
+#include "null-message-simulator-impl.h"
+
 #include <ns3/nstime.h>
 #include <ns3/ptr.h>
 
@@ -83,6 +85,12 @@ class RemoteChannelBundleManager
      */
     static Time GetSafeTime();
 
+    /**
+     * Get the message counts summed over all bundles.
+     * \return The statistics.
+     */
+    static NullMessageStatistics GetStatistics();
+
     /** Destroy the singleton. */
     static void Destroy();
 
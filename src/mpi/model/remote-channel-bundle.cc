@@ -47,14 +47,20 @@ RemoteChannelBundle::GetTypeId()
 RemoteChannelBundle::RemoteChannelBundle()
     : m_remoteSystemId(UINT32_MAX),
       m_guaranteeTime(0),
-      m_delay(Time::Max())
+      m_delay(Time::Max()),
+      m_sentGuaranteeTime(0),
+      m_guaranteeRequested(false),
+      m_requestPending(false)
 {
 }
 
 RemoteChannelBundle::RemoteChannelBundle(const uint32_t remoteSystemId)
     : m_remoteSystemId(remoteSystemId),
       m_guaranteeTime(0),
-      m_delay(Time::Max())
+      m_delay(Time::Max()),
+      m_sentGuaranteeTime(0),
+      m_guaranteeRequested(false),
+      m_requestPending(false)
 {
 }
 
@@ -109,6 +115,54 @@ RemoteChannelBundle::GetSize() const
     return m_channels.size();
 }
 
+Time
+RemoteChannelBundle::GetSentGuaranteeTime() const
+{
+    return m_sentGuaranteeTime;
+}
+
+void
+RemoteChannelBundle::SetSentGuaranteeTime(Time time)
+{
+    m_sentGuaranteeTime = time;
+}
+
+bool
+RemoteChannelBundle::IsGuaranteeRequested() const
+{
+    return m_guaranteeRequested;
+}
+
+void
+RemoteChannelBundle::SetGuaranteeRequested(bool requested)
+{
+    m_guaranteeRequested = requested;
+}
+
+bool
+RemoteChannelBundle::IsRequestPending() const
+{
+    return m_requestPending;
+}
+
+void
+RemoteChannelBundle::SetRequestPending(bool pending)
+{
+    m_requestPending = pending;
+}
+
+NullMessageStatistics&
+RemoteChannelBundle::GetStatistics()
+{
+    return m_statistics;
+}
+
+const NullMessageStatistics&
+RemoteChannelBundle::GetStatistics() const
+{
+    return m_statistics;
+}
+
 void
 RemoteChannelBundle::Send(Time time)
 {
@@ -120,7 +174,7 @@ operator<<(std::ostream& out, ns3::RemoteChannelBundle& bundle)
 {
     out << "RemoteChannelBundle Rank = " << bundle.m_remoteSystemId
         << ", GuaranteeTime = " << bundle.m_guaranteeTime << ", Delay = " << bundle.m_delay
-        << std::endl;
+        << ", " << bundle.m_statistics << std::endl;
 
     for (const auto& element : bundle.m_channels)
     {
@@ -124,6 +124,58 @@ class RemoteChannelBundle : public Object
      */
     std::size_t GetSize() const;
 
+    /**
+     * Get the last guarantee time sent to the remote task.
+     * \return The last guarantee time sent.
+     */
+    Time GetSentGuaranteeTime() const;
+
+    /**
+     * Set the last guarantee time sent to the remote task.  This should
+     * be called after a packet or Null Message is sent.
+     *
+     * \param time The guarantee time.
+     */
+    void SetSentGuaranteeTime(Time time);
+
+    /**
+     * Whether the remote task is blocked, waiting for a guarantee time
+     * greater than the last one sent.
+     * \return true if a new guarantee time was requested.
+     */
+    bool IsGuaranteeRequested() const;
+
+    /**
+     * Record whether the remote task waits for a new guarantee time.
+     * \param requested true if a new guarantee time was requested.
+     */
+    void SetGuaranteeRequested(bool requested);
+
+    /**
+     * Whether this task has requested a new guarantee time from the
+     * remote task and received no message since.
+     * \return true if a request is outstanding.
+     */
+    bool IsRequestPending() const;
+
+    /**
+     * Record whether a request for a new guarantee time is outstanding.
+     * \param pending true if a request is outstanding.
+     */
+    void SetRequestPending(bool pending);
+
+    /**
+     * Get the message counts for this bundle.
+     * \return The statistics.
+     */
+    NullMessageStatistics& GetStatistics();
+
+    /**
+     * Get the message counts for this bundle.
+     * \return The statistics.
+     */
+    const NullMessageStatistics& GetStatistics() const;
+
     /**
      * Send Null Message to the remote task associated with this bundle.
      * Message will be delivered at current simulation time + the time
@@ -169,6 +221,18 @@ class RemoteChannelBundle : public Object
 
     /** Event scheduled to send Null Message for this bundle. */
     EventId m_nullEventId;
+
+    /** Last guarantee time sent to the remote task. */
+    Time m_sentGuaranteeTime;
+
+    /** Whether the remote task waits for a new guarantee time. */
+    bool m_guaranteeRequested;
+
+    /** Whether a new guarantee time was requested from the remote task. */
+    bool m_requestPending;
+
+    /** Message counts for this bundle. */
+    NullMessageStatistics m_statistics;
 };
 
 } // namespace ns3
@@ -171,3 +171,8 @@ static MpiTestSuite g_mpiEmpty3NullMsg("mpi-example-empty-3-nullmsg",
                                        NS_TEST_SOURCEDIR,
                                        3,
                                        "-nullmsg");
+static MpiTestSuite g_mpiSimple2Lazy("mpi-example-simple-2-lazy",
+                                     "simple-distributed",
+                                     NS_TEST_SOURCEDIR,
+                                     2,
+                                     "--nullmsg --ns3::NullMessageSimulatorImpl::LazyNullMessages=1");
@@ -0,0 +1,679 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <barrier>
+#include <limits>
+#include <map>
+#include <set>
+#include <thread>
+#include <tuple>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+/** Timestamp standing for "never". */
+static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+thread_local MultithreadedSimulatorImpl::Partition* MultithreadedSimulatorImpl::g_partition =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MultithreadedSimulatorImpl")
+                            .SetParent<SimulatorImpl>()
+                            .SetGroupName("Mtp")
+                            .AddConstructor<MultithreadedSimulatorImpl>();
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_partitioned(false),
+      m_lookahead(NEVER),
+      m_windowEnd(0),
+      m_windowCount(0),
+      m_finished(false),
+      m_stop(false),
+      m_uid(EventId::UID::VALID),
+      m_stopEventTs(NEVER)
+{
+    NS_LOG_FUNCTION(this);
+    // Until the first Run, every event goes to a single partition.
+    auto p = std::make_unique<Partition>();
+    p->index = 0;
+    p->systemId = 0;
+    p->currentTs = 0;
+    p->currentContext = Simulator::NO_CONTEXT;
+    p->currentUid = EventId::UID::INVALID;
+    p->eventCount = 0;
+    p->unscheduledEvents = 0;
+    p->remoteSeq = 0;
+    p->stop = false;
+    p->inbox = nullptr;
+    m_partitions.push_back(std::move(p));
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& p : m_partitions)
+    {
+        ReceiveRemoteEvents(p.get());
+        while (!p->events->IsEmpty())
+        {
+            Scheduler::Event next = p->events->RemoveNext();
+            next.impl->Unref();
+        }
+        p->events = nullptr;
+    }
+    m_partitions.clear();
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+    for (auto& p : m_partitions)
+    {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        if (p->events)
+        {
+            while (!p->events->IsEmpty())
+            {
+                scheduler->Insert(p->events->RemoveNext());
+            }
+        }
+        p->events = scheduler;
+    }
+}
+
+MultithreadedSimulatorImpl::Partition*
+MultithreadedSimulatorImpl::GetCurrentPartition() const
+{
+    // Outside of Run, the main thread acts for the first partition.
+    return g_partition != nullptr ? g_partition : m_partitions.front().get();
+}
+
+MultithreadedSimulatorImpl::Partition*
+MultithreadedSimulatorImpl::GetPartition(uint32_t context) const
+{
+    if (context < m_nodePartition.size())
+    {
+        return m_partitions[m_nodePartition[context]].get();
+    }
+    // No node context, or a node created while running: stay local.
+    return GetCurrentPartition();
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions()
+{
+    NS_LOG_FUNCTION(this);
+    std::set<uint32_t> systemIds;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); ++i)
+    {
+        systemIds.insert((*i)->GetSystemId());
+    }
+
+    if (!m_partitioned && !systemIds.empty())
+    {
+        // Spread the events scheduled so far over one partition per system id.
+        Partition* first = m_partitions.front().get();
+        first->systemId = *systemIds.begin();
+        for (auto id = std::next(systemIds.begin()); id != systemIds.end(); ++id)
+        {
+            auto p = std::make_unique<Partition>();
+            p->index = m_partitions.size();
+            p->systemId = *id;
+            p->events = m_schedulerFactory.Create<Scheduler>();
+            p->currentTs = first->currentTs;
+            p->currentContext = Simulator::NO_CONTEXT;
+            p->currentUid = EventId::UID::INVALID;
+            p->eventCount = 0;
+            p->unscheduledEvents = 0;
+            p->remoteSeq = 0;
+            p->stop = false;
+            p->inbox = nullptr;
+            m_partitions.push_back(std::move(p));
+        }
+        m_partitioned = true;
+    }
+
+    std::map<uint32_t, uint32_t> indexOf;
+    for (const auto& p : m_partitions)
+    {
+        indexOf[p->systemId] = p->index;
+    }
+    m_nodePartition.resize(NodeList::GetNNodes());
+    for (auto i = NodeList::Begin(); i != NodeList::End(); ++i)
+    {
+        auto it = indexOf.find((*i)->GetSystemId());
+        NS_ABORT_MSG_IF(it == indexOf.end(),
+                        "Node " << (*i)->GetId() << " uses system id " << (*i)->GetSystemId()
+                                << ", unknown when the partitions were created by the first Run");
+        m_nodePartition[(*i)->GetId()] = it->second;
+    }
+
+    // Move the events of the first partition to the partition of their context.
+    Partition* first = m_partitions.front().get();
+    if (m_partitions.size() > 1)
+    {
+        std::vector<Scheduler::Event> local;
+        while (!first->events->IsEmpty())
+        {
+            Scheduler::Event ev = first->events->RemoveNext();
+            Partition* p = GetPartition(ev.key.m_context);
+            if (p == first)
+            {
+                local.push_back(ev);
+            }
+            else
+            {
+                first->unscheduledEvents--;
+                p->unscheduledEvents++;
+                p->events->Insert(ev);
+            }
+        }
+        for (const auto& ev : local)
+        {
+            first->events->Insert(ev);
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookahead()
+{
+    NS_LOG_FUNCTION(this);
+    m_lookahead = NEVER;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); ++i)
+    {
+        Ptr<Node> node = *i;
+        for (uint32_t j = 0; j < node->GetNDevices(); ++j)
+        {
+            Ptr<NetDevice> device = node->GetDevice(j);
+            // only point-to-point links are allowed between partitions
+            Ptr<Channel> channel = device->GetChannel();
+            if (!device->IsPointToPoint() || !channel)
+            {
+                continue;
+            }
+            for (std::size_t k = 0; k < channel->GetNDevices(); ++k)
+            {
+                Ptr<Node> remote = channel->GetDevice(k)->GetNode();
+                if (remote->GetSystemId() == node->GetSystemId())
+                {
+                    continue;
+                }
+                TimeValue delay;
+                channel->GetAttribute("Delay", delay);
+                NS_ABORT_MSG_IF(!delay.Get().IsStrictlyPositive(),
+                                "Channel between nodes " << node->GetId() << " and "
+                                                         << remote->GetId()
+                                                         << " crosses partitions with no delay");
+                m_lookahead = std::min<uint64_t>(m_lookahead, delay.Get().GetTimeStep());
+            }
+        }
+    }
+    NS_LOG_LOGIC("lookahead " << m_lookahead);
+}
+
+EventId
+MultithreadedSimulatorImpl::Insert(Partition* p, uint64_t ts, uint32_t context, EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    // The uids only need to grow within a partition to order its events,
+    // but they also have to be unique across partitions to identify them
+    ev.key.m_uid = m_uid.fetch_add(1, std::memory_order_relaxed);
+    p->unscheduledEvents++;
+    p->events->Insert(ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ReceiveRemoteEvents(Partition* p)
+{
+    RemoteEvent* head = p->inbox.exchange(nullptr, std::memory_order_acquire);
+    if (head == nullptr)
+    {
+        return;
+    }
+    std::vector<RemoteEvent*> received;
+    for (RemoteEvent* e = head; e != nullptr; e = e->next)
+    {
+        received.push_back(e);
+    }
+    // Assign uids in an order which does not depend on thread timing.
+    std::sort(received.begin(), received.end(), [](const RemoteEvent* a, const RemoteEvent* b) {
+        return std::tie(a->ts, a->source, a->seq) < std::tie(b->ts, b->source, b->seq);
+    });
+    for (RemoteEvent* e : received)
+    {
+        NS_ASSERT(e->ts >= p->currentTs);
+        Insert(p, e->ts, e->context, e->event);
+        delete e;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::NextWindow()
+{
+    uint64_t next = NEVER;
+    for (const auto& p : m_partitions)
+    {
+        if (!p->events->IsEmpty())
+        {
+            next = std::min(next, p->events->PeekNext().key.m_ts);
+        }
+        for (RemoteEvent* e = p->inbox.load(std::memory_order_acquire); e != nullptr; e = e->next)
+        {
+            next = std::min(next, e->ts);
+        }
+    }
+    if (m_stop || next == NEVER)
+    {
+        m_finished = true;
+        return;
+    }
+    m_windowEnd = m_lookahead == NEVER || next > NEVER - m_lookahead ? NEVER : next + m_lookahead;
+    uint64_t stopEventTs = m_stopEventTs.load(std::memory_order_relaxed);
+    if (next <= stopEventTs && stopEventTs < NEVER)
+    {
+        // let the Stop event end the window so that no partition runs past it
+        m_windowEnd = std::min(m_windowEnd, stopEventTs + 1);
+    }
+    m_windowCount++;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow(Partition* p)
+{
+    while (!p->events->IsEmpty() && !p->stop)
+    {
+        Scheduler::Event next = p->events->PeekNext();
+        if (next.key.m_ts >= m_windowEnd)
+        {
+            break;
+        }
+        p->events->RemoveNext();
+
+        PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+        NS_ASSERT(next.key.m_ts >= p->currentTs);
+        p->unscheduledEvents--;
+        p->eventCount++;
+
+        p->currentTs = next.key.m_ts;
+        p->currentContext = next.key.m_context;
+        p->currentUid = next.key.m_uid;
+        next.impl->Invoke();
+        next.impl->Unref();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(g_partition == nullptr, "Simulator::Run called from an event");
+    CreatePartitions();
+    CalculateLookahead();
+    m_stop = false;
+    for (auto& p : m_partitions)
+    {
+        p->stop = false;
+    }
+    m_finished = false;
+    m_windowCount = 0;
+
+    auto onWindow = [this]() noexcept { NextWindow(); };
+    std::barrier window(m_partitions.size(), onWindow);
+    auto drive = [this, &window](Partition* p) {
+        g_partition = p;
+        while (true)
+        {
+            window.arrive_and_wait();
+            if (m_finished)
+            {
+                break;
+            }
+            ReceiveRemoteEvents(p);
+            ProcessWindow(p);
+        }
+        g_partition = nullptr;
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < m_partitions.size(); ++i)
+    {
+        threads.emplace_back(drive, m_partitions[i].get());
+    }
+    drive(m_partitions.front().get());
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto& p : m_partitions)
+    {
+        ReceiveRemoteEvents(p.get());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    // The other partitions complete the current window, whatever their
+    // progress so far, and the barrier then ends the simulation
+    GetCurrentPartition()->stop = true;
+    m_stop = true;
+}
+
+EventId
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    uint64_t ts = GetCurrentPartition()->currentTs + delay.GetTimeStep();
+    uint64_t stopEventTs = m_stopEventTs.load();
+    while (ts < stopEventTs && !m_stopEventTs.compare_exchange_weak(stopEventTs, ts))
+    {
+    }
+    return Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+    Partition* p = GetCurrentPartition();
+    Time tAbsolute = delay + TimeStep(p->currentTs);
+    return Insert(p, tAbsolute.GetTimeStep(), p->currentContext, event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+    Partition* current = GetCurrentPartition();
+    Partition* p = GetPartition(context);
+    uint64_t ts = (delay + TimeStep(current->currentTs)).GetTimeStep();
+    if (g_partition == nullptr || p == current)
+    {
+        Insert(p, ts, context, event);
+        return;
+    }
+
+    NS_ABORT_MSG_IF(ts < m_windowEnd,
+                    "Event for node " << context << " scheduled " << delay.As(Time::S)
+                                      << " ahead, below the lookahead of "
+                                      << TimeStep(m_lookahead).As(Time::S));
+    auto e = new RemoteEvent;
+    e->ts = ts;
+    e->context = context;
+    e->source = current->index;
+    e->seq = current->remoteSeq++;
+    e->event = event;
+    e->next = p->inbox.load(std::memory_order_relaxed);
+    while (!p->inbox.compare_exchange_weak(e->next,
+                                           e,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed))
+    {
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    NS_ASSERT_MSG(g_partition == nullptr,
+                  "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+
+    EventId id(Ptr<EventImpl>(event, false), GetCurrentPartition()->currentTs, 0xffffffff, 2);
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(GetCurrentPartition()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - GetCurrentPartition()->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Partition* p = GetCurrentPartition();
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    p->events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    p->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    const Partition* p = GetCurrentPartition();
+    return id.PeekEventImpl() == nullptr || id.GetTs() < p->currentTs ||
+           (id.GetTs() == p->currentTs && id.GetUid() <= p->currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (g_partition != nullptr)
+    {
+        // The other partitions are running: the barrier found pending
+        // events to open the current window, and decides the end of Run,
+        // a Stop included
+        return m_finished;
+    }
+    if (m_stop)
+    {
+        return true;
+    }
+    for (const auto& p : m_partitions)
+    {
+        if (!p->events->IsEmpty() || p->inbox.load() != nullptr)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return GetCurrentPartition()->systemId;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrentPartition()->currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    if (g_partition != nullptr)
+    {
+        return g_partition->eventCount;
+    }
+    uint64_t count = 0;
+    for (const auto& p : m_partitions)
+    {
+        count += p->eventCount;
+    }
+    return count;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount() const
+{
+    return m_partitions.size();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return m_lookahead == NEVER ? GetMaximumSimulationTime() : TimeStep(m_lookahead);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetWindowCount() const
+{
+    return m_windowCount;
+}
+
+} // namespace ns3
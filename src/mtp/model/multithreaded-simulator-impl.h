@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-id.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3
+{
+
+class Scheduler;
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Shared-memory parallel simulator implementation.
+ *
+ * Nodes are partitioned by Node::GetSystemId, exactly as for the MPI
+ * based implementations, but all partitions live in one process and
+ * each one is driven by its own thread with its own event queue.
+ * Partitions synchronize with a conservative time window: every
+ * partition processes the events that are earlier than the smallest
+ * pending timestamp plus the lookahead, which is the smallest delay of
+ * the point-to-point channels connecting nodes of different
+ * partitions.  Events scheduled on a node of another partition are
+ * handed over, together with their Ptr<Packet> arguments, through a
+ * lock-free queue owned by the receiving partition, so no packet is
+ * ever serialized.
+ *
+ * Events scheduled before the first Run are assigned to the partition
+ * of the node in their context; events without a node context run in
+ * the first partition.  Remove, Cancel and IsExpired must be called
+ * from the partition which scheduled the event, and destroy events
+ * run on the main thread.
+ *
+ * Stop ends the partition which calls it after the current event, like
+ * the default implementation, and the other partitions at the end of
+ * the current window, whose bounds were computed from the global
+ * minimum time at the last synchronization: where the simulation stops
+ * does not depend on the progress of the threads.  For the same reason,
+ * IsFinished only considers the state of the last synchronization while
+ * the partitions run.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * \return the number of partitions, hence of threads, used by Run
+     */
+    uint32_t GetPartitionCount() const;
+    /**
+     * \return the lookahead computed by the last Run
+     */
+    Time GetLookahead() const;
+    /**
+     * \return the number of synchronization windows of the last Run
+     */
+    uint64_t GetWindowCount() const;
+
+  private:
+    void DoDispose() override;
+
+    /** An event handed over to another partition. */
+    struct RemoteEvent
+    {
+        RemoteEvent* next; //!< Next in the receiving inbox
+        uint64_t ts;       //!< Absolute timestamp
+        uint32_t context;  //!< Event context
+        uint32_t source;   //!< Index of the sending partition
+        uint64_t seq;      //!< Sequence number within the sending partition
+        EventImpl* event;  //!< The event, holding one reference
+    };
+
+    /** The state of one partition, owned by a single thread during Run. */
+    struct Partition
+    {
+        uint32_t index;          //!< Index in m_partitions
+        uint32_t systemId;       //!< The Node::GetSystemId served
+        Ptr<Scheduler> events;   //!< The event queue
+        uint64_t currentTs;      //!< Timestamp of the current event
+        uint32_t currentContext; //!< Context of the current event
+        uint32_t currentUid;     //!< Uid of the current event
+        uint64_t eventCount;     //!< Number of events executed
+        int unscheduledEvents;   //!< Number of events in the queue
+        uint64_t remoteSeq;      //!< Sequence number of the next remote event
+        bool stop;               //!< Whether Stop was called by an event of the partition
+        /** Events received from other partitions, most recent first */
+        std::atomic<RemoteEvent*> inbox;
+    };
+
+    /** \return the partition of the calling thread */
+    Partition* GetCurrentPartition() const;
+    /**
+     * \param context the event context
+     * \return the partition which executes the events of \pname{context}
+     */
+    Partition* GetPartition(uint32_t context) const;
+    /** Create the partitions and assign nodes and pending events to them. */
+    void CreatePartitions();
+    /** Compute m_lookahead from the channels crossing partitions. */
+    void CalculateLookahead();
+    /**
+     * Insert an event in the queue of a partition.
+     * \param p the partition
+     * \param ts the absolute timestamp
+     * \param context the event context
+     * \param event the event
+     * \return the id of the scheduled event
+     */
+    EventId Insert(Partition* p, uint64_t ts, uint32_t context, EventImpl* event);
+    /**
+     * Move the events received from other partitions into the queue.
+     * \param p the receiving partition
+     */
+    void ReceiveRemoteEvents(Partition* p);
+    /**
+     * Compute the next window, or decide the end of Run; called by the
+     * last thread to reach the window barrier.
+     */
+    void NextWindow();
+    /**
+     * Process the events of a partition which fall in the current window.
+     * \param p the partition
+     */
+    void ProcessWindow(Partition* p);
+
+    /** Container type for the destroy events */
+    typedef std::list<EventId> DestroyEvents;
+
+    /** The destroy events, run on the main thread */
+    DestroyEvents m_destroyEvents;
+    /** The scheduler factory, used once per partition */
+    ObjectFactory m_schedulerFactory;
+    /** The partitions, indexed in increasing system id order */
+    std::vector<std::unique_ptr<Partition>> m_partitions;
+    /** The partition of each node, indexed by node id */
+    std::vector<uint32_t> m_nodePartition;
+    /** Whether the partitions have been created */
+    bool m_partitioned;
+    /** The conservative lookahead, in time steps */
+    uint64_t m_lookahead;
+    /** Exclusive end of the current window */
+    uint64_t m_windowEnd;
+    /** Number of windows of the last Run */
+    uint64_t m_windowCount;
+    /** Set by the barrier when every partition has to leave Run */
+    bool m_finished;
+    /** Flag calling for the end of the simulation at the end of the window */
+    std::atomic<bool> m_stop;
+    /** Next event uid, shared by all the partitions so that uids are unique */
+    std::atomic<uint32_t> m_uid;
+    /** Earliest timestamp of a pending Stop(delay) event */
+    std::atomic<uint64_t> m_stopEventTs;
+
+    /** The partition driven by the calling thread during Run */
+    static thread_local Partition* g_partition;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
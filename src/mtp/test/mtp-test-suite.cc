@@ -0,0 +1,360 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * Multithreaded simulator test suite.
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests Multithreaded simulator tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Relays packets around a ring of nodes, one partition per node,
+ * and checks that the multithreaded simulator reproduces the reception
+ * times of the default simulator.
+ */
+class MtpRingTestCase : public TestCase
+{
+  public:
+    MtpRingTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Reception time and packet uid, in reception order */
+    typedef std::vector<std::pair<Time, uint64_t>> Log;
+
+    /**
+     * Run the ring scenario.
+     * \param simulatorType the simulator implementation type
+     * \return the per-node reception logs
+     */
+    std::vector<Log> RunRing(const std::string& simulatorType);
+
+    /**
+     * Receive a packet and relay it to the next node while it has hops left.
+     * \param device the receiving device
+     * \param packet the packet
+     * \param protocol the protocol number
+     * \param from the sender address
+     * \return true
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    NetDeviceContainer m_out; //!< Device of each node towards the next node
+    std::vector<Log> m_logs;  //!< Reception logs, per node
+};
+
+/** Number of nodes, hence partitions, in the ring. */
+static const uint32_t RING_SIZE = 4;
+/** Number of receptions of each packet before it is dropped. */
+static const uint32_t HOPS = 12;
+
+MtpRingTestCase::MtpRingTestCase()
+    : TestCase("Check that a ring of partitions matches the default simulator")
+{
+}
+
+bool
+MtpRingTestCase::Receive(Ptr<NetDevice> device,
+                         Ptr<const Packet> packet,
+                         uint16_t protocol,
+                         const Address& from)
+{
+    // the payload size counts the hops done so far
+    uint32_t node = device->GetNode()->GetId();
+    m_logs[node].emplace_back(Simulator::Now(), packet->GetUid());
+    uint32_t hops = packet->GetSize() - 100 + 1;
+    if (hops < HOPS)
+    {
+        Ptr<NetDevice> out = m_out.Get(node);
+        out->Send(Create<Packet>(100 + hops), out->GetBroadcast(), 0x0800);
+    }
+    return true;
+}
+
+std::vector<MtpRingTestCase::Log>
+MtpRingTestCase::RunRing(const std::string& simulatorType)
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(simulatorType));
+
+    NodeContainer nodes;
+    for (uint32_t i = 0; i < RING_SIZE; ++i)
+    {
+        nodes.Add(CreateObject<Node>(i));
+    }
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("2ms"));
+    m_out = NetDeviceContainer();
+    for (uint32_t i = 0; i < RING_SIZE; ++i)
+    {
+        NetDeviceContainer link = p2p.Install(nodes.Get(i), nodes.Get((i + 1) % RING_SIZE));
+        m_out.Add(link.Get(0));
+        link.Get(1)->SetReceiveCallback(MakeCallback(&MtpRingTestCase::Receive, this));
+    }
+
+    m_logs.assign(RING_SIZE, Log());
+    for (uint32_t i = 0; i < RING_SIZE; ++i)
+    {
+        Ptr<NetDevice> out = m_out.Get(i);
+        Simulator::ScheduleWithContext(i,
+                                       MicroSeconds(100 * i),
+                                       [out]() {
+                                           out->Send(Create<Packet>(100),
+                                                     out->GetBroadcast(),
+                                                     0x0800);
+                                       });
+    }
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+
+    std::vector<Log> logs = std::move(m_logs);
+    m_out = NetDeviceContainer();
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    return logs;
+}
+
+void
+MtpRingTestCase::DoRun()
+{
+    std::vector<Log> expected = RunRing("ns3::DefaultSimulatorImpl");
+    std::vector<Log> actual = RunRing("ns3::MultithreadedSimulatorImpl");
+
+    NS_TEST_ASSERT_MSG_EQ(actual.size(), expected.size(), "Wrong number of nodes");
+    for (uint32_t node = 0; node < RING_SIZE; ++node)
+    {
+        NS_TEST_ASSERT_MSG_EQ(expected[node].size(), HOPS, "Wrong number of receptions");
+        NS_TEST_ASSERT_MSG_EQ(actual[node].size(),
+                              expected[node].size(),
+                              "Wrong number of receptions on node " << node);
+        for (std::size_t i = 0; i < expected[node].size(); ++i)
+        {
+            NS_TEST_EXPECT_MSG_EQ(actual[node][i].first,
+                                  expected[node][i].first,
+                                  "Wrong reception time on node " << node);
+            // the upper 32 bits of the uid carry the system id of the sender
+            uint64_t sender = actual[node][i].second >> 32;
+            NS_TEST_EXPECT_MSG_EQ(sender,
+                                  (node + RING_SIZE - 1) % RING_SIZE,
+                                  "Wrong sender partition on node " << node);
+        }
+    }
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Checks the partitions and lookahead derived from the topology.
+ */
+class MtpLookaheadTestCase : public TestCase
+{
+  public:
+    MtpLookaheadTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MtpLookaheadTestCase::MtpLookaheadTestCase()
+    : TestCase("Check partitioning and lookahead")
+{
+}
+
+void
+MtpLookaheadTestCase::DoRun()
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+
+    // two nodes per partition; the intra-partition link is faster
+    NodeContainer nodes;
+    nodes.Add(CreateObject<Node>(0));
+    nodes.Add(CreateObject<Node>(0));
+    nodes.Add(CreateObject<Node>(1));
+    nodes.Add(CreateObject<Node>(1));
+
+    PointToPointHelper p2p;
+    p2p.SetChannelAttribute("Delay", StringValue("1us"));
+    p2p.Install(nodes.Get(0), nodes.Get(1));
+    p2p.SetChannelAttribute("Delay", StringValue("5ms"));
+    p2p.Install(nodes.Get(1), nodes.Get(2));
+    p2p.SetChannelAttribute("Delay", StringValue("3ms"));
+    p2p.Install(nodes.Get(3), nodes.Get(0));
+
+    // each event writes its own slot, from the thread of its partition
+    std::vector<uint32_t> systemIds(nodes.GetN(), 0xffffffff);
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Simulator::ScheduleWithContext(i, MilliSeconds(10 * i), [&systemIds]() {
+            systemIds[Simulator::GetContext()] = Simulator::GetSystemId();
+        });
+    }
+    Simulator::Run();
+
+    auto impl = DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    NS_TEST_ASSERT_MSG_NE(impl, nullptr, "Wrong simulator implementation");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetPartitionCount(), 2, "Wrong number of partitions");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLookahead(), MilliSeconds(3), "Wrong lookahead");
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(systemIds[i], i / 2, "Event of node " << i << " ran elsewhere");
+    }
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MilliSeconds(10), "Wrong final time of partition 0");
+
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Checks that Stop ends the other partitions at the end of the
+ * window, whatever the progress of their threads, and that the event
+ * uids are unique across partitions.
+ */
+class MtpStopTestCase : public TestCase
+{
+  public:
+    MtpStopTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run two partitions, the first one stopping the simulation at 1ms.
+     * \return the number of events run by each partition
+     */
+    std::vector<uint32_t> RunStop();
+};
+
+MtpStopTestCase::MtpStopTestCase()
+    : TestCase("Check Stop, IsFinished and the event uids across partitions")
+{
+}
+
+std::vector<uint32_t>
+MtpStopTestCase::RunStop()
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+
+    NodeContainer nodes;
+    nodes.Add(CreateObject<Node>(0));
+    nodes.Add(CreateObject<Node>(1));
+    PointToPointHelper p2p;
+    p2p.SetChannelAttribute("Delay", StringValue("3ms"));
+    p2p.Install(nodes);
+
+    // each partition counts its events, and keeps the ids of the events
+    // it schedules while running
+    std::vector<uint32_t> counts(2, 0);
+    std::vector<std::vector<EventId>> ids(2);
+    std::vector<bool> finished(2, true);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        for (uint32_t node = 0; node < 2; ++node)
+        {
+            Simulator::ScheduleWithContext(node,
+                                           MicroSeconds(100 * i),
+                                           [&counts, &ids, &finished, node]() {
+                                               counts[node]++;
+                                               ids[node].push_back(Simulator::Schedule(
+                                                   Seconds(1),
+                                                   []() {}));
+                                               finished[node] = Simulator::IsFinished();
+                                           });
+        }
+    }
+    Simulator::ScheduleWithContext(0, MilliSeconds(1), []() { Simulator::Stop(); });
+    Simulator::Run();
+
+    std::set<uint32_t> uids;
+    for (const auto& partition : ids)
+    {
+        for (const auto& id : partition)
+        {
+            uids.insert(id.GetUid());
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(uids.size(), counts[0] + counts[1], "Event uids reused");
+    NS_TEST_EXPECT_MSG_EQ(finished[0], false, "Finished while events are pending");
+    NS_TEST_EXPECT_MSG_EQ(finished[1], false, "Finished while events are pending");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::IsFinished(), true, "Not finished after Stop");
+
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    return counts;
+}
+
+void
+MtpStopTestCase::DoRun()
+{
+    // the first partition stops after its events up to 1ms, the event at
+    // 1ms included since it was scheduled before the Stop one, and the
+    // second one completes the window which the lookahead of 3ms opened
+    // at 0: the outcome is the same on every run
+    for (uint32_t run = 0; run < 5; ++run)
+    {
+        std::vector<uint32_t> counts = RunStop();
+        NS_TEST_EXPECT_MSG_EQ(counts[0], 11, "Wrong events of the stopping partition");
+        NS_TEST_EXPECT_MSG_EQ(counts[1], 30, "Wrong events of the other partition");
+    }
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Multithreaded simulator test suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite()
+        : TestSuite("mtp", UNIT)
+    {
+        AddTestCase(new MtpRingTestCase(), TestCase::QUICK);
+        AddTestCase(new MtpLookaheadTestCase(), TestCase::QUICK);
+        AddTestCase(new MtpStopTestCase(), TestCase::QUICK);
+    }
+};
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
@@ -260,10 +260,12 @@ NixVector::Deserialize(const uint32_t* buffer, uint32_t size)
         uint32_t nixVectorLength = m_totalBitSize / 32;
         nixVectorLength += (m_totalBitSize % 32) ? 1 : 0;
 
-        NS_ASSERT_MSG(size >= 16 + nixVectorLength,
-                      "NixVector serialized length should have been " << 16 + nixVectorLength
+        // m_totalBitSize, m_used, the nix-vector and m_epoch
+        uint32_t serializedSize = 12 + nixVectorLength * 4;
+        NS_ASSERT_MSG(size >= serializedSize,
+                      "NixVector serialized length should have been " << serializedSize
                                                                       << " but buffer is shorter");
-        if (size < 16 + nixVectorLength * 4)
+        if (size < serializedSize)
         {
             // return zero if an entire nix-vector was
             // not deserialized
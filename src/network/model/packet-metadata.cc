@@ -25,6 +25,7 @@
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 #include <list>
 #include <utility>
@@ -36,10 +37,20 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
+std::vector<bool> PacketMetadata::m_enableNodes;
+#ifdef NS3_MTP
+std::atomic<bool> PacketMetadata::m_metadataSkipped = false;
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+thread_local uint16_t PacketMetadata::m_chunkUid = 0;
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local bool PacketMetadata::m_freeListDestroyed = false;
+#else
 bool PacketMetadata::m_metadataSkipped = false;
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+bool PacketMetadata::m_freeListDestroyed = false;
+#endif
 
 PacketMetadata::DataFreeList::~DataFreeList()
 {
@@ -48,7 +59,7 @@ PacketMetadata::DataFreeList::~DataFreeList()
     {
         PacketMetadata::Deallocate(*i);
     }
-    PacketMetadata::m_enable = false;
+    PacketMetadata::m_freeListDestroyed = true;
 }
 
 void
@@ -73,6 +84,62 @@ PacketMetadata::EnableChecking()
     m_enableChecking = true;
 }
 
+void
+PacketMetadata::EnableNode(uint32_t nodeId)
+{
+    NS_LOG_FUNCTION(nodeId);
+    if (m_enableNodes.size() <= nodeId)
+    {
+        m_enableNodes.resize(nodeId + 1, false);
+    }
+    m_enableNodes[nodeId] = true;
+}
+
+bool
+PacketMetadata::IsContextEnabled()
+{
+    uint32_t context = Simulator::GetContext();
+    return context < m_enableNodes.size() && m_enableNodes[context];
+}
+
+PacketMetadata
+PacketMetadata::CreateEmpty(uint64_t uid)
+{
+    NS_LOG_FUNCTION(uid);
+    PacketMetadata metadata(uid, 0);
+    metadata.m_enabled = true;
+    metadata.Spill();
+    return metadata;
+}
+
+void
+PacketMetadata::Spill()
+{
+    if (m_data != nullptr)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this << +m_inlineSize);
+    uint8_t size = m_inlineSize;
+    m_data = PacketMetadata::Create(10);
+    memset(m_data->m_data, 0xff, 4);
+    m_head = 0xffff;
+    m_tail = 0xffff;
+    m_used = 0;
+    m_inlineSize = 0;
+    for (uint8_t i = 0; i < size; i++)
+    {
+        PacketMetadata::SmallItem item;
+        item.next = m_head;
+        item.prev = 0xffff;
+        item.typeUid = m_inline[i].typeUid;
+        item.size = m_inline[i].size;
+        item.chunkUid = m_inline[i].chunkUid;
+        uint16_t written = AddSmall(&item);
+        UpdateHead(written);
+    }
+}
+
 void
 PacketMetadata::ReserveCopy(uint32_t size)
 {
@@ -80,8 +147,7 @@ PacketMetadata::ReserveCopy(uint32_t size)
     PacketMetadata::Data* newData = PacketMetadata::Create(m_used + size);
     memcpy(newData->m_data, m_data->m_data, m_used);
     newData->m_dirtyEnd = m_used;
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
@@ -104,8 +170,7 @@ PacketMetadata::Reserve(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
     NS_ASSERT(m_data != nullptr);
-    if (m_data->m_size >= m_used + size &&
-        (m_head == 0xffff || m_data->m_count == 1 || m_data->m_dirtyEnd == m_used))
+    if (m_data->m_size >= m_used + size && IsTailWritable())
     {
         /* enough room, not dirty. */
     }
@@ -116,6 +181,17 @@ PacketMetadata::Reserve(uint32_t size)
     }
 }
 
+bool
+PacketMetadata::IsTailWritable() const
+{
+#ifdef NS3_MTP
+    // a shared tail may be appended to concurrently from another thread
+    return m_data->m_count == 1;
+#else
+    return m_head == 0xffff || m_data->m_count == 1 || m_data->m_dirtyEnd == m_used;
+#endif
+}
+
 bool
 PacketMetadata::IsSharedPointerOk(uint16_t pointer) const
 {
@@ -136,6 +212,11 @@ bool
 PacketMetadata::IsStateOk() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_data == nullptr)
+    {
+        return m_inlineSize <= INLINE_ITEMS &&
+               m_head == (m_inlineSize == 0 ? 0xffff : m_inlineSize - 1);
+    }
     bool ok = m_used <= m_data->m_size;
     ok &= IsPointerOk(m_head);
     ok &= IsPointerOk(m_tail);
@@ -384,8 +465,7 @@ PacketMetadata::AddSmall(const PacketMetadata::SmallItem* item)
     uint32_t typeUidSize = GetUleb128Size(item->typeUid);
     uint32_t sizeSize = GetUleb128Size(item->size);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2;
-    if (m_used + n > m_data->m_size ||
-        (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
+    if (m_used + n > m_data->m_size || !IsTailWritable())
     {
         ReserveCopy(n);
     }
@@ -421,8 +501,7 @@ PacketMetadata::AddBig(uint32_t next,
     uint32_t fragEndSize = GetUleb128Size(extraItem->fragmentEnd);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
 
-    if (m_used + n > m_data->m_size ||
-        (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
+    if (m_used + n > m_data->m_size || !IsTailWritable())
     {
         ReserveCopy(n);
     }
@@ -503,7 +582,7 @@ PacketMetadata::ReplaceTail(PacketMetadata::SmallItem* item,
      */
 
     // create a copy of the packet without its tail.
-    PacketMetadata h(m_packetUid, 0);
+    PacketMetadata h = CreateEmpty(m_packetUid);
     uint16_t current = m_head;
     while (current != 0xffff && current != m_tail)
     {
@@ -529,6 +608,20 @@ PacketMetadata::ReadItems(uint16_t current,
     NS_LOG_FUNCTION(this << current << item->chunkUid << item->prev << item->next << item->size
                          << item->typeUid << extraItem->fragmentEnd << extraItem->fragmentStart
                          << extraItem->packetUid);
+    if (m_data == nullptr)
+    {
+        // inline header stack: the next item is the one below
+        NS_ASSERT(current < m_inlineSize);
+        item->next = current == 0 ? 0xffff : current - 1;
+        item->prev = current + 1 == m_inlineSize ? 0xffff : current + 1;
+        item->typeUid = m_inline[current].typeUid;
+        item->size = m_inline[current].size;
+        item->chunkUid = m_inline[current].chunkUid;
+        extraItem->fragmentStart = 0;
+        extraItem->fragmentEnd = item->size;
+        extraItem->packetUid = m_packetUid;
+        return 0;
+    }
     NS_ASSERT(current <= m_data->m_size);
     const uint8_t* buffer = &m_data->m_data[current];
     item->next = buffer[0];
@@ -572,7 +665,7 @@ PacketMetadata::Create(uint32_t size)
     {
         m_maxSize = size;
     }
-    while (!m_freeList.empty())
+    while (!m_freeListDestroyed && !m_freeList.empty())
     {
         PacketMetadata::Data* data = m_freeList.back();
         m_freeList.pop_back();
@@ -593,7 +686,7 @@ void
 PacketMetadata::Recycle(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
-    if (!m_enable)
+    if (m_freeListDestroyed)
     {
         PacketMetadata::Deallocate(data);
         return;
@@ -659,11 +752,19 @@ void
 PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
 {
     NS_LOG_FUNCTION(this << uid << size);
-    if (!m_enable)
+    if (!m_enabled)
     {
         m_metadataSkipped = true;
         return;
     }
+    if (m_data == nullptr && m_inlineSize < INLINE_ITEMS)
+    {
+        m_inline[m_inlineSize] = {uid, size, m_chunkUid};
+        m_chunkUid++;
+        SetInlineSize(m_inlineSize + 1);
+        return;
+    }
+    Spill();
 
     PacketMetadata::SmallItem item;
     item.next = m_head;
@@ -681,11 +782,25 @@ PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
 {
     uint32_t uid = header.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &header << size);
-    if (!m_enable)
+    if (!m_enabled)
     {
         m_metadataSkipped = true;
         return;
     }
+    if (m_data == nullptr)
+    {
+        if (m_inlineSize == 0 || m_inline[m_inlineSize - 1].typeUid != uid ||
+            m_inline[m_inlineSize - 1].size != size)
+        {
+            if (m_enableChecking)
+            {
+                NS_FATAL_ERROR("Removing unexpected header.");
+            }
+            return;
+        }
+        SetInlineSize(m_inlineSize - 1);
+        return;
+    }
     PacketMetadata::SmallItem item;
     PacketMetadata::ExtraItem extraItem;
     uint32_t read = ReadItems(m_head, &item, &extraItem);
@@ -726,11 +841,12 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
 {
     uint32_t uid = trailer.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &trailer << size);
-    if (!m_enable)
+    if (!m_enabled)
     {
         m_metadataSkipped = true;
         return;
     }
+    Spill();
     PacketMetadata::SmallItem item;
     item.next = 0xffff;
     item.prev = m_tail;
@@ -748,11 +864,12 @@ PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
 {
     uint32_t uid = trailer.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &trailer << size);
-    if (!m_enable)
+    if (!m_enabled)
     {
         m_metadataSkipped = true;
         return;
     }
+    Spill();
     PacketMetadata::SmallItem item;
     PacketMetadata::ExtraItem extraItem;
     uint32_t read = ReadItems(m_tail, &item, &extraItem);
@@ -792,7 +909,7 @@ void
 PacketMetadata::AddAtEnd(const PacketMetadata& o)
 {
     NS_LOG_FUNCTION(this << &o);
-    if (!m_enable)
+    if (!m_enabled)
     {
         m_metadataSkipped = true;
         return;
@@ -805,6 +922,20 @@ PacketMetadata::AddAtEnd(const PacketMetadata& o)
         NS_ASSERT(IsStateOk());
         return;
     }
+    if (!o.m_enabled)
+    {
+        // The items would not describe the appended bytes: drop them all
+        // rather than keep an inconsistent metadata.
+        if (m_data != nullptr && --m_data->m_count == 0)
+        {
+            PacketMetadata::Recycle(m_data);
+        }
+        m_data = nullptr;
+        m_used = 0;
+        SetInlineSize(0);
+        m_enabled = false;
+        return;
+    }
     if (o.m_head == 0xffff)
     {
         NS_ASSERT(o.m_tail == 0xffff);
@@ -812,6 +943,7 @@ PacketMetadata::AddAtEnd(const PacketMetadata& o)
         return;
     }
     NS_ASSERT(m_head != 0xffff && m_tail != 0xffff);
+    Spill();
 
     // We read the current tail because we are going to append
     // after this item.
@@ -868,7 +1000,7 @@ void
 PacketMetadata::AddPaddingAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
-    if (!m_enable)
+    if (!m_enabled)
     {
         m_metadataSkipped = true;
         return;
@@ -879,12 +1011,16 @@ void
 PacketMetadata::RemoveAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
-    if (!m_enable)
+    if (!m_enabled)
     {
         m_metadataSkipped = true;
         return;
     }
-    NS_ASSERT(m_data != nullptr);
+    if (start == 0)
+    {
+        return;
+    }
+    Spill();
     uint32_t leftToRemove = start;
     uint16_t current = m_head;
     while (current != 0xffff && leftToRemove > 0)
@@ -910,7 +1046,7 @@ PacketMetadata::RemoveAtStart(uint32_t start)
         else
         {
             // fragment the list item.
-            PacketMetadata fragment(m_packetUid, 0);
+            PacketMetadata fragment = CreateEmpty(m_packetUid);
             extraItem.fragmentStart += leftToRemove;
             leftToRemove = 0;
             uint16_t written = fragment.AddBig(0xffff, fragment.m_tail, &item, &extraItem);
@@ -940,12 +1076,16 @@ void
 PacketMetadata::RemoveAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
-    if (!m_enable)
+    if (!m_enabled)
     {
         m_metadataSkipped = true;
         return;
     }
-    NS_ASSERT(m_data != nullptr);
+    if (end == 0)
+    {
+        return;
+    }
+    Spill();
 
     uint32_t leftToRemove = end;
     uint16_t current = m_tail;
@@ -972,7 +1112,7 @@ PacketMetadata::RemoveAtEnd(uint32_t end)
         else
         {
             // fragment the list item.
-            PacketMetadata fragment(m_packetUid, 0);
+            PacketMetadata fragment = CreateEmpty(m_packetUid);
             NS_ASSERT(extraItem.fragmentEnd > leftToRemove);
             extraItem.fragmentEnd -= leftToRemove;
             leftToRemove = 0;
@@ -1124,7 +1264,7 @@ PacketMetadata::GetSerializedSize() const
     // if packet-metadata not enabled, total size
     // is simply 4-bytes for itself plus 8-bytes
     // for packet uid
-    if (!m_enable)
+    if (!m_enabled)
     {
         return totalSize;
     }
@@ -1275,6 +1415,12 @@ PacketMetadata::Deserialize(const uint8_t* buffer, uint32_t size)
 
     PacketMetadata::SmallItem item = {0};
     PacketMetadata::ExtraItem extraItem = {0};
+    if (desSize > 0)
+    {
+        // the sender recorded the metadata of this packet
+        m_enabled = true;
+        Spill();
+    }
     while (desSize > 0)
     {
         uint32_t uidStringSize = 0;
@@ -25,10 +25,17 @@
 #include "ns3/callback.h"
 #include "ns3/type-id.h"
 
+#include <algorithm>
 #include <limits>
 #include <stdint.h>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
+class PacketMetadataNodeTest;
+
 namespace ns3
 {
 
@@ -76,6 +83,18 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * As long as the items of a packet are whole headers stacked on its
+ * payload, and there are at most PacketMetadata::INLINE_ITEMS of them,
+ * they are kept in a fixed-size array inside the PacketMetadata instead,
+ * which needs neither a byte buffer nor reference counting. Any other
+ * operation first spills the array to the byte buffer. A packet created
+ * while metadata is disabled has no item nor buffer at all.
+ *
+ * Metadata is either enabled for all the packets with Enable, or for the
+ * packets created in the context of some nodes with EnableNode: a packet
+ * records its metadata for its whole lifetime, on every node it crosses,
+ * if it was created on one of these nodes.
  */
 class PacketMetadata
 {
@@ -169,6 +188,17 @@ class PacketMetadata
      * \brief Enable the packet metadata checking
      */
     static void EnableChecking();
+    /**
+     * \brief Enable the packet metadata of the packets created by a node
+     *
+     * The node is identified by the context of the events it runs.
+     *
+     * \param nodeId the node id
+     */
+    static void EnableNode(uint32_t nodeId);
+
+    /// Maximum number of items kept in the inline header stack
+    static constexpr uint8_t INLINE_ITEMS = 4;
 
     /**
      * \brief Constructor
@@ -426,7 +456,11 @@ class PacketMetadata
     struct Data
     {
         /** number of references to this struct Data instance. */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /** size (in bytes) of m_data buffer below */
         uint32_t m_size;
         /** max of the m_used field over all objects which reference this struct Data instance */
@@ -518,9 +552,47 @@ class PacketMetadata
         ~DataFreeList();
     };
 
+    /**
+     * \brief Item of the inline header stack, a whole header or payload
+     */
+    struct InlineItem
+    {
+        uint32_t typeUid;  //!< type of the header, zero for payload, as in SmallItem
+        uint32_t size;     //!< size of the header or payload
+        uint16_t chunkUid; //!< instance of the header, as in SmallItem
+    };
+
     friend DataFreeList::~DataFreeList();
     /// Friend class
     friend class ItemIterator;
+    /// Friend class for the tests of EnableNode
+    friend class ::PacketMetadataNodeTest;
+
+    /**
+     * \brief Check if the packets created now record their metadata
+     * \returns true if metadata is enabled globally or for the current context
+     */
+    inline static bool IsEnabled();
+    /**
+     * \brief Check if metadata is enabled for the node of the current context
+     * \returns true if metadata is enabled for the current context
+     */
+    static bool IsContextEnabled();
+    /**
+     * \brief Create an enabled metadata without items, in the byte buffer encoding
+     * \param uid packet uid
+     * \returns the metadata
+     */
+    static PacketMetadata CreateEmpty(uint64_t uid);
+    /**
+     * \brief Move the items of the inline header stack to the byte buffer
+     */
+    void Spill();
+    /**
+     * \brief Set the number of items of the inline header stack
+     * \param size the number of items
+     */
+    inline void SetInlineSize(uint8_t size);
 
     /**
      * \brief Add a SmallItem
@@ -651,6 +723,11 @@ class PacketMetadata
      * \returns true if the position is valid
      */
     bool IsSharedPointerOk(uint16_t pointer) const;
+    /**
+     * \brief Check if bytes can be appended past m_used without copying
+     * \returns true if no other instance sharing m_data can write there
+     */
+    bool IsTailWritable() const;
 
     /**
      * \brief Recycle the buffer memory
@@ -675,30 +752,48 @@ class PacketMetadata
      */
     static void Deallocate(PacketMetadata::Data* data);
 
-    static DataFreeList m_freeList; //!< the metadata data storage
-    static bool m_enable;           //!< Enable the packet metadata
-    static bool m_enableChecking;   //!< Enable the packet metadata checking
+    static bool m_enable;                   //!< Enable the packet metadata
+    static bool m_enableChecking;           //!< Enable the packet metadata checking
+    static std::vector<bool> m_enableNodes; //!< Enable the packet metadata per node
 
+#ifdef NS3_MTP
+    static thread_local DataFreeList m_freeList;  //!< the metadata data storage
+    static thread_local bool m_freeListDestroyed; //!< the free list was destroyed
+    static thread_local uint32_t m_maxSize;       //!< maximum metadata size
+    static thread_local uint16_t m_chunkUid;      //!< Chunk Uid
+    /**
+     * Set to true when adding metadata to a packet is skipped because
+     * m_enable is false; written concurrently by the worker threads.
+     */
+    static std::atomic<bool> m_metadataSkipped;
+#else
+    static DataFreeList m_freeList;  //!< the metadata data storage
+    static bool m_freeListDestroyed; //!< the free list was destroyed
+    static uint32_t m_maxSize;       //!< maximum metadata size
+    static uint16_t m_chunkUid;      //!< Chunk Uid
     /**
      * Set to true when adding metadata to a packet is skipped because
      * m_enable is false; used to detect enabling of metadata in the
      * middle of a simulation, which isn't allowed.
      */
     static bool m_metadataSkipped;
+#endif
 
-    static uint32_t m_maxSize;  //!< maximum metadata size
-    static uint16_t m_chunkUid; //!< Chunk Uid
-
-    Data* m_data; //!< Metadata storage
+    Data* m_data; //!< Metadata storage, null while the items are inline
     /*
        head -(next)-> tail
          ^             |
           \---(prev)---|
-     */
-    uint16_t m_head;      //!< list head
-    uint16_t m_tail;      //!< list tail
-    uint32_t m_used;      //!< used portion
-    uint64_t m_packetUid; //!< packet Uid
+       For the inline header stack, head is the index of the top item and
+       tail is zero, the index of the bottom item.
+     */
+    uint16_t m_head;                   //!< list head
+    uint16_t m_tail;                   //!< list tail
+    uint32_t m_used;                   //!< used portion
+    uint64_t m_packetUid;              //!< packet Uid
+    InlineItem m_inline[INLINE_ITEMS]; //!< inline header stack, bottom first
+    uint8_t m_inlineSize;              //!< number of items of the inline header stack
+    bool m_enabled;                    //!< this packet records its metadata
 };
 
 } // namespace ns3
@@ -706,14 +801,29 @@ class PacketMetadata
 namespace ns3
 {
 
+bool
+PacketMetadata::IsEnabled()
+{
+    return m_enable || (!m_enableNodes.empty() && IsContextEnabled());
+}
+
+void
+PacketMetadata::SetInlineSize(uint8_t size)
+{
+    m_inlineSize = size;
+    m_head = size == 0 ? 0xffff : size - 1;
+    m_tail = size == 0 ? 0xffff : 0;
+}
+
 PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
-    : m_data(PacketMetadata::Create(10)),
+    : m_data(nullptr),
       m_head(0xffff),
       m_tail(0xffff),
       m_used(0),
-      m_packetUid(uid)
+      m_packetUid(uid),
+      m_inlineSize(0),
+      m_enabled(IsEnabled())
 {
-    memset(m_data->m_data, 0xff, 4);
     if (size > 0)
     {
         DoAddHeader(0, size);
@@ -725,11 +835,16 @@ PacketMetadata::PacketMetadata(const PacketMetadata& o)
       m_head(o.m_head),
       m_tail(o.m_tail),
       m_used(o.m_used),
-      m_packetUid(o.m_packetUid)
+      m_packetUid(o.m_packetUid),
+      m_inlineSize(o.m_inlineSize),
+      m_enabled(o.m_enabled)
 {
-    NS_ASSERT(m_data != nullptr);
-    NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
-    m_data->m_count++;
+    std::copy_n(o.m_inline, m_inlineSize, m_inline);
+    if (m_data != nullptr)
+    {
+        NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
+        m_data->m_count++;
+    }
 }
 
 PacketMetadata&
@@ -738,28 +853,32 @@ PacketMetadata::operator=(const PacketMetadata& o)
     if (m_data != o.m_data)
     {
         // not self assignment
-        NS_ASSERT(m_data != nullptr);
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (m_data != nullptr && --m_data->m_count == 0)
         {
             PacketMetadata::Recycle(m_data);
         }
         m_data = o.m_data;
-        NS_ASSERT(m_data != nullptr);
-        m_data->m_count++;
+        if (m_data != nullptr)
+        {
+            m_data->m_count++;
+        }
     }
     m_head = o.m_head;
     m_tail = o.m_tail;
     m_used = o.m_used;
     m_packetUid = o.m_packetUid;
+    if (this != &o)
+    {
+        std::copy_n(o.m_inline, o.m_inlineSize, m_inline);
+    }
+    m_inlineSize = o.m_inlineSize;
+    m_enabled = o.m_enabled;
     return *this;
 }
 
 PacketMetadata::~PacketMetadata()
 {
-    NS_ASSERT(m_data != nullptr);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (m_data != nullptr && --m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
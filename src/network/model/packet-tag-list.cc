@@ -37,6 +37,13 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("PacketTagList");
 
+#ifdef NS3_MTP
+/// Lists on other threads may drop their link to a merge point at any time.
+constexpr uint32_t MERGE_MIN_COUNT = 1;
+#else
+constexpr uint32_t MERGE_MIN_COUNT = 2; //!< Minimum count of a merge point
+#endif
+
 PacketTagList::TagData*
 PacketTagList::CreateTagData(size_t dataSize)
 {
@@ -52,6 +59,23 @@ PacketTagList::CreateTagData(size_t dataSize)
     return tag;
 }
 
+void
+PacketTagList::Unmerge(TagData* cur)
+{
+    if (--cur->count == 0)
+    {
+        // Only in multithreaded builds: every other list sharing cur has
+        // released it meanwhile, so the caller's link to cur->next is the
+        // one which survives.
+        if (cur->next != nullptr)
+        {
+            cur->next->count--;
+        }
+        cur->~TagData();
+        std::free(cur);
+    }
+}
+
 bool
 PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 {
@@ -121,7 +145,7 @@ PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 
     // At this point cur is a merge, but untested for tid
     NS_ASSERT(cur != nullptr);
-    NS_ASSERT(cur->count > 1);
+    NS_ASSERT(cur->count >= MERGE_MIN_COUNT);
 
     /*
        Walk the remainder of the list, copying, until we find tid
@@ -149,8 +173,7 @@ PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
     while (/* cur && */ cur->tid != tid)
     {
         NS_ASSERT(cur != nullptr);
-        NS_ASSERT(cur->count > 1);
-        cur->count--; // unmerge cur
+        NS_ASSERT(cur->count >= MERGE_MIN_COUNT);
         TagData* copy = CreateTagData(cur->size);
         copy->tid = cur->tid;
         copy->count = 1;
@@ -160,12 +183,13 @@ PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
         copy->next->count++;    // mark new merge
         *prevNext = copy;       // point prior list at copy
         prevNext = &copy->next; // advance
+        Unmerge(cur);           // unmerge cur
         cur = copy->next;
     }
     // Sanity check:
     NS_ASSERT(cur != nullptr);  // cur should be non-zero
     NS_ASSERT(cur->tid == tid); // cur->tid should be tid
-    NS_ASSERT(cur->count > 1);  // cur should be a merge
+    NS_ASSERT(cur->count >= MERGE_MIN_COUNT); // cur should be a merge
 
     // link around tid, removing it from our list
     found = (this->*Writer)(tag, false, cur, prevNext);
@@ -202,12 +226,12 @@ PacketTagList::RemoveWriter(Tag& tag,
     {
         // cur is always a merge at this point
         // unmerge cur, since we linked around it already
-        cur->count--;
         if (cur->next != nullptr)
         {
             // there's a next, so make it a merge
             cur->next->count++;
         }
+        Unmerge(cur);
     }
     return found;
 }
@@ -243,7 +267,6 @@ PacketTagList::ReplaceWriter(Tag& tag,
     {
         // cur is always a merge at this point
         // need to copy, replace, and link past cur
-        cur->count--; // unmerge cur
         TagData* copy = CreateTagData(tag.GetSerializedSize());
         copy->tid = tag.GetInstanceTypeId();
         copy->count = 1;
@@ -254,6 +277,7 @@ PacketTagList::ReplaceWriter(Tag& tag,
             copy->next->count++; // mark new merge
         }
         *prevNext = copy; // point prior list at copy
+        Unmerge(cur);     // unmerge cur
     }
     return found;
 }
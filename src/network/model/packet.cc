@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 
 #include <cstdarg>
+#include <new>
 #include <string>
 
 namespace ns3
@@ -30,7 +31,110 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Packet::m_globalUid = 0;
+#else
 uint32_t Packet::m_globalUid = 0;
+#endif
+
+namespace
+{
+
+/** A free packet, linked to the next free packet. */
+struct FreePacket
+{
+    FreePacket* next; //!< Next free packet
+};
+
+/**
+ * The packet free list of a thread.
+ *
+ * The packets sent by a thread to another one, as done by the
+ * multithreaded simulator, end up in the free list of the thread which
+ * releases them; the size limit of the list returns the excess to the heap.
+ */
+struct PacketFreeList
+{
+    /** Maximum number of free packets kept. */
+    static constexpr std::size_t MAX_SIZE = 4096;
+
+    /** Destructor, releases the free packets to the heap. */
+    ~PacketFreeList();
+
+    FreePacket* head{nullptr};          //!< First free packet
+    std::size_t size{0};                //!< Number of free packets
+    Packet::PoolStatistics stats{0, 0}; //!< Allocation counters
+};
+
+#ifdef NS3_MTP
+thread_local PacketFreeList g_packetFreeList; //!< The packet free list of the thread
+/** Set once the free list of the thread is destroyed. */
+thread_local bool g_packetFreeListDestroyed = false;
+#else
+PacketFreeList g_packetFreeList; //!< The packet free list
+/** Set once the free list is destroyed by the static destructors. */
+bool g_packetFreeListDestroyed = false;
+#endif
+
+PacketFreeList::~PacketFreeList()
+{
+    while (head != nullptr)
+    {
+        FreePacket* packet = head;
+        head = head->next;
+        ::operator delete(packet);
+    }
+    size = 0;
+    g_packetFreeListDestroyed = true;
+}
+
+} // unnamed namespace
+
+void*
+Packet::operator new(std::size_t size)
+{
+    if (size != sizeof(Packet) || g_packetFreeListDestroyed)
+    {
+        return ::operator new(size);
+    }
+    ++g_packetFreeList.stats.allocations;
+    if (g_packetFreeList.head == nullptr)
+    {
+        ++g_packetFreeList.stats.heapAllocations;
+        return ::operator new(size);
+    }
+    FreePacket* packet = g_packetFreeList.head;
+    g_packetFreeList.head = packet->next;
+    --g_packetFreeList.size;
+    return packet;
+}
+
+void
+Packet::operator delete(void* p, std::size_t size)
+{
+    if (size != sizeof(Packet) || g_packetFreeListDestroyed ||
+        g_packetFreeList.size >= PacketFreeList::MAX_SIZE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto packet = static_cast<FreePacket*>(p);
+    packet->next = g_packetFreeList.head;
+    g_packetFreeList.head = packet;
+    ++g_packetFreeList.size;
+}
+
+void
+PacketDeleter::Delete(Packet* packet)
+{
+    delete packet;
+}
+
+Packet::PoolStatistics
+Packet::GetPoolStatistics()
+{
+    return g_packetFreeList.stats;
+}
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -146,10 +250,9 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
@@ -186,10 +289,9 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -213,10 +315,9 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -599,6 +700,13 @@ Packet::EnablePrinting()
     PacketMetadata::Enable();
 }
 
+void
+Packet::EnablePrinting(uint32_t nodeId)
+{
+    NS_LOG_FUNCTION(nodeId);
+    PacketMetadata::EnableNode(nodeId);
+}
+
 void
 Packet::EnableChecking()
 {
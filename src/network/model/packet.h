@@ -33,13 +33,19 @@
 #include "ns3/mac48-address.h"
 #include "ns3/ptr.h"
 
+#include <cstddef>
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
 // Forward declaration
 class Address;
+class Packet;
 
 /**
  * \ingroup network
@@ -186,6 +192,22 @@ class PacketTagIterator
     const PacketTagList::TagData* m_current; //!< actual position over the set of tags in a packet
 };
 
+/**
+ * \ingroup packet
+ * Packet deleter, used by SimpleRefCount to return a Packet to the free
+ * list of the calling thread when the reference count drops to zero.
+ */
+struct PacketDeleter
+{
+    /**
+     * Delete the packet, out of line so that the callers of Unref do not
+     * see its memory returned to the free list and reused.
+     *
+     * \param [in] packet The packet.
+     */
+    static void Delete(Packet* packet);
+};
+
 /**
  * \ingroup packet
  * \brief network packets
@@ -234,8 +256,12 @@ class PacketTagIterator
  *
  * The performance aspects copy-on-write semantics of the
  * Packet API are discussed in \ref packetperf
+ *
+ * Packets are allocated from a per-thread free list, so that creating,
+ * copying and releasing packets, which most models do for every packet
+ * sent, does not usually reach the heap.
  */
-class Packet : public SimpleRefCount<Packet>
+class Packet : public SimpleRefCount<Packet, Empty, PacketDeleter>
 {
   public:
     /**
@@ -525,6 +551,17 @@ class Packet : public SimpleRefCount<Packet>
      * simulation setup and before any packet is created.
      */
     static void EnablePrinting();
+    /**
+     * \brief Enable printing the metadata of the packets created by a node.
+     *
+     * Only the packets created while the node runs an event, such as the
+     * packets of its applications and protocols, keep their metadata,
+     * which costs nothing to the packets of the other nodes. To print the
+     * packets of a device, enable printing for the nodes which send them.
+     *
+     * \param nodeId the node id
+     */
+    static void EnablePrinting(uint32_t nodeId);
     /**
      * \brief Enable packets metadata checking.
      *
@@ -537,6 +574,36 @@ class Packet : public SimpleRefCount<Packet>
      */
     static void EnableChecking();
 
+    /** Allocation counters of the packet free list of a thread. */
+    struct PoolStatistics
+    {
+        uint64_t allocations;     //!< Number of packets allocated
+        uint64_t heapAllocations; //!< Number of packets allocated from the heap
+    };
+
+    /**
+     * \brief Get the allocation counters of the packet free list of the
+     * calling thread.
+     *
+     * \returns The counters.
+     */
+    static PoolStatistics GetPoolStatistics();
+
+    /**
+     * \brief Allocate a packet from the free list of the calling thread.
+     *
+     * \param [in] size The size of the packet.
+     * \returns The memory of the packet.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * \brief Return a packet to the free list of the calling thread.
+     *
+     * \param [in] p The memory of the packet.
+     * \param [in] size The size of the packet.
+     */
+    static void operator delete(void* p, std::size_t size);
+
     /**
      * \brief Returns number of bytes required for packet
      * serialization.
@@ -795,7 +862,11 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
     static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -19,11 +19,13 @@
 #include "ns3/header.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
+#include "ns3/simulator.h"
 #include "ns3/test.h"
 #include "ns3/trailer.h"
 
 #include <cstdarg>
 #include <iostream>
+#include <map>
 #include <sstream>
 
 using namespace ns3;
@@ -879,6 +881,152 @@ PacketMetadataTest::DoRun()
     NS_TEST_EXPECT_MSG_EQ(msg,
                           std::string("hello world"),
                           "Could not find original data in received packet");
+
+    // the header stack of a copy is independent of the original, below
+    // and above the inline capacity
+    p = Create<Packet>(10);
+    ADD_HEADER(p, 1);
+    ADD_HEADER(p, 2);
+    p1 = p->Copy();
+    ADD_HEADER(p1, 3);
+    ADD_HEADER(p1, 5);
+    ADD_HEADER(p1, 6);
+    CHECK_HISTORY(p, 3, 2, 1, 10);
+    CHECK_HISTORY(p1, 6, 6, 5, 3, 2, 1, 10);
+    REM_HEADER(p1, 6);
+    REM_HEADER(p1, 5);
+    CHECK_HISTORY(p1, 4, 3, 2, 1, 10);
+    ADD_HEADER(p, 7);
+    CHECK_HISTORY(p, 4, 7, 2, 1, 10);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet Metadata enabled for some nodes only: the packets created in the
+ * context of nodes 1 and 3 record their headers on every node, the others
+ * on none.
+ */
+class PacketMetadataNodeTest : public TestCase
+{
+  public:
+    PacketMetadataNodeTest();
+    void DoRun() override;
+
+  private:
+    /**
+     * Create a packet with two headers in the context of a node
+     * \param node The node
+     */
+    void Originate(uint32_t node);
+    /**
+     * Create a packet with a header in the context of a node, and add its
+     * second header in the context of another node
+     * \param node The node
+     * \param next The other node
+     */
+    void Forward(uint32_t node, uint32_t next);
+    /**
+     * Add the second header to a packet, and keep it
+     * \param p The packet
+     */
+    void Receive(Ptr<Packet> p);
+    /**
+     * Count the items of a packet
+     * \param p The packet
+     * \return The number of items
+     */
+    static uint32_t CountItems(Ptr<Packet> p);
+
+    std::map<uint32_t, Ptr<Packet>> m_packets; //!< Packets by node which created them
+};
+
+PacketMetadataNodeTest::PacketMetadataNodeTest()
+    : TestCase("Packet metadata enabled per node")
+{
+}
+
+void
+PacketMetadataNodeTest::Originate(uint32_t node)
+{
+    Ptr<Packet> p = Create<Packet>(10);
+    ADD_HEADER(p, 1);
+    ADD_HEADER(p, 2);
+    m_packets[node] = p;
+}
+
+void
+PacketMetadataNodeTest::Forward(uint32_t node, uint32_t next)
+{
+    Ptr<Packet> p = Create<Packet>(10);
+    ADD_HEADER(p, 1);
+    m_packets[node] = p;
+    Simulator::ScheduleWithContext(next, Seconds(1), &PacketMetadataNodeTest::Receive, this, p);
+}
+
+void
+PacketMetadataNodeTest::Receive(Ptr<Packet> p)
+{
+    ADD_HEADER(p, 2);
+}
+
+uint32_t
+PacketMetadataNodeTest::CountItems(Ptr<Packet> p)
+{
+    uint32_t items = 0;
+    PacketMetadata::ItemIterator k = p->BeginItem();
+    while (k.HasNext())
+    {
+        k.Next();
+        items++;
+    }
+    return items;
+}
+
+void
+PacketMetadataNodeTest::DoRun()
+{
+    // Start from metadata disabled for every packet, whatever ran before
+    bool enable = PacketMetadata::m_enable;
+    std::vector<bool> enableNodes = PacketMetadata::m_enableNodes;
+    bool metadataSkipped = PacketMetadata::m_metadataSkipped;
+    PacketMetadata::m_enable = false;
+    PacketMetadata::m_enableNodes.clear();
+
+    Packet::EnablePrinting(1);
+    PacketMetadata::EnableNode(3);
+    for (uint32_t node = 0; node < 5; node++)
+    {
+        Simulator::ScheduleWithContext(node,
+                                       Seconds(1),
+                                       &PacketMetadataNodeTest::Originate,
+                                       this,
+                                       node);
+    }
+    Simulator::ScheduleWithContext(1, Seconds(2), &PacketMetadataNodeTest::Forward, this, 11, 0);
+    Simulator::ScheduleWithContext(0, Seconds(2), &PacketMetadataNodeTest::Forward, this, 10, 1);
+    Originate(Simulator::NO_CONTEXT);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    for (uint32_t node = 0; node < 5; node++)
+    {
+        uint32_t items = (node == 1 || node == 3) ? 3 : 0;
+        NS_TEST_EXPECT_MSG_EQ(CountItems(m_packets[node]),
+                              items,
+                              "Wrong metadata of a packet created on node " << node);
+    }
+    NS_TEST_EXPECT_MSG_EQ(CountItems(m_packets[11]), 3, "Metadata lost on another node");
+    NS_TEST_EXPECT_MSG_EQ(CountItems(m_packets[10]), 0, "Metadata recorded on another node");
+    NS_TEST_EXPECT_MSG_EQ(CountItems(m_packets[Simulator::NO_CONTEXT]),
+                          0,
+                          "Metadata recorded out of any node");
+    m_packets.clear();
+
+    PacketMetadata::m_enable = enable;
+    PacketMetadata::m_enableNodes = enableNodes;
+    PacketMetadata::m_metadataSkipped = metadataSkipped;
 }
 
 /**
@@ -897,6 +1045,7 @@ PacketMetadataTestSuite::PacketMetadataTestSuite()
     : TestSuite("packet-metadata", UNIT)
 {
     AddTestCase(new PacketMetadataTest, TestCase::QUICK);
+    AddTestCase(new PacketMetadataNodeTest, TestCase::QUICK);
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
@@ -1268,6 +1268,59 @@ PacketTagListTest::DoRun()
     } // Timing
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet free list unit tests.
+ */
+class PacketPoolTest : public TestCase
+{
+  public:
+    PacketPoolTest();
+
+  private:
+    void DoRun() override;
+};
+
+PacketPoolTest::PacketPoolTest()
+    : TestCase("Packet free list")
+{
+}
+
+void
+PacketPoolTest::DoRun()
+{
+    Packet::PoolStatistics before = Packet::GetPoolStatistics();
+
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddHeader(ATestHeader<10>());
+    p->AddPacketTag(ATestTag<1>());
+    p->AddByteTag(ATestTag<2>());
+    p->SetNixVector(Create<NixVector>());
+    uint64_t uid = p->GetUid();
+    const Packet* released = PeekPointer(p);
+    p = nullptr;
+
+    // the released packet is reused, without any of its former content
+    Ptr<Packet> q = Create<Packet>();
+    NS_TEST_EXPECT_MSG_EQ(PeekPointer(q), released, "The released packet was not reused");
+    NS_TEST_EXPECT_MSG_EQ(q->GetSize(), 0, "The reused packet is not empty");
+    NS_TEST_EXPECT_MSG_NE(q->GetUid(), uid, "The reused packet kept its uid");
+    ATestTag<1> tag;
+    NS_TEST_EXPECT_MSG_EQ(q->PeekPacketTag(tag), false, "The reused packet kept its packet tag");
+    NS_TEST_EXPECT_MSG_EQ(q->GetByteTagIterator().HasNext(),
+                          false,
+                          "The reused packet kept its byte tag");
+    NS_TEST_EXPECT_MSG_EQ(q->GetNixVector(), nullptr, "The reused packet kept its nix vector");
+
+    Packet::PoolStatistics after = Packet::GetPoolStatistics();
+    NS_TEST_EXPECT_MSG_EQ(after.allocations - before.allocations, 2, "Wrong number of packets");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(after.heapAllocations - before.heapAllocations,
+                                1,
+                                "The released packet was allocated from the heap again");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1285,6 +1338,7 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::QUICK);
+    AddTestCase(new PacketPoolTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -15,6 +15,9 @@
  * Author:  Craig Dowell (craigdo@ee.washington.edu)
  */
 
+#include "ns3/async-file-stream.h"
+#include "ns3/boolean.h"
+#include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/pcap-file.h"
 #include "ns3/test.h"
@@ -1375,6 +1378,110 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that a pcap file written from the
+ * background thread is complete once flushed, as on a fatal error, and
+ * once closed.
+ */
+class AsyncWriteTestCase : public TestCase
+{
+  public:
+    AsyncWriteTestCase();
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    std::string m_testFilename; //!< File name
+};
+
+AsyncWriteTestCase::AsyncWriteTestCase()
+    : TestCase("Check that a pcap file written in the background is complete once flushed and "
+               "once closed")
+{
+}
+
+void
+AsyncWriteTestCase::DoSetup()
+{
+    std::stringstream filename;
+    uint32_t n = rand();
+    filename << n;
+    m_testFilename = CreateTempDirFilename(filename.str() + ".pcap");
+    Config::SetGlobal("AsyncTraceWriter", BooleanValue(true));
+}
+
+void
+AsyncWriteTestCase::DoTeardown()
+{
+    Config::SetGlobal("AsyncTraceWriter", BooleanValue(false));
+    if (remove(m_testFilename.c_str()))
+    {
+        NS_LOG_ERROR("Failed to delete file " << m_testFilename);
+    }
+}
+
+void
+AsyncWriteTestCase::DoRun()
+{
+    //
+    // Write enough packets to fill several blocks of the buffer
+    //
+    const uint32_t nPackets = 2000;
+    const uint32_t packetSize = 100;
+    uint8_t data[packetSize];
+
+    PcapFile f;
+    f.Open(m_testFilename, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(),
+                          false,
+                          "Open (" << m_testFilename << ", \"std::ios::out\") returns error");
+    f.Init(1, packetSize);
+    for (uint32_t i = 0; i < nPackets; ++i)
+    {
+        std::memset(data, i & 0xff, packetSize);
+        f.Write(i, 0, data, packetSize);
+        NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Write must not fail");
+    }
+
+    // The last block is only partly filled
+    AsyncFileBuf::FlushAll();
+    NS_TEST_ASSERT_MSG_EQ(CheckFileLength(m_testFilename, 24 + nPackets * (16 + packetSize)),
+                          true,
+                          "Flushed file has wrong length");
+    f.Close();
+
+    NS_TEST_ASSERT_MSG_EQ(CheckFileLength(m_testFilename, 24 + nPackets * (16 + packetSize)),
+                          true,
+                          "Closed file has wrong length");
+
+    //
+    // Read the packets back
+    //
+    f.Open(m_testFilename, std::ios::in);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(),
+                          false,
+                          "Open (" << m_testFilename << ", \"std::ios::in\") returns error");
+    for (uint32_t i = 0; i < nPackets; ++i)
+    {
+        uint32_t tsSec;
+        uint32_t tsUsec;
+        uint32_t inclLen;
+        uint32_t origLen;
+        uint32_t readLen;
+        f.Read(data, packetSize, tsSec, tsUsec, inclLen, origLen, readLen);
+        NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Read must not fail");
+        NS_TEST_EXPECT_MSG_EQ(tsSec, i, "Packets are out of order");
+        NS_TEST_EXPECT_MSG_EQ(readLen, packetSize, "Packet has wrong length");
+        NS_TEST_EXPECT_MSG_EQ(uint32_t(data[packetSize - 1]), (i & 0xff), "Packet is corrupted");
+    }
+    f.Close();
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1398,6 +1505,7 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new AsyncWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
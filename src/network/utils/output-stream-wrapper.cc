@@ -18,6 +18,7 @@
 #include "output-stream-wrapper.h"
 
 #include "ns3/abort.h"
+#include "ns3/async-file-stream.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/log.h"
 
@@ -32,11 +33,22 @@ OutputStreamWrapper::OutputStreamWrapper(std::string filename, std::ios::openmod
     : m_destroyable(true)
 {
     NS_LOG_FUNCTION(this << filename << filemode);
-    auto os = new std::ofstream();
-    os->open(filename, filemode);
-    m_ostream = os;
+    bool isOpen;
+    if (AsyncFileBuf::IsEnabled())
+    {
+        auto os = new AsyncFileStream(filename, filemode);
+        isOpen = os->IsOpen();
+        m_ostream = os;
+    }
+    else
+    {
+        auto os = new std::ofstream();
+        os->open(filename, filemode);
+        isOpen = os->is_open();
+        m_ostream = os;
+    }
     FatalImpl::RegisterStream(m_ostream);
-    NS_ABORT_MSG_UNLESS(os->is_open(),
+    NS_ABORT_MSG_UNLESS(isOpen,
                         "AsciiTraceHelper::CreateFileStream():  "
                             << "Unable to Open " << filename << " for mode " << filemode);
 }
@@ -20,6 +20,7 @@
 #include "pcap-file.h"
 
 #include "ns3/assert.h"
+#include "ns3/async-file-stream.h"
 #include "ns3/buffer.h"
 #include "ns3/build-profile.h"
 #include "ns3/fatal-error.h"
@@ -71,7 +72,7 @@ bool
 PcapFile::Fail() const
 {
     NS_LOG_FUNCTION(this);
-    return m_file.fail();
+    return m_asyncFile ? m_asyncFile->fail() : m_file.fail();
 }
 
 bool
@@ -85,6 +86,10 @@ void
 PcapFile::Clear()
 {
     NS_LOG_FUNCTION(this);
+    if (m_asyncFile)
+    {
+        m_asyncFile->clear();
+    }
     m_file.clear();
 }
 
@@ -92,9 +97,30 @@ void
 PcapFile::Close()
 {
     NS_LOG_FUNCTION(this);
+    if (m_asyncFile)
+    {
+        FatalImpl::UnregisterStream(m_asyncFile.get());
+        m_asyncFile->Close();
+        if (m_asyncFile->fail())
+        {
+            m_file.setstate(std::ios::failbit);
+        }
+        m_asyncFile.reset();
+        return;
+    }
     m_file.close();
 }
 
+std::ostream&
+PcapFile::GetOutputStream()
+{
+    if (m_asyncFile)
+    {
+        return *m_asyncFile;
+    }
+    return m_file;
+}
+
 uint32_t
 PcapFile::GetMagic()
 {
@@ -211,7 +237,8 @@ PcapFile::WriteFileHeader()
     // If we're initializing the file, we need to write the pcap file header
     // at the start of the file.
     //
-    m_file.seekp(0, std::ios::beg);
+    std::ostream& os = GetOutputStream();
+    os.seekp(0, std::ios::beg);
 
     //
     // We have the ability to write out the pcap file header in a foreign endian
@@ -239,13 +266,13 @@ PcapFile::WriteFileHeader()
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-    m_file.write((const char*)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-    m_file.write((const char*)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-    m_file.write((const char*)&headerOut->m_zone, sizeof(headerOut->m_zone));
-    m_file.write((const char*)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-    m_file.write((const char*)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-    m_file.write((const char*)&headerOut->m_type, sizeof(headerOut->m_type));
+    os.write((const char*)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+    os.write((const char*)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+    os.write((const char*)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+    os.write((const char*)&headerOut->m_zone, sizeof(headerOut->m_zone));
+    os.write((const char*)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+    os.write((const char*)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+    os.write((const char*)&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -333,12 +360,19 @@ PcapFile::Open(const std::string& filename, std::ios::openmode mode)
     NS_LOG_FUNCTION(this << filename << mode);
     NS_ASSERT((mode & std::ios::app) == 0);
     NS_ASSERT(!m_file.fail());
+    NS_ASSERT(!m_asyncFile);
     //
     // All pcap files are binary files, so we just do this automatically.
     //
     mode |= std::ios::binary;
 
     m_filename = filename;
+    if ((mode & std::ios::in) == 0 && AsyncFileBuf::IsEnabled())
+    {
+        m_asyncFile = std::make_unique<AsyncFileStream>(filename, mode);
+        FatalImpl::RegisterStream(m_asyncFile.get());
+        return;
+    }
     m_file.open(filename, mode);
     if (mode & std::ios::in)
     {
@@ -413,7 +447,8 @@ uint32_t
 PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen);
-    NS_ASSERT(m_file.good());
+    std::ostream& os = GetOutputStream();
+    NS_ASSERT(os.good());
 
     uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -432,11 +467,11 @@ PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&header.m_tsSec, sizeof(header.m_tsSec));
-    m_file.write((const char*)&header.m_tsUsec, sizeof(header.m_tsUsec));
-    m_file.write((const char*)&header.m_inclLen, sizeof(header.m_inclLen));
-    m_file.write((const char*)&header.m_origLen, sizeof(header.m_origLen));
-    NS_BUILD_DEBUG(m_file.flush());
+    os.write((const char*)&header.m_tsSec, sizeof(header.m_tsSec));
+    os.write((const char*)&header.m_tsUsec, sizeof(header.m_tsUsec));
+    os.write((const char*)&header.m_inclLen, sizeof(header.m_inclLen));
+    os.write((const char*)&header.m_origLen, sizeof(header.m_origLen));
+    NS_BUILD_DEBUG(os.flush());
     return inclLen;
 }
 
@@ -445,8 +480,8 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const uint8_t* const data, uint
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &data << totalLen);
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalLen);
-    m_file.write((const char*)data, inclLen);
-    NS_BUILD_DEBUG(m_file.flush());
+    GetOutputStream().write((const char*)data, inclLen);
+    NS_BUILD_DEBUG(GetOutputStream().flush());
 }
 
 void
@@ -454,8 +489,8 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << p);
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize());
-    p->CopyData(&m_file, inclLen);
-    NS_BUILD_DEBUG(m_file.flush());
+    p->CopyData(&GetOutputStream(), inclLen);
+    NS_BUILD_DEBUG(GetOutputStream().flush());
 }
 
 void
@@ -470,9 +505,9 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const Header& header, Ptr<const
     headerBuffer.AddAtStart(headerSize);
     header.Serialize(headerBuffer.Begin());
     uint32_t toCopy = std::min(headerSize, inclLen);
-    headerBuffer.CopyData(&m_file, toCopy);
+    headerBuffer.CopyData(&GetOutputStream(), toCopy);
     inclLen -= toCopy;
-    p->CopyData(&m_file, inclLen);
+    p->CopyData(&GetOutputStream(), inclLen);
 }
 
 void
@@ -23,6 +23,7 @@
 #include "ns3/ptr.h"
 
 #include <fstream>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -31,6 +32,7 @@ namespace ns3
 
 class Packet;
 class Header;
+class AsyncFileStream;
 
 /**
  * \brief A class representing a pcap file
@@ -75,6 +77,10 @@ class PcapFile
      * selected as a binary file (fstream::binary is automatically ored with the mode
      * field).
      *
+     * If the AsyncTraceWriter global value is true, a file opened for writing
+     * only is written from a background thread, see AsyncFileBuf, and is only
+     * complete once closed.
+     *
      * \param filename String containing the name of the file.
      *
      * \param mode the access mode for the file.
@@ -373,11 +379,17 @@ class PcapFile
      */
     void ReadAndVerifyFileHeader();
 
-    std::string m_filename;      //!< file name
-    std::fstream m_file;         //!< file stream
-    PcapFileHeader m_fileHeader; //!< file header
-    bool m_swapMode;             //!< swap mode
-    bool m_nanosecMode;          //!< nanosecond timestamp mode
+    /**
+     * \returns the stream the records are written to
+     */
+    std::ostream& GetOutputStream();
+
+    std::string m_filename;                       //!< file name
+    std::fstream m_file;                          //!< file stream
+    std::unique_ptr<AsyncFileStream> m_asyncFile; //!< file stream written in the background
+    PcapFileHeader m_fileHeader;                  //!< file header
+    bool m_swapMode;                              //!< swap mode
+    bool m_nanosecMode;                           //!< nanosecond timestamp mode
 };
 
 } // namespace ns3
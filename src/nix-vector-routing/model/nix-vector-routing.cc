@@ -29,7 +29,9 @@
 #include "ns3/log.h"
 #include "ns3/loopback-net-device.h"
 #include "ns3/names.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <queue>
 
@@ -48,6 +50,16 @@ bool NixVectorRouting<T>::g_isCacheDirty = false;
 template <typename T>
 uint32_t NixVectorRouting<T>::g_epoch = 1;
 
+template <typename T>
+bool NixVectorRouting<T>::g_isCacheDirtyGlobal = false;
+
+template <typename T>
+std::vector<uint32_t> NixVectorRouting<T>::g_dirtyNodes;
+
+template <typename T>
+std::vector<typename NixVectorRouting<T>::NixCacheInvalidation>
+    NixVectorRouting<T>::g_invalidations;
+
 template <typename T>
 typename NixVectorRouting<T>::IpAddressToNodeMap NixVectorRouting<T>::g_ipAddressToNodeMap;
 
@@ -71,13 +83,29 @@ NixVectorRouting<T>::GetTypeId()
     static TypeId tid = TypeId("ns3::" + name + "NixVectorRouting")
                             .SetParent<T>()
                             .SetGroupName("NixVectorRouting")
-                            .template AddConstructor<NixVectorRouting<T>>();
+                            .template AddConstructor<NixVectorRouting<T>>()
+                            .AddAttribute(
+                                "CacheCapacity",
+                                "Maximum number of nix-vectors cached by a node "
+                                "(0 means unbounded). Once full, new nix-vectors "
+                                "replace older ones.",
+                                UintegerValue(0),
+                                MakeUintegerAccessor(&NixVectorRouting<T>::m_nixCacheCapacity),
+                                MakeUintegerChecker<uint32_t>())
+                            .AddAttribute(
+                                "BfsBatchSize",
+                                "Number of additional destinations whose nix-vector "
+                                "is cached from the BFS run for a cache miss.",
+                                UintegerValue(64),
+                                MakeUintegerAccessor(&NixVectorRouting<T>::m_nixCacheBatchSize),
+                                MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 template <typename T>
 NixVectorRouting<T>::NixVectorRouting()
-    : m_totalNeighbors(0)
+    : m_nixCacheSize(0),
+      m_totalNeighbors(0)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -165,6 +193,9 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
         rp->m_totalNeighbors = 0;
     }
 
+    // All the nix-vector caches are empty, scoped invalidations are not needed anymore
+    g_invalidations.clear();
+
     // IP address to node mapping is potentially invalid so clear it.
     // Will be repopulated in lazy evaluation when mapping is needed.
     g_ipAddressToNodeMap.clear();
@@ -176,6 +207,7 @@ NixVectorRouting<T>::FlushNixCache() const
 {
     NS_LOG_FUNCTION_NOARGS();
     m_nixCache.clear();
+    m_nixCacheSize = 0;
 }
 
 template <typename T>
@@ -219,10 +251,22 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
         // and build the nix vector
         std::vector<Ptr<Node>> parentVector;
 
-        if (BFS(NodeList::GetNNodes(), source, destNode, parentVector, oif))
+        // A BFS from this node that is not constrained by an output interface
+        // is valid for every destination: run it to completion and use it to
+        // fill the cache.
+        bool cacheable = !oif && source == m_node;
+
+        if (BFS(NodeList::GetNNodes(), source, cacheable ? nullptr : destNode, parentVector, oif))
         {
             if (BuildNixVector(parentVector, source->GetId(), destNode->GetId(), nixVector))
             {
+                if (cacheable)
+                {
+                    std::vector<uint32_t> path;
+                    BuildNixPath(parentVector, source->GetId(), destNode->GetId(), path);
+                    InsertNixCacheEntry(destNode->GetId(), nixVector, path);
+                    PrefillNixCache(parentVector, destNode->GetId());
+                }
                 return nixVector;
             }
             else
@@ -241,25 +285,303 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
 
 template <typename T>
 Ptr<NixVector>
-NixVectorRouting<T>::GetNixVectorInCache(const IpAddress& address, bool& foundInCache) const
+NixVectorRouting<T>::GetNixVectorInCache(const IpAddress& address,
+                                         bool& foundInCache,
+                                         bool requested) const
 {
     NS_LOG_FUNCTION(this << address);
 
     CheckCacheStateAndFlush();
 
-    auto iter = m_nixCache.find(address);
-    if (iter != m_nixCache.end())
+    foundInCache = false;
+
+    Ptr<Node> destNode = GetNodeByIp(address);
+    if (!destNode)
+    {
+        return nullptr;
+    }
+
+    NixCacheEntry* entry = FindNixCacheEntry(destNode->GetId());
+    if (entry && IsNixCacheEntryValid(*entry))
     {
         NS_LOG_LOGIC("Found Nix-vector in cache.");
         foundInCache = true;
-        return iter->second;
+        if (requested)
+        {
+            entry->address = address;
+        }
+        return LoadNixCacheEntry(*entry);
     }
 
     // not in cache
-    foundInCache = false;
     return nullptr;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::SetNixCacheEntryAddress(const IpAddress& address) const
+{
+    NS_LOG_FUNCTION(this << address);
+
+    Ptr<Node> destNode = GetNodeByIp(address);
+    NixCacheEntry* entry = destNode ? FindNixCacheEntry(destNode->GetId()) : nullptr;
+    if (entry)
+    {
+        entry->address = address;
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildNixPath(const std::vector<Ptr<Node>>& parentVector,
+                                  uint32_t source,
+                                  uint32_t dest,
+                                  std::vector<uint32_t>& path) const
+{
+    NS_LOG_FUNCTION(this << source << dest);
+
+    path.clear();
+    path.push_back(dest);
+    while (dest != source)
+    {
+        dest = parentVector.at(dest)->GetId();
+        path.push_back(dest);
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::PrefillNixCache(const std::vector<Ptr<Node>>& parentVector,
+                                     uint32_t dest) const
+{
+    NS_LOG_FUNCTION(this << dest);
+
+    uint32_t source = m_node->GetId();
+    uint32_t numberOfNodes = parentVector.size();
+    uint32_t filled = 0;
+    std::vector<uint32_t> path;
+
+    // Destinations following the requested one are the most likely to be
+    // requested next (e.g., all-to-all patterns iterating over the ranks).
+    for (uint32_t offset = 1; offset < numberOfNodes && filled < m_nixCacheBatchSize; offset++)
+    {
+        if (m_nixCacheCapacity && m_nixCacheSize >= m_nixCacheCapacity)
+        {
+            // Do not evict entries that were actually requested
+            break;
+        }
+
+        uint32_t candidate = (dest + offset) % numberOfNodes;
+        if (candidate == source || !parentVector[candidate] ||
+            !NodeList::GetNode(candidate)->GetObject<IpL3Protocol>())
+        {
+            continue;
+        }
+
+        NixCacheEntry* entry = FindNixCacheEntry(candidate);
+        if (entry && IsNixCacheEntryValid(*entry))
+        {
+            continue;
+        }
+
+        Ptr<NixVector> nixVector = Create<NixVector>();
+        nixVector->SetEpoch(g_epoch);
+        BuildNixVector(parentVector, source, candidate, nixVector);
+        BuildNixPath(parentVector, source, candidate, path);
+        InsertNixCacheEntry(candidate, nixVector, path);
+        filled++;
+    }
+
+    NS_LOG_LOGIC("Prefilled " << filled << " nix-vectors for node " << source);
+}
+
+template <typename T>
+typename NixVectorRouting<T>::NixCacheEntry*
+NixVectorRouting<T>::FindNixCacheEntry(uint32_t dest) const
+{
+    if (m_nixCache.empty())
+    {
+        return nullptr;
+    }
+
+    uint32_t mask = m_nixCache.size() - 1;
+    for (uint32_t slot = (dest * 0x9E3779B1U) & mask;; slot = (slot + 1) & mask)
+    {
+        NixCacheEntry& entry = m_nixCache[slot];
+        if (entry.dest == dest)
+        {
+            return &entry;
+        }
+        if (entry.dest == NIX_CACHE_EMPTY)
+        {
+            return nullptr;
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::InsertNixCacheEntry(uint32_t dest,
+                                         Ptr<const NixVector> nixVector,
+                                         const std::vector<uint32_t>& path) const
+{
+    NS_LOG_FUNCTION(this << dest << nixVector);
+
+    NixCacheEntry* entry = FindNixCacheEntry(dest);
+
+    if (!entry)
+    {
+        bool full = m_nixCacheCapacity && m_nixCacheSize >= m_nixCacheCapacity;
+
+        // Keep the load factor at most 3/4
+        if (!full && (m_nixCacheSize + 1) * 4 > m_nixCache.size() * 3)
+        {
+            std::vector<NixCacheEntry> old(std::max<std::size_t>(16, m_nixCache.size() * 2));
+            old.swap(m_nixCache);
+            uint32_t mask = m_nixCache.size() - 1;
+            for (auto& e : old)
+            {
+                if (e.dest == NIX_CACHE_EMPTY)
+                {
+                    continue;
+                }
+                uint32_t slot = (e.dest * 0x9E3779B1U) & mask;
+                while (m_nixCache[slot].dest != NIX_CACHE_EMPTY)
+                {
+                    slot = (slot + 1) & mask;
+                }
+                m_nixCache[slot] = std::move(e);
+            }
+        }
+
+        uint32_t mask = m_nixCache.size() - 1;
+        uint32_t slot = (dest * 0x9E3779B1U) & mask;
+        if (full && m_nixCache[slot].dest == NIX_CACHE_EMPTY)
+        {
+            // Filling the empty home slot would exceed the capacity: evict
+            // the entry following it instead, the new one then takes it.
+            uint32_t victim = (slot + 1) & mask;
+            while (m_nixCache[victim].dest == NIX_CACHE_EMPTY)
+            {
+                victim = (victim + 1) & mask;
+            }
+            NS_LOG_LOGIC("Nix cache full, evicting entry for node " << m_nixCache[victim].dest);
+            EraseNixCacheEntry(victim);
+            full = false;
+        }
+        if (full)
+        {
+            // Replacing the home slot in place keeps the probe sequences of
+            // the other entries intact.
+            NS_LOG_LOGIC("Nix cache full, replacing entry for node " << m_nixCache[slot].dest);
+        }
+        else
+        {
+            while (m_nixCache[slot].dest != NIX_CACHE_EMPTY)
+            {
+                slot = (slot + 1) & mask;
+            }
+            m_nixCacheSize++;
+        }
+        entry = &m_nixCache[slot];
+    }
+
+    entry->dest = dest;
+    entry->epoch = g_epoch;
+    entry->address = IpAddress();
+    entry->spill = nullptr;
+    entry->nWords = 0;
+    if (nixVector->GetSerializedSize() <= sizeof(entry->words))
+    {
+        nixVector->Serialize(entry->words, sizeof(entry->words));
+        entry->nWords = nixVector->GetSerializedSize() / sizeof(uint32_t);
+    }
+    else
+    {
+        entry->spill = nixVector->Copy();
+    }
+    entry->nHops = std::min<std::size_t>(path.size(), std::numeric_limits<uint16_t>::max());
+    std::copy_n(path.begin(),
+                std::min<std::size_t>(path.size(), NIX_CACHE_INLINE_HOPS),
+                entry->hops);
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::EraseNixCacheEntry(uint32_t slot) const
+{
+    NS_LOG_FUNCTION(this << slot);
+
+    uint32_t mask = m_nixCache.size() - 1;
+    m_nixCache[slot] = NixCacheEntry();
+    m_nixCacheSize--;
+    // Move back the following entries which could no longer be found past
+    // the new hole, as linear probing requires
+    for (uint32_t j = (slot + 1) & mask; m_nixCache[j].dest != NIX_CACHE_EMPTY; j = (j + 1) & mask)
+    {
+        uint32_t home = (m_nixCache[j].dest * 0x9E3779B1U) & mask;
+        if (((j - home) & mask) >= ((j - slot) & mask))
+        {
+            m_nixCache[slot] = std::move(m_nixCache[j]);
+            m_nixCache[j] = NixCacheEntry();
+            slot = j;
+        }
+    }
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::IsNixCacheEntryValid(NixCacheEntry& entry) const
+{
+    if (entry.epoch == g_epoch)
+    {
+        return true;
+    }
+    if (entry.epoch == NIX_CACHE_STALE)
+    {
+        return false;
+    }
+
+    // Only scoped invalidations can have happened since the entry was
+    // stored, as global ones empty the caches.
+    for (auto it = g_invalidations.rbegin();
+         it != g_invalidations.rend() && it->epoch > entry.epoch;
+         it++)
+    {
+        bool crossed = entry.nHops > NIX_CACHE_INLINE_HOPS;
+        for (uint16_t i = 0; i < entry.nHops && !crossed; i++)
+        {
+            crossed = std::binary_search(it->nodes.begin(), it->nodes.end(), entry.hops[i]);
+        }
+        if (crossed)
+        {
+            entry.epoch = NIX_CACHE_STALE;
+            return false;
+        }
+    }
+
+    entry.epoch = g_epoch;
+    return true;
+}
+
+template <typename T>
+Ptr<NixVector>
+NixVectorRouting<T>::LoadNixCacheEntry(const NixCacheEntry& entry) const
+{
+    Ptr<NixVector> nixVector;
+    if (entry.spill)
+    {
+        nixVector = entry.spill->Copy();
+    }
+    else
+    {
+        nixVector = Create<NixVector>();
+        nixVector->Deserialize(entry.words, entry.nWords * sizeof(uint32_t));
+    }
+    nixVector->SetEpoch(g_epoch);
+    return nixVector;
+}
+
 template <typename T>
 Ptr<typename NixVectorRouting<T>::IpRoute>
 NixVectorRouting<T>::GetIpRouteInCache(IpAddress address)
@@ -749,7 +1071,7 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
     }
     // Check the Nix cache
     bool foundInCache = false;
-    nixVectorInCache = GetNixVectorInCache(destAddress, foundInCache);
+    nixVectorInCache = GetNixVectorInCache(destAddress, foundInCache, true);
 
     // not in cache
     if (!foundInCache)
@@ -757,11 +1079,11 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
         NS_LOG_LOGIC("Nix-vector not in cache, build: ");
         // Build the nix-vector, given this node and the
         // dest IP address
+        // (cached as part of the build when possible)
         nixVectorInCache = GetNixVector(m_node, destAddress, oif);
-        if (nixVectorInCache)
+        if (nixVectorInCache && !oif)
         {
-            // cache it
-            m_nixCache.insert(typename NixMap_t::value_type(destAddress, nixVectorInCache));
+            SetNixCacheEntryAddress(destAddress);
         }
     }
 
@@ -770,9 +1092,9 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
     {
         NS_LOG_LOGIC("Nix-vector contents: " << *nixVectorInCache);
 
-        // create a new nix vector to be used,
-        // we want to keep the cached version clean
-        nixVectorForPacket = nixVectorInCache->Copy();
+        // the cache hands out private copies, so the nix vector
+        // can be used for the packet directly
+        nixVectorForPacket = nixVectorInCache;
 
         // Get the interface number that we go out of, by extracting
         // from the nix-vector
@@ -1014,23 +1336,30 @@ NixVectorRouting<T>::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Un
         << ", Nix Routing" << std::endl;
 
     *os << "NixCache:" << std::endl;
-    if (m_nixCache.size() > 0)
+    // Only the destinations packets were routed to are listed, not the
+    // ones prefilled from their BFS, sorted as the map they were kept in
+    std::vector<std::pair<IpAddress, NixCacheEntry*>> nixCache;
+    for (auto& entry : m_nixCache)
+    {
+        if (entry.dest != NIX_CACHE_EMPTY && entry.address.IsInitialized() &&
+            IsNixCacheEntryValid(entry))
+        {
+            nixCache.emplace_back(entry.address, &entry);
+        }
+    }
+    std::sort(nixCache.begin(), nixCache.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    if (!nixCache.empty())
     {
         *os << std::setw(30) << "Destination";
         *os << "NixVector" << std::endl;
-        for (auto it = m_nixCache.begin(); it != m_nixCache.end(); it++)
+        for (const auto& [address, entry] : nixCache)
         {
             std::ostringstream dest;
-            dest << it->first;
+            dest << address;
             *os << std::setw(30) << dest.str();
-            if (it->second)
-            {
-                *os << *(it->second) << std::endl;
-            }
-            else
-            {
-                *os << "-" << std::endl;
-            }
+            *os << *LoadNixCacheEntry(*entry) << std::endl;
         }
     }
 
@@ -1074,14 +1403,16 @@ template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceUp(uint32_t i)
 {
+    // New links can shorten any path
     g_isCacheDirty = true;
+    g_isCacheDirtyGlobal = true;
 }
 
 template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceDown(uint32_t i)
 {
-    g_isCacheDirty = true;
+    MarkInterfaceDirty(i);
 }
 
 template <typename T>
@@ -1089,13 +1420,14 @@ void
 NixVectorRouting<T>::NotifyAddAddress(uint32_t interface, IpInterfaceAddress address)
 {
     g_isCacheDirty = true;
+    g_isCacheDirtyGlobal = true;
 }
 
 template <typename T>
 void
 NixVectorRouting<T>::NotifyRemoveAddress(uint32_t interface, IpInterfaceAddress address)
 {
-    g_isCacheDirty = true;
+    MarkInterfaceDirty(interface);
 }
 
 template <typename T>
@@ -1107,6 +1439,7 @@ NixVectorRouting<T>::NotifyAddRoute(IpAddress dst,
                                     IpAddress prefixToUse)
 {
     g_isCacheDirty = true;
+    g_isCacheDirtyGlobal = true;
 }
 
 template <typename T>
@@ -1118,6 +1451,7 @@ NixVectorRouting<T>::NotifyRemoveRoute(IpAddress dst,
                                        IpAddress prefixToUse)
 {
     g_isCacheDirty = true;
+    g_isCacheDirtyGlobal = true;
 }
 
 template <typename T>
@@ -1130,7 +1464,8 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
 {
     NS_LOG_FUNCTION(this << numberOfNodes << source << dest << parentVector << oif);
 
-    NS_LOG_LOGIC("Going from Node " << source->GetId() << " to Node " << dest->GetId());
+    NS_LOG_LOGIC("Going from Node " << source->GetId() << " to Node "
+                                    << (dest ? std::to_string(dest->GetId()) : "any"));
     std::queue<Ptr<Node>> greyNodeList; // discovered nodes with unexplored children
 
     // reset the parent vector
@@ -1278,8 +1613,8 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
         greyNodeList.pop();
     }
 
-    // Didn't find the dest...
-    return false;
+    // Didn't find the dest, unless the whole tree was requested
+    return !dest;
 }
 
 template <typename T>
@@ -1423,9 +1758,95 @@ NixVectorRouting<T>::CheckCacheStateAndFlush() const
 {
     if (g_isCacheDirty)
     {
-        FlushGlobalNixRoutingCache();
         g_epoch++;
+        if (g_isCacheDirtyGlobal)
+        {
+            FlushGlobalNixRoutingCache();
+        }
+        else
+        {
+            // Nix-vectors not going through the affected nodes are still
+            // valid and are revalidated lazily against this record; the
+            // route caches and neighbor counts are cheap to rebuild.
+            for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+            {
+                Ptr<NixVectorRouting<T>> rp = (*i)->GetObject<NixVectorRouting>();
+                if (!rp)
+                {
+                    continue;
+                }
+                rp->FlushIpRouteCache();
+                rp->m_totalNeighbors = 0;
+            }
+            g_ipAddressToNodeMap.clear();
+
+            std::sort(g_dirtyNodes.begin(), g_dirtyNodes.end());
+            g_dirtyNodes.erase(std::unique(g_dirtyNodes.begin(), g_dirtyNodes.end()),
+                               g_dirtyNodes.end());
+            g_invalidations.push_back({g_epoch, g_dirtyNodes});
+
+            if (g_invalidations.size() > NIX_CACHE_MAX_INVALIDATIONS)
+            {
+                // Check every slot against the records, which stamps it with
+                // the current epoch or as stale, so that the records can go
+                for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+                {
+                    Ptr<NixVectorRouting<T>> rp = (*i)->GetObject<NixVectorRouting>();
+                    if (!rp)
+                    {
+                        continue;
+                    }
+                    for (auto& entry : rp->m_nixCache)
+                    {
+                        if (entry.dest != NIX_CACHE_EMPTY)
+                        {
+                            rp->IsNixCacheEntryValid(entry);
+                        }
+                    }
+                }
+                g_invalidations.clear();
+            }
+        }
+        g_dirtyNodes.clear();
         g_isCacheDirty = false;
+        g_isCacheDirtyGlobal = false;
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::MarkInterfaceDirty(uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << interface);
+
+    g_isCacheDirty = true;
+
+    if (!m_ip)
+    {
+        g_isCacheDirtyGlobal = true;
+        return;
+    }
+
+    Ptr<NetDevice> device = m_ip->GetNetDevice(interface);
+    Ptr<Channel> channel = device->GetChannel();
+    if (!channel || NetDeviceIsBridged(device))
+    {
+        g_isCacheDirtyGlobal = true;
+        return;
+    }
+
+    // The neighbor indices of every node attached to the channel depend on
+    // the state of this interface.
+    g_dirtyNodes.push_back(device->GetNode()->GetId());
+    for (std::size_t i = 0; i < channel->GetNDevices(); i++)
+    {
+        Ptr<NetDevice> remoteDevice = channel->GetDevice(i);
+        if (NetDeviceIsBridged(remoteDevice))
+        {
+            g_isCacheDirtyGlobal = true;
+            return;
+        }
+        g_dirtyNodes.push_back(remoteDevice->GetNode()->GetId());
     }
 }
 
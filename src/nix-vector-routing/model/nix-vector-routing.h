@@ -41,11 +41,14 @@
 #include "ns3/node-list.h"
 #include "ns3/nstime.h"
 
+#include <limits>
 #include <map>
 #include <unordered_map>
 
 // NOLINTBEGIN(modernize-use-override)
 
+class NixVectorCacheTest;
+
 namespace ns3
 {
 
@@ -143,6 +146,9 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                           Time::Unit unit) const;
 
   private:
+    /// Allow test cases to access the nix-vector cache
+    friend class ::NixVectorCacheTest;
+
     /**
      * Flushes the cache which stores nix-vector based on
      * destination IP
@@ -167,6 +173,10 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      * BFS, accounting for any output interface specified, and finally
      * BuildNixVector to return the built nix-vector
      *
+     * When no output interface is given and the source is this node, a
+     * single BFS covering all destinations is run and its results are
+     * used to fill the nix-vector cache in batches (see PrefillNixCache).
+     *
      * \param source Source node
      * \param dest Destination node address
      * \param oif Preferred output interface
@@ -178,9 +188,41 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      * Checks the cache based on dest IP for the nix-vector
      * \param address Address to check
      * \param foundInCache Address found in cache
-     * \returns The NixVector to be used in routing.
+     * \param requested Whether the lookup routes a packet, which lists
+     *        the address in the routing table
+     * \returns A private copy of the cached NixVector, to be used in routing.
+     */
+    Ptr<NixVector> GetNixVectorInCache(const IpAddress& address,
+                                       bool& foundInCache,
+                                       bool requested = false) const;
+
+    /**
+     * Lists an address in the routing table, once the nix-vector built
+     * to route a packet to it is cached.
+     * \param address the destination address of the packet
+     */
+    void SetNixCacheEntryAddress(const IpAddress& address) const;
+
+    /**
+     * Walks the parent vector from dest back to source and collects the
+     * indices of the nodes on the path.
+     * \param [in] parentVector Parent vector for retracing routes
+     * \param [in] source Source Node index
+     * \param [in] dest Destination Node index
+     * \param [out] path node indices from dest to source, both included
      */
-    Ptr<NixVector> GetNixVectorInCache(const IpAddress& address, bool& foundInCache) const;
+    void BuildNixPath(const std::vector<Ptr<Node>>& parentVector,
+                      uint32_t source,
+                      uint32_t dest,
+                      std::vector<uint32_t>& path) const;
+
+    /**
+     * Stores the nix-vectors for up to m_nixCacheBatchSize further destinations
+     * reachable in a BFS tree, so that later lookups from this node skip the BFS.
+     * \param parentVector BFS tree rooted at this node
+     * \param dest index of the destination that triggered the BFS
+     */
+    void PrefillNixCache(const std::vector<Ptr<Node>>& parentVector, uint32_t dest) const;
 
     /**
      * Checks the cache based on dest IP for the IpRoute
@@ -283,8 +325,6 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     void DoDispose();
 
-    /// Map of IpAddress to NixVector
-    typedef std::map<IpAddress, Ptr<NixVector>> NixMap_t;
     /// Map of IpAddress to IpRoute
     typedef std::map<IpAddress, Ptr<IpRoute>> IpRouteMap_t;
 
@@ -475,6 +515,97 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     void CheckCacheStateAndFlush() const;
 
+    /**
+     * Records the nodes whose neighbor numbering is affected by a change on
+     * one of this node's interfaces, so that only the cached nix-vectors going
+     * through them are invalidated. Falls back to a global flush when the
+     * affected set cannot be determined (e.g., bridged devices).
+     * \param interface the interface index on this node
+     */
+    void MarkInterfaceDirty(uint32_t interface);
+
+    /// Sentinel for an unused nix-vector cache slot
+    static constexpr uint32_t NIX_CACHE_EMPTY = std::numeric_limits<uint32_t>::max();
+    /// Number of serialized NixVector words stored inline in a cache slot
+    static constexpr uint16_t NIX_CACHE_INLINE_WORDS = 6;
+    /// Number of path nodes stored inline in a cache slot
+    static constexpr uint16_t NIX_CACHE_INLINE_HOPS = 8;
+    /// Epoch of the cache slots invalidated by a topology change
+    static constexpr uint32_t NIX_CACHE_STALE = 0;
+    /// Number of scoped invalidations kept before all the slots are checked against them
+    static constexpr std::size_t NIX_CACHE_MAX_INVALIDATIONS = 16;
+
+    /**
+     * Slot of the per-node nix-vector cache.
+     *
+     * The nix-vector is kept in its serialized form in the slot itself; only
+     * nix-vectors too long to fit are spilled to a heap-allocated NixVector.
+     * The nodes of the path are kept so that a topology change only
+     * invalidates the slots whose path goes through an affected node.
+     */
+    struct NixCacheEntry
+    {
+        uint32_t dest{NIX_CACHE_EMPTY}; //!< Destination node index
+        uint32_t epoch{0};              //!< Epoch the entry was last validated in
+        uint16_t nWords{0};             //!< Inline serialized words, 0 if spilled
+        uint16_t nHops{0};              //!< Path length, may exceed the inline storage
+        uint32_t words[NIX_CACHE_INLINE_WORDS]; //!< Serialized NixVector
+        uint32_t hops[NIX_CACHE_INLINE_HOPS];   //!< Node indices on the path
+        Ptr<NixVector> spill;                   //!< NixVector too long to be stored inline
+        IpAddress address;                      //!< Address routed to, unset if prefilled
+    };
+
+    /**
+     * Nodes affected by the topology changes flushed at a given epoch.
+     */
+    struct NixCacheInvalidation
+    {
+        uint32_t epoch;              //!< Epoch created by the flush
+        std::vector<uint32_t> nodes; //!< Sorted indices of the affected nodes
+    };
+
+    /**
+     * Looks up the cache slot of a destination.
+     * \param dest destination node index
+     * \returns the slot, or nullptr if the destination is not cached
+     */
+    NixCacheEntry* FindNixCacheEntry(uint32_t dest) const;
+
+    /**
+     * Stores a nix-vector in the cache, growing the table up to
+     * m_nixCacheCapacity entries and replacing the entry in the home slot,
+     * or the one following it, once full.
+     * \param dest destination node index
+     * \param nixVector the nix-vector to store
+     * \param path node indices on the path
+     */
+    void InsertNixCacheEntry(uint32_t dest,
+                             Ptr<const NixVector> nixVector,
+                             const std::vector<uint32_t>& path) const;
+
+    /**
+     * Empties a cache slot, moving back the entries which follow it so
+     * that they can still be found.
+     * \param slot the index of the slot
+     */
+    void EraseNixCacheEntry(uint32_t slot) const;
+
+    /**
+     * Checks whether a cache slot survived the topology changes since it
+     * was last validated, and stamps it with the current epoch if so, or
+     * as stale otherwise.
+     * \param entry the cache slot
+     * \returns true if the slot can be used
+     */
+    bool IsNixCacheEntryValid(NixCacheEntry& entry) const;
+
+    /**
+     * Materializes the nix-vector held by a cache slot.
+     * \param entry the cache slot
+     * \returns a new NixVector, owned by the caller
+     */
+    Ptr<NixVector> LoadNixCacheEntry(const NixCacheEntry& entry) const;
+
     /**
      * Build map from IP Address to Node for faster lookup.
      */
@@ -491,8 +622,26 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     static uint32_t g_epoch;
 
-    /** Cache stores nix-vectors based on destination ip */
-    mutable NixMap_t m_nixCache;
+    /// Set when a pending topology change requires flushing every nix-vector cache
+    static bool g_isCacheDirtyGlobal;
+
+    /// Nodes affected by the pending topology changes
+    static std::vector<uint32_t> g_dirtyNodes;
+
+    /// Scoped invalidations not yet checked by every cache slot, ordered by epoch
+    static std::vector<NixCacheInvalidation> g_invalidations;
+
+    /**
+     * Cache stores nix-vectors based on destination node index.
+     * Open addressing with linear probing, the size is a power of two.
+     */
+    mutable std::vector<NixCacheEntry> m_nixCache;
+
+    /// Number of used slots in m_nixCache
+    mutable uint32_t m_nixCacheSize;
+
+    uint32_t m_nixCacheCapacity;  //!< Maximum number of cached nix-vectors, 0 if unbounded
+    uint32_t m_nixCacheBatchSize; //!< Destinations filled from a single BFS
 
     /** Cache stores IpRoutes based on destination ip */
     mutable IpRouteMap_t m_ipRouteCache;
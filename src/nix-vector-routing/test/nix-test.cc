@@ -25,6 +25,7 @@
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
@@ -32,6 +33,9 @@
 #include "ns3/test.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
 
 using namespace ns3;
 
@@ -393,6 +397,271 @@ NixVectorRoutingTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * The topology is of the form:
+ * \verbatim
+    n3 -- n2 -- n1 -- n0 -- n4 -- n5
+   \endverbatim
+ *
+ * Following are the tests in this test case:
+ * - Test that a BFS fills the cache for BfsBatchSize more destinations.
+ * - Test that the cache holds at most CacheCapacity nix-vectors, and that
+ *   the ones it holds can still be found.
+ * - Test that a link going down only invalidates the nix-vectors through
+ *   its nodes, and that the routing table lists the addresses routed to.
+ * - Test that the records of the invalidations do not pile up.
+ *
+ * \brief IPv4 Nix-Vector Routing cache Test
+ */
+class NixVectorCacheTest : public TestCase
+{
+  public:
+    NixVectorCacheTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create the topology.
+     * \param capacity The CacheCapacity of the nodes.
+     * \param batchSize The BfsBatchSize of the nodes.
+     */
+    void CreateTopology(uint32_t capacity, uint32_t batchSize);
+
+    /**
+     * \brief Route a packet from n0.
+     * \param dest The destination node.
+     * \returns true if a route was found.
+     */
+    bool Route(uint32_t dest);
+
+    /**
+     * \brief Check the cache of n0.
+     * \param dest The destination node.
+     * \returns true if n0 holds a valid nix-vector to dest.
+     */
+    bool IsCached(uint32_t dest);
+
+    /**
+     * \returns The number of nix-vectors held by n0.
+     */
+    uint32_t GetCacheSize();
+
+    /**
+     * \returns The nix-vector cache part of the routing table of n0.
+     */
+    std::string GetNixCacheTable();
+
+    /// Test the BfsBatchSize attribute
+    void TestBatch();
+    /// Test the CacheCapacity attribute
+    void TestCapacity();
+    /// Test the invalidation of the nix-vectors through a link going down
+    void TestInvalidation();
+
+    NodeContainer m_nodes;                //!< The nodes
+    std::vector<Ipv4Address> m_addresses; //!< The address of each node
+    NetDeviceContainer m_branch;          //!< The devices of the n4 - n5 link
+};
+
+NixVectorCacheTest::NixVectorCacheTest()
+    : TestCase("nix-vector cache test")
+{
+}
+
+void
+NixVectorCacheTest::CreateTopology(uint32_t capacity, uint32_t batchSize)
+{
+    m_nodes = NodeContainer();
+    m_nodes.Create(6);
+    m_addresses.assign(6, Ipv4Address());
+
+    InternetStackHelper stack;
+    stack.SetRoutingHelper(Ipv4NixVectorHelper());
+    stack.SetIpv6StackInstall(false);
+    stack.Install(m_nodes);
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4NixVectorRouting> routing = m_nodes.Get(i)->GetObject<Ipv4NixVectorRouting>();
+        routing->SetAttribute("CacheCapacity", UintegerValue(capacity));
+        routing->SetAttribute("BfsBatchSize", UintegerValue(batchSize));
+    }
+
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper addresses;
+    addresses.SetBase("10.2.1.0", "255.255.255.0");
+    const std::pair<uint32_t, uint32_t> links[] = {{0, 1}, {1, 2}, {2, 3}, {0, 4}, {4, 5}};
+    for (const auto& [a, b] : links)
+    {
+        NetDeviceContainer devices =
+            devHelper.Install(NodeContainer(m_nodes.Get(a), m_nodes.Get(b)));
+        Ipv4InterfaceContainer interfaces = addresses.Assign(devices);
+        addresses.NewNetwork();
+        if (m_addresses[a] == Ipv4Address())
+        {
+            m_addresses[a] = interfaces.GetAddress(0);
+        }
+        m_addresses[b] = interfaces.GetAddress(1);
+        if (a == 4)
+        {
+            m_branch = devices;
+        }
+    }
+}
+
+bool
+NixVectorCacheTest::Route(uint32_t dest)
+{
+    Ipv4Header header;
+    header.SetDestination(m_addresses[dest]);
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = m_nodes.Get(0)->GetObject<Ipv4NixVectorRouting>()->RouteOutput(
+        Create<Packet>(),
+        header,
+        nullptr,
+        sockerr);
+    return route != nullptr;
+}
+
+bool
+NixVectorCacheTest::IsCached(uint32_t dest)
+{
+    Ptr<Ipv4NixVectorRouting> routing = m_nodes.Get(0)->GetObject<Ipv4NixVectorRouting>();
+    routing->CheckCacheStateAndFlush();
+    Ipv4NixVectorRouting::NixCacheEntry* entry = routing->FindNixCacheEntry(dest);
+    return entry && routing->IsNixCacheEntryValid(*entry);
+}
+
+uint32_t
+NixVectorCacheTest::GetCacheSize()
+{
+    return m_nodes.Get(0)->GetObject<Ipv4NixVectorRouting>()->m_nixCacheSize;
+}
+
+std::string
+NixVectorCacheTest::GetNixCacheTable()
+{
+    std::ostringstream table;
+    m_nodes.Get(0)->GetObject<Ipv4NixVectorRouting>()->PrintRoutingTable(
+        Create<OutputStreamWrapper>(&table));
+    std::string str = table.str();
+    std::size_t begin = str.find("NixCache:\n") + 10;
+    return str.substr(begin, str.find("IpRouteCache:") - begin);
+}
+
+void
+NixVectorCacheTest::TestBatch()
+{
+    CreateTopology(0, 2);
+    NS_TEST_ASSERT_MSG_EQ(Route(1), true, "No route to n1");
+    // The BFS fills the cache for the two nodes following n1
+    NS_TEST_EXPECT_MSG_EQ(GetCacheSize(), 3, "Wrong number of nix-vectors from one BFS");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(1), true, "Nix-vector to n1 not cached");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(2), true, "Nix-vector to n2 not prefilled");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(3), true, "Nix-vector to n3 not prefilled");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(4), false, "Nix-vector to n4 prefilled past the batch");
+    Simulator::Destroy();
+
+    CreateTopology(0, 0);
+    NS_TEST_ASSERT_MSG_EQ(Route(1), true, "No route to n1");
+    NS_TEST_EXPECT_MSG_EQ(GetCacheSize(), 1, "Nix-vectors prefilled without a batch");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(2), false, "Nix-vector to n2 prefilled without a batch");
+    Simulator::Destroy();
+}
+
+void
+NixVectorCacheTest::TestCapacity()
+{
+    CreateTopology(2, 64);
+    for (uint32_t round = 0; round < 3; round++)
+    {
+        for (uint32_t dest = 1; dest < m_nodes.GetN(); dest++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(Route(dest), true, "No route to n" << dest);
+            NS_TEST_EXPECT_MSG_LT_OR_EQ(GetCacheSize(), 2, "Cache over its capacity");
+            NS_TEST_EXPECT_MSG_EQ(IsCached(dest), true, "Nix-vector to n" << dest << " lost");
+        }
+    }
+    // Every nix-vector counted can be found
+    uint32_t found = 0;
+    for (uint32_t dest = 1; dest < m_nodes.GetN(); dest++)
+    {
+        found += IsCached(dest);
+    }
+    NS_TEST_EXPECT_MSG_EQ(found, GetCacheSize(), "Nix-vectors counted but not found");
+    Simulator::Destroy();
+}
+
+void
+NixVectorCacheTest::TestInvalidation()
+{
+    CreateTopology(0, 64);
+    NS_TEST_ASSERT_MSG_EQ(Route(3), true, "No route to n3");
+    NS_TEST_ASSERT_MSG_EQ(Route(5), true, "No route to n5");
+
+    // Only the destinations routed to are listed
+    std::ostringstream n3;
+    n3 << m_addresses[3];
+    n3 << std::string(30 - n3.str().size(), ' ');
+    std::ostringstream n5;
+    n5 << m_addresses[5];
+    n5 << std::string(30 - n5.str().size(), ' ');
+    std::string table = GetNixCacheTable();
+    NS_TEST_EXPECT_MSG_EQ(table.substr(0, 40),
+                          "Destination                   NixVector\n",
+                          "Wrong NixCache header");
+    NS_TEST_EXPECT_MSG_EQ(std::count(table.begin(), table.end(), '\n'),
+                          3,
+                          "Wrong number of destinations listed");
+    NS_TEST_EXPECT_MSG_NE(table.find("\n" + n3.str()), std::string::npos, "n3 not listed");
+    NS_TEST_EXPECT_MSG_NE(table.find("\n" + n5.str()), std::string::npos, "n5 not listed");
+    NS_TEST_EXPECT_MSG_LT(table.find(n3.str()), table.find(n5.str()), "Wrong order");
+
+    // Set the n4 interface on the n4 - n5 link down
+    Ptr<Ipv4> ipv4 = m_nodes.Get(4)->GetObject<Ipv4>();
+    ipv4->SetDown(ipv4->GetInterfaceForDevice(m_branch.Get(0)));
+    NS_TEST_EXPECT_MSG_EQ(IsCached(1), true, "Nix-vector to n1 invalidated");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(2), true, "Nix-vector to n2 invalidated");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(3), true, "Nix-vector to n3 invalidated");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(4), false, "Nix-vector to n4 not invalidated");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(5), false, "Nix-vector to n5 not invalidated");
+    table = GetNixCacheTable();
+    NS_TEST_EXPECT_MSG_NE(table.find("\n" + n3.str()), std::string::npos, "n3 not listed");
+    NS_TEST_EXPECT_MSG_EQ(table.find(n5.str()), std::string::npos, "n5 listed");
+    NS_TEST_EXPECT_MSG_EQ(Route(5), false, "Route to n5 through a link down");
+    NS_TEST_EXPECT_MSG_EQ(Route(3), true, "No route to n3");
+
+    // Many changes on the n2 - n3 link: the records are dropped once the
+    // nix-vectors are checked against them, which keep their state
+    Ptr<Ipv4NixVectorRouting> routing = m_nodes.Get(2)->GetObject<Ipv4NixVectorRouting>();
+    uint32_t interface = m_nodes.Get(2)->GetObject<Ipv4>()->GetNInterfaces() - 1;
+    for (std::size_t i = 0; i <= Ipv4NixVectorRouting::NIX_CACHE_MAX_INVALIDATIONS; i++)
+    {
+        routing->NotifyInterfaceDown(interface);
+        NS_TEST_EXPECT_MSG_EQ(IsCached(1), true, "Nix-vector to n1 invalidated");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(Ipv4NixVectorRouting::g_invalidations.size(),
+                                    Ipv4NixVectorRouting::NIX_CACHE_MAX_INVALIDATIONS,
+                                    "Invalidations piling up");
+    }
+    NS_TEST_EXPECT_MSG_EQ(IsCached(1), true, "Nix-vector to n1 invalidated");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(2), false, "Nix-vector to n2 not invalidated");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(3), false, "Nix-vector to n3 not invalidated");
+    NS_TEST_EXPECT_MSG_EQ(IsCached(5), false, "Nix-vector to n5 valid again");
+    Simulator::Destroy();
+}
+
+void
+NixVectorCacheTest::DoRun()
+{
+    TestBatch();
+    TestCapacity();
+    TestInvalidation();
+}
+
 /**
  * \ingroup nix-vector-routing-test
  * \ingroup tests
@@ -406,6 +675,7 @@ class NixVectorRoutingTestSuite : public TestSuite
         : TestSuite("nix-vector-routing", UNIT)
     {
         AddTestCase(new NixVectorRoutingTest(), TestCase::QUICK);
+        AddTestCase(new NixVectorCacheTest(), TestCase::QUICK);
     }
 };
 
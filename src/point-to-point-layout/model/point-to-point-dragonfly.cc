@@ -0,0 +1,205 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Implement an object to create a dragonfly topology.
+
+#include "point-to-point-dragonfly.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointDragonflyHelper");
+
+namespace
+{
+
+/**
+ * \param p the number of hosts of each router
+ * \param a the number of routers of each group
+ * \param h the number of global links of each router
+ * \param g the number of groups
+ *
+ * \returns the number of ports of each node of the dragonfly
+ */
+std::vector<uint32_t>
+DragonflyPorts(uint32_t p, uint32_t a, uint32_t h, uint32_t g)
+{
+    uint64_t maxGroups = uint64_t(a) * h + 1;
+    if (a < 1 || g < 1 || g > maxGroups)
+    {
+        NS_FATAL_ERROR("Invalid dragonfly: need more routers, or fewer groups.");
+    }
+    uint64_t routers = uint64_t(a) * g;
+    uint64_t hosts = routers * p;
+    if (hosts + routers >= PointToPointFabricHelper::NO_NEIGHBOR)
+    {
+        NS_FATAL_ERROR("Too many nodes for dragonfly.");
+    }
+    std::vector<uint32_t> ports(hosts + routers, p + a - 1 + h);
+    std::fill(ports.begin(), ports.begin() + hosts, 1);
+    return ports;
+}
+
+} // unnamed namespace
+
+PointToPointDragonflyHelper::PointToPointDragonflyHelper(uint32_t nHosts,
+                                                         uint32_t nRouters,
+                                                         uint32_t nGlobal,
+                                                         uint32_t nGroups,
+                                                         PointToPointHelper pointToPoint)
+    : PointToPointFabricHelper(DragonflyPorts(nHosts,
+                                              nRouters,
+                                              nGlobal,
+                                              nGroups ? nGroups : nRouters * nGlobal + 1)),
+      m_p(nHosts),
+      m_a(nRouters),
+      m_h(nGlobal),
+      m_g(nGroups ? nGroups : nRouters * nGlobal + 1),
+      m_hosts(m_p * m_a * m_g)
+{
+    for (uint32_t group = 0; group < m_g; ++group)
+    {
+        for (uint32_t r = 0; r < m_a; ++r)
+        {
+            for (uint32_t i = 0; i < m_p; ++i)
+            {
+                Connect(pointToPoint, GetHost(group, r, i), 0, GetRouter(group, r), i);
+            }
+        }
+        for (uint32_t r = 0; r < m_a; ++r)
+        {
+            for (uint32_t s = r + 1; s < m_a; ++s)
+            {
+                Connect(pointToPoint,
+                        GetRouter(group, r),
+                        GetLocalPort(r, s),
+                        GetRouter(group, s),
+                        GetLocalPort(s, r));
+            }
+        }
+        // Each global link is installed from the lower group
+        for (uint32_t other = group + 1; other < m_g; ++other)
+        {
+            Connect(pointToPoint,
+                    GetRouter(group, GetGatewayRouter(group, other)),
+                    GetGlobalPort(group, other),
+                    GetRouter(other, GetGatewayRouter(other, group)),
+                    GetGlobalPort(other, group));
+        }
+    }
+}
+
+PointToPointDragonflyHelper::~PointToPointDragonflyHelper()
+{
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetNHosts() const
+{
+    return m_hosts;
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetNGroups() const
+{
+    return m_g;
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetHost(uint32_t group, uint32_t router, uint32_t i) const
+{
+    if (group >= m_g || router >= m_a || i >= m_p)
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointDragonflyHelper::GetHost.");
+    }
+    return (group * m_a + router) * m_p + i;
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetRouter(uint32_t group, uint32_t router) const
+{
+    if (group >= m_g || router >= m_a)
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointDragonflyHelper::GetRouter.");
+    }
+    return m_hosts + group * m_a + router;
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetGroup(uint32_t i) const
+{
+    if (i >= GetN())
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointDragonflyHelper::GetGroup.");
+    }
+    return i < m_hosts ? i / (m_p * m_a) : (i - m_hosts) / m_a;
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetRouterInGroup(uint32_t i) const
+{
+    if (i >= GetN())
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointDragonflyHelper::GetRouterInGroup.");
+    }
+    return i < m_hosts ? (i / m_p) % m_a : (i - m_hosts) % m_a;
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetLocalPort(uint32_t router, uint32_t other) const
+{
+    NS_ASSERT_MSG(router != other && router < m_a && other < m_a, "Invalid local link");
+    return m_p + (other < router ? other : other - 1);
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetGatewayRouter(uint32_t group, uint32_t other) const
+{
+    NS_ASSERT_MSG(group != other && group < m_g && other < m_g, "Invalid global link");
+    return (other < group ? other : other - 1) / m_h;
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetGlobalPort(uint32_t group, uint32_t other) const
+{
+    NS_ASSERT_MSG(group != other && group < m_g && other < m_g, "Invalid global link");
+    return m_p + m_a - 1 + (other < group ? other : other - 1) % m_h;
+}
+
+uint32_t
+PointToPointDragonflyHelper::GetNextPort(uint32_t from, uint32_t to) const
+{
+    NS_ASSERT_MSG(from != to && to < m_hosts, "Invalid route");
+    if (from < m_hosts)
+    {
+        return 0;
+    }
+    uint32_t group = GetGroup(from);
+    uint32_t router = GetRouterInGroup(from);
+    uint32_t target = GetGroup(to);
+    uint32_t targetRouter = GetRouterInGroup(to);
+    if (group == target)
+    {
+        return router == targetRouter ? to % m_p : GetLocalPort(router, targetRouter);
+    }
+    uint32_t gateway = GetGatewayRouter(group, target);
+    return router == gateway ? GetGlobalPort(group, target) : GetLocalPort(router, gateway);
+}
+
+} // namespace ns3
@@ -0,0 +1,158 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Define an object to create a dragonfly topology.
+
+#ifndef POINT_TO_POINT_DRAGONFLY_HELPER_H
+#define POINT_TO_POINT_DRAGONFLY_HELPER_H
+
+#include "point-to-point-fabric.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point-layout
+ *
+ * \brief A helper to make it easier to create a dragonfly topology
+ * with p2p links
+ *
+ * A dragonfly has g groups of a routers, each with p hosts and h global
+ * links.  The routers of a group are fully connected by local links, and
+ * each pair of groups is connected by one global link, so there are at
+ * most a * h + 1 groups.  The hosts come first in the node indices, then
+ * the routers, both ordered by group.
+ *
+ * Port 0 of a host leads to its router.  Ports 0 to p - 1 of a router
+ * lead to its hosts, ports p to p + a - 2 to the other routers of its
+ * group, in order, and ports p + a - 1 to p + a + h - 2 are global.  The
+ * global links are arranged consecutively: global port x of a group,
+ * which is port x % h of its router x / h, leads to group x if x is
+ * lower than the group, and to group x + 1 otherwise.  With fewer than
+ * a * h + 1 groups, the global ports leading past the last group are
+ * unconnected.
+ *
+ * GetNextPort() routes to hosts only, on the minimal route: at most one
+ * local link in the source group, the global link, and at most one
+ * local link in the destination group.
+ */
+class PointToPointDragonflyHelper : public PointToPointFabricHelper
+{
+  public:
+    /**
+     * Create a PointToPointDragonflyHelper in order to easily create
+     * dragonfly topologies using p2p links
+     *
+     * \param nHosts the number of hosts of each router (p)
+     *
+     * \param nRouters the number of routers of each group (a)
+     *
+     * \param nGlobal the number of global links of each router (h)
+     *
+     * \param nGroups the number of groups (g), at most a * h + 1;
+     *                0 for a * h + 1
+     *
+     * \param pointToPoint the PointToPointHelper which is used
+     *                     to connect all of the nodes together
+     *                     in the dragonfly
+     */
+    PointToPointDragonflyHelper(uint32_t nHosts,
+                                uint32_t nRouters,
+                                uint32_t nGlobal,
+                                uint32_t nGroups,
+                                PointToPointHelper pointToPoint);
+
+    ~PointToPointDragonflyHelper() override;
+
+    /**
+     * \returns the number of hosts in the dragonfly
+     */
+    uint32_t GetNHosts() const;
+
+    /**
+     * \returns the number of groups in the dragonfly
+     */
+    uint32_t GetNGroups() const;
+
+    /**
+     * \param group a group
+     * \param router the position of the router in the group
+     * \param i the position of the host on the router
+     *
+     * \returns the index of the host
+     */
+    uint32_t GetHost(uint32_t group, uint32_t router, uint32_t i) const;
+
+    /**
+     * \param group a group
+     * \param router the position of the router in the group
+     *
+     * \returns the index of the router
+     */
+    uint32_t GetRouter(uint32_t group, uint32_t router) const;
+
+    /**
+     * \param i the index of a host or router
+     *
+     * \returns the group of the node
+     */
+    uint32_t GetGroup(uint32_t i) const;
+
+    /**
+     * \param i the index of a host or router
+     *
+     * \returns the position in its group of the router of the node, or of
+     *          the node itself if it is a router
+     */
+    uint32_t GetRouterInGroup(uint32_t i) const;
+
+    /**
+     * \param router the position of a router in its group
+     * \param other the position of another router of the group
+     *
+     * \returns the port of the router leading to the other router
+     */
+    uint32_t GetLocalPort(uint32_t router, uint32_t other) const;
+
+    /**
+     * \param group a group
+     * \param other another group
+     *
+     * \returns the position in \p group of the router linked to \p other
+     */
+    uint32_t GetGatewayRouter(uint32_t group, uint32_t other) const;
+
+    /**
+     * \param group a group
+     * \param other another group
+     *
+     * \returns the port of the gateway router of \p group leading to
+     *          \p other
+     */
+    uint32_t GetGlobalPort(uint32_t group, uint32_t other) const;
+
+    uint32_t GetNextPort(uint32_t from, uint32_t to) const override;
+
+  private:
+    uint32_t m_p;     //!< number of hosts of each router
+    uint32_t m_a;     //!< number of routers of each group
+    uint32_t m_h;     //!< number of global links of each router
+    uint32_t m_g;     //!< number of groups
+    uint32_t m_hosts; //!< number of hosts
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_DRAGONFLY_HELPER_H */
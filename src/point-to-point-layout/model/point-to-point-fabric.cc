@@ -0,0 +1,207 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Implement the base of the helpers creating large regular topologies.
+
+#include "point-to-point-fabric.h"
+
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointFabricHelper");
+
+PointToPointFabricHelper::PointToPointFabricHelper(const std::vector<uint32_t>& nPorts)
+{
+    NS_LOG_FUNCTION(this << nPorts.size());
+    m_nodes.Create(nPorts.size());
+
+    m_firstPort.reserve(nPorts.size() + 1);
+    std::size_t slots = 0;
+    for (uint32_t ports : nPorts)
+    {
+        m_firstPort.push_back(slots);
+        slots += ports;
+    }
+    m_firstPort.push_back(slots);
+    m_ports.resize(slots, Port{NO_NEIGHBOR, nullptr, Ipv4Address()});
+    m_links.reserve(slots / 2);
+}
+
+PointToPointFabricHelper::~PointToPointFabricHelper()
+{
+}
+
+std::size_t
+PointToPointFabricHelper::Slot(uint32_t i, uint32_t port) const
+{
+    if (i >= m_nodes.GetN() || port >= m_firstPort[i + 1] - m_firstPort[i])
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointFabricHelper.");
+    }
+    return m_firstPort[i] + port;
+}
+
+void
+PointToPointFabricHelper::Connect(PointToPointHelper& pointToPoint,
+                                  uint32_t a,
+                                  uint32_t portA,
+                                  uint32_t b,
+                                  uint32_t portB)
+{
+    std::size_t slotA = Slot(a, portA);
+    std::size_t slotB = Slot(b, portB);
+    NS_ASSERT_MSG(!m_ports[slotA].device && !m_ports[slotB].device, "Port already connected");
+
+    NetDeviceContainer devices = pointToPoint.Install(m_nodes.Get(a), m_nodes.Get(b));
+    m_ports[slotA].neighbor = b;
+    m_ports[slotA].device = devices.Get(0);
+    m_ports[slotB].neighbor = a;
+    m_ports[slotB].device = devices.Get(1);
+    m_links.emplace_back(slotA, slotB);
+}
+
+uint32_t
+PointToPointFabricHelper::GetN() const
+{
+    return m_nodes.GetN();
+}
+
+Ptr<Node>
+PointToPointFabricHelper::GetNode(uint32_t i) const
+{
+    if (i >= m_nodes.GetN())
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointFabricHelper::GetNode.");
+    }
+    return m_nodes.Get(i);
+}
+
+const NodeContainer&
+PointToPointFabricHelper::GetNodes() const
+{
+    return m_nodes;
+}
+
+uint32_t
+PointToPointFabricHelper::GetNLinks() const
+{
+    return m_links.size();
+}
+
+uint32_t
+PointToPointFabricHelper::GetNPorts(uint32_t i) const
+{
+    if (i >= m_nodes.GetN())
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointFabricHelper::GetNPorts.");
+    }
+    return m_firstPort[i + 1] - m_firstPort[i];
+}
+
+Ptr<NetDevice>
+PointToPointFabricHelper::GetDevice(uint32_t i, uint32_t port) const
+{
+    return m_ports[Slot(i, port)].device;
+}
+
+uint32_t
+PointToPointFabricHelper::GetNeighbor(uint32_t i, uint32_t port) const
+{
+    return m_ports[Slot(i, port)].neighbor;
+}
+
+Ipv4Address
+PointToPointFabricHelper::GetIpv4Address(uint32_t i, uint32_t port) const
+{
+    return m_ports[Slot(i, port)].address;
+}
+
+void
+PointToPointFabricHelper::InstallStack(InternetStackHelper stack)
+{
+    stack.Install(m_nodes);
+}
+
+void
+PointToPointFabricHelper::AssignIpv4Addresses(Ipv4Address network, Ipv4Mask mask)
+{
+    NS_LOG_FUNCTION(this << network << mask);
+    uint64_t available = uint64_t(~mask.Get()) + 1;
+    if (uint64_t(4) * m_links.size() > available)
+    {
+        NS_FATAL_ERROR("The Ipv4 range holds too few addresses for the fabric.");
+    }
+
+    // Ipv4AddressHelper allocates the two addresses of each link apart, so
+    // the blocks of allocated addresses never merge and checking each new
+    // address against them is quadratic in the number of links; the range
+    // of the fabric is reserved in increasing order instead, which only
+    // ever extends a single block, and reports any collision with the
+    // addresses of the other helpers
+    uint32_t base = network.CombineMask(mask).Get();
+    for (uint32_t address = base; address < base + 4 * m_links.size(); ++address)
+    {
+        Ipv4AddressGenerator::AddAllocated(Ipv4Address(address));
+    }
+
+    Ipv4Mask linkMask("255.255.255.252");
+    TrafficControlHelper tcHelper = TrafficControlHelper::Default();
+    for (std::size_t link = 0; link < m_links.size(); ++link)
+    {
+        uint32_t subnet = base + 4 * link;
+        for (std::size_t slot : {m_links[link].first, m_links[link].second})
+        {
+            ++subnet;
+            Port& port = m_ports[slot];
+            Ptr<Node> node = port.device->GetNode();
+            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+            NS_ASSERT_MSG(ipv4,
+                          "PointToPointFabricHelper::AssignIpv4Addresses(): node without IPv4 "
+                          "stack installed (maybe need to call InstallStack?)");
+
+            port.address = Ipv4Address(subnet);
+            int32_t interface = ipv4->AddInterface(port.device);
+            ipv4->AddAddress(interface, Ipv4InterfaceAddress(port.address, linkMask));
+            ipv4->SetMetric(interface, 1);
+            ipv4->SetUp(interface);
+
+            // Install the default traffic control configuration, as
+            // Ipv4AddressHelper does
+            Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+            Ptr<NetDeviceQueueInterface> ndqi = port.device->GetObject<NetDeviceQueueInterface>();
+            if (tc && ndqi && !tc->GetRootQueueDiscOnDevice(port.device))
+            {
+                if (ndqi->GetNTxQueues() == 1)
+                {
+                    tcHelper.Install(port.device);
+                }
+                else
+                {
+                    TrafficControlHelper::Default(ndqi->GetNTxQueues()).Install(port.device);
+                }
+            }
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,196 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Define the base of the helpers creating large regular topologies.
+
+#ifndef POINT_TO_POINT_FABRIC_HELPER_H
+#define POINT_TO_POINT_FABRIC_HELPER_H
+
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/point-to-point-helper.h"
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point-layout
+ *
+ * \brief The base of the helpers creating large regular topologies
+ * (fabrics) with p2p links
+ *
+ * A fabric numbers its nodes from 0 to GetN() - 1 and the ports of
+ * each node from 0 to GetNPorts() - 1, following the structure of the
+ * topology, so that the neighbor behind a port and the port leading
+ * to a destination are known analytically: GetNextPort() gives the
+ * port of a minimal route, which lets specialized routing forward
+ * packets without running SPF on the whole fabric.  A port is not
+ * the interface index of its device, which depends on the order the
+ * links are installed in; GetDevice() maps a port to its device.
+ *
+ * The fabric is built in bulk: the nodes are created at once, the
+ * port table is allocated up front, and AssignIpv4Addresses() computes
+ * the address of each port from the index of its link instead of
+ * going through Ipv4AddressHelper, after reserving the addresses of the
+ * fabric with the Ipv4AddressGenerator.
+ */
+class PointToPointFabricHelper
+{
+  public:
+    /// The neighbor of an unconnected port.
+    static constexpr uint32_t NO_NEIGHBOR = std::numeric_limits<uint32_t>::max();
+
+    virtual ~PointToPointFabricHelper();
+
+    /**
+     * \returns the number of nodes in the fabric
+     */
+    uint32_t GetN() const;
+
+    /**
+     * \param i the index of a node of the fabric
+     *
+     * \returns a pointer to the node
+     */
+    Ptr<Node> GetNode(uint32_t i) const;
+
+    /**
+     * \returns all the nodes of the fabric, by index
+     */
+    const NodeContainer& GetNodes() const;
+
+    /**
+     * \returns the number of links in the fabric
+     */
+    uint32_t GetNLinks() const;
+
+    /**
+     * \param i the index of a node of the fabric
+     *
+     * \returns the number of ports of the node
+     */
+    uint32_t GetNPorts(uint32_t i) const;
+
+    /**
+     * \param i the index of a node of the fabric
+     * \param port a port of the node
+     *
+     * \returns the device of the port, null if the port is unconnected
+     */
+    Ptr<NetDevice> GetDevice(uint32_t i, uint32_t port) const;
+
+    /**
+     * \param i the index of a node of the fabric
+     * \param port a port of the node
+     *
+     * \returns the index of the node at the other end of the port, or
+     *          NO_NEIGHBOR if the port is unconnected
+     */
+    uint32_t GetNeighbor(uint32_t i, uint32_t port) const;
+
+    /**
+     * \param i the index of a node of the fabric
+     * \param port a connected port of the node
+     *
+     * \returns the Ipv4 address of the port
+     */
+    Ipv4Address GetIpv4Address(uint32_t i, uint32_t port) const;
+
+    /**
+     * Get the port of node \p from on a minimal route to node \p to.
+     *
+     * \param from the index of the current node
+     * \param to the index of the destination node, different from \p from
+     *
+     * \returns the port on which to forward the packets
+     */
+    virtual uint32_t GetNextPort(uint32_t from, uint32_t to) const = 0;
+
+    /**
+     * \param stack an InternetStackHelper which is used to install
+     *              on every node in the fabric
+     */
+    void InstallStack(InternetStackHelper stack);
+
+    /**
+     * Assigns Ipv4 addresses to all the ports of the fabric.  Link
+     * number n gets the /30 subnet starting 4 * n addresses after
+     * \p network, the first address to its first port and the second
+     * to its other port.  The 4 addresses of each link are reserved with
+     * the Ipv4AddressGenerator, so that their collisions with the
+     * addresses allocated by any other helper are detected.
+     *
+     * \param network the first address of the range of the fabric
+     * \param mask the mask of the range, which must hold 4 addresses
+     *             per link
+     */
+    void AssignIpv4Addresses(Ipv4Address network = Ipv4Address("10.0.0.0"),
+                             Ipv4Mask mask = Ipv4Mask("255.0.0.0"));
+
+  protected:
+    /**
+     * Create the nodes of the fabric and allocate its port table.
+     *
+     * \param nPorts the number of ports of each node of the fabric
+     */
+    PointToPointFabricHelper(const std::vector<uint32_t>& nPorts);
+
+    /**
+     * Install a p2p link between two ports.
+     *
+     * \param pointToPoint the PointToPointHelper creating the link
+     * \param a the index of the first node
+     * \param portA the port of the first node
+     * \param b the index of the second node
+     * \param portB the port of the second node
+     */
+    void Connect(PointToPointHelper& pointToPoint,
+                 uint32_t a,
+                 uint32_t portA,
+                 uint32_t b,
+                 uint32_t portB);
+
+  private:
+    /// A port of a node.
+    struct Port
+    {
+        uint32_t neighbor;     //!< Index of the node at the other end
+        Ptr<NetDevice> device; //!< Device of the port
+        Ipv4Address address;   //!< Ipv4 address of the port
+    };
+
+    /**
+     * \param i the index of a node of the fabric
+     * \param port a port of the node
+     *
+     * \returns the position of the port in m_ports
+     */
+    std::size_t Slot(uint32_t i, uint32_t port) const;
+
+    NodeContainer m_nodes;                //!< all the nodes of the fabric
+    std::vector<std::size_t> m_firstPort; //!< position of the ports of each node
+    std::vector<Port> m_ports;            //!< ports of all the nodes
+    std::vector<std::pair<std::size_t, std::size_t>> m_links; //!< positions of the link ports
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_FABRIC_HELPER_H */
@@ -0,0 +1,190 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Implement an object to create a k-ary fat-tree topology.
+
+#include "point-to-point-fat-tree.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointFatTreeHelper");
+
+namespace
+{
+
+/**
+ * \param k the number of ports of the switches
+ *
+ * \returns the number of ports of each node of the fat-tree
+ */
+std::vector<uint32_t>
+FatTreePorts(uint32_t k)
+{
+    if (k < 2 || k % 2 != 0 || k > 1024)
+    {
+        NS_FATAL_ERROR("The switches of a fat-tree need an even number of ports.");
+    }
+    uint32_t hosts = k * k * k / 4;
+    uint32_t switches = 5 * k * k / 4;
+    std::vector<uint32_t> ports(hosts + switches, k);
+    std::fill(ports.begin(), ports.begin() + hosts, 1);
+    return ports;
+}
+
+} // unnamed namespace
+
+PointToPointFatTreeHelper::PointToPointFatTreeHelper(uint32_t k, PointToPointHelper pointToPoint)
+    : PointToPointFabricHelper(FatTreePorts(k)),
+      m_k(k),
+      m_half(k / 2),
+      m_hosts(k * k * k / 4)
+{
+    for (uint32_t pod = 0; pod < m_k; ++pod)
+    {
+        for (uint32_t i = 0; i < m_half; ++i)
+        {
+            for (uint32_t h = 0; h < m_half; ++h)
+            {
+                Connect(pointToPoint, GetHost(pod, i, h), 0, GetEdge(pod, i), h);
+            }
+        }
+        for (uint32_t i = 0; i < m_half; ++i)
+        {
+            for (uint32_t j = 0; j < m_half; ++j)
+            {
+                Connect(pointToPoint, GetEdge(pod, i), m_half + j, GetAggregation(pod, j), i);
+            }
+        }
+        for (uint32_t j = 0; j < m_half; ++j)
+        {
+            for (uint32_t m = 0; m < m_half; ++m)
+            {
+                Connect(pointToPoint,
+                        GetAggregation(pod, j),
+                        m_half + m,
+                        GetCore(j * m_half + m),
+                        pod);
+            }
+        }
+    }
+}
+
+PointToPointFatTreeHelper::~PointToPointFatTreeHelper()
+{
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetNHosts() const
+{
+    return m_hosts;
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetHost(uint32_t pod, uint32_t edge, uint32_t i) const
+{
+    if (pod >= m_k || edge >= m_half || i >= m_half)
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointFatTreeHelper::GetHost.");
+    }
+    return (pod * m_half + edge) * m_half + i;
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetEdge(uint32_t pod, uint32_t i) const
+{
+    if (pod >= m_k || i >= m_half)
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointFatTreeHelper::GetEdge.");
+    }
+    return m_hosts + pod * m_half + i;
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetAggregation(uint32_t pod, uint32_t j) const
+{
+    if (pod >= m_k || j >= m_half)
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointFatTreeHelper::GetAggregation.");
+    }
+    return m_hosts + m_k * m_half + pod * m_half + j;
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetCore(uint32_t i) const
+{
+    if (i >= m_half * m_half)
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointFatTreeHelper::GetCore.");
+    }
+    return m_hosts + 2 * m_k * m_half + i;
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetLevel(uint32_t i) const
+{
+    if (i >= GetN())
+    {
+        NS_FATAL_ERROR("Index out of bounds in PointToPointFatTreeHelper::GetLevel.");
+    }
+    if (i < m_hosts)
+    {
+        return 0;
+    }
+    return 1 + (i - m_hosts) / (m_k * m_half);
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetPod(uint32_t i) const
+{
+    switch (GetLevel(i))
+    {
+    case 0:
+        return i / (m_half * m_half);
+    case 1:
+        return (i - m_hosts) / m_half;
+    case 2:
+        return (i - m_hosts - m_k * m_half) / m_half;
+    default:
+        NS_FATAL_ERROR("A core switch has no pod.");
+        return 0;
+    }
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetNextPort(uint32_t from, uint32_t to) const
+{
+    NS_ASSERT_MSG(from != to && to < m_hosts, "Invalid route");
+    uint32_t pod = to / (m_half * m_half);
+    uint32_t edge = (to / m_half) % m_half;
+    uint32_t i = to % m_half;
+    switch (GetLevel(from))
+    {
+    case 0:
+        return 0;
+    case 1:
+        return from == GetEdge(pod, edge) ? i : m_half + i;
+    case 2:
+        return GetPod(from) == pod ? edge : m_half + edge;
+    default:
+        return pod;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,128 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Define an object to create a k-ary fat-tree topology.
+
+#ifndef POINT_TO_POINT_FAT_TREE_HELPER_H
+#define POINT_TO_POINT_FAT_TREE_HELPER_H
+
+#include "point-to-point-fabric.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point-layout
+ *
+ * \brief A helper to make it easier to create a k-ary fat-tree
+ * topology with p2p links
+ *
+ * A k-ary fat-tree has k pods of k/2 edge and k/2 aggregation switches,
+ * (k/2)^2 core switches and k^3/4 hosts, k/2 per edge switch.  The
+ * hosts come first in the node indices, then the edge, aggregation and
+ * core switches.
+ *
+ * Port 0 of a host leads to its edge switch.  Ports 0 to k/2 - 1 of an
+ * edge switch lead to its hosts and ports k/2 + j to the aggregation
+ * switch j of its pod.  Ports 0 to k/2 - 1 of the aggregation switch j
+ * lead to the edge switches of its pod and ports k/2 + m to the core
+ * switch j * k/2 + m.  Port p of a core switch leads to pod p.
+ *
+ * GetNextPort() routes to hosts only, with the two-level scheme of
+ * Al-Fares et al.: going up, an edge switch picks the aggregation
+ * switch from the position of the destination host on its edge switch,
+ * and an aggregation switch picks the core switch from the position of
+ * the edge switch of the destination host in its pod.
+ */
+class PointToPointFatTreeHelper : public PointToPointFabricHelper
+{
+  public:
+    /**
+     * Create a PointToPointFatTreeHelper in order to easily create
+     * fat-tree topologies using p2p links
+     *
+     * \param k the number of ports of the switches, an even number
+     *
+     * \param pointToPoint the PointToPointHelper which is used
+     *                     to connect all of the nodes together
+     *                     in the fat-tree
+     */
+    PointToPointFatTreeHelper(uint32_t k, PointToPointHelper pointToPoint);
+
+    ~PointToPointFatTreeHelper() override;
+
+    /**
+     * \returns the number of hosts in the fat-tree
+     */
+    uint32_t GetNHosts() const;
+
+    /**
+     * \param pod the pod of the host
+     * \param edge the edge switch of the host in the pod
+     * \param i the position of the host on the edge switch
+     *
+     * \returns the index of the host
+     */
+    uint32_t GetHost(uint32_t pod, uint32_t edge, uint32_t i) const;
+
+    /**
+     * \param pod a pod
+     * \param i the position of the switch in the pod
+     *
+     * \returns the index of the edge switch
+     */
+    uint32_t GetEdge(uint32_t pod, uint32_t i) const;
+
+    /**
+     * \param pod a pod
+     * \param j the position of the switch in the pod
+     *
+     * \returns the index of the aggregation switch
+     */
+    uint32_t GetAggregation(uint32_t pod, uint32_t j) const;
+
+    /**
+     * \param i the position of the core switch
+     *
+     * \returns the index of the core switch
+     */
+    uint32_t GetCore(uint32_t i) const;
+
+    /**
+     * \param i the index of a node of the fat-tree
+     *
+     * \returns the level of the node: 0 for a host, 1 for an edge switch,
+     *          2 for an aggregation switch and 3 for a core switch
+     */
+    uint32_t GetLevel(uint32_t i) const;
+
+    /**
+     * \param i the index of a host, edge or aggregation switch
+     *
+     * \returns the pod of the node
+     */
+    uint32_t GetPod(uint32_t i) const;
+
+    uint32_t GetNextPort(uint32_t from, uint32_t to) const override;
+
+  private:
+    uint32_t m_k;     //!< number of ports of the switches
+    uint32_t m_half;  //!< k/2
+    uint32_t m_hosts; //!< number of hosts
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_FAT_TREE_HELPER_H */
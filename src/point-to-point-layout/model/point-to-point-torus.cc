@@ -0,0 +1,141 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Implement an object to create an n-dimensional torus topology.
+
+#include "point-to-point-torus.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointTorusHelper");
+
+namespace
+{
+
+/**
+ * \param dimensions the size of each dimension of the torus
+ *
+ * \returns the number of ports of each node of the torus
+ */
+std::vector<uint32_t>
+TorusPorts(const std::vector<uint32_t>& dimensions)
+{
+    uint64_t nNodes = 1;
+    for (uint32_t size : dimensions)
+    {
+        if (size < 1)
+        {
+            NS_FATAL_ERROR("Empty dimension in torus.");
+        }
+        nNodes *= size;
+    }
+    if (dimensions.empty() || nNodes < 2 || nNodes >= PointToPointFabricHelper::NO_NEIGHBOR)
+    {
+        NS_FATAL_ERROR("Need more nodes for torus.");
+    }
+    return std::vector<uint32_t>(nNodes, 2 * dimensions.size());
+}
+
+} // unnamed namespace
+
+PointToPointTorusHelper::PointToPointTorusHelper(std::vector<uint32_t> dimensions,
+                                                 PointToPointHelper pointToPoint)
+    : PointToPointFabricHelper(TorusPorts(dimensions)),
+      m_dimensions(std::move(dimensions))
+{
+    uint32_t stride = 1;
+    for (uint32_t size : m_dimensions)
+    {
+        m_strides.push_back(stride);
+        stride *= size;
+    }
+
+    for (uint32_t k = 0; k < m_dimensions.size(); ++k)
+    {
+        if (m_dimensions[k] < 2)
+        {
+            continue;
+        }
+        for (uint32_t i = 0; i < GetN(); ++i)
+        {
+            uint32_t c = GetCoordinate(i, k);
+            uint32_t next = c + 1 < m_dimensions[k] ? i + m_strides[k] : i - c * m_strides[k];
+            Connect(pointToPoint, i, 2 * k, next, 2 * k + 1);
+        }
+    }
+}
+
+PointToPointTorusHelper::~PointToPointTorusHelper()
+{
+}
+
+uint32_t
+PointToPointTorusHelper::GetIndex(const std::vector<uint32_t>& coordinates) const
+{
+    if (coordinates.size() != m_dimensions.size())
+    {
+        NS_FATAL_ERROR("Wrong number of coordinates in PointToPointTorusHelper::GetIndex.");
+    }
+    uint32_t i = 0;
+    for (uint32_t k = 0; k < m_dimensions.size(); ++k)
+    {
+        if (coordinates[k] >= m_dimensions[k])
+        {
+            NS_FATAL_ERROR("Index out of bounds in PointToPointTorusHelper::GetIndex.");
+        }
+        i += coordinates[k] * m_strides[k];
+    }
+    return i;
+}
+
+std::vector<uint32_t>
+PointToPointTorusHelper::GetCoordinates(uint32_t i) const
+{
+    std::vector<uint32_t> coordinates;
+    coordinates.reserve(m_dimensions.size());
+    for (uint32_t k = 0; k < m_dimensions.size(); ++k)
+    {
+        coordinates.push_back(GetCoordinate(i, k));
+    }
+    return coordinates;
+}
+
+uint32_t
+PointToPointTorusHelper::GetCoordinate(uint32_t i, uint32_t dimension) const
+{
+    return (i / m_strides.at(dimension)) % m_dimensions[dimension];
+}
+
+uint32_t
+PointToPointTorusHelper::GetNextPort(uint32_t from, uint32_t to) const
+{
+    NS_ASSERT_MSG(from < GetN() && to < GetN() && from != to, "Invalid route");
+    for (uint32_t k = 0; k < m_dimensions.size(); ++k)
+    {
+        uint32_t a = GetCoordinate(from, k);
+        uint32_t b = GetCoordinate(to, k);
+        if (a != b)
+        {
+            uint32_t forward = (b + m_dimensions[k] - a) % m_dimensions[k];
+            return forward <= m_dimensions[k] - forward ? 2 * k : 2 * k + 1;
+        }
+    }
+    return 0;
+}
+
+} // namespace ns3
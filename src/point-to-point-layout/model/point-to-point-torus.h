@@ -0,0 +1,91 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Define an object to create an n-dimensional torus topology.
+
+#ifndef POINT_TO_POINT_TORUS_HELPER_H
+#define POINT_TO_POINT_TORUS_HELPER_H
+
+#include "point-to-point-fabric.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point-layout
+ *
+ * \brief A helper to make it easier to create an n-dimensional torus
+ * topology with p2p links
+ *
+ * The node at coordinates (c0, c1, ...) has index c0 + d0 * (c1 +
+ * d1 * (...)), where d0, d1, ... are the sizes of the dimensions.  Port
+ * 2 * k of a node leads to the next node along dimension k, and port
+ * 2 * k + 1 to the previous one, with wraparound.  Every node links its
+ * port 2 * k to the port 2 * k + 1 of the next node, so a dimension of
+ * size 2 has two parallel links between its nodes, and a dimension of
+ * size 1 has no link.  GetNextPort() routes in dimension order, the
+ * shorter way around each ring.
+ */
+class PointToPointTorusHelper : public PointToPointFabricHelper
+{
+  public:
+    /**
+     * Create a PointToPointTorusHelper in order to easily create
+     * torus topologies using p2p links
+     *
+     * \param dimensions the size of each dimension of the torus
+     *
+     * \param pointToPoint the PointToPointHelper which is used
+     *                     to connect all of the nodes together
+     *                     in the torus
+     */
+    PointToPointTorusHelper(std::vector<uint32_t> dimensions, PointToPointHelper pointToPoint);
+
+    ~PointToPointTorusHelper() override;
+
+    /**
+     * \param coordinates the coordinates of a node, one per dimension
+     *
+     * \returns the index of the node
+     */
+    uint32_t GetIndex(const std::vector<uint32_t>& coordinates) const;
+
+    /**
+     * \param i the index of a node of the torus
+     *
+     * \returns the coordinates of the node, one per dimension
+     */
+    std::vector<uint32_t> GetCoordinates(uint32_t i) const;
+
+    /**
+     * \param i the index of a node of the torus
+     * \param dimension a dimension of the torus
+     *
+     * \returns the coordinate of the node along the dimension
+     */
+    uint32_t GetCoordinate(uint32_t i, uint32_t dimension) const;
+
+    uint32_t GetNextPort(uint32_t from, uint32_t to) const override;
+
+  private:
+    std::vector<uint32_t> m_dimensions; //!< size of each dimension
+    std::vector<uint32_t> m_strides;    //!< index distance between neighbors in each dimension
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_TORUS_HELPER_H */
@@ -0,0 +1,596 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/channel.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/ipv4.h"
+#include "ns3/point-to-point-dragonfly.h"
+#include "ns3/point-to-point-fat-tree.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-torus.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup point-to-point-layout-tests
+ * Point-to-point fabric helpers test suite.
+ */
+
+/**
+ * \ingroup point-to-point-layout
+ * \defgroup point-to-point-layout-tests Point-to-point layout tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup point-to-point-layout-tests
+ *
+ * \brief The checks shared by the tests of the fabric helpers.
+ */
+class FabricTestCase : public TestCase
+{
+  protected:
+    /**
+     * Constructor.
+     *
+     * \param name the name of the test
+     */
+    FabricTestCase(std::string name);
+
+    /**
+     * Get the port of the neighbor behind a port, checking that the
+     * devices of both ports are the ends of the same channel.
+     *
+     * \param fabric the fabric
+     * \param i the index of a node
+     * \param port a connected port of the node
+     * \returns the port of the neighbor leading back to the node
+     */
+    uint32_t GetReversePort(const PointToPointFabricHelper& fabric, uint32_t i, uint32_t port);
+
+    /**
+     * Check that the device of each connected port is linked to its
+     * neighbor, and that each node has as many devices as connected ports.
+     *
+     * \param fabric the fabric
+     */
+    void CheckPorts(const PointToPointFabricHelper& fabric);
+
+    /**
+     * Follow the routes of GetNextPort() from every node to every
+     * destination, and check that they reach it with the expected number
+     * of hops.
+     *
+     * \param fabric the fabric
+     * \param destinations the number of destinations, the first nodes
+     * \param hops the number of hops of the minimal route between two
+     *             nodes, or 0 if the test only checks that the route
+     *             reaches the destination
+     */
+    void CheckRoutes(const PointToPointFabricHelper& fabric,
+                     uint32_t destinations,
+                     std::function<uint32_t(uint32_t, uint32_t)> hops);
+};
+
+FabricTestCase::FabricTestCase(std::string name)
+    : TestCase(name)
+{
+}
+
+uint32_t
+FabricTestCase::GetReversePort(const PointToPointFabricHelper& fabric, uint32_t i, uint32_t port)
+{
+    Ptr<NetDevice> device = fabric.GetDevice(i, port);
+    uint32_t neighbor = fabric.GetNeighbor(i, port);
+    Ptr<Channel> channel = device->GetChannel();
+    Ptr<NetDevice> other = channel->GetDevice(channel->GetDevice(0) == device ? 1 : 0);
+    for (uint32_t reverse = 0; reverse < fabric.GetNPorts(neighbor); ++reverse)
+    {
+        if (fabric.GetDevice(neighbor, reverse) == other)
+        {
+            NS_TEST_EXPECT_MSG_EQ(fabric.GetNeighbor(neighbor, reverse),
+                                  i,
+                                  "Wrong neighbor behind port " << reverse << " of " << neighbor);
+            return reverse;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(true, false, "Port " << port << " of " << i << " not linked back");
+    return PointToPointFabricHelper::NO_NEIGHBOR;
+}
+
+void
+FabricTestCase::CheckPorts(const PointToPointFabricHelper& fabric)
+{
+    uint32_t connected = 0;
+    for (uint32_t i = 0; i < fabric.GetN(); ++i)
+    {
+        uint32_t devices = 0;
+        for (uint32_t port = 0; port < fabric.GetNPorts(i); ++port)
+        {
+            Ptr<NetDevice> device = fabric.GetDevice(i, port);
+            uint32_t neighbor = fabric.GetNeighbor(i, port);
+            NS_TEST_EXPECT_MSG_EQ((device == nullptr),
+                                  (neighbor == PointToPointFabricHelper::NO_NEIGHBOR),
+                                  "Port " << port << " of " << i << " half connected");
+            if (device)
+            {
+                NS_TEST_EXPECT_MSG_EQ(device->GetNode(),
+                                      fabric.GetNode(i),
+                                      "Device of port " << port << " on another node");
+                GetReversePort(fabric, i, port);
+                ++devices;
+            }
+        }
+        NS_TEST_EXPECT_MSG_EQ(fabric.GetNode(i)->GetNDevices(),
+                              devices,
+                              "Device of node " << i << " without port");
+        connected += devices;
+    }
+    NS_TEST_EXPECT_MSG_EQ(connected, 2 * fabric.GetNLinks(), "Wrong number of links");
+}
+
+void
+FabricTestCase::CheckRoutes(const PointToPointFabricHelper& fabric,
+                            uint32_t destinations,
+                            std::function<uint32_t(uint32_t, uint32_t)> hops)
+{
+    for (uint32_t from = 0; from < fabric.GetN(); ++from)
+    {
+        for (uint32_t to = 0; to < destinations; ++to)
+        {
+            if (from == to)
+            {
+                continue;
+            }
+            uint32_t node = from;
+            uint32_t count = 0;
+            while (node != to && count < fabric.GetN())
+            {
+                uint32_t port = fabric.GetNextPort(node, to);
+                NS_TEST_ASSERT_MSG_LT(port, fabric.GetNPorts(node), "Invalid port");
+                node = fabric.GetNeighbor(node, port);
+                NS_TEST_ASSERT_MSG_NE(node,
+                                      PointToPointFabricHelper::NO_NEIGHBOR,
+                                      "Route from " << from << " to " << to
+                                                    << " on an unconnected port");
+                ++count;
+            }
+            NS_TEST_ASSERT_MSG_EQ(node, to, "Route from " << from << " to " << to << " loops");
+            uint32_t expected = hops(from, to);
+            if (expected != 0)
+            {
+                NS_TEST_EXPECT_MSG_EQ(count,
+                                      expected,
+                                      "Route from " << from << " to " << to << " not minimal");
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup point-to-point-layout-tests
+ *
+ * \brief Check the port numbering and the routes of a fat-tree.
+ */
+class FatTreeTestCase : public FabricTestCase
+{
+  public:
+    FatTreeTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FatTreeTestCase::FatTreeTestCase()
+    : FabricTestCase("Check the ports and routes of a fat-tree")
+{
+}
+
+void
+FatTreeTestCase::DoRun()
+{
+    const uint32_t k = 4;
+    const uint32_t half = k / 2;
+    PointToPointFatTreeHelper fatTree(k, PointToPointHelper());
+    NS_TEST_ASSERT_MSG_EQ(fatTree.GetNHosts(), k * k * k / 4, "Wrong number of hosts");
+    NS_TEST_ASSERT_MSG_EQ(fatTree.GetN(), k * k * k / 4 + 5 * k * k / 4, "Wrong number of nodes");
+    CheckPorts(fatTree);
+
+    for (uint32_t pod = 0; pod < k; ++pod)
+    {
+        for (uint32_t i = 0; i < half; ++i)
+        {
+            uint32_t edge = fatTree.GetEdge(pod, i);
+            NS_TEST_EXPECT_MSG_EQ(fatTree.GetLevel(edge), 1, "Wrong level of edge switch");
+            NS_TEST_EXPECT_MSG_EQ(fatTree.GetPod(edge), pod, "Wrong pod of edge switch");
+            for (uint32_t h = 0; h < half; ++h)
+            {
+                uint32_t host = fatTree.GetHost(pod, i, h);
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetNeighbor(host, 0), edge, "Wrong host port");
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetNeighbor(edge, h), host, "Wrong edge port");
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetPod(host), pod, "Wrong pod of host");
+            }
+            for (uint32_t j = 0; j < half; ++j)
+            {
+                uint32_t aggregation = fatTree.GetAggregation(pod, j);
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetNeighbor(edge, half + j),
+                                      aggregation,
+                                      "Wrong uplink of edge switch");
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetNeighbor(aggregation, i),
+                                      edge,
+                                      "Wrong downlink of aggregation switch");
+            }
+        }
+        for (uint32_t j = 0; j < half; ++j)
+        {
+            uint32_t aggregation = fatTree.GetAggregation(pod, j);
+            NS_TEST_EXPECT_MSG_EQ(fatTree.GetLevel(aggregation), 2, "Wrong level");
+            for (uint32_t m = 0; m < half; ++m)
+            {
+                uint32_t core = fatTree.GetCore(j * half + m);
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetNeighbor(aggregation, half + m),
+                                      core,
+                                      "Wrong uplink of aggregation switch");
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetNeighbor(core, pod),
+                                      aggregation,
+                                      "Wrong port of core switch");
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetLevel(core), 3, "Wrong level of core switch");
+            }
+        }
+    }
+
+    // up to the lowest common level and back down
+    CheckRoutes(fatTree, fatTree.GetNHosts(), [&fatTree, half](uint32_t from, uint32_t to) {
+        if (from >= fatTree.GetNHosts())
+        {
+            return 0u;
+        }
+        if (fatTree.GetPod(from) != fatTree.GetPod(to))
+        {
+            return 6u;
+        }
+        return from / half == to / half ? 2u : 4u;
+    });
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup point-to-point-layout-tests
+ *
+ * \brief Check the port numbering and the routes of a dragonfly, with all
+ * its groups, or with fewer groups and unconnected global ports.
+ */
+class DragonflyTestCase : public FabricTestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param groups the number of groups, 0 for all
+     */
+    DragonflyTestCase(uint32_t groups);
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_groups; //!< number of groups
+};
+
+DragonflyTestCase::DragonflyTestCase(uint32_t groups)
+    : FabricTestCase("Check the ports and routes of a dragonfly of " +
+                     (groups ? std::to_string(groups) : std::string("all")) + " groups"),
+      m_groups(groups)
+{
+}
+
+void
+DragonflyTestCase::DoRun()
+{
+    const uint32_t p = 2;
+    const uint32_t a = 4;
+    const uint32_t h = 2;
+    PointToPointDragonflyHelper dragonfly(p, a, h, m_groups, PointToPointHelper());
+    uint32_t g = m_groups ? m_groups : a * h + 1;
+    NS_TEST_ASSERT_MSG_EQ(dragonfly.GetNGroups(), g, "Wrong number of groups");
+    NS_TEST_ASSERT_MSG_EQ(dragonfly.GetNHosts(), p * a * g, "Wrong number of hosts");
+    NS_TEST_ASSERT_MSG_EQ(dragonfly.GetNLinks(),
+                          p * a * g + a * (a - 1) / 2 * g + g * (g - 1) / 2,
+                          "Wrong number of links");
+    CheckPorts(dragonfly);
+
+    for (uint32_t group = 0; group < g; ++group)
+    {
+        for (uint32_t r = 0; r < a; ++r)
+        {
+            uint32_t router = dragonfly.GetRouter(group, r);
+            NS_TEST_EXPECT_MSG_EQ(dragonfly.GetGroup(router), group, "Wrong group of router");
+            NS_TEST_EXPECT_MSG_EQ(dragonfly.GetRouterInGroup(router), r, "Wrong router");
+            for (uint32_t i = 0; i < p; ++i)
+            {
+                uint32_t host = dragonfly.GetHost(group, r, i);
+                NS_TEST_EXPECT_MSG_EQ(dragonfly.GetNeighbor(router, i), host, "Wrong host port");
+                NS_TEST_EXPECT_MSG_EQ(dragonfly.GetNeighbor(host, 0), router, "Wrong router port");
+                NS_TEST_EXPECT_MSG_EQ(dragonfly.GetGroup(host), group, "Wrong group of host");
+                NS_TEST_EXPECT_MSG_EQ(dragonfly.GetRouterInGroup(host), r, "Wrong router of host");
+            }
+            // the other routers of the group, in order
+            for (uint32_t s = 0, port = p; s < a; ++s)
+            {
+                if (s != r)
+                {
+                    NS_TEST_EXPECT_MSG_EQ(dragonfly.GetNeighbor(router, port++),
+                                          dragonfly.GetRouter(group, s),
+                                          "Wrong local port");
+                }
+            }
+            // global port x of the group leads to group x, or x + 1 past the group
+            for (uint32_t j = 0; j < h; ++j)
+            {
+                uint32_t x = r * h + j;
+                uint32_t other = x < group ? x : x + 1;
+                uint32_t neighbor = dragonfly.GetNeighbor(router, p + a - 1 + j);
+                if (other >= g)
+                {
+                    NS_TEST_EXPECT_MSG_EQ(neighbor,
+                                          PointToPointFabricHelper::NO_NEIGHBOR,
+                                          "Global port past the last group connected");
+                    continue;
+                }
+                NS_TEST_EXPECT_MSG_EQ(dragonfly.GetGroup(neighbor), other, "Wrong global port");
+                NS_TEST_EXPECT_MSG_EQ(dragonfly.GetGatewayRouter(group, other),
+                                      r,
+                                      "Wrong gateway router");
+                NS_TEST_EXPECT_MSG_EQ(dragonfly.GetGlobalPort(group, other),
+                                      p + a - 1 + j,
+                                      "Wrong global port");
+                NS_TEST_EXPECT_MSG_EQ(dragonfly.GetRouterInGroup(neighbor),
+                                      dragonfly.GetGatewayRouter(other, group),
+                                      "Global link to the wrong gateway router");
+            }
+        }
+    }
+
+    // local, global and local links, each only when needed
+    CheckRoutes(dragonfly, dragonfly.GetNHosts(), [&dragonfly](uint32_t from, uint32_t to) {
+        if (from >= dragonfly.GetNHosts())
+        {
+            return 0u;
+        }
+        uint32_t group = dragonfly.GetGroup(from);
+        uint32_t router = dragonfly.GetRouterInGroup(from);
+        uint32_t target = dragonfly.GetGroup(to);
+        uint32_t targetRouter = dragonfly.GetRouterInGroup(to);
+        if (group == target)
+        {
+            return router == targetRouter ? 2u : 3u;
+        }
+        return 3u + (router != dragonfly.GetGatewayRouter(group, target)) +
+               (targetRouter != dragonfly.GetGatewayRouter(target, group));
+    });
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup point-to-point-layout-tests
+ *
+ * \brief Check the port numbering and the routes of a torus, including
+ * dimensions of size 2 and 1.
+ */
+class TorusTestCase : public FabricTestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param dimensions the size of each dimension of the torus
+     */
+    TorusTestCase(std::vector<uint32_t> dimensions);
+
+  private:
+    void DoRun() override;
+
+    std::vector<uint32_t> m_dimensions; //!< size of each dimension
+};
+
+TorusTestCase::TorusTestCase(std::vector<uint32_t> dimensions)
+    : FabricTestCase("Check the ports and routes of a torus"),
+      m_dimensions(std::move(dimensions))
+{
+}
+
+void
+TorusTestCase::DoRun()
+{
+    PointToPointTorusHelper torus(m_dimensions, PointToPointHelper());
+    uint32_t nodes = 1;
+    uint32_t links = 0;
+    for (uint32_t size : m_dimensions)
+    {
+        nodes *= size;
+    }
+    for (uint32_t size : m_dimensions)
+    {
+        links += size < 2 ? 0 : nodes;
+    }
+    NS_TEST_ASSERT_MSG_EQ(torus.GetN(), nodes, "Wrong number of nodes");
+    NS_TEST_ASSERT_MSG_EQ(torus.GetNLinks(), links, "Wrong number of links");
+    CheckPorts(torus);
+
+    for (uint32_t i = 0; i < torus.GetN(); ++i)
+    {
+        std::vector<uint32_t> coordinates = torus.GetCoordinates(i);
+        NS_TEST_EXPECT_MSG_EQ(torus.GetIndex(coordinates), i, "Wrong coordinates");
+        for (uint32_t k = 0; k < m_dimensions.size(); ++k)
+        {
+            uint32_t size = m_dimensions[k];
+            if (size < 2)
+            {
+                NS_TEST_EXPECT_MSG_EQ(torus.GetNeighbor(i, 2 * k),
+                                      PointToPointFabricHelper::NO_NEIGHBOR,
+                                      "Port of a dimension of size 1 connected");
+                NS_TEST_EXPECT_MSG_EQ(torus.GetNeighbor(i, 2 * k + 1),
+                                      PointToPointFabricHelper::NO_NEIGHBOR,
+                                      "Port of a dimension of size 1 connected");
+                continue;
+            }
+            // port 2k leads up dimension k and port 2k + 1 down
+            std::vector<uint32_t> next = coordinates;
+            next[k] = (coordinates[k] + 1) % size;
+            NS_TEST_EXPECT_MSG_EQ(torus.GetNeighbor(i, 2 * k),
+                                  torus.GetIndex(next),
+                                  "Wrong port up dimension " << k);
+            NS_TEST_EXPECT_MSG_EQ(GetReversePort(torus, i, 2 * k), 2 * k + 1, "Wrong port back");
+            std::vector<uint32_t> previous = coordinates;
+            previous[k] = (coordinates[k] + size - 1) % size;
+            NS_TEST_EXPECT_MSG_EQ(torus.GetNeighbor(i, 2 * k + 1),
+                                  torus.GetIndex(previous),
+                                  "Wrong port down dimension " << k);
+        }
+    }
+
+    // the shorter way around each ring
+    CheckRoutes(torus, torus.GetN(), [this, &torus](uint32_t from, uint32_t to) {
+        uint32_t hops = 0;
+        for (uint32_t k = 0; k < m_dimensions.size(); ++k)
+        {
+            uint32_t forward = (torus.GetCoordinate(to, k) + m_dimensions[k] -
+                                torus.GetCoordinate(from, k)) %
+                               m_dimensions[k];
+            hops += std::min(forward, m_dimensions[k] - forward);
+        }
+        return hops;
+    });
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup point-to-point-layout-tests
+ *
+ * \brief Check the addresses assigned to the ports of a fabric, and their
+ * reservation in the Ipv4AddressGenerator.
+ */
+class FabricAddressTestCase : public FabricTestCase
+{
+  public:
+    FabricAddressTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FabricAddressTestCase::FabricAddressTestCase()
+    : FabricTestCase("Check the Ipv4 addresses of a fabric")
+{
+}
+
+void
+FabricAddressTestCase::DoRun()
+{
+    Ipv4AddressGenerator::Reset();
+    PointToPointTorusHelper torus({3, 2}, PointToPointHelper());
+    torus.InstallStack(InternetStackHelper());
+    torus.AssignIpv4Addresses(Ipv4Address("10.1.0.0"), Ipv4Mask("255.255.0.0"));
+
+    Ipv4Mask linkMask("255.255.255.252");
+    std::vector<uint32_t> subnets;
+    for (uint32_t i = 0; i < torus.GetN(); ++i)
+    {
+        Ptr<Ipv4> ipv4 = torus.GetNode(i)->GetObject<Ipv4>();
+        for (uint32_t port = 0; port < torus.GetNPorts(i); ++port)
+        {
+            Ipv4Address address = torus.GetIpv4Address(i, port);
+            int32_t interface = ipv4->GetInterfaceForDevice(torus.GetDevice(i, port));
+            NS_TEST_ASSERT_MSG_GT(interface, 0, "No interface on port " << port << " of " << i);
+            NS_TEST_EXPECT_MSG_EQ(ipv4->GetAddress(interface, 0).GetLocal(),
+                                  address,
+                                  "Wrong address of port " << port << " of " << i);
+            NS_TEST_EXPECT_MSG_EQ(ipv4->IsUp(interface), true, "Interface down");
+            NS_TEST_EXPECT_MSG_EQ(address.CombineMask(Ipv4Mask("255.255.0.0")),
+                                  Ipv4Address("10.1.0.0"),
+                                  "Address " << address << " out of the range");
+            NS_TEST_EXPECT_MSG_EQ(Ipv4AddressGenerator::IsAddressAllocated(address),
+                                  true,
+                                  "Address " << address << " not reserved");
+
+            // both ends of a link share a /30, which no other link uses
+            uint32_t neighbor = torus.GetNeighbor(i, port);
+            Ipv4Address other =
+                torus.GetIpv4Address(neighbor, GetReversePort(torus, i, port));
+            NS_TEST_EXPECT_MSG_EQ(address.CombineMask(linkMask),
+                                  other.CombineMask(linkMask),
+                                  "Ends of a link on different subnets");
+            NS_TEST_EXPECT_MSG_NE(address, other, "Ends of a link with the same address");
+            subnets.push_back(address.CombineMask(linkMask).Get());
+        }
+    }
+    std::sort(subnets.begin(), subnets.end());
+    subnets.erase(std::unique(subnets.begin(), subnets.end()), subnets.end());
+    NS_TEST_EXPECT_MSG_EQ(subnets.size(),
+                          torus.GetNLinks(),
+                          "Subnets shared by several links");
+
+    // the whole range of the links is reserved, and nothing past it
+    Ipv4AddressGenerator::TestMode();
+    NS_TEST_EXPECT_MSG_EQ(Ipv4AddressGenerator::AddAllocated(Ipv4Address("10.1.0.0")),
+                          false,
+                          "Network address of the first link not reserved");
+    Ipv4Address last(Ipv4Address("10.1.0.0").Get() + 4 * torus.GetNLinks() - 1);
+    NS_TEST_EXPECT_MSG_EQ(Ipv4AddressGenerator::AddAllocated(last),
+                          false,
+                          "Broadcast address of the last link not reserved");
+    NS_TEST_EXPECT_MSG_EQ(Ipv4AddressGenerator::AddAllocated(Ipv4Address(last.Get() + 1)),
+                          true,
+                          "Address past the fabric reserved");
+
+    Ipv4AddressGenerator::Reset();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup point-to-point-layout-tests
+ *
+ * \brief Point-to-point fabric helpers test suite.
+ */
+class PointToPointLayoutTestSuite : public TestSuite
+{
+  public:
+    PointToPointLayoutTestSuite();
+};
+
+PointToPointLayoutTestSuite::PointToPointLayoutTestSuite()
+    : TestSuite("point-to-point-layout", UNIT)
+{
+    AddTestCase(new FatTreeTestCase(), TestCase::QUICK);
+    AddTestCase(new DragonflyTestCase(0), TestCase::QUICK);
+    AddTestCase(new DragonflyTestCase(5), TestCase::QUICK);
+    AddTestCase(new TorusTestCase({4, 3}), TestCase::QUICK);
+    AddTestCase(new TorusTestCase({2, 1, 3}), TestCase::QUICK);
+    AddTestCase(new TorusTestCase({2}), TestCase::QUICK);
+    AddTestCase(new FabricAddressTestCase(), TestCase::QUICK);
+}
+
+static PointToPointLayoutTestSuite g_pointToPointLayoutTestSuite; //!< Static variable for test
+                                                                   //!< initialization
@@ -0,0 +1,800 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "point-to-point-partition-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/uinteger.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "ns3/point-to-point-remote-channel.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <set>
+#include <utility>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointPartitionHelper");
+
+namespace
+{
+
+/** Weighted undirected graph, in compressed adjacency form. */
+struct Graph
+{
+    std::vector<uint64_t> vwgt;   //!< Vertex weights
+    std::vector<uint32_t> xadj;   //!< Adjacency of vertex v is [xadj[v], xadj[v + 1])
+    std::vector<uint32_t> adjncy; //!< Adjacent vertices
+    std::vector<double> adjwgt;   //!< Weights of the adjacent edges
+
+    /** \return the number of vertices */
+    uint32_t GetN() const
+    {
+        return vwgt.size();
+    }
+};
+
+/** An undirected weighted edge. */
+struct WeightedEdge
+{
+    uint32_t a; //!< First vertex
+    uint32_t b; //!< Second vertex
+    double w;   //!< Weight
+};
+
+/**
+ * Build a graph, merging parallel edges and dropping self loops.
+ * \param vwgt the vertex weights
+ * \param edges the edges
+ * \return the graph
+ */
+Graph
+MakeGraph(std::vector<uint64_t> vwgt, const std::vector<WeightedEdge>& edges)
+{
+    std::vector<WeightedEdge> arcs;
+    arcs.reserve(2 * edges.size());
+    for (const auto& e : edges)
+    {
+        if (e.a != e.b)
+        {
+            arcs.push_back(e);
+            arcs.push_back({e.b, e.a, e.w});
+        }
+    }
+    std::sort(arcs.begin(), arcs.end(), [](const WeightedEdge& x, const WeightedEdge& y) {
+        return x.a < y.a || (x.a == y.a && x.b < y.b);
+    });
+
+    Graph g;
+    g.vwgt = std::move(vwgt);
+    g.xadj.assign(g.GetN() + 1, 0);
+    const WeightedEdge* last = nullptr;
+    for (const auto& arc : arcs)
+    {
+        if (last && last->a == arc.a && last->b == arc.b)
+        {
+            g.adjwgt.back() += arc.w;
+        }
+        else
+        {
+            g.adjncy.push_back(arc.b);
+            g.adjwgt.push_back(arc.w);
+            ++g.xadj[arc.a + 1];
+        }
+        last = &arc;
+    }
+    std::partial_sum(g.xadj.begin(), g.xadj.end(), g.xadj.begin());
+    return g;
+}
+
+/**
+ * Linear congruential generator; the partition must not depend on the
+ * RngSeedManager state, so that every rank computes the same one.
+ */
+class Lcg
+{
+  public:
+    /** \param seed the initial state */
+    explicit Lcg(uint64_t seed)
+        : m_state(seed)
+    {
+    }
+
+    /**
+     * \param n the upper bound
+     * \return a number in [0, n)
+     */
+    uint32_t Next(uint32_t n)
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (m_state >> 33) % n;
+    }
+
+  private:
+    uint64_t m_state; //!< Generator state
+};
+
+/**
+ * Contract a heavy edge matching of a graph.
+ * \param g the graph
+ * \param maxVertexWeight the largest weight of a contracted vertex
+ * \param rng the generator of the visit order
+ * \param [out] cmap the coarse vertex of each vertex of \pname{g}
+ * \return the coarse graph
+ */
+Graph
+Coarsen(const Graph& g, uint64_t maxVertexWeight, Lcg& rng, std::vector<uint32_t>& cmap)
+{
+    const uint32_t unmatched = std::numeric_limits<uint32_t>::max();
+    uint32_t n = g.GetN();
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    for (uint32_t i = n; i > 1; --i)
+    {
+        std::swap(order[i - 1], order[rng.Next(i)]);
+    }
+
+    std::vector<uint32_t> match(n, unmatched);
+    for (uint32_t u : order)
+    {
+        if (match[u] != unmatched)
+        {
+            continue;
+        }
+        uint32_t best = u;
+        double bestWeight = 0;
+        for (uint32_t j = g.xadj[u]; j < g.xadj[u + 1]; ++j)
+        {
+            uint32_t v = g.adjncy[j];
+            if (match[v] == unmatched && g.adjwgt[j] > bestWeight &&
+                g.vwgt[u] + g.vwgt[v] <= maxVertexWeight)
+            {
+                best = v;
+                bestWeight = g.adjwgt[j];
+            }
+        }
+        match[u] = best;
+        match[best] = u;
+    }
+
+    cmap.assign(n, unmatched);
+    uint32_t nCoarse = 0;
+    for (uint32_t u = 0; u < n; ++u)
+    {
+        if (cmap[u] == unmatched)
+        {
+            cmap[u] = nCoarse;
+            cmap[match[u]] = nCoarse;
+            ++nCoarse;
+        }
+    }
+    std::vector<uint64_t> vwgt(nCoarse, 0);
+    std::vector<WeightedEdge> edges;
+    for (uint32_t u = 0; u < n; ++u)
+    {
+        vwgt[cmap[u]] += g.vwgt[u];
+        for (uint32_t j = g.xadj[u]; j < g.xadj[u + 1]; ++j)
+        {
+            if (u < g.adjncy[j])
+            {
+                edges.push_back({cmap[u], cmap[g.adjncy[j]], g.adjwgt[j]});
+            }
+        }
+    }
+    return MakeGraph(std::move(vwgt), edges);
+}
+
+/**
+ * Initial k-way partition by greedy graph growing: the first partition
+ * grows from a seed vertex, the next ones from the lowest unassigned
+ * vertex, always adding the frontier vertex most connected to them.
+ * \param g the graph
+ * \param k the number of partitions
+ * \param maxPart the largest partition weight
+ * \param seed the first vertex of the first partition
+ * \return the partition of each vertex
+ */
+std::vector<uint32_t>
+GrowPartition(const Graph& g, uint32_t k, uint64_t maxPart, uint32_t seed)
+{
+    uint32_t n = g.GetN();
+    std::vector<uint32_t> part(n, k);
+    uint64_t remaining = std::accumulate(g.vwgt.begin(), g.vwgt.end(), uint64_t(0));
+    uint32_t next = 0;
+    std::vector<double> conn(n);
+    for (uint32_t p = 0; p + 1 < k; ++p)
+    {
+        uint64_t target = remaining / (k - p);
+        uint64_t weight = 0;
+        std::fill(conn.begin(), conn.end(), 0);
+        std::set<std::pair<double, uint32_t>> frontier; // (-connection, vertex)
+        while (weight < target)
+        {
+            uint32_t v;
+            if (seed < n)
+            {
+                v = seed;
+                seed = n;
+            }
+            else if (frontier.empty())
+            {
+                while (next < n && part[next] != k)
+                {
+                    ++next;
+                }
+                if (next == n || (weight > 0 && weight + g.vwgt[next] > maxPart))
+                {
+                    break;
+                }
+                v = next;
+            }
+            else
+            {
+                v = frontier.begin()->second;
+                frontier.erase(frontier.begin());
+                if (weight + g.vwgt[v] > maxPart)
+                {
+                    continue;
+                }
+            }
+            part[v] = p;
+            weight += g.vwgt[v];
+            for (uint32_t j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+            {
+                uint32_t w = g.adjncy[j];
+                if (part[w] == k)
+                {
+                    frontier.erase({-conn[w], w});
+                    conn[w] += g.adjwgt[j];
+                    frontier.insert({-conn[w], w});
+                }
+            }
+        }
+        remaining -= weight;
+    }
+    for (auto& p : part)
+    {
+        p = std::min(p, k - 1);
+    }
+    return part;
+}
+
+/**
+ * \param g the graph
+ * \param k the number of partitions
+ * \param maxPart the largest partition weight
+ * \param part the partition of each vertex
+ * \return the weight above \pname{maxPart} of the heaviest partition, and
+ * the weight of the edges cut
+ */
+std::pair<uint64_t, double>
+Evaluate(const Graph& g, uint32_t k, uint64_t maxPart, const std::vector<uint32_t>& part)
+{
+    std::vector<uint64_t> pw(k, 0);
+    double cut = 0;
+    for (uint32_t u = 0; u < g.GetN(); ++u)
+    {
+        pw[part[u]] += g.vwgt[u];
+        for (uint32_t j = g.xadj[u]; j < g.xadj[u + 1]; ++j)
+        {
+            if (u < g.adjncy[j] && part[u] != part[g.adjncy[j]])
+            {
+                cut += g.adjwgt[j];
+            }
+        }
+    }
+    uint64_t heaviest = *std::max_element(pw.begin(), pw.end());
+    return {heaviest > maxPart ? heaviest - maxPart : 0, cut};
+}
+
+/**
+ * Greedy refinement: move boundary vertices to the neighbouring partition
+ * which most reduces the cut weight, or which improves the balance at
+ * equal cut, while respecting the partition weight limit.
+ * \param g the graph
+ * \param k the number of partitions
+ * \param maxPart the largest partition weight
+ * \param [in,out] part the partition of each vertex
+ */
+void
+Refine(const Graph& g, uint32_t k, uint64_t maxPart, std::vector<uint32_t>& part)
+{
+    const uint32_t maxPasses = 8;
+    std::vector<uint64_t> pw(k, 0);
+    for (uint32_t u = 0; u < g.GetN(); ++u)
+    {
+        pw[part[u]] += g.vwgt[u];
+    }
+    std::vector<double> conn(k, 0);
+    std::vector<uint32_t> touched;
+    for (uint32_t pass = 0; pass < maxPasses; ++pass)
+    {
+        bool moved = false;
+        for (uint32_t u = 0; u < g.GetN(); ++u)
+        {
+            uint32_t from = part[u];
+            if (pw[from] == g.vwgt[u])
+            {
+                continue; // keep every partition non empty
+            }
+            touched.clear();
+            for (uint32_t j = g.xadj[u]; j < g.xadj[u + 1]; ++j)
+            {
+                uint32_t q = part[g.adjncy[j]];
+                if (conn[q] == 0)
+                {
+                    touched.push_back(q);
+                }
+                conn[q] += g.adjwgt[j];
+            }
+            uint32_t to = from;
+            double bestGain = 0;
+            for (uint32_t q : touched)
+            {
+                if (q == from || pw[q] + g.vwgt[u] > maxPart)
+                {
+                    continue;
+                }
+                double gain = conn[q] - conn[from];
+                bool better;
+                if (to == from)
+                {
+                    better = gain > 0 || (gain == 0 && pw[q] + g.vwgt[u] < pw[from]) ||
+                             pw[from] > maxPart;
+                }
+                else
+                {
+                    better = gain > bestGain || (gain == bestGain && pw[q] < pw[to]);
+                }
+                if (better)
+                {
+                    to = q;
+                    bestGain = gain;
+                }
+            }
+            for (uint32_t q : touched)
+            {
+                conn[q] = 0;
+            }
+            if (to != from)
+            {
+                part[u] = to;
+                pw[from] -= g.vwgt[u];
+                pw[to] += g.vwgt[u];
+                moved = true;
+            }
+        }
+        if (!moved)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * Multilevel k-way partitioning.
+ * \param graph the graph
+ * \param k the number of partitions
+ * \param maxPart the largest partition weight
+ * \return the partition of each vertex
+ */
+std::vector<uint32_t>
+PartitionGraph(const Graph& graph, uint32_t k, uint64_t maxPart)
+{
+    // coarse vertices stay small enough to balance the initial partition
+    uint64_t total = std::accumulate(graph.vwgt.begin(), graph.vwgt.end(), uint64_t(0));
+    uint64_t maxVertexWeight = std::max(*std::max_element(graph.vwgt.begin(), graph.vwgt.end()),
+                                        total / (10 * k));
+    Lcg rng(0x9e3779b97f4a7c15ULL);
+    std::vector<Graph> levels{graph};
+    std::vector<std::vector<uint32_t>> cmaps;
+    while (levels.back().GetN() > 20 * k)
+    {
+        std::vector<uint32_t> cmap;
+        Graph coarse = Coarsen(levels.back(), maxVertexWeight, rng, cmap);
+        if (coarse.GetN() * 20 > levels.back().GetN() * 19)
+        {
+            break; // the matching no longer shrinks the graph
+        }
+        levels.push_back(std::move(coarse));
+        cmaps.push_back(std::move(cmap));
+    }
+
+    // the refinement only moves single vertices, and cannot undo a poor
+    // initial partition: keep the best of a few grown from different seeds
+    const Graph& coarsest = levels.back();
+    const uint32_t tries = std::min<uint32_t>(coarsest.GetN(), 8);
+    std::vector<uint32_t> part;
+    std::pair<uint64_t, double> best;
+    for (uint32_t i = 0; i < tries; ++i)
+    {
+        std::vector<uint32_t> candidate =
+            GrowPartition(coarsest, k, maxPart, uint64_t(i) * coarsest.GetN() / tries);
+        Refine(coarsest, k, maxPart, candidate);
+        std::pair<uint64_t, double> quality = Evaluate(coarsest, k, maxPart, candidate);
+        if (part.empty() || quality < best)
+        {
+            part = std::move(candidate);
+            best = quality;
+        }
+    }
+    for (std::size_t level = cmaps.size(); level-- > 0;)
+    {
+        std::vector<uint32_t> fine(cmaps[level].size());
+        for (std::size_t v = 0; v < fine.size(); ++v)
+        {
+            fine[v] = part[cmaps[level][v]];
+        }
+        part = std::move(fine);
+        Refine(levels[level], k, maxPart, part);
+    }
+    return part;
+}
+
+/**
+ * Union the endpoints of the edges faster than a threshold.
+ * \param nNodes the number of nodes
+ * \param edges the edges
+ * \param threshold the delay threshold
+ * \param [out] component the component of each node, numbered in order of
+ * their smallest node id
+ * \param [out] sizes the number of nodes of each component
+ */
+template <typename E>
+void
+Contract(uint32_t nNodes,
+         const std::vector<E>& edges,
+         Time threshold,
+         std::vector<uint32_t>& component,
+         std::vector<uint64_t>& sizes)
+{
+    std::vector<uint32_t> parent(nNodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t v) {
+        while (parent[v] != v)
+        {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+    for (const auto& e : edges)
+    {
+        if (e.delay < threshold)
+        {
+            uint32_t a = find(e.a);
+            uint32_t b = find(e.b);
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+    component.assign(nNodes, 0);
+    sizes.clear();
+    for (uint32_t v = 0; v < nNodes; ++v)
+    {
+        uint32_t root = find(v);
+        if (root == v)
+        {
+            component[v] = sizes.size();
+            sizes.push_back(0);
+        }
+        else
+        {
+            component[v] = component[root];
+        }
+        ++sizes[component[v]];
+    }
+}
+
+} // namespace
+
+PointToPointPartitionHelper::PointToPointPartitionHelper()
+    : m_imbalance(0.03),
+      m_lookahead(Time::Max())
+{
+}
+
+void
+PointToPointPartitionHelper::SetImbalance(double imbalance)
+{
+    NS_LOG_FUNCTION(this << imbalance);
+    NS_ABORT_MSG_IF(imbalance < 0, "The imbalance cannot be negative");
+    m_imbalance = imbalance;
+}
+
+void
+PointToPointPartitionHelper::AddTraffic(Ptr<Node> src, Ptr<Node> dst, double bytes)
+{
+    NS_LOG_FUNCTION(this << src << dst << bytes);
+    if (src != dst && bytes > 0)
+    {
+        m_traffic[{src->GetId(), dst->GetId()}] += bytes;
+    }
+}
+
+void
+PointToPointPartitionHelper::AddTrafficMatrix(const std::vector<std::vector<uint64_t>>& matrix,
+                                              const NodeContainer& ranks)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(matrix.size() > ranks.GetN(), "Fewer nodes than ranks in the matrix");
+    for (uint32_t i = 0; i < matrix.size(); ++i)
+    {
+        NS_ABORT_MSG_IF(matrix[i].size() > ranks.GetN(), "Fewer nodes than ranks in the matrix");
+        for (uint32_t j = 0; j < matrix[i].size(); ++j)
+        {
+            AddTraffic(ranks.Get(i), ranks.Get(j), matrix[i][j]);
+        }
+    }
+}
+
+void
+PointToPointPartitionHelper::BuildGraph()
+{
+    NS_LOG_FUNCTION(this);
+    m_edges.clear();
+    std::set<uint32_t> channels;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); ++i)
+    {
+        for (uint32_t j = 0; j < (*i)->GetNDevices(); ++j)
+        {
+            Ptr<Channel> channel = (*i)->GetDevice(j)->GetChannel();
+            if (!channel || !channels.insert(channel->GetId()).second)
+            {
+                continue;
+            }
+            // only point-to-point links can separate partitions
+            Time delay;
+            if (DynamicCast<PointToPointChannel>(channel) && channel->GetNDevices() == 2)
+            {
+                TimeValue value;
+                channel->GetAttribute("Delay", value);
+                delay = value.Get();
+            }
+            uint32_t first = channel->GetDevice(0)->GetNode()->GetId();
+            for (std::size_t k = 1; k < channel->GetNDevices(); ++k)
+            {
+                m_edges.push_back({first, channel->GetDevice(k)->GetNode()->GetId(), delay, 0});
+            }
+        }
+    }
+}
+
+void
+PointToPointPartitionHelper::RouteTraffic()
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t nNodes = NodeList::GetNNodes();
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> adjacency(nNodes);
+    for (uint32_t e = 0; e < m_edges.size(); ++e)
+    {
+        adjacency[m_edges[e].a].emplace_back(m_edges[e].b, e);
+        adjacency[m_edges[e].b].emplace_back(m_edges[e].a, e);
+    }
+
+    // one breadth first search per source; m_traffic is sorted by source
+    const uint32_t unreached = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> parentEdge(nNodes);
+    for (auto i = m_traffic.begin(); i != m_traffic.end();)
+    {
+        uint32_t src = i->first.first;
+        NS_ABORT_MSG_IF(src >= nNodes, "Traffic from a node which is not in NodeList");
+        std::fill(parentEdge.begin(), parentEdge.end(), unreached);
+        std::queue<uint32_t> queue;
+        queue.push(src);
+        while (!queue.empty())
+        {
+            uint32_t u = queue.front();
+            queue.pop();
+            for (const auto& [v, e] : adjacency[u])
+            {
+                if (v != src && parentEdge[v] == unreached)
+                {
+                    parentEdge[v] = e;
+                    queue.push(v);
+                }
+            }
+        }
+        for (; i != m_traffic.end() && i->first.first == src; ++i)
+        {
+            uint32_t v = i->first.second;
+            NS_ABORT_MSG_IF(v >= nNodes, "Traffic to a node which is not in NodeList");
+            if (parentEdge[v] == unreached)
+            {
+                NS_LOG_WARN("No path from node " << src << " to node " << v);
+                continue;
+            }
+            while (v != src)
+            {
+                Edge& edge = m_edges[parentEdge[v]];
+                edge.traffic += i->second;
+                v = edge.a == v ? edge.b : edge.a;
+            }
+        }
+    }
+}
+
+std::vector<uint32_t>
+PointToPointPartitionHelper::Partition(uint32_t n)
+{
+    NS_LOG_FUNCTION(this << n);
+    uint32_t nNodes = NodeList::GetNNodes();
+    NS_ABORT_MSG_IF(n == 0, "At least one partition is needed");
+    NS_ABORT_MSG_IF(nNodes < n, "Cannot split " << nNodes << " nodes in " << n << " partitions");
+    BuildGraph();
+    RouteTraffic();
+
+    // Find the largest delay threshold such that the channels faster than
+    // it can be kept inside partitions, at the requested balance.
+    uint64_t maxPart = std::ceil((1 + m_imbalance) * nNodes / n);
+    std::vector<Time> thresholds;
+    for (const auto& e : m_edges)
+    {
+        if (e.delay.IsStrictlyPositive())
+        {
+            thresholds.push_back(e.delay);
+        }
+    }
+    std::sort(thresholds.begin(), thresholds.end(), std::greater<>());
+    thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+    thresholds.push_back(TimeStep(1));
+
+    std::vector<uint32_t> component;
+    std::vector<uint64_t> sizes;
+    for (const auto& threshold : thresholds)
+    {
+        Contract(nNodes, m_edges, threshold, component, sizes);
+        if (sizes.size() >= n && *std::max_element(sizes.begin(), sizes.end()) <= maxPart)
+        {
+            NS_LOG_INFO("Keeping the channels faster than " << threshold.As(Time::US)
+                                                             << " inside partitions");
+            break;
+        }
+    }
+    NS_ABORT_MSG_IF(sizes.size() < n,
+                    "Only " << sizes.size() << " groups of nodes can be separated by "
+                            << "point-to-point channels with a positive delay");
+    maxPart = std::max(maxPart, *std::max_element(sizes.begin(), sizes.end()));
+
+    // Partition the graph of the components, in which the weight of a channel
+    // is one plus its traffic relative to the mean traffic of the channels.
+    double traffic = 0;
+    uint32_t loaded = 0;
+    for (const auto& e : m_edges)
+    {
+        traffic += e.traffic;
+        loaded += e.traffic > 0;
+    }
+    double scale = loaded > 0 ? loaded / traffic : 0;
+    std::vector<WeightedEdge> edges;
+    for (const auto& e : m_edges)
+    {
+        edges.push_back({component[e.a], component[e.b], 1 + e.traffic * scale});
+    }
+    std::vector<uint32_t> part = PartitionGraph(MakeGraph(sizes, edges), n, maxPart);
+
+    // Number the partitions in order of their smallest node id.
+    std::vector<uint32_t> number(n, n);
+    uint32_t next = 0;
+    std::vector<uint32_t> assignment(nNodes);
+    for (uint32_t v = 0; v < nNodes; ++v)
+    {
+        uint32_t& p = number[part[component[v]]];
+        if (p == n)
+        {
+            p = next++;
+        }
+        assignment[v] = p;
+    }
+
+    m_lookahead = Time::Max();
+    for (const auto& e : m_edges)
+    {
+        if (assignment[e.a] != assignment[e.b])
+        {
+            m_lookahead = std::min(m_lookahead, e.delay);
+        }
+    }
+    NS_LOG_INFO("Lookahead " << m_lookahead.As(Time::US) << " with " << next << " partitions");
+    return assignment;
+}
+
+void
+PointToPointPartitionHelper::Install(uint32_t n)
+{
+    NS_LOG_FUNCTION(this << n);
+    std::vector<uint32_t> assignment = Partition(n);
+    for (uint32_t i = 0; i < assignment.size(); ++i)
+    {
+        NodeList::GetNode(i)->SetAttribute("SystemId", UintegerValue(assignment[i]));
+    }
+
+#ifdef NS3_MPI
+    // Apply the channel type rule of PointToPointHelper::Install to the new
+    // assignment.
+    if (!MpiInterface::IsEnabled())
+    {
+        return;
+    }
+    uint32_t currSystemId = MpiInterface::GetSystemId();
+    std::set<uint32_t> channels;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); ++i)
+    {
+        for (uint32_t j = 0; j < (*i)->GetNDevices(); ++j)
+        {
+            auto channel = DynamicCast<PointToPointChannel>((*i)->GetDevice(j)->GetChannel());
+            if (!channel || channel->GetNDevices() != 2 ||
+                !channels.insert(channel->GetId()).second)
+            {
+                continue;
+            }
+            Ptr<PointToPointNetDevice> devA = channel->GetPointToPointDevice(0);
+            Ptr<PointToPointNetDevice> devB = channel->GetPointToPointDevice(1);
+            bool remote = devA->GetNode()->GetSystemId() != currSystemId ||
+                          devB->GetNode()->GetSystemId() != currSystemId;
+            if (remote == bool(DynamicCast<PointToPointRemoteChannel>(channel)))
+            {
+                continue;
+            }
+            Ptr<PointToPointChannel> replacement;
+            if (remote)
+            {
+                replacement = CreateObject<PointToPointRemoteChannel>();
+                for (const auto& dev : {devA, devB})
+                {
+                    if (!dev->GetObject<MpiReceiver>())
+                    {
+                        Ptr<MpiReceiver> mpiRec = CreateObject<MpiReceiver>();
+                        mpiRec->SetReceiveCallback(
+                            MakeCallback(&PointToPointNetDevice::Receive, dev));
+                        dev->AggregateObject(mpiRec);
+                    }
+                }
+            }
+            else
+            {
+                replacement = CreateObject<PointToPointChannel>();
+            }
+            TimeValue delay;
+            channel->GetAttribute("Delay", delay);
+            replacement->SetAttribute("Delay", delay);
+            devA->Attach(replacement);
+            devB->Attach(replacement);
+        }
+    }
+#endif
+}
+
+Time
+PointToPointPartitionHelper::GetLookahead() const
+{
+    return m_lookahead;
+}
+
+} // namespace ns3
@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef POINT_TO_POINT_PARTITION_HELPER_H
+#define POINT_TO_POINT_PARTITION_HELPER_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Assign the nodes of a point-to-point topology to the partitions
+ * of a distributed simulation.
+ *
+ * The nodes of NodeList form a graph whose edges are their channels.
+ * The helper looks for the assignment of nodes to a given number of
+ * partitions such that:
+ *
+ * - every partition holds at most (1 + imbalance) times the average
+ *   number of nodes;
+ * - the smallest delay of the point-to-point channels crossing
+ *   partitions, which is the lookahead of the conservative
+ *   synchronization, is as large as possible: channels faster than the
+ *   chosen delay threshold are never cut, and neither are channels
+ *   which are not point-to-point;
+ * - among those, the weight of the cut channels is small.  Each channel
+ *   weighs one, plus the expected traffic routed on it along shortest
+ *   paths, when traffic is given with AddTraffic or AddTrafficMatrix.
+ *
+ * The cut is computed with a multilevel k-way scheme: the graph is
+ * coarsened by heavy edge matching, partitioned by greedy graph
+ * growing and the partition is refined by moving boundary nodes while
+ * projecting it back.  The result only depends on the topology, so
+ * every MPI rank computes the same assignment.
+ *
+ * Install must be called after the topology is built and before
+ * routing is populated and applications are installed.
+ */
+class PointToPointPartitionHelper
+{
+  public:
+    /** Create a helper with a 3% allowed imbalance and no traffic. */
+    PointToPointPartitionHelper();
+
+    /**
+     * \param imbalance the allowed imbalance, as a fraction of the
+     * average number of nodes per partition
+     */
+    void SetImbalance(double imbalance);
+
+    /**
+     * Add expected traffic between two nodes.
+     *
+     * \param src the sending node
+     * \param dst the receiving node
+     * \param bytes the number of bytes sent
+     */
+    void AddTraffic(Ptr<Node> src, Ptr<Node> dst, double bytes);
+
+    /**
+     * Add the expected traffic of a communication matrix, such as the one
+     * returned by ns3::parse_traffic_matrix for a DUMPI trace.
+     *
+     * \param matrix matrix[i][j] is the number of bytes sent by rank i to rank j
+     * \param ranks the node hosting each rank
+     */
+    void AddTrafficMatrix(const std::vector<std::vector<uint64_t>>& matrix,
+                          const NodeContainer& ranks);
+
+    /**
+     * Compute an assignment without applying it.
+     *
+     * \param n the number of partitions
+     * \return the partition of each node of NodeList, indexed by node id
+     */
+    std::vector<uint32_t> Partition(uint32_t n);
+
+    /**
+     * Compute an assignment and set the SystemId attribute of every node
+     * of NodeList accordingly.  When MPI is enabled, the channels whose
+     * endpoints now belong to different ranks are replaced by
+     * PointToPointRemoteChannel, and conversely.
+     *
+     * \param n the number of partitions
+     */
+    void Install(uint32_t n);
+
+    /**
+     * \return the smallest delay of the channels cut by the last
+     * computed assignment, or Time::Max if no channel is cut
+     */
+    Time GetLookahead() const;
+
+  private:
+    /** A channel of the topology graph. */
+    struct Edge
+    {
+        uint32_t a;     //!< Id of the first node
+        uint32_t b;     //!< Id of the second node
+        Time delay;     //!< Channel delay, zero when it cannot be cut
+        double traffic; //!< Expected traffic routed on the channel
+    };
+
+    /** Build m_edges from the channels of the nodes of NodeList. */
+    void BuildGraph();
+    /** Route the expected traffic on the edges, along shortest paths. */
+    void RouteTraffic();
+
+    double m_imbalance; //!< Allowed imbalance
+    /** Expected traffic in bytes, indexed by (source, destination) node ids */
+    std::map<std::pair<uint32_t, uint32_t>, double> m_traffic;
+    std::vector<Edge> m_edges; //!< The edges of the last computed graph
+    Time m_lookahead;          //!< Lookahead of the last computed assignment
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_PARTITION_HELPER_H */
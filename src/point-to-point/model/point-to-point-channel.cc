@@ -19,7 +19,9 @@
 
 #include "point-to-point-net-device.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
+#include "ns3/packet-burst.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
@@ -44,6 +46,14 @@ PointToPointChannel::GetTypeId()
                           TimeValue(Seconds(0)),
                           MakeTimeAccessor(&PointToPointChannel::m_delay),
                           MakeTimeChecker())
+            .AddAttribute("TransferOwnership",
+                          "Deliver the transmitted packets themselves to the receiving device, "
+                          "rather than copies, when the transmitting device does not trace "
+                          "their transmission end. The transmitted packets must not be used "
+                          "by anything else once sent.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PointToPointChannel::m_transferOwnership),
+                          MakeBooleanChecker())
             .AddTraceSource("TxRxPointToPoint",
                             "Trace source indicating transmission of packet "
                             "from the PointToPointChannel, used by the Animation "
@@ -59,6 +69,7 @@ PointToPointChannel::GetTypeId()
 PointToPointChannel::PointToPointChannel()
     : Channel(),
       m_delay(Seconds(0.)),
+      m_transferOwnership(false),
       m_nDevices(0)
 {
     NS_LOG_FUNCTION_NOARGS();
@@ -96,17 +107,59 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+    // The receiver strips the headers of the packet: copy it, unless the
+    // sender hands it over
+    Ptr<Packet> packet = m_transferOwnership && !src->KeepsTransmittedPacket()
+                             ? ConstCast<Packet>(p)
+                             : p->Copy();
     Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
                                    txTime + m_delay,
                                    &PointToPointNetDevice::Receive,
                                    m_link[wire].m_dst,
-                                   p->Copy());
+                                   packet);
 
     // Call the tx anim callback on the net device
     m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
     return true;
 }
 
+bool
+PointToPointChannel::TransmitBurst(Ptr<const PacketBurst> burst,
+                                   Ptr<PointToPointNetDevice> src,
+                                   const std::vector<Time>& txStart,
+                                   const std::vector<Time>& txTime)
+{
+    NS_LOG_FUNCTION(this << burst << src);
+
+    NS_ASSERT(m_link[0].m_state != INITIALIZING);
+    NS_ASSERT(m_link[1].m_state != INITIALIZING);
+    NS_ASSERT(txStart.size() == burst->GetNPackets() && txTime.size() == burst->GetNPackets());
+
+    uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+
+    // The packets have already been transmitted: the last bit of each one
+    // arrives after its own transmission, even if the train is received
+    // at once
+    Ptr<PacketBurst> packets = Create<PacketBurst>();
+    bool transfer = m_transferOwnership && !src->KeepsTransmittedPacket();
+    std::size_t i = 0;
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++i)
+    {
+        packets->AddPacket(transfer ? *it : (*it)->Copy());
+        m_txrxPointToPoint(*it,
+                           src,
+                           m_link[wire].m_dst,
+                           txTime[i],
+                           txStart[i] + txTime[i] + m_delay);
+    }
+    Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
+                                   m_delay,
+                                   &PointToPointNetDevice::ReceiveBurst,
+                                   m_link[wire].m_dst,
+                                   packets);
+    return true;
+}
+
 std::size_t
 PointToPointChannel::GetNDevices() const
 {
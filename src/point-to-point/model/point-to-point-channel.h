@@ -25,12 +25,14 @@
 #include "ns3/traced-callback.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3
 {
 
 class PointToPointNetDevice;
 class Packet;
+class PacketBurst;
 
 /**
  * \ingroup point-to-point
@@ -45,6 +47,14 @@ class Packet;
  * [0] wire to transmit on.  The second device gets the [1] wire.  There is a
  * state (IDLE, TRANSMITTING) associated with each wire.
  *
+ * The receiving device strips the headers of the packets it receives, so
+ * the channel delivers a copy of each transmitted packet.  When the
+ * TransferOwnership attribute is set, the channel delivers the packet
+ * itself instead, unless the transmitting device still reads it after the
+ * transmission, to trace its end.  This is only correct if nothing above
+ * the transmitting device keeps the packets it sends, which is the case of
+ * the Internet stack and of the usual applications.
+ *
  * \see Attach
  * \see TransmitStart
  */
@@ -81,6 +91,20 @@ class PointToPointChannel : public Channel
      */
     virtual bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+    /**
+     * \brief Transmit a train of packets over this channel, once the last
+     * one has been transmitted
+     * \param burst Packets to transmit
+     * \param src Source PointToPointNetDevice
+     * \param txStart Transmit start time of each packet, relative to now
+     * \param txTime Transmit time of each packet
+     * \returns true if successful (currently always true)
+     */
+    virtual bool TransmitBurst(Ptr<const PacketBurst> burst,
+                               Ptr<PointToPointNetDevice> src,
+                               const std::vector<Time>& txStart,
+                               const std::vector<Time>& txTime);
+
     /**
      * \brief Get number of devices on this channel
      * \returns number of devices on this channel
@@ -151,8 +175,9 @@ class PointToPointChannel : public Channel
     /** Each point to point link has exactly two net devices. */
     static const std::size_t N_DEVICES = 2;
 
-    Time m_delay;           //!< Propagation delay
-    std::size_t m_nDevices; //!< Devices of this channel
+    Time m_delay;             //!< Propagation delay
+    bool m_transferOwnership; //!< Deliver the transmitted packets rather than copies
+    std::size_t m_nDevices;   //!< Devices of this channel
 
     /**
      * The trace source for the packet transmission animation events that the
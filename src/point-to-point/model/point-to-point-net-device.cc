@@ -30,6 +30,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <limits>
+
 namespace ns3
 {
 
@@ -71,6 +73,18 @@ PointToPointNetDevice::GetTypeId()
                           TimeValue(Seconds(0.0)),
                           MakeTimeAccessor(&PointToPointNetDevice::m_tInterframeGap),
                           MakeTimeChecker())
+            .AddAttribute("MaxBurstPackets",
+                          "The largest number of packets of a flow queued back to back "
+                          "transmitted as a single train, 1 to transmit every packet alone",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&PointToPointNetDevice::m_maxBurstPackets),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("BurstQueueThreshold",
+                          "The number of packets in the transmit queue above which the "
+                          "train of packets being transmitted is split",
+                          UintegerValue(std::numeric_limits<uint32_t>::max()),
+                          MakeUintegerAccessor(&PointToPointNetDevice::m_burstQueueThreshold),
+                          MakeUintegerChecker<uint32_t>())
 
             //
             // Transmit queueing discipline for the device which includes its own set
@@ -137,6 +151,12 @@ PointToPointNetDevice::GetTypeId()
                             "dropped by the device during transmission",
                             MakeTraceSourceAccessor(&PointToPointNetDevice::m_phyTxDropTrace),
                             "ns3::Packet::TracedCallback")
+            .AddTraceSource("TxBurst",
+                            "Trace source indicating a train of packets has been "
+                            "completely transmitted over the channel, with the "
+                            "largest and the mean delay of their reception",
+                            MakeTraceSourceAccessor(&PointToPointNetDevice::m_txBurstTrace),
+                            "ns3::PointToPointNetDevice::TxBurstTracedCallback")
 #if 0
     // Not currently implemented for this device
     .AddTraceSource ("PhyRxBegin",
@@ -178,7 +198,9 @@ PointToPointNetDevice::PointToPointNetDevice()
     : m_txMachineState(READY),
       m_channel(nullptr),
       m_linkUp(false),
-      m_currentPkt(nullptr)
+      m_currentPkt(nullptr),
+      m_trainFlow(0),
+      m_trainSplit(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -215,6 +237,8 @@ PointToPointNetDevice::DoDispose()
     m_channel = nullptr;
     m_receiveErrorModel = nullptr;
     m_currentPkt = nullptr;
+    m_train.clear();
+    m_pending.clear();
     m_queue = nullptr;
     NetDevice::DoDispose();
 }
@@ -245,6 +269,11 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     // schedule an event that will be executed when the transmission is complete.
     //
     NS_ASSERT_MSG(m_txMachineState == READY, "Must be READY to transmit");
+    if (m_maxBurstPackets > 1 && !m_trainSplit && FormTrain(p))
+    {
+        TransmitTrain();
+        return true;
+    }
     m_txMachineState = BUSY;
     m_currentPkt = p;
     m_phyTxBeginTrace(m_currentPkt);
@@ -277,15 +306,35 @@ PointToPointNetDevice::TransmitComplete()
     NS_ASSERT_MSG(m_txMachineState == BUSY, "Must be BUSY if transmitting");
     m_txMachineState = READY;
 
-    NS_ASSERT_MSG(m_currentPkt, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
+    if (!m_train.empty())
+    {
+        CompleteTrain();
+    }
+    else
+    {
+        NS_ASSERT_MSG(m_currentPkt,
+                      "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
 
-    m_phyTxEndTrace(m_currentPkt);
-    m_currentPkt = nullptr;
+        m_phyTxEndTrace(m_currentPkt);
+        m_currentPkt = nullptr;
+    }
+
+    //
+    // The packets left from a split train were already dequeued, and go first.
+    //
+    if (!m_pending.empty())
+    {
+        Ptr<Packet> p = m_pending.front();
+        m_pending.pop_front();
+        TransmitStart(p);
+        return;
+    }
 
     Ptr<Packet> p = m_queue->Dequeue();
     if (!p)
     {
         NS_LOG_LOGIC("No pending packets in device queue after tx complete");
+        m_trainSplit = false;
         return;
     }
 
@@ -297,6 +346,186 @@ PointToPointNetDevice::TransmitComplete()
     TransmitStart(p);
 }
 
+bool
+PointToPointNetDevice::FormTrain(Ptr<Packet> p)
+{
+    NS_LOG_FUNCTION(this << p);
+
+    if (m_queue->GetNPackets() > m_burstQueueThreshold)
+    {
+        return false;
+    }
+    uint64_t flow = GetFlowKey(p);
+    m_train.push_back(p);
+    for (Ptr<const Packet> next = m_queue->Peek();
+         next && m_train.size() < m_maxBurstPackets && GetFlowKey(next) == flow;
+         next = m_queue->Peek())
+    {
+        Ptr<Packet> packet = m_queue->Dequeue();
+        m_snifferTrace(packet);
+        m_promiscSnifferTrace(packet);
+        m_train.push_back(packet);
+    }
+    if (m_train.size() == 1)
+    {
+        m_train.clear();
+        return false;
+    }
+    m_trainFlow = flow;
+    return true;
+}
+
+void
+PointToPointNetDevice::TransmitTrain()
+{
+    NS_LOG_FUNCTION(this << m_train.size());
+
+    //
+    // The whole train is transmitted back to back, and a single event is
+    // scheduled at the end of the transmission of its last packet.
+    //
+    m_txMachineState = BUSY;
+    m_trainStart = Simulator::Now();
+    Time txCompleteTime;
+    for (const auto& p : m_train)
+    {
+        m_phyTxBeginTrace(p);
+        txCompleteTime += m_bps.CalculateBytesTxTime(p->GetSize()) + m_tInterframeGap;
+    }
+
+    NS_LOG_LOGIC("Schedule TransmitCompleteEvent of a train of "
+                 << m_train.size() << " packets in " << txCompleteTime.As(Time::S));
+    m_txCompleteEvent =
+        Simulator::Schedule(txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+}
+
+void
+PointToPointNetDevice::CompleteTrain()
+{
+    NS_LOG_FUNCTION(this << m_train.size());
+
+    //
+    // Every packet is received when the last one is, rather than when its
+    // own last bit arrives.
+    //
+    Time now = Simulator::Now();
+    Time lastBit = m_trainStart;
+    Time maxError;
+    Time totalError;
+    Ptr<PacketBurst> burst = Create<PacketBurst>();
+    std::vector<Time> txStart;
+    std::vector<Time> txTime;
+    for (const auto& p : m_train)
+    {
+        txStart.push_back(lastBit - now);
+        txTime.push_back(m_bps.CalculateBytesTxTime(p->GetSize()));
+        lastBit += txTime.back();
+        Time error = now - lastBit;
+        maxError = Max(maxError, error);
+        totalError += error;
+        lastBit += m_tInterframeGap;
+        m_phyTxEndTrace(p);
+        burst->AddPacket(p);
+    }
+    Time meanError = totalError / static_cast<int64_t>(m_train.size());
+    m_train.clear();
+
+    m_txBurstTrace(burst, maxError, meanError);
+    if (!m_channel->TransmitBurst(burst, this, txStart, txTime))
+    {
+        for (auto it = burst->Begin(); it != burst->End(); ++it)
+        {
+            m_phyTxDropTrace(*it);
+        }
+    }
+}
+
+void
+PointToPointNetDevice::SplitTrain()
+{
+    NS_LOG_FUNCTION(this);
+
+    //
+    // Keep the packets whose transmission has started, the first one at
+    // least, and end the train after the last of them.
+    //
+    m_trainSplit = true;
+    Time now = Simulator::Now();
+    Time end = m_trainStart + m_bps.CalculateBytesTxTime(m_train.front()->GetSize()) +
+               m_tInterframeGap;
+    std::size_t kept = 1;
+    while (kept < m_train.size() && end < now)
+    {
+        end += m_bps.CalculateBytesTxTime(m_train[kept]->GetSize()) + m_tInterframeGap;
+        ++kept;
+    }
+    if (kept == m_train.size())
+    {
+        return;
+    }
+
+    NS_LOG_LOGIC("Split a train of " << m_train.size() << " packets after " << kept);
+    m_pending.insert(m_pending.begin(), m_train.begin() + kept, m_train.end());
+    m_train.resize(kept);
+    m_txCompleteEvent.Cancel();
+    m_txCompleteEvent =
+        Simulator::Schedule(end - now, &PointToPointNetDevice::TransmitComplete, this);
+}
+
+uint64_t
+PointToPointNetDevice::GetFlowKey(Ptr<const Packet> p)
+{
+    //
+    // The PPP header, the largest IPv4 header or the IPv6 header, and the
+    // ports.
+    //
+    uint8_t buffer[2 + 60 + 4];
+    uint32_t size = p->CopyData(buffer, sizeof(buffer));
+    if (size < 2)
+    {
+        return 0;
+    }
+    uint16_t protocol = (buffer[0] << 8) | buffer[1];
+    const uint8_t* ip = buffer + 2;
+    size -= 2;
+
+    // FNV-1a hash of the fields identifying the flow
+    uint64_t key = 0xcbf29ce484222325ULL ^ protocol;
+    auto hash = [&key](const uint8_t* begin, uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            key = (key ^ begin[i]) * 0x100000001b3ULL;
+        }
+    };
+    uint8_t transport = 0;
+    uint32_t headerSize = 0;
+    if (protocol == 0x0021 && size >= 20)
+    {
+        transport = ip[9];
+        hash(ip + 9, 1);
+        hash(ip + 12, 8);
+        headerSize = (ip[0] & 0x0f) * 4;
+        // only the first fragment holds the ports
+        if ((ip[6] & 0x1f) != 0 || ip[7] != 0)
+        {
+            transport = 0;
+        }
+    }
+    else if (protocol == 0x0057 && size >= 40)
+    {
+        transport = ip[6];
+        hash(ip + 6, 1);
+        hash(ip + 8, 32);
+        headerSize = 40;
+    }
+    // TCP or UDP
+    if ((transport == 6 || transport == 17) && size >= headerSize + 4)
+    {
+        hash(ip + headerSize, 4);
+    }
+    return key;
+}
+
 bool
 PointToPointNetDevice::Attach(Ptr<PointToPointChannel> ch)
 {
@@ -356,9 +585,14 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
 
         //
         // Trace sinks will expect complete packets, not packets without some of the
-        // headers.
+        // headers.  Only copy the packet if a sink is connected.
         //
-        Ptr<Packet> originalPacket = packet->Copy();
+        bool promisc = !m_promiscCallback.IsNull();
+        Ptr<Packet> originalPacket;
+        if (!m_macRxTrace.IsEmpty() || (promisc && !m_macPromiscRxTrace.IsEmpty()))
+        {
+            originalPacket = packet->Copy();
+        }
 
         //
         // Strip off the point-to-point protocol header and forward this packet
@@ -368,7 +602,7 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
         //
         ProcessHeader(packet, protocol);
 
-        if (!m_promiscCallback.IsNull())
+        if (promisc)
         {
             m_macPromiscRxTrace(originalPacket);
             m_promiscCallback(this,
@@ -384,6 +618,22 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
     }
 }
 
+void
+PointToPointNetDevice::ReceiveBurst(Ptr<PacketBurst> burst)
+{
+    NS_LOG_FUNCTION(this << burst);
+    for (auto it = burst->Begin(); it != burst->End(); ++it)
+    {
+        Receive(*it);
+    }
+}
+
+bool
+PointToPointNetDevice::KeepsTransmittedPacket() const
+{
+    return !m_phyTxEndTrace.IsEmpty();
+}
+
 Ptr<Queue<Packet>>
 PointToPointNetDevice::GetQueue() const
 {
@@ -539,6 +789,16 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     //
     if (m_queue->Enqueue(packet))
     {
+        //
+        // A packet of another flow, or a long queue, ends the train being
+        // transmitted.
+        //
+        if (!m_train.empty() && (m_queue->GetNPackets() > m_burstQueueThreshold ||
+                                 GetFlowKey(packet) != m_trainFlow))
+        {
+            SplitTrain();
+        }
+
         //
         // If the channel is ready for transition we send the packet right now
         //
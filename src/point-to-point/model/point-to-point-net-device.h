@@ -21,16 +21,20 @@
 #include "ns3/address.h"
 #include "ns3/callback.h"
 #include "ns3/data-rate.h"
+#include "ns3/event-id.h"
 #include "ns3/mac48-address.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/nstime.h"
+#include "ns3/packet-burst.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
 #include "ns3/queue-fwd.h"
 #include "ns3/traced-callback.h"
 
 #include <cstring>
+#include <deque>
+#include <vector>
 
 namespace ns3
 {
@@ -59,6 +63,32 @@ class ErrorModel;
  * Key parameters or objects that can be specified for this device
  * include a queue, data rate, and interframe transmission gap (the
  * propagation delay is set in the PointToPointChannel).
+ *
+ * Each transmitted packet costs a transmit complete event on the sender
+ * and a receive event on the receiver.  When the MaxBurstPackets attribute
+ * is greater than one, the device instead transmits the packets of a flow
+ * queued back to back as a train: it takes up to MaxBurstPackets packets of
+ * the flow of the packet it starts transmitting from the head of its queue,
+ * schedules a single transmit complete event at the end of the train, whose
+ * duration is the sum of the transmission times given by the data rate and
+ * of the interframe gaps, and hands the whole train to the channel as a
+ * PacketBurst, delivered by a single receive event.  The flow of a packet
+ * is given by its PPP protocol and, for IPv4 and IPv6, by its addresses,
+ * transport protocol and ports.
+ *
+ * A train is delivered when its last packet has been transmitted, so every
+ * packet of the train is received late by the time the train took to
+ * transmit after it, and never early.  This error is bounded by the
+ * duration of a train of MaxBurstPackets packets, and the TxBurst trace
+ * source reports the largest and the mean error of each train.  To keep
+ * the timing exact when it matters, a train is split as soon as a packet
+ * of another flow is queued, or the queue holds more than
+ * BurstQueueThreshold packets: the packets of the train whose transmission
+ * has already started are delivered at the end of the last of them, and
+ * the following ones, like every packet queued until the queue empties,
+ * are then transmitted one by one.  The packets of a
+ * train leave the queue when the train starts, so they are not counted in
+ * its length while they wait to be transmitted.
  */
 class PointToPointNetDevice : public NetDevice
 {
@@ -154,6 +184,25 @@ class PointToPointNetDevice : public NetDevice
      */
     void Receive(Ptr<Packet> p);
 
+    /**
+     * Receive a train of packets from a connected PointToPointChannel.
+     *
+     * This is the public method used by the channel to indicate that the
+     * last bit of the last packet of a train has arrived at the device.  The
+     * packets are received in order, as by Receive().
+     *
+     * \param burst Ptr to the received packets.
+     */
+    void ReceiveBurst(Ptr<PacketBurst> burst);
+
+    /**
+     * Check whether the device reads the packet it transmits after
+     * handing it to the channel, to trace the end of its transmission.
+     *
+     * \returns true if the PhyTxEnd trace source is connected.
+     */
+    bool KeepsTransmittedPacket() const;
+
     // The remaining methods are documented in ns3::NetDevice*
 
     void SetIfIndex(const uint32_t index) override;
@@ -198,6 +247,19 @@ class PointToPointNetDevice : public NetDevice
     void SetPromiscReceiveCallback(PromiscReceiveCallback cb) override;
     bool SupportsSendFrom() const override;
 
+    /**
+     * TracedCallback signature for the transmission of a train of packets.
+     *
+     * \param [in] burst The packets of the train.
+     * \param [in] maxError The largest delay of the reception of a packet
+     * of the train, that of its first packet.
+     * \param [in] meanError The mean delay of the reception of the packets
+     * of the train.
+     */
+    typedef void (*TxBurstTracedCallback)(Ptr<const PacketBurst> burst,
+                                          Time maxError,
+                                          Time meanError);
+
   protected:
     /**
      * \brief Handler for MPI receive event
@@ -261,6 +323,42 @@ class PointToPointNetDevice : public NetDevice
      */
     void TransmitComplete();
 
+    /**
+     * Take from the queue the packets of the flow of a packet which follow
+     * it, to start a train with it.
+     *
+     * \param p the first packet of the train
+     * \returns true if a train of at least two packets was formed in m_train
+     */
+    bool FormTrain(Ptr<Packet> p);
+
+    /**
+     * Start sending the train of packets of m_train down the wire.
+     */
+    void TransmitTrain();
+
+    /**
+     * Hand the train of packets of m_train to the channel, at the end of its
+     * transmission.
+     */
+    void CompleteTrain();
+
+    /**
+     * Stop the train of packets being transmitted after the packets whose
+     * transmission has started, move the others to m_pending, and form no
+     * other train until the queue empties.
+     */
+    void SplitTrain();
+
+    /**
+     * Get the flow a packet belongs to, from its PPP protocol and, for IPv4
+     * and IPv6, from its addresses, transport protocol and ports.
+     *
+     * \param p the packet, with its PPP header
+     * \returns a hash of the flow of the packet
+     */
+    static uint64_t GetFlowKey(Ptr<const Packet> p);
+
     /**
      * \brief Make the link up and running
      *
@@ -444,6 +542,22 @@ class PointToPointNetDevice : public NetDevice
 
     Ptr<Packet> m_currentPkt; //!< Current packet processed
 
+    uint32_t m_maxBurstPackets;        //!< Largest number of packets of a train
+    uint32_t m_burstQueueThreshold;    //!< Queue length above which a train is split
+    std::vector<Ptr<Packet>> m_train;  //!< Packets of the train being transmitted
+    uint64_t m_trainFlow;              //!< Flow of the train being transmitted
+    Time m_trainStart;                 //!< Time the train started to be transmitted
+    EventId m_txCompleteEvent;         //!< End of the transmission of the train
+    std::deque<Ptr<Packet>> m_pending; //!< Packets of a split train left to transmit
+    bool m_trainSplit;                 //!< A train was split since the queue last emptied
+
+    /**
+     * The trace source fired when a train of packets is handed to the
+     * channel, with the largest and the mean delay of the reception of its
+     * packets.
+     */
+    TracedCallback<Ptr<const PacketBurst>, Time, Time> m_txBurstTrace;
+
     /**
      * \brief PPP to Ethernet protocol number mapping
      * \param protocol A PPP protocol number
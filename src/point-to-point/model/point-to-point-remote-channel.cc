@@ -23,6 +23,7 @@
 
 #include "ns3/log.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/packet-burst.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
@@ -73,4 +74,26 @@ PointToPointRemoteChannel::TransmitStart(Ptr<const Packet> p,
     return true;
 }
 
+bool
+PointToPointRemoteChannel::TransmitBurst(Ptr<const PacketBurst> burst,
+                                         Ptr<PointToPointNetDevice> src,
+                                         const std::vector<Time>& txStart,
+                                         const std::vector<Time>& txTime)
+{
+    NS_LOG_FUNCTION(this << burst << src);
+
+    IsInitialized();
+
+    uint32_t wire = src == GetSource(0) ? 0 : 1;
+    Ptr<PointToPointNetDevice> dst = GetDestination(wire);
+
+    // The whole train is received at once, no earlier than the lookahead
+    Time rxTime = Simulator::Now() + GetDelay();
+    for (auto it = burst->Begin(); it != burst->End(); ++it)
+    {
+        MpiInterface::SendPacket((*it)->Copy(), rxTime, dst->GetNode()->GetId(), dst->GetIfIndex());
+    }
+    return true;
+}
+
 } // namespace ns3
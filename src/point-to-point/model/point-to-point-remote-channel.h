@@ -67,6 +67,20 @@ class PointToPointRemoteChannel : public PointToPointChannel
      * \returns true if successful (currently always true)
      */
     bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime) override;
+
+    /**
+     * \brief Transmit the packets of a train, each with its own MPI send
+     *
+     * \param burst Packets to transmit
+     * \param src Source PointToPointNetDevice
+     * \param txStart Transmit start time of each packet, relative to now
+     * \param txTime Transmit time of each packet
+     * \returns true if successful (currently always true)
+     */
+    bool TransmitBurst(Ptr<const PacketBurst> burst,
+                       Ptr<PointToPointNetDevice> src,
+                       const std::vector<Time>& txStart,
+                       const std::vector<Time>& txTime) override;
 };
 
 } // namespace ns3
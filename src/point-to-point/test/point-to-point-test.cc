@@ -17,14 +17,24 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include "ns3/boolean.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/packet-burst.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-helper.h"
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-partition-helper.h"
+#include "ns3/ppp-header.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -139,6 +149,484 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test class for PointToPointPartitionHelper
+ *
+ * It partitions a ring of four clusters of nodes, whose internal links are
+ * faster than the links between clusters.
+ */
+class PointToPointPartitionTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointPartitionTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Check that every cluster lies in a single partition
+     *
+     * \param assignment The partition of each node, indexed by node id.
+     * \param n The number of partitions.
+     */
+    void CheckClusters(const std::vector<uint32_t>& assignment, uint32_t n);
+
+    std::vector<NodeContainer> m_clusters; //!< The clusters of nodes
+};
+
+PointToPointPartitionTest::PointToPointPartitionTest()
+    : TestCase("PointToPointPartition")
+{
+}
+
+void
+PointToPointPartitionTest::CheckClusters(const std::vector<uint32_t>& assignment, uint32_t n)
+{
+    std::vector<uint32_t> sizes(n, 0);
+    for (const auto& cluster : m_clusters)
+    {
+        uint32_t p = assignment[cluster.Get(0)->GetId()];
+        NS_TEST_ASSERT_MSG_LT(p, n, "Wrong partition number");
+        for (uint32_t i = 0; i < cluster.GetN(); ++i)
+        {
+            NS_TEST_EXPECT_MSG_EQ(assignment[cluster.Get(i)->GetId()], p, "Cluster split");
+        }
+        sizes[p] += cluster.GetN();
+    }
+    for (uint32_t p = 0; p < n; ++p)
+    {
+        NS_TEST_EXPECT_MSG_EQ(sizes[p], assignment.size() / n, "Unbalanced partition " << p);
+    }
+}
+
+void
+PointToPointPartitionTest::DoRun()
+{
+    const uint32_t nClusters = 4;
+    const uint32_t clusterSize = 4;
+
+    PointToPointHelper p2p;
+    p2p.SetChannelAttribute("Delay", StringValue("10us"));
+    m_clusters.resize(nClusters);
+    for (auto& cluster : m_clusters)
+    {
+        cluster.Create(clusterSize);
+        for (uint32_t i = 0; i < clusterSize; ++i)
+        {
+            p2p.Install(cluster.Get(i), cluster.Get((i + 1) % clusterSize));
+        }
+    }
+    p2p.SetChannelAttribute("Delay", StringValue("1ms"));
+    for (uint32_t c = 0; c < nClusters; ++c)
+    {
+        p2p.Install(m_clusters[c].Get(0), m_clusters[(c + 1) % nClusters].Get(1));
+    }
+
+    PointToPointPartitionHelper partitioner;
+    partitioner.SetImbalance(0);
+    CheckClusters(partitioner.Partition(4), 4);
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetLookahead(), MilliSeconds(1), "Wrong lookahead");
+
+    // with heavy traffic between clusters 1 and 2, they share a partition
+    partitioner.AddTraffic(m_clusters[1].Get(2), m_clusters[2].Get(3), 1e6);
+    std::vector<uint32_t> assignment = partitioner.Partition(2);
+    CheckClusters(assignment, 2);
+    NS_TEST_EXPECT_MSG_EQ(assignment[m_clusters[1].Get(0)->GetId()],
+                          assignment[m_clusters[2].Get(0)->GetId()],
+                          "Heavy traffic crosses partitions");
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetLookahead(), MilliSeconds(1), "Wrong lookahead");
+
+    partitioner.Install(4);
+    std::set<uint32_t> systemIds;
+    for (const auto& cluster : m_clusters)
+    {
+        systemIds.insert(cluster.Get(0)->GetSystemId());
+        for (uint32_t i = 1; i < cluster.GetN(); ++i)
+        {
+            NS_TEST_EXPECT_MSG_EQ(cluster.Get(i)->GetSystemId(),
+                                  cluster.Get(0)->GetSystemId(),
+                                  "Cluster split by Install");
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(systemIds.size(), 4, "Wrong number of system ids");
+
+    m_clusters.clear();
+    Simulator::Destroy();
+}
+
+/**
+ * \brief Test class for the TransferOwnership mode of PointToPointChannel
+ *
+ * It checks that the transmitted packet itself is delivered, unless the
+ * transmitting device traces the end of its transmission.
+ */
+class PointToPointTransferOwnershipTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointTransferOwnershipTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Send a packet through two devices and record the received packet
+     *
+     * \param traceTxEnd Whether to connect the PhyTxEnd trace of the sender.
+     */
+    void SendOnePacket(bool traceTxEnd);
+    /**
+     * \brief Callback function which records the received packet
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    /**
+     * \brief PhyTxEnd trace sink, which records the transmitted packet
+     *
+     * \param pkt The transmitted packet.
+     */
+    void TxEnd(Ptr<const Packet> pkt);
+
+    Ptr<const Packet> m_sentPacket;  //!< sent packet
+    Ptr<const Packet> m_recvdPacket; //!< received packet
+    uint32_t m_txEndSize;            //!< size of the packet traced by PhyTxEnd
+};
+
+PointToPointTransferOwnershipTest::PointToPointTransferOwnershipTest()
+    : TestCase("PointToPointTransferOwnership")
+{
+}
+
+bool
+PointToPointTransferOwnershipTest::RxPacket(Ptr<NetDevice> dev,
+                                            Ptr<const Packet> pkt,
+                                            uint16_t mode,
+                                            const Address& sender)
+{
+    m_recvdPacket = pkt;
+    return true;
+}
+
+void
+PointToPointTransferOwnershipTest::TxEnd(Ptr<const Packet> pkt)
+{
+    m_txEndSize = pkt->GetSize();
+}
+
+void
+PointToPointTransferOwnershipTest::SendOnePacket(bool traceTxEnd)
+{
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("TransferOwnership", BooleanValue(true));
+    // the packet is received before the sender completes its transmission
+    devA->SetAttribute("InterframeGap", TimeValue(MicroSeconds(10)));
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    devB->SetReceiveCallback(MakeCallback(&PointToPointTransferOwnershipTest::RxPacket, this));
+    if (traceTxEnd)
+    {
+        devA->TraceConnectWithoutContext(
+            "PhyTxEnd",
+            MakeCallback(&PointToPointTransferOwnershipTest::TxEnd, this));
+    }
+
+    Ptr<Packet> p = Create<Packet>(100);
+    m_sentPacket = p;
+    m_recvdPacket = nullptr;
+    m_txEndSize = 0;
+    Simulator::Schedule(Seconds(1.0),
+                        &PointToPointNetDevice::Send,
+                        devA,
+                        p,
+                        devA->GetBroadcast(),
+                        0x800);
+    p = nullptr;
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+PointToPointTransferOwnershipTest::DoRun()
+{
+    SendOnePacket(false);
+    NS_TEST_ASSERT_MSG_NE(m_recvdPacket, nullptr, "No packet received");
+    NS_TEST_EXPECT_MSG_EQ(m_recvdPacket->GetSize(), 100, "Wrong received size");
+    NS_TEST_EXPECT_MSG_EQ(m_recvdPacket, m_sentPacket, "The packet was not handed over");
+
+    // the sender traces the packet with its header after it is received
+    SendOnePacket(true);
+    NS_TEST_ASSERT_MSG_NE(m_recvdPacket, nullptr, "No packet received");
+    NS_TEST_EXPECT_MSG_EQ(m_recvdPacket->GetSize(), 100, "Wrong received size");
+    NS_TEST_EXPECT_MSG_NE(m_recvdPacket, m_sentPacket, "The traced packet was handed over");
+    NS_TEST_EXPECT_MSG_EQ(m_txEndSize, 102, "The traced packet lost its header");
+
+    m_sentPacket = nullptr;
+    m_recvdPacket = nullptr;
+}
+
+/**
+ * \brief Test class for the trains of packets of PointToPointNetDevice
+ *
+ * It sends packets of a flow back to back, with and without trains, and
+ * checks the reception times and the number of events, then checks that a
+ * packet of another flow splits a train.
+ */
+class PointToPointBurstTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointBurstTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Send packets through two devices and record their reception
+     *
+     * The packets take 1ms to transmit, and the channel delay is 10us.
+     *
+     * \param maxBurstPackets The MaxBurstPackets attribute of the sender.
+     * \param competingTime When to send a packet of another flow, or zero.
+     */
+    void Run(uint32_t maxBurstPackets, Time competingTime);
+    /**
+     * \brief Send a packet
+     *
+     * \param device The sending device.
+     * \param seq The sequence number of the packet.
+     * \param flow The flow of the packet.
+     */
+    void Send(Ptr<PointToPointNetDevice> device, uint8_t seq, uint8_t flow);
+    /**
+     * \brief Callback function which records the received packet
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    /**
+     * \brief TxBurst trace sink
+     *
+     * \param burst The packets of the train.
+     * \param maxError The largest reception delay.
+     * \param meanError The mean reception delay.
+     */
+    void TxBurst(Ptr<const PacketBurst> burst, Time maxError, Time meanError);
+    /**
+     * \brief TxRxPointToPoint trace sink, which checks the transmission times
+     *
+     * \param packet The transmitted packet.
+     * \param txDevice The sending device.
+     * \param rxDevice The receiving device.
+     * \param duration The transmission time of the packet.
+     * \param lastBitTime The time of the reception of its last bit, relative to now.
+     */
+    void TxRx(Ptr<const Packet> packet,
+              Ptr<NetDevice> txDevice,
+              Ptr<NetDevice> rxDevice,
+              Time duration,
+              Time lastBitTime);
+
+    std::vector<std::pair<uint8_t, Time>> m_received; //!< sequence number and time of reception
+    uint32_t m_traced;                                //!< number of packets traced by the channel
+    std::vector<uint32_t> m_trains;                   //!< number of packets of each train
+    Time m_maxError;                                  //!< largest reported reception delay
+    uint64_t m_events;                                //!< number of events run
+};
+
+PointToPointBurstTest::PointToPointBurstTest()
+    : TestCase("PointToPointBurst")
+{
+}
+
+void
+PointToPointBurstTest::Send(Ptr<PointToPointNetDevice> device, uint8_t seq, uint8_t flow)
+{
+    // the sequence number is the IPv4 version and header length, which do
+    // not identify the flow, the flow is the first byte of the source address
+    uint8_t buffer[998] = {};
+    buffer[0] = seq;
+    buffer[12] = flow;
+    device->Send(Create<Packet>(buffer, sizeof(buffer)), device->GetBroadcast(), 0x800);
+}
+
+bool
+PointToPointBurstTest::RxPacket(Ptr<NetDevice> dev,
+                                Ptr<const Packet> pkt,
+                                uint16_t mode,
+                                const Address& sender)
+{
+    uint8_t seq;
+    pkt->CopyData(&seq, 1);
+    m_received.emplace_back(seq, Simulator::Now());
+    return true;
+}
+
+void
+PointToPointBurstTest::TxBurst(Ptr<const PacketBurst> burst, Time maxError, Time meanError)
+{
+    m_trains.push_back(burst->GetNPackets());
+    m_maxError = Max(m_maxError, maxError);
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(meanError, maxError, "Mean error above the largest one");
+}
+
+void
+PointToPointBurstTest::TxRx(Ptr<const Packet> packet,
+                            Ptr<NetDevice> txDevice,
+                            Ptr<NetDevice> rxDevice,
+                            Time duration,
+                            Time lastBitTime)
+{
+    // the packets of a train are traced with the times they would have alone;
+    // the channel sees them with their PPP header
+    Ptr<Packet> copy = packet->Copy();
+    PppHeader ppp;
+    copy->RemoveHeader(ppp);
+    uint8_t seq;
+    copy->CopyData(&seq, 1);
+    ++m_traced;
+    NS_TEST_EXPECT_MSG_EQ(duration, MilliSeconds(1), "Wrong transmission time");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now() + lastBitTime,
+                          Seconds(1) + MilliSeconds(seq + 1) + MicroSeconds(10),
+                          "Wrong time of the last bit");
+}
+
+void
+PointToPointBurstTest::Run(uint32_t maxBurstPackets, Time competingTime)
+{
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(MicroSeconds(10)));
+    devA->SetAttribute("DataRate", DataRateValue(DataRate("8Mbps")));
+    devA->SetAttribute("MaxBurstPackets", UintegerValue(maxBurstPackets));
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    devB->SetReceiveCallback(MakeCallback(&PointToPointBurstTest::RxPacket, this));
+    devA->TraceConnectWithoutContext("TxBurst",
+                                     MakeCallback(&PointToPointBurstTest::TxBurst, this));
+    channel->TraceConnectWithoutContext("TxRxPointToPoint",
+                                        MakeCallback(&PointToPointBurstTest::TxRx, this));
+
+    m_received.clear();
+    m_traced = 0;
+    m_trains.clear();
+    m_maxError = Time();
+    for (uint8_t seq = 0; seq < 20; ++seq)
+    {
+        Simulator::Schedule(Seconds(1), &PointToPointBurstTest::Send, this, devA, seq, 0);
+    }
+    if (competingTime.IsStrictlyPositive())
+    {
+        Simulator::Schedule(Seconds(1) + competingTime,
+                            &PointToPointBurstTest::Send,
+                            this,
+                            devA,
+                            20,
+                            1);
+    }
+    Simulator::Run();
+    m_events = Simulator::GetEventCount();
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(m_traced, m_received.size(), "Wrong number of packets traced");
+}
+
+void
+PointToPointBurstTest::DoRun()
+{
+    // Time of the reception of the last bit of a packet sent alone
+    auto exact = [](uint32_t seq) { return Seconds(1) + MilliSeconds(seq + 1) + MicroSeconds(10); };
+
+    Run(1, Time());
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), 20, "Wrong number of packets received");
+    for (uint32_t i = 0; i < m_received.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(uint32_t(m_received[i].first), i, "Packet received out of order");
+        NS_TEST_EXPECT_MSG_EQ(m_received[i].second, exact(i), "Wrong reception time");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_trains.size(), 0, "Train sent while disabled");
+    uint64_t events = m_events;
+
+    // the first packet goes alone, the others queue behind it
+    Run(8, Time());
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), 20, "Wrong number of packets received");
+    for (uint32_t i = 0; i < m_received.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(uint32_t(m_received[i].first), i, "Packet received out of order");
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(m_received[i].second, exact(i), "Packet received early");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(m_received[i].second,
+                                    exact(i) + m_maxError,
+                                    "Delay above the reported error");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_received.back().second, exact(19), "Wrong end of the last train");
+    NS_TEST_ASSERT_MSG_EQ(m_trains.size(), 3, "Wrong number of trains");
+    NS_TEST_EXPECT_MSG_EQ(m_trains[0], 8, "Wrong length of the first train");
+    NS_TEST_EXPECT_MSG_EQ(m_trains[2], 3, "Wrong length of the last train");
+    NS_TEST_EXPECT_MSG_EQ(m_maxError, MilliSeconds(7), "Wrong largest error");
+    NS_TEST_EXPECT_MSG_LT(m_events, events, "Trains did not save events");
+
+    // the packet of another flow splits the first train after its third
+    // packet, and the packets queued with it are then sent alone
+    Run(8, MicroSeconds(3500));
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), 21, "Wrong number of packets received");
+    NS_TEST_ASSERT_MSG_EQ(m_trains.size(), 1, "Wrong number of trains");
+    NS_TEST_EXPECT_MSG_EQ(m_trains[0], 3, "Wrong length of the split train");
+    NS_TEST_EXPECT_MSG_EQ(m_maxError, MilliSeconds(2), "Wrong largest error");
+    for (uint32_t i = 4; i < m_received.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(uint32_t(m_received[i].first), i, "Packet received out of order");
+        NS_TEST_EXPECT_MSG_EQ(m_received[i].second, exact(i), "Wrong reception time");
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -155,6 +643,9 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::QUICK);
+    AddTestCase(new PointToPointPartitionTest, TestCase::QUICK);
+    AddTestCase(new PointToPointTransferOwnershipTest, TestCase::QUICK);
+    AddTestCase(new PointToPointBurstTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -0,0 +1,216 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "columnar-aggregator.h"
+
+#include "ns3/abort.h"
+#include "ns3/async-file-stream.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ColumnarAggregator");
+
+NS_OBJECT_ENSURE_REGISTERED(ColumnarAggregator);
+
+/** Magic number of the files, "NS3COLS" and a null byte. */
+static const char COLUMNAR_MAGIC[8] = {'N', 'S', '3', 'C', 'O', 'L', 'S', '\0'};
+
+TypeId
+ColumnarAggregator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ColumnarAggregator")
+            .SetParent<DataCollectionObject>()
+            .SetGroupName("Stats")
+            .AddAttribute("ChunkSize",
+                          "The number of samples of a column written to the file at once",
+                          UintegerValue(4096),
+                          MakeUintegerAccessor(&ColumnarAggregator::m_chunkSize),
+                          MakeUintegerChecker<uint32_t>(1));
+
+    return tid;
+}
+
+ColumnarAggregator::ColumnarAggregator(const std::string& outputFileName)
+    : m_chunkSize(4096),
+      m_offset(0)
+{
+    NS_LOG_FUNCTION(this << outputFileName);
+
+    m_file = std::make_unique<AsyncFileStream>(outputFileName, std::ios::out | std::ios::binary);
+    NS_ABORT_MSG_UNLESS(m_file->IsOpen(), "Unable to open " << outputFileName);
+
+    uint32_t version[2] = {VERSION, 0};
+    int64_t timeSteps = Seconds(1).GetTimeStep();
+    Write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+    Write(version, sizeof(version));
+    Write(&timeSteps, sizeof(timeSteps));
+}
+
+ColumnarAggregator::~ColumnarAggregator()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_file)
+    {
+        Close();
+    }
+}
+
+void
+ColumnarAggregator::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_file)
+    {
+        Close();
+        m_file = nullptr;
+    }
+    DataCollectionObject::DoDispose();
+}
+
+void
+ColumnarAggregator::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(m_file, "ColumnarAggregator used after being disposed");
+    for (uint32_t id = 0; id < m_columns.size(); ++id)
+    {
+        WriteChunk(id);
+    }
+}
+
+void
+ColumnarAggregator::Close()
+{
+    NS_LOG_FUNCTION(this);
+    Flush();
+
+    uint64_t index = m_offset;
+    uint32_t block[2] = {INDEX, uint32_t(m_columns.size())};
+    Write(block, sizeof(block));
+    for (uint32_t id = 0; id < m_columns.size(); ++id)
+    {
+        const Column& column = m_columns[id];
+        uint32_t entry[2] = {id, uint32_t(column.chunks.size())};
+        Write(entry, sizeof(entry));
+        Write(&column.offset, sizeof(column.offset));
+        Write(column.chunks.data(), column.chunks.size() * sizeof(uint64_t));
+    }
+    Write(&index, sizeof(index));
+    m_file->Close();
+}
+
+void
+ColumnarAggregator::Write1d(std::string context, double v1)
+{
+    NS_LOG_FUNCTION(this << context << v1);
+
+    if (m_enabled)
+    {
+        Append(context, Simulator::Now().GetTimeStep(), v1);
+    }
+}
+
+void
+ColumnarAggregator::Write2d(std::string context, double time, double value)
+{
+    NS_LOG_FUNCTION(this << context << time << value);
+
+    if (m_enabled)
+    {
+        Append(context, Seconds(time).GetTimeStep(), value);
+    }
+}
+
+void
+ColumnarAggregator::Append(const std::string& context, int64_t time, double value)
+{
+    NS_ABORT_MSG_UNLESS(m_file, "ColumnarAggregator used after being disposed");
+    auto [it, inserted] = m_ids.emplace(context, m_columns.size());
+    uint32_t id = it->second;
+    if (inserted)
+    {
+        m_columns.push_back({0, {}, {}, m_offset, {}});
+
+        // Name the column before any of its chunks
+        uint32_t block[4] = {COLUMN, id, uint32_t(context.size()), 0};
+        Write(block, sizeof(block));
+        WritePadded(context.data(), context.size());
+    }
+
+    // Zigzag LEB128 of the difference to the previous sample, which is
+    // short for periodic samples
+    Column& column = m_columns[id];
+    int64_t delta = time - column.lastTime;
+    uint64_t zigzag = (uint64_t(delta) << 1) ^ uint64_t(delta >> 63);
+    while (zigzag >= 0x80)
+    {
+        column.times.push_back(uint8_t(zigzag) | 0x80);
+        zigzag >>= 7;
+    }
+    column.times.push_back(uint8_t(zigzag));
+    column.lastTime = time;
+    column.values.push_back(value);
+
+    if (column.values.size() >= m_chunkSize)
+    {
+        WriteChunk(id);
+    }
+}
+
+void
+ColumnarAggregator::WriteChunk(uint32_t id)
+{
+    Column& column = m_columns[id];
+    if (column.values.empty())
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this << id << column.values.size());
+
+    uint32_t timesSize = (column.times.size() + 7) & ~std::size_t(7);
+    uint32_t block[4] = {CHUNK, id, uint32_t(column.values.size()), timesSize};
+    column.chunks.push_back(m_offset);
+    Write(block, sizeof(block));
+    WritePadded(column.times.data(), column.times.size());
+    Write(column.values.data(), column.values.size() * sizeof(double));
+
+    // Each chunk starts from time zero, to be decoded on its own
+    column.lastTime = 0;
+    column.times.clear();
+    column.values.clear();
+}
+
+void
+ColumnarAggregator::Write(const void* data, std::size_t size)
+{
+    m_file->write((const char*)data, size);
+    m_offset += size;
+}
+
+void
+ColumnarAggregator::WritePadded(const void* data, std::size_t size)
+{
+    static const char padding[8] = {};
+    Write(data, size);
+    Write(padding, (8 - size % 8) % 8);
+}
+
+} // namespace ns3
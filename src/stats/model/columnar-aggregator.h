@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COLUMNAR_AGGREGATOR_H
+#define COLUMNAR_AGGREGATOR_H
+
+#include "data-collection-object.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class AsyncFileStream;
+
+/**
+ * \ingroup aggregator
+ * This aggregator stores the time series it receives as columns of a
+ * chunked binary file, written from a background thread.
+ *
+ * Each context, usually one probe, is a column of (time, value)
+ * samples.  The samples of a column are kept in memory until ChunkSize
+ * of them are collected, and then appended to the file as a chunk,
+ * through an AsyncFileStream.  The times are stored in time steps, as
+ * zigzag LEB128 varints of the difference to the previous sample of the
+ * chunk, and the values as raw doubles, aligned on 8 bytes in the file,
+ * so that a mapped file can be read without copying the values.
+ *
+ * All the integers and doubles are in the byte order of the simulation
+ * host.  The file starts with the magic "NS3COLS", a null byte, a
+ * \c uint32_t version, a \c uint32_t zero and the \c int64_t number of
+ * time steps per second.  Then come the blocks, each starting with a
+ * \c uint32_t tag (ColumnarAggregator::BlockTag) and a \c uint32_t
+ * column id, or number of columns for the index:
+ *
+ * - COLUMN: a \c uint32_t name length, a \c uint32_t zero and the name
+ *   of the column, padded to 8 bytes;
+ * - CHUNK: a \c uint32_t number of samples and the \c uint32_t length
+ *   of the times, padded to 8 bytes, followed by the times and the
+ *   values;
+ * - INDEX, the last block, written when the aggregator is disposed: for
+ *   each column, its \c uint32_t id, its \c uint32_t number of chunks,
+ *   the \c uint64_t offset of its COLUMN block and the \c uint64_t
+ *   offsets of its CHUNK blocks, in order.
+ *
+ * The file ends with the \c uint64_t offset of the INDEX block, from
+ * which ColumnarReader finds the chunks of a column without reading the
+ * chunks of the other columns.
+  **/
+class ColumnarAggregator : public DataCollectionObject
+{
+  public:
+    /** Tags of the blocks of the file. */
+    enum BlockTag : uint32_t
+    {
+        COLUMN = 1, //!< The name of a column
+        CHUNK = 2,  //!< A chunk of samples of a column
+        INDEX = 3   //!< The offsets of the blocks of every column
+    };
+
+    /** Version of the file format. */
+    static constexpr uint32_t VERSION = 2;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \param outputFileName name of the file to write.
+     *
+     * Constructs a columnar aggregator that will create a file named
+     * outputFileName.
+     */
+    ColumnarAggregator(const std::string& outputFileName);
+
+    ~ColumnarAggregator() override;
+
+    /**
+     * \brief Append the samples kept in memory to the file.
+     */
+    void Flush();
+
+    // Below are hooked to connectors exporting data
+
+    /**
+     * \param context specifies the column this value came from.
+     * \param v1 value for the new sample, taken now.
+     * \brief Appends a sample to a column.
+     */
+    void Write1d(std::string context, double v1);
+
+    /**
+     * \param context specifies the column these values came from.
+     * \param time time in seconds of the new sample.
+     * \param value value for the new sample.
+     * \brief Appends a sample to a column.
+     *
+     * This is the signature of the Output trace source of
+     * TimeSeriesAdaptor.
+     */
+    void Write2d(std::string context, double time, double value);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /** The samples of a column kept in memory. */
+    struct Column
+    {
+        int64_t lastTime;             //!< time of the last sample of the chunk
+        std::vector<uint8_t> times;   //!< encoded times of the chunk
+        std::vector<double> values;   //!< values of the chunk
+        uint64_t offset;              //!< offset of the COLUMN block
+        std::vector<uint64_t> chunks; //!< offsets of the CHUNK blocks written
+    };
+
+    /**
+     * \param context the column
+     * \param time time step of the sample
+     * \param value value of the sample
+     */
+    void Append(const std::string& context, int64_t time, double value);
+
+    /**
+     * \param id the id of the column whose chunk to write
+     */
+    void WriteChunk(uint32_t id);
+
+    /**
+     * Write the remaining chunks and the index, and close the file.
+     */
+    void Close();
+
+    /**
+     * Write bytes to the file.
+     *
+     * \param data the bytes
+     * \param size the number of bytes
+     */
+    void Write(const void* data, std::size_t size);
+
+    /**
+     * Write bytes to the file, and pad them to 8 bytes.
+     *
+     * \param data the bytes
+     * \param size the number of bytes
+     */
+    void WritePadded(const void* data, std::size_t size);
+
+    std::unique_ptr<AsyncFileStream> m_file;         //!< the output file
+    std::unordered_map<std::string, uint32_t> m_ids; //!< the ids of the columns by context
+    std::vector<Column> m_columns;                   //!< the columns by id
+    uint32_t m_chunkSize;                            //!< samples per chunk
+    uint64_t m_offset;                               //!< bytes written to the file
+};
+
+} // namespace ns3
+
+#endif // COLUMNAR_AGGREGATOR_H
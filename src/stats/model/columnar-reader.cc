@@ -0,0 +1,234 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "columnar-reader.h"
+
+#include "columnar-aggregator.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <cstring>
+
+#ifdef __WIN32__
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ColumnarReader");
+
+ColumnarReader::ColumnarReader()
+    : m_data(nullptr),
+      m_size(0),
+      m_timeSteps(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ColumnarReader::~ColumnarReader()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+ColumnarReader::Open(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    Close();
+
+#ifdef __WIN32__
+    // No mapping: read the file in a buffer of doubles, aligned as the
+    // values of the chunks
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+    m_size = file.tellg();
+    m_buffer.resize((m_size + sizeof(double) - 1) / sizeof(double));
+    file.seekg(0);
+    if (!file.read((char*)m_buffer.data(), m_size))
+    {
+        Close();
+        return false;
+    }
+    m_data = (const uint8_t*)m_buffer.data();
+#else
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    m_data = (const uint8_t*)data;
+    m_size = st.st_size;
+#endif
+
+    // Header, then the offset of the index at the end of the file
+    uint64_t index = 0;
+    if (m_size < 32 || std::memcmp(m_data, "NS3COLS", 8) != 0 ||
+        GetWords(8)[0] != ColumnarAggregator::VERSION)
+    {
+        Close();
+        return false;
+    }
+    std::memcpy(&m_timeSteps, m_data + 16, sizeof(m_timeSteps));
+    std::memcpy(&index, m_data + m_size - sizeof(index), sizeof(index));
+    if (index % 8 != 0 || !IsInFile(index, 8) || GetWords(index)[0] != ColumnarAggregator::INDEX)
+    {
+        Close();
+        return false;
+    }
+
+    uint32_t nColumns = GetWords(index)[1];
+    uint64_t offset = index + 8;
+    for (uint32_t i = 0; i < nColumns; ++i)
+    {
+        if (!IsInFile(offset, 16))
+        {
+            Close();
+            return false;
+        }
+        uint32_t nChunks = GetWords(offset)[1];
+        const uint64_t* offsets = (const uint64_t*)(m_data + offset + 8);
+        if (!IsInFile(offset, 16 + uint64_t(nChunks) * 8) || !IsInFile(offsets[0], 16))
+        {
+            Close();
+            return false;
+        }
+        const uint32_t* block = GetWords(offsets[0]);
+        if (block[0] != ColumnarAggregator::COLUMN || !IsInFile(offsets[0] + 16, block[2]))
+        {
+            Close();
+            return false;
+        }
+        std::string name((const char*)(block + 4), block[2]);
+        m_indexes[name] = m_columns.size();
+        m_columns.push_back({name, offsets + 1, nChunks});
+        offset += 16 + uint64_t(nChunks) * 8;
+    }
+    return true;
+}
+
+void
+ColumnarReader::Close()
+{
+    NS_LOG_FUNCTION(this);
+#ifndef __WIN32__
+    if (m_data != nullptr)
+    {
+        munmap((void*)m_data, m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_buffer.clear();
+    m_columns.clear();
+    m_indexes.clear();
+}
+
+std::vector<std::string>
+ColumnarReader::GetColumnNames() const
+{
+    std::vector<std::string> names;
+    for (const auto& column : m_columns)
+    {
+        names.push_back(column.name);
+    }
+    return names;
+}
+
+uint32_t
+ColumnarReader::GetNChunks(const std::string& name) const
+{
+    auto it = m_indexes.find(name);
+    return it == m_indexes.end() ? 0 : m_columns[it->second].nChunks;
+}
+
+ColumnarReader::Chunk
+ColumnarReader::GetChunk(const std::string& name, uint32_t i) const
+{
+    NS_LOG_FUNCTION(this << name << i);
+    NS_ABORT_MSG_UNLESS(i < GetNChunks(name), "No chunk " << i << " in column " << name);
+    uint64_t offset = m_columns[m_indexes.at(name)].chunks[i];
+    NS_ABORT_MSG_UNLESS(IsInFile(offset, 16), "Chunk out of the file");
+    const uint32_t* block = GetWords(offset);
+    NS_ABORT_MSG_UNLESS(block[0] == ColumnarAggregator::CHUNK &&
+                            IsInFile(offset + 16, block[3] + uint64_t(block[2]) * 8),
+                        "Chunk " << i << " of column " << name << " is corrupted");
+    Chunk chunk;
+    chunk.size = block[2];
+    chunk.times = m_data + offset + 16;
+    chunk.values = (const double*)(chunk.times + block[3]);
+    return chunk;
+}
+
+std::vector<Time>
+ColumnarReader::GetTimes(const Chunk& chunk) const
+{
+    std::vector<Time> times;
+    times.reserve(chunk.size);
+    const uint8_t* p = chunk.times;
+    int64_t time = 0;
+    for (uint32_t i = 0; i < chunk.size; ++i)
+    {
+        uint64_t zigzag = 0;
+        for (uint32_t shift = 0;; shift += 7)
+        {
+            zigzag |= uint64_t(*p & 0x7f) << shift;
+            if ((*p++ & 0x80) == 0)
+            {
+                break;
+            }
+        }
+        time += int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1);
+        times.push_back(m_timeSteps == Seconds(1).GetTimeStep()
+                            ? TimeStep(time)
+                            : Seconds(double(time) / m_timeSteps));
+    }
+    return times;
+}
+
+bool
+ColumnarReader::IsInFile(uint64_t offset, uint64_t size) const
+{
+    return offset <= m_size && size <= m_size - offset;
+}
+
+const uint32_t*
+ColumnarReader::GetWords(uint64_t offset) const
+{
+    return (const uint32_t*)(m_data + offset);
+}
+
+} // namespace ns3
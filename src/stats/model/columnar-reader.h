@@ -0,0 +1,129 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COLUMNAR_READER_H
+#define COLUMNAR_READER_H
+
+#include "ns3/nstime.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup aggregator
+ * Reader of the files written by ColumnarAggregator.
+ *
+ * The file is mapped in memory, and the index at its end gives the
+ * chunks of each column, so that reading a column only touches the pages
+ * of its own chunks.  The values of a chunk are read in place, without
+ * copying them; its times are decoded on demand.
+ *
+ * A file without index, whose aggregator was not disposed, cannot be
+ * opened.
+ */
+class ColumnarReader
+{
+  public:
+    /** A chunk of samples of a column, in the mapped file. */
+    struct Chunk
+    {
+        uint32_t size;        //!< number of samples
+        const uint8_t* times; //!< encoded times of the samples
+        const double* values; //!< values of the samples
+    };
+
+    ColumnarReader();
+    ~ColumnarReader();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    /**
+     * Map a file and read its index.
+     *
+     * \param fileName the name of the file
+     * \returns true if the file is a complete file of ColumnarAggregator
+     */
+    bool Open(const std::string& fileName);
+
+    /**
+     * Unmap the file.  The chunks read from it are no longer valid.
+     */
+    void Close();
+
+    /**
+     * \returns the names of the columns, in the order they were created
+     */
+    std::vector<std::string> GetColumnNames() const;
+
+    /**
+     * \param name the name of a column
+     * \returns the number of chunks of the column, zero if there is no
+     * such column
+     */
+    uint32_t GetNChunks(const std::string& name) const;
+
+    /**
+     * \param name the name of a column
+     * \param i the index of a chunk of the column
+     * \returns the chunk
+     */
+    Chunk GetChunk(const std::string& name, uint32_t i) const;
+
+    /**
+     * \param chunk a chunk
+     * \returns the times of the samples of the chunk
+     */
+    std::vector<Time> GetTimes(const Chunk& chunk) const;
+
+  private:
+    /** A column of the index. */
+    struct Column
+    {
+        std::string name;       //!< name of the column
+        const uint64_t* chunks; //!< offsets of the CHUNK blocks
+        uint32_t nChunks;       //!< number of chunks
+    };
+
+    /**
+     * \param offset an offset in the file
+     * \param size a number of bytes
+     * \returns true if the bytes are in the file
+     */
+    bool IsInFile(uint64_t offset, uint64_t size) const;
+
+    /**
+     * \param offset an offset in the file
+     * \returns the 32-bit words at this offset
+     */
+    const uint32_t* GetWords(uint64_t offset) const;
+
+    const uint8_t* m_data;                     //!< the mapped file
+    uint64_t m_size;                           //!< size of the file
+    std::vector<double> m_buffer;              //!< the file, where it cannot be mapped
+    int64_t m_timeSteps;                       //!< time steps per second of the file
+    std::vector<Column> m_columns;             //!< the columns, in the order of creation
+    std::map<std::string, uint32_t> m_indexes; //!< index of each column by name
+};
+
+} // namespace ns3
+
+#endif // COLUMNAR_READER_H
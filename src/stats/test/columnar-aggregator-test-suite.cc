@@ -0,0 +1,152 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/columnar-aggregator.h"
+#include "ns3/columnar-reader.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief Check that the columns written by a ColumnarAggregator can be
+ * read back.
+ */
+class ColumnarAggregatorTestCase : public TestCase
+{
+  public:
+    ColumnarAggregatorTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ColumnarAggregatorTestCase::ColumnarAggregatorTestCase()
+    : TestCase("Check that the columns written by a ColumnarAggregator can be read back")
+{
+}
+
+void
+ColumnarAggregatorTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("columnar-aggregator.bin");
+
+    // Two columns, one of which spans several chunks, with a negative
+    // time step between samples
+    std::vector<std::pair<double, double>> queue = {{0.1, 1},
+                                                    {0.2, 2},
+                                                    {0.3, 3},
+                                                    {0.25, 4},
+                                                    {0.5, 5}};
+    std::vector<std::pair<double, double>> rate = {{0.1, 10.5}, {0.4, -7}};
+    Ptr<ColumnarAggregator> aggregator = CreateObject<ColumnarAggregator>(filename);
+    aggregator->SetAttribute("ChunkSize", UintegerValue(2));
+    for (std::size_t i = 0; i < queue.size(); ++i)
+    {
+        aggregator->Write2d("queue", queue[i].first, queue[i].second);
+        if (i < rate.size())
+        {
+            aggregator->Write2d("rate", rate[i].first, rate[i].second);
+        }
+    }
+    aggregator->Dispose();
+
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(data.size(), 24, "File is too short");
+    NS_TEST_ASSERT_MSG_EQ(std::memcmp(data.data(), "NS3COLS", 8), 0, "Wrong magic number");
+    int64_t timeSteps;
+    std::memcpy(&timeSteps, data.data() + 16, sizeof(timeSteps));
+    NS_TEST_ASSERT_MSG_EQ(timeSteps, Seconds(1).GetTimeStep(), "Wrong time resolution");
+
+    // Read the columns through the index
+    ColumnarReader reader;
+    NS_TEST_ASSERT_MSG_EQ(reader.Open(filename), true, "Cannot open the file");
+    std::vector<std::string> names = reader.GetColumnNames();
+    NS_TEST_ASSERT_MSG_EQ(names.size(), 2, "Wrong number of columns");
+    NS_TEST_EXPECT_MSG_EQ(names[0], "queue", "Wrong column");
+    NS_TEST_EXPECT_MSG_EQ(names[1], "rate", "Wrong column");
+    NS_TEST_EXPECT_MSG_EQ(reader.GetNChunks("queue"), 3, "Wrong number of chunks");
+    NS_TEST_EXPECT_MSG_EQ(reader.GetNChunks("rate"), 1, "Wrong number of chunks");
+    NS_TEST_EXPECT_MSG_EQ(reader.GetNChunks("drops"), 0, "Chunks of an unknown column");
+    std::map<std::string, std::vector<std::pair<double, double>>> columns;
+    for (const auto& name : names)
+    {
+        for (uint32_t i = 0; i < reader.GetNChunks(name); ++i)
+        {
+            ColumnarReader::Chunk chunk = reader.GetChunk(name, i);
+            NS_TEST_EXPECT_MSG_EQ(uintptr_t(chunk.values) % alignof(double),
+                                  0,
+                                  "Values are not aligned");
+            std::vector<Time> times = reader.GetTimes(chunk);
+            for (uint32_t j = 0; j < chunk.size; ++j)
+            {
+                columns[name].emplace_back(times[j].GetSeconds(), chunk.values[j]);
+            }
+        }
+    }
+    reader.Close();
+
+    NS_TEST_ASSERT_MSG_EQ(columns["queue"].size(), queue.size(), "Wrong number of samples");
+    NS_TEST_ASSERT_MSG_EQ(columns["rate"].size(), rate.size(), "Wrong number of samples");
+    for (std::size_t i = 0; i < queue.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ_TOL(columns["queue"][i].first, queue[i].first, 1e-9, "Wrong time");
+        NS_TEST_EXPECT_MSG_EQ(columns["queue"][i].second, queue[i].second, "Wrong value");
+    }
+    for (std::size_t i = 0; i < rate.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ_TOL(columns["rate"][i].first, rate[i].first, 1e-9, "Wrong time");
+        NS_TEST_EXPECT_MSG_EQ(columns["rate"][i].second, rate[i].second, "Wrong value");
+    }
+
+    // Without its index, a file cannot be read
+    std::string truncated = CreateTempDirFilename("columnar-aggregator-truncated.bin");
+    std::ofstream(truncated, std::ios::binary).write(data.data(), data.size() - 8);
+    NS_TEST_EXPECT_MSG_EQ(reader.Open(truncated), false, "Opened a file without index");
+    std::remove(truncated.c_str());
+    std::remove(filename.c_str());
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief ColumnarAggregator class TestSuite
+ */
+class ColumnarAggregatorTestSuite : public TestSuite
+{
+  public:
+    ColumnarAggregatorTestSuite();
+};
+
+ColumnarAggregatorTestSuite::ColumnarAggregatorTestSuite()
+    : TestSuite("columnar-aggregator", UNIT)
+{
+    AddTestCase(new ColumnarAggregatorTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static ColumnarAggregatorTestSuite columnarAggregatorTestSuite;
@@ -0,0 +1,319 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "port-telemetry.h"
+
+#include "queue-disc.h"
+
+#include "ns3/abort.h"
+#include "ns3/async-file-stream.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PortTelemetry");
+
+NS_OBJECT_ENSURE_REGISTERED(PortTelemetry);
+
+static_assert(sizeof(PortTelemetry::Sample) == 24, "Samples are written as is to the file");
+
+/** Magic number of the files, "NS3TELM" and a null byte. */
+static const char TELEMETRY_MAGIC[8] = {'N', 'S', '3', 'T', 'E', 'L', 'M', '\0'};
+/** Version of the file format. */
+static const uint32_t TELEMETRY_VERSION = 1;
+
+TypeId
+PortTelemetry::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::PortTelemetry")
+            .SetParent<Object>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<PortTelemetry>()
+            .AddAttribute("Interval",
+                          "The time between two samples of the ports",
+                          TimeValue(MicroSeconds(10)),
+                          MakeTimeAccessor(&PortTelemetry::m_interval),
+                          MakeTimeChecker(TimeStep(1)))
+            .AddAttribute("HistorySize",
+                          "The number of samples kept in memory for each port",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&PortTelemetry::m_historySize),
+                          MakeUintegerChecker<uint32_t>(2));
+    return tid;
+}
+
+PortTelemetry::PortTelemetry()
+    : m_nSamples(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PortTelemetry::~PortTelemetry()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PortTelemetry::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Stop();
+    m_ports.clear();
+    m_samples.clear();
+    Object::DoDispose();
+}
+
+uint32_t
+PortTelemetry::AddQueue(Ptr<QueueBase> queue, DataRate rate)
+{
+    NS_LOG_FUNCTION(this << queue << rate);
+    NS_ASSERT(queue);
+    return AddPort({QUEUE, queue, nullptr, rate, UNKNOWN, UNKNOWN, 0, 0, 0, 0});
+}
+
+uint32_t
+PortTelemetry::AddQueueDisc(Ptr<QueueDisc> queueDisc, DataRate rate)
+{
+    NS_LOG_FUNCTION(this << queueDisc << rate);
+    NS_ASSERT(queueDisc);
+    return AddPort({QUEUE_DISC, nullptr, queueDisc, rate, UNKNOWN, UNKNOWN, 0, 0, 0, 0});
+}
+
+uint32_t
+PortTelemetry::AddDevice(Ptr<NetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    PointerValue queue;
+    if (!device->GetAttributeFailSafe("TxQueue", queue) || !queue.Get<QueueBase>())
+    {
+        NS_FATAL_ERROR("Device " << device << " has no transmission queue to sample");
+    }
+    DataRateValue rate(DataRate(0));
+    device->GetAttributeFailSafe("DataRate", rate);
+    uint32_t nodeId = device->GetNode() ? device->GetNode()->GetId() : UNKNOWN;
+    return AddPort({DEVICE,
+                    queue.Get<QueueBase>(),
+                    nullptr,
+                    rate.Get(),
+                    nodeId,
+                    device->GetIfIndex(),
+                    0,
+                    0,
+                    0,
+                    0});
+}
+
+uint32_t
+PortTelemetry::AddPort(Port port)
+{
+    NS_ABORT_MSG_IF(m_event.IsRunning(), "Ports must be registered before sampling starts");
+    m_ports.push_back(port);
+    return m_ports.size() - 1;
+}
+
+void
+PortTelemetry::SetOutputFile(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    m_filename = filename;
+}
+
+void
+PortTelemetry::Start()
+{
+    NS_LOG_FUNCTION(this);
+    Stop();
+    m_samples.assign(std::size_t(m_historySize) * m_ports.size(), Sample());
+    m_nSamples = 0;
+    m_start = Simulator::Now();
+
+    // Count the bytes from now on
+    for (auto& port : m_ports)
+    {
+        ReadCounters(port);
+        port.sentBytes = 0;
+        port.droppedBytes = 0;
+    }
+
+    if (!m_filename.empty())
+    {
+        m_file = std::make_unique<AsyncFileStream>(m_filename, std::ios::out | std::ios::binary);
+        NS_ABORT_MSG_UNLESS(m_file->IsOpen(), "Unable to open " << m_filename);
+        WriteHeader();
+    }
+    SampleAll();
+}
+
+void
+PortTelemetry::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_event.Cancel();
+    if (m_file)
+    {
+        m_file->Close();
+        m_file = nullptr;
+    }
+}
+
+void
+PortTelemetry::WriteHeader()
+{
+    uint32_t header[2] = {TELEMETRY_VERSION, uint32_t(m_ports.size())};
+    int64_t times[3] = {Seconds(1).GetTimeStep(), m_interval.GetTimeStep(), m_start.GetTimeStep()};
+    m_file->write(TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+    m_file->write((const char*)header, sizeof(header));
+    m_file->write((const char*)times, sizeof(times));
+    for (const auto& port : m_ports)
+    {
+        uint32_t description[4] = {port.kind, port.nodeId, port.ifIndex, 0};
+        uint64_t rate = port.rate.GetBitRate();
+        m_file->write((const char*)description, sizeof(description));
+        m_file->write((const char*)&rate, sizeof(rate));
+    }
+}
+
+void
+PortTelemetry::ReadCounters(Port& port) const
+{
+    // The counters are read modulo 2^32, since those of the queues are
+    // 32 bit, and accumulated in 64 bit
+    uint32_t sent;
+    uint32_t dropped;
+    if (port.queueDisc)
+    {
+        const QueueDisc::Stats& stats = port.queueDisc->GetStats();
+        sent = stats.nTotalSentBytes;
+        dropped = stats.nTotalDroppedBytes;
+    }
+    else
+    {
+        sent = port.queue->GetTotalReceivedBytes() -
+               port.queue->GetTotalDroppedBytesBeforeEnqueue() -
+               port.queue->GetTotalDroppedBytesAfterDequeue() - port.queue->GetNBytes();
+        dropped = port.queue->GetTotalDroppedBytes();
+    }
+    port.sentBytes += uint32_t(sent - port.lastSentBytes);
+    port.droppedBytes += uint32_t(dropped - port.lastDroppedBytes);
+    port.lastSentBytes = sent;
+    port.lastDroppedBytes = dropped;
+}
+
+void
+PortTelemetry::SampleAll()
+{
+    Sample* samples = &m_samples[(m_nSamples % m_historySize) * m_ports.size()];
+    for (std::size_t i = 0; i < m_ports.size(); ++i)
+    {
+        Port& port = m_ports[i];
+        ReadCounters(port);
+        if (port.queueDisc)
+        {
+            samples[i].packets = port.queueDisc->GetNPackets();
+            samples[i].bytes = port.queueDisc->GetNBytes();
+        }
+        else
+        {
+            samples[i].packets = port.queue->GetNPackets();
+            samples[i].bytes = port.queue->GetNBytes();
+        }
+        samples[i].sentBytes = port.sentBytes;
+        samples[i].droppedBytes = port.droppedBytes;
+    }
+    if (m_file)
+    {
+        m_file->write((const char*)samples, m_ports.size() * sizeof(Sample));
+    }
+    ++m_nSamples;
+    m_event = Simulator::Schedule(m_interval, &PortTelemetry::SampleAll, this);
+}
+
+uint32_t
+PortTelemetry::GetNPorts() const
+{
+    return m_ports.size();
+}
+
+uint64_t
+PortTelemetry::GetNSamples() const
+{
+    return m_nSamples;
+}
+
+const PortTelemetry::Sample&
+PortTelemetry::GetSample(uint32_t port, uint32_t age) const
+{
+    NS_ASSERT_MSG(port < m_ports.size(), "Invalid port " << port);
+    NS_ASSERT_MSG(age < std::min<uint64_t>(m_nSamples, m_historySize), "Sample not kept");
+    return m_samples[((m_nSamples - 1 - age) % m_historySize) * m_ports.size() + port];
+}
+
+uint32_t
+PortTelemetry::GetIntervals(Time window) const
+{
+    if (m_nSamples == 0)
+    {
+        return 0;
+    }
+    uint64_t intervals = window.GetTimeStep() / m_interval.GetTimeStep();
+    return std::min<uint64_t>({intervals, m_nSamples - 1, m_historySize - 1});
+}
+
+double
+PortTelemetry::GetThroughput(uint32_t port, Time window) const
+{
+    uint32_t intervals = GetIntervals(window);
+    if (intervals == 0)
+    {
+        return 0;
+    }
+    uint64_t bytes = GetSample(port).sentBytes - GetSample(port, intervals).sentBytes;
+    return bytes * 8 / (m_interval.GetSeconds() * intervals);
+}
+
+double
+PortTelemetry::GetUtilization(uint32_t port, Time window) const
+{
+    uint64_t rate = m_ports[port].rate.GetBitRate();
+    return rate == 0 ? 0 : GetThroughput(port, window) / rate;
+}
+
+double
+PortTelemetry::GetMeanQueueBytes(uint32_t port, Time window) const
+{
+    if (m_nSamples == 0)
+    {
+        return 0;
+    }
+    uint32_t intervals = GetIntervals(window);
+    double bytes = 0;
+    for (uint32_t age = 0; age <= intervals; ++age)
+    {
+        bytes += GetSample(port, age).bytes;
+    }
+    return bytes / (intervals + 1);
+}
+
+} // namespace ns3
@@ -0,0 +1,237 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PORT_TELEMETRY_H
+#define PORT_TELEMETRY_H
+
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class AsyncFileStream;
+class NetDevice;
+class QueueBase;
+class QueueDisc;
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Periodic sampler of the queues of many ports
+ *
+ * PortTelemetry samples the occupancy and the sent and dropped byte
+ * counters of registered queues, queue discs and devices every Interval,
+ * with a single event for all the ports, instead of a trace sink called
+ * for each packet.  The last HistorySize samples of each port are kept
+ * in a ring buffer allocated when sampling starts, which answers the
+ * windowed queries, e.g. the utilization of a port for adaptive routing.
+ *
+ * With an output file, all the samples are also written to it, from a
+ * background thread.  All the integers are in the byte order of the
+ * simulation host.  The file starts with the magic "NS3TELM", a null
+ * byte, a \c uint32_t version, the \c uint32_t number of ports, and the
+ * \c int64_t number of time steps per second, interval and time of the
+ * first sample, in time steps.  A description of each port follows: its
+ * \c uint32_t PortTelemetry::PortKind, node id and interface index,
+ * a \c uint32_t zero and the \c uint64_t data rate of the port in bit/s.
+ * Then come the samples, a PortTelemetry::Sample for each port at each
+ * interval.
+ */
+class PortTelemetry : public Object
+{
+  public:
+    /** The kind of object sampled for a port. */
+    enum PortKind : uint32_t
+    {
+        QUEUE = 0,      //!< A Queue
+        QUEUE_DISC = 1, //!< A QueueDisc
+        DEVICE = 2      //!< The transmission queue of a NetDevice
+    };
+
+    /** A sample of a port. */
+    struct Sample
+    {
+        uint32_t packets;      //!< Number of packets in the queue
+        uint32_t bytes;        //!< Number of bytes in the queue
+        uint64_t sentBytes;    //!< Bytes which left the queue since sampling started
+        uint64_t droppedBytes; //!< Bytes dropped since sampling started
+    };
+
+    /** Unknown node id or interface index. */
+    static constexpr uint32_t UNKNOWN = UINT32_MAX;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    PortTelemetry();
+    ~PortTelemetry() override;
+
+    /**
+     * Register a queue.
+     *
+     * \param queue the queue
+     * \param rate the rate the queue is drained at, to compute its
+     *             utilization
+     * \returns the index of the port
+     */
+    uint32_t AddQueue(Ptr<QueueBase> queue, DataRate rate = DataRate(0));
+
+    /**
+     * Register a queue disc.
+     *
+     * \param queueDisc the queue disc
+     * \param rate the rate the queue disc is drained at, to compute its
+     *             utilization
+     * \returns the index of the port
+     */
+    uint32_t AddQueueDisc(Ptr<QueueDisc> queueDisc, DataRate rate = DataRate(0));
+
+    /**
+     * Register the transmission queue of a device, found with its
+     * TxQueue attribute, and drained at the rate of its DataRate
+     * attribute, if any.
+     *
+     * \param device the device
+     * \returns the index of the port
+     */
+    uint32_t AddDevice(Ptr<NetDevice> device);
+
+    /**
+     * Write all the samples to a file.  Must be called before Start().
+     *
+     * \param filename the name of the file
+     */
+    void SetOutputFile(const std::string& filename);
+
+    /**
+     * Sample all the ports now, and then every Interval.  No port may be
+     * registered afterwards.
+     */
+    void Start();
+
+    /**
+     * Stop sampling, and close the output file.
+     */
+    void Stop();
+
+    /**
+     * \returns the number of ports
+     */
+    uint32_t GetNPorts() const;
+
+    /**
+     * \returns the number of samples taken of each port
+     */
+    uint64_t GetNSamples() const;
+
+    /**
+     * \param port the index of a port
+     * \param age the number of intervals since the sample, lower than
+     *            HistorySize and the number of samples
+     * \returns the sample of the port
+     */
+    const Sample& GetSample(uint32_t port, uint32_t age = 0) const;
+
+    /**
+     * \param port the index of a port
+     * \param window the duration of the window, rounded down to a number
+     *               of intervals, and to the history
+     * \returns the rate the port sent at during the window, in bit/s
+     */
+    double GetThroughput(uint32_t port, Time window) const;
+
+    /**
+     * \param port the index of a port
+     * \param window the duration of the window, rounded down to a number
+     *               of intervals, and to the history
+     * \returns the fraction of the rate of the port used during the
+     *          window, 0 if the rate is unknown
+     */
+    double GetUtilization(uint32_t port, Time window) const;
+
+    /**
+     * \param port the index of a port
+     * \param window the duration of the window, rounded down to a number
+     *               of intervals, and to the history
+     * \returns the mean number of bytes in the queue of the port over
+     *          the samples of the window
+     */
+    double GetMeanQueueBytes(uint32_t port, Time window) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /** A registered port. */
+    struct Port
+    {
+        PortKind kind;             //!< the kind of the port
+        Ptr<QueueBase> queue;      //!< the queue, for a queue or a device
+        Ptr<QueueDisc> queueDisc;  //!< the queue disc
+        DataRate rate;             //!< the rate the port is drained at
+        uint32_t nodeId;           //!< the node of the port, or UNKNOWN
+        uint32_t ifIndex;          //!< the interface index of the port, or UNKNOWN
+        uint32_t lastSentBytes;    //!< last value of the sent bytes counter of a queue
+        uint32_t lastDroppedBytes; //!< last value of the dropped bytes counter of a queue
+        uint64_t sentBytes;        //!< bytes sent since sampling started
+        uint64_t droppedBytes;     //!< bytes dropped since sampling started
+    };
+
+    /**
+     * \param port the port to register
+     * \returns the index of the port
+     */
+    uint32_t AddPort(Port port);
+
+    /** Read the counters of a port. */
+    void ReadCounters(Port& port) const;
+
+    /** Sample all the ports. */
+    void SampleAll();
+
+    /** Write the header of the output file. */
+    void WriteHeader();
+
+    /**
+     * \param window the duration of a window
+     * \returns the number of intervals of the window in the history
+     */
+    uint32_t GetIntervals(Time window) const;
+
+    Time m_interval;                         //!< the sampling interval
+    uint32_t m_historySize;                  //!< the number of samples kept per port
+    std::vector<Port> m_ports;               //!< the ports
+    std::vector<Sample> m_samples;           //!< the rings of samples, one after the other
+    uint64_t m_nSamples;                     //!< the number of samples of each port
+    Time m_start;                            //!< the time of the first sample
+    EventId m_event;                         //!< the next sampling event
+    std::string m_filename;                  //!< the name of the output file
+    std::unique_ptr<AsyncFileStream> m_file; //!< the output file
+};
+
+} // namespace ns3
+
+#endif /* PORT_TELEMETRY_H */
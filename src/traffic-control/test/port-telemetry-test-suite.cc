@@ -0,0 +1,138 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/drop-tail-queue.h"
+#include "ns3/packet.h"
+#include "ns3/port-telemetry.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Port Telemetry Test Case
+ */
+class PortTelemetryTestCase : public TestCase
+{
+  public:
+    PortTelemetryTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Enqueue a packet, and dequeue it if asked to.
+     *
+     * \param dequeue whether to dequeue the packet
+     */
+    void Send(bool dequeue);
+
+    Ptr<Queue<Packet>> m_queue; //!< the sampled queue
+};
+
+PortTelemetryTestCase::PortTelemetryTestCase()
+    : TestCase("Sanity check on the samples and windowed queries of PortTelemetry")
+{
+}
+
+void
+PortTelemetryTestCase::Send(bool dequeue)
+{
+    m_queue->Enqueue(Create<Packet>(500));
+    if (dequeue)
+    {
+        m_queue->Dequeue();
+    }
+}
+
+void
+PortTelemetryTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("port-telemetry.bin");
+    m_queue = CreateObject<DropTailQueue<Packet>>();
+
+    Ptr<PortTelemetry> telemetry = CreateObject<PortTelemetry>();
+    telemetry->SetAttribute("Interval", TimeValue(MilliSeconds(1)));
+    telemetry->SetAttribute("HistorySize", UintegerValue(8));
+    uint32_t port = telemetry->AddQueue(m_queue, DataRate("8Mbps"));
+    telemetry->SetOutputFile(filename);
+    Simulator::ScheduleNow(&PortTelemetry::Start, telemetry);
+
+    // One packet of 500 bytes sent each millisecond, and the last one
+    // left in the queue
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        Simulator::Schedule(MicroSeconds(1000 * i + 500), &PortTelemetryTestCase::Send, this, i < 9);
+    }
+    Simulator::Stop(MicroSeconds(10500));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(telemetry->GetNPorts(), 1, "Wrong number of ports");
+    NS_TEST_ASSERT_MSG_EQ(telemetry->GetNSamples(), 11, "Wrong number of samples");
+    NS_TEST_EXPECT_MSG_EQ(telemetry->GetSample(port).packets, 1, "Wrong queue length");
+    NS_TEST_EXPECT_MSG_EQ(telemetry->GetSample(port).bytes, 500, "Wrong queue length");
+    NS_TEST_EXPECT_MSG_EQ(telemetry->GetSample(port).sentBytes, 4500, "Wrong sent bytes");
+    NS_TEST_EXPECT_MSG_EQ(telemetry->GetSample(port, 1).bytes, 0, "Wrong queue length");
+    NS_TEST_EXPECT_MSG_EQ(telemetry->GetSample(port, 1).sentBytes, 4500, "Wrong sent bytes");
+
+    // 3 packets sent in the last 4 intervals
+    NS_TEST_EXPECT_MSG_EQ_TOL(telemetry->GetThroughput(port, MilliSeconds(4)),
+                              3e6,
+                              1,
+                              "Wrong throughput");
+    NS_TEST_EXPECT_MSG_EQ_TOL(telemetry->GetUtilization(port, MilliSeconds(4)),
+                              0.375,
+                              1e-9,
+                              "Wrong utilization");
+    NS_TEST_EXPECT_MSG_EQ_TOL(telemetry->GetMeanQueueBytes(port, MilliSeconds(4)),
+                              100,
+                              1e-9,
+                              "Wrong mean queue length");
+    // The window is limited to the history
+    NS_TEST_EXPECT_MSG_EQ_TOL(telemetry->GetThroughput(port, MilliSeconds(100)),
+                              500 * 6 * 8 / 7e-3,
+                              1,
+                              "Wrong throughput over the history");
+
+    telemetry->Dispose();
+    Simulator::Destroy();
+
+    // Header, description of the port and samples
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    NS_TEST_EXPECT_MSG_EQ(file.tellg(), 40 + 24 + 11 * 24, "Wrong file length");
+    file.close();
+    std::remove(filename.c_str());
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Port Telemetry Test Suite
+ */
+static class PortTelemetryTestSuite : public TestSuite
+{
+  public:
+    PortTelemetryTestSuite()
+        : TestSuite("port-telemetry", UNIT)
+    {
+        AddTestCase(new PortTelemetryTestCase(), TestCase::QUICK);
+    }
+} g_portTelemetryTestSuite; ///< the test suite
@@ -0,0 +1,651 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the coroutine runtime and the MPI replay: the
+// creation of coroutine frames, co_await chains, CoroutineSocket on the
+// loopback and over a point-to-point link, the MPICommunicator collectives
+// on a star of ranks, and optionally the replay of a directory of DUMPI
+// traces, one file per rank.  The results are written as JSON.
+// Sample usage:  ./ns3 run 'bench-coroutine --n=100000 --output=bench.json'
+
+#include "ns3/core-module.h"
+#include "ns3/coroutine-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mpi-application-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+/** The port the MPI ranks listen on. */
+const uint16_t MPI_PORT = 10000;
+
+/**
+ * Escape a string for JSON.
+ *
+ * \param [in] str The string.
+ * \returns The escaped string.
+ */
+std::string
+Escape(const std::string& str)
+{
+    std::string escaped;
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+/**
+ * The result of one benchmark, a flat JSON object.
+ */
+class Result
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] name The name of the benchmark.
+     */
+    Result(const std::string& name)
+    {
+        Set("name", name);
+    }
+
+    /**
+     * Set a string field.
+     * \param [in] key The name of the field.
+     * \param [in] value The value of the field.
+     * \returns This result.
+     */
+    Result& Set(const std::string& key, const std::string& value)
+    {
+        m_fields.emplace_back(key, "\"" + Escape(value) + "\"");
+        return *this;
+    }
+
+    /**
+     * Set an integer field.
+     * \param [in] key The name of the field.
+     * \param [in] value The value of the field.
+     * \returns This result.
+     */
+    Result& Set(const std::string& key, uint64_t value)
+    {
+        m_fields.emplace_back(key, std::to_string(value));
+        return *this;
+    }
+
+    /**
+     * Set a floating point field, null if it is not finite.
+     * \param [in] key The name of the field.
+     * \param [in] value The value of the field.
+     * \returns This result.
+     */
+    Result& Set(const std::string& key, double value)
+    {
+        std::ostringstream oss;
+        if (std::isfinite(value))
+        {
+            oss << std::setprecision(9) << value;
+        }
+        else
+        {
+            oss << "null";
+        }
+        m_fields.emplace_back(key, oss.str());
+        return *this;
+    }
+
+    /**
+     * Write the result as a JSON object.
+     * \param [in,out] os The output stream.
+     */
+    void Write(std::ostream& os) const
+    {
+        os << "{";
+        for (std::size_t i = 0; i < m_fields.size(); ++i)
+        {
+            os << (i ? ", " : "") << "\"" << m_fields[i].first << "\": " << m_fields[i].second;
+        }
+        os << "}";
+    }
+
+  private:
+    /** The fields, with their values in JSON. */
+    std::vector<std::pair<std::string, std::string>> m_fields;
+};
+
+/** Wall clock timer with sub-millisecond resolution. */
+class Stopwatch
+{
+  public:
+    Stopwatch()
+        : m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    /** \returns The seconds elapsed since construction. */
+    double Seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+  private:
+    std::chrono::steady_clock::time_point m_start; //!< Start time.
+};
+
+/**
+ * A coroutine which completes at once.
+ * \param [in] i The value to return.
+ * \returns \p i.
+ */
+CoroutineOperation<uint64_t>
+Frame(uint64_t i)
+{
+    co_return i;
+}
+
+/**
+ * Create and destroy coroutine frames.
+ * \param [in] n The number of frames.
+ * \returns The result.
+ */
+Result
+BenchFrames(uint64_t n)
+{
+    uint64_t sum = 0;
+    Stopwatch watch;
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        sum += Frame(i).result();
+    }
+    double seconds = watch.Seconds();
+    NS_ABORT_MSG_UNLESS(sum == n * (n - 1) / 2, "Wrong coroutine results");
+    return Result("frame")
+        .Set("frames", n)
+        .Set("seconds", seconds)
+        .Set("frames_per_second", n / seconds);
+}
+
+/**
+ * A chain of coroutines, each awaiting the next one, the last one
+ * awaiting a pending operation.
+ * \param [in] depth The number of coroutines after this one.
+ * \param [in] leaf The pending operation.
+ * \returns The result of the leaf plus \p depth.
+ */
+CoroutineOperation<uint64_t>
+Chain(uint32_t depth, CoroutineOperation<uint64_t> leaf)
+{
+    if (depth == 0)
+    {
+        co_return co_await leaf;
+    }
+    co_return co_await Chain(depth - 1, leaf) + 1;
+}
+
+/**
+ * Suspend chains of coroutines on a pending operation, and resume them by
+ * completing it.
+ * \param [in] depth The number of coroutines of each chain.
+ * \param [in] n The number of chains.
+ * \returns The result.
+ */
+Result
+BenchChain(uint32_t depth, uint64_t n)
+{
+    Stopwatch watch;
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        auto leaf = makeCoroutineOperation<uint64_t>();
+        auto chain = Chain(depth - 1, leaf);
+        leaf.terminate(i);
+        NS_ABORT_MSG_UNLESS(chain.done() && chain.result() == i + depth - 1,
+                            "Wrong co_await chain result");
+    }
+    double seconds = watch.Seconds();
+    return Result("await-chain")
+        .Set("depth", static_cast<uint64_t>(depth))
+        .Set("chains", n)
+        .Set("seconds", seconds)
+        .Set("ns_per_level", seconds * 1e9 / (static_cast<double>(n) * depth));
+}
+
+/**
+ * Send and receive messages on a loopback socket.
+ * \param [in] socket The socket, which must outlive the events it schedules.
+ * \param [in] n The number of messages.
+ * \param [in] size The size of the messages.
+ * \param [out] received The number of messages received.
+ * \returns The operation.
+ */
+CoroutineOperation<void>
+Loopback(CoroutineSocket* socket, uint64_t n, uint32_t size, uint64_t* received)
+{
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        co_await socket->send(Create<Packet>(size));
+        auto [packet, error] = std::move(co_await socket->receive(size));
+        if (error == Socket::ERROR_NOTERROR && packet->GetSize() == size)
+        {
+            ++*received;
+        }
+    }
+}
+
+/**
+ * Send and receive messages on a loopback CoroutineSocket.
+ * \param [in] n The number of messages.
+ * \param [in] size The size of the messages.
+ * \returns The result.
+ */
+Result
+BenchLoopback(uint64_t n, uint32_t size)
+{
+    CoroutineSocket socket;
+    uint64_t received = 0;
+    Stopwatch watch;
+    auto operation = Loopback(&socket, n, size, &received);
+    Simulator::Run();
+    double seconds = watch.Seconds();
+    NS_ABORT_MSG_UNLESS(operation.done() && received == n, "Loopback messages lost");
+    Simulator::Destroy();
+    return Result("loopback-socket")
+        .Set("messages", n)
+        .Set("size", static_cast<uint64_t>(size))
+        .Set("seconds", seconds)
+        .Set("ops_per_second", 2 * n / seconds);
+}
+
+/**
+ * Accept a connection and receive messages from it.
+ * \param [in] node The node.
+ * \param [in] n The number of messages.
+ * \param [in] size The size of the messages.
+ * \param [out] received The number of messages received.
+ * \returns The operation.
+ */
+CoroutineOperation<void>
+Server(Ptr<Node> node, uint64_t n, uint32_t size, uint64_t* received)
+{
+    CoroutineSocket listener(node, TcpSocketFactory::GetTypeId());
+    listener.bind(InetSocketAddress(Ipv4Address::GetAny(), MPI_PORT));
+    auto accepted = std::move(co_await listener.accept());
+    auto& socket = std::get<0>(accepted);
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        auto [packet, error] = std::move(co_await socket.receive(size));
+        if (error != Socket::ERROR_NOTERROR)
+        {
+            break;
+        }
+        ++*received;
+    }
+    socket.close();
+    listener.close();
+}
+
+/**
+ * Connect to a server and send messages to it.
+ * \param [in] node The node.
+ * \param [in] server The address of the server.
+ * \param [in] n The number of messages.
+ * \param [in] size The size of the messages.
+ * \returns The operation.
+ */
+CoroutineOperation<void>
+Client(Ptr<Node> node, Ipv4Address server, uint64_t n, uint32_t size)
+{
+    CoroutineSocket socket(node, TcpSocketFactory::GetTypeId());
+    if (co_await socket.connect(InetSocketAddress(server, MPI_PORT)) != Socket::ERROR_NOTERROR)
+    {
+        co_return;
+    }
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        co_await socket.send(Create<Packet>(size));
+    }
+    socket.close();
+}
+
+/**
+ * Send messages between two CoroutineSockets over a point-to-point link.
+ * \param [in] n The number of messages.
+ * \param [in] size The size of the messages.
+ * \param [in] p2p The helper of the link.
+ * \returns The result.
+ */
+Result
+BenchPointToPoint(uint64_t n, uint32_t size, PointToPointHelper p2p)
+{
+    NodeContainer nodes(2);
+    NetDeviceContainer devices = p2p.Install(nodes);
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    Ipv4AddressHelper address("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // Started once the simulation initialized the nodes and their queue discs
+    uint64_t received = 0;
+    std::optional<CoroutineOperation<void>> server;
+    std::optional<CoroutineOperation<void>> client;
+    Simulator::ScheduleWithContext(nodes.Get(1)->GetId(), Seconds(0), [&]() {
+        server = Server(nodes.Get(1), n, size, &received);
+    });
+    Simulator::ScheduleWithContext(nodes.Get(0)->GetId(), Seconds(0), [&]() {
+        client = Client(nodes.Get(0), interfaces.GetAddress(1), n, size);
+    });
+    Stopwatch watch;
+    Simulator::Run();
+    double seconds = watch.Seconds();
+    uint64_t events = Simulator::GetEventCount();
+    double simulated = Simulator::Now().GetSeconds();
+    NS_ABORT_MSG_UNLESS(server && server->done() && client && client->done() && received == n,
+                        "Point-to-point messages lost");
+    Simulator::Destroy();
+    return Result("p2p-socket")
+        .Set("messages", n)
+        .Set("size", static_cast<uint64_t>(size))
+        .Set("seconds", seconds)
+        .Set("ops_per_second", 2 * n / seconds)
+        .Set("events", events)
+        .Set("events_per_second", events / seconds)
+        .Set("simulated_seconds", simulated);
+}
+
+/** The progress of a run of MPI ranks, between two marks of rank 0. */
+struct Marks
+{
+    double start{0};      //!< Wall clock seconds at the first mark.
+    double end{0};        //!< Wall clock seconds at the second mark.
+    uint64_t events[2]{}; //!< Simulator event count at each mark.
+    Time now[2];          //!< Simulated time at each mark.
+};
+
+/**
+ * Replay the functions of MPI ranks, each on a spoke of a star.
+ * \param [in] functions The functions of each rank.
+ * \param [in] p2p The helper of the links of the star.
+ * \returns The wall clock seconds of the whole run.
+ */
+double
+RunRanks(std::vector<std::queue<MPIFunction>> functions, PointToPointHelper p2p)
+{
+    auto nRanks = static_cast<uint32_t>(functions.size());
+    PointToPointStarHelper star(nRanks, p2p);
+    InternetStackHelper stack;
+    star.InstallStack(stack);
+    star.AssignIpv4Addresses(Ipv4AddressHelper("10.1.1.0", "255.255.255.0"));
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    std::map<MPIRankIDType, Address> addresses;
+    std::map<Address, MPIRankIDType> ranks;
+    for (uint32_t i = 0; i < nRanks; ++i)
+    {
+        addresses[i] = InetSocketAddress(star.GetSpokeIpv4Address(i), MPI_PORT);
+        ranks[star.GetSpokeIpv4Address(i)] = i;
+    }
+    for (uint32_t i = 0; i < nRanks; ++i)
+    {
+        auto application =
+            CreateObject<MPIApplication>(i, addresses, ranks, std::move(functions[i]));
+        star.GetSpokeNode(i)->AddApplication(application);
+        application->SetStartTime(Seconds(0));
+    }
+
+    Stopwatch watch;
+    Simulator::Run();
+    return watch.Seconds();
+}
+
+/**
+ * \param [in] marks The marks to set.
+ * \param [in] watch The wall clock of the run.
+ * \param [in] index The index of the mark, 0 or 1.
+ * \returns The function setting the mark.
+ */
+MPIFunction
+Mark(Marks* marks, const Stopwatch* watch, int index)
+{
+    return [marks, watch, index](MPIApplication&) -> CoroutineOperation<void> {
+        (index ? marks->end : marks->start) = watch->Seconds();
+        marks->events[index] = Simulator::GetEventCount();
+        marks->now[index] = Simulator::Now();
+        co_return;
+    };
+}
+
+/**
+ * Measure the cost of a collective operation of MPICommunicator, on a star
+ * of ranks.
+ * \param [in] collective The collective: barrier, broadcast or allreduce.
+ * \param [in] nRanks The number of ranks.
+ * \param [in] repetitions The number of collectives.
+ * \param [in] count The number of doubles of a broadcast or allreduce.
+ * \param [in] p2p The helper of the links of the star.
+ * \returns The result.
+ */
+Result
+BenchCollective(const std::string& collective,
+                uint32_t nRanks,
+                uint32_t repetitions,
+                int count,
+                PointToPointHelper p2p)
+{
+    Marks marks;
+    Stopwatch watch;
+    std::vector<std::queue<MPIFunction>> functions(nRanks);
+    for (uint32_t rank = 0; rank < nRanks; ++rank)
+    {
+        auto& q = functions[rank];
+        q.emplace([](MPIApplication& application) -> CoroutineOperation<void> {
+            co_await application.Initialize();
+        });
+        // the collectives start when all the ranks are connected
+        q.emplace([](MPIApplication& application) -> CoroutineOperation<void> {
+            co_await application.communicator(WORLD_COMMUNICATOR).Barrier();
+        });
+        if (rank == 0)
+        {
+            q.emplace(Mark(&marks, &watch, 0));
+        }
+        for (uint32_t i = 0; i < repetitions; ++i)
+        {
+            q.emplace([collective, count](MPIApplication& application) -> CoroutineOperation<void> {
+                auto& c = application.communicator(WORLD_COMMUNICATOR);
+                if (collective == "barrier")
+                {
+                    co_await c.Barrier();
+                }
+                else if (collective == "broadcast")
+                {
+                    co_await c.template Broadcast<std::vector<double>>(FakePacket, 0, count);
+                }
+                else
+                {
+                    co_await c.template AllReduce<std::vector<double>>(FakePacket, count);
+                }
+            });
+        }
+        if (rank == 0)
+        {
+            q.emplace(Mark(&marks, &watch, 1));
+        }
+        q.emplace([](MPIApplication& application) -> CoroutineOperation<void> {
+            application.Finalize();
+            co_return;
+        });
+    }
+
+    RunRanks(std::move(functions), p2p);
+    Simulator::Destroy();
+    NS_ABORT_MSG_UNLESS(marks.end > 0, "The " << collective << " collectives did not complete");
+
+    double seconds = marks.end - marks.start;
+    return Result("collective")
+        .Set("collective", collective)
+        .Set("group_size", static_cast<uint64_t>(nRanks))
+        .Set("repetitions", static_cast<uint64_t>(repetitions))
+        .Set("count", static_cast<uint64_t>(count))
+        .Set("seconds", seconds)
+        .Set("us_per_collective", seconds * 1e6 / repetitions)
+        .Set("events_per_collective",
+             static_cast<double>(marks.events[1] - marks.events[0]) / repetitions)
+        .Set("simulated_us_per_collective",
+             (marks.now[1] - marks.now[0]).GetMicroSeconds() / static_cast<double>(repetitions));
+}
+
+/**
+ * Replay a directory of DUMPI traces, one file per rank.
+ * \param [in] traceDir The directory of the traces.
+ * \param [in] p2p The helper of the links of the star of ranks.
+ * \returns The result.
+ */
+Result
+BenchReplay(const std::string& traceDir, PointToPointHelper p2p)
+{
+    Stopwatch parse;
+    auto functions = parse_traces(traceDir);
+    double parseSeconds = parse.Seconds();
+    auto nRanks = static_cast<uint64_t>(functions.size());
+    uint64_t total = 0;
+    for (const auto& q : functions)
+    {
+        total += q.size();
+    }
+
+    double seconds = RunRanks(std::move(functions), p2p);
+    uint64_t events = Simulator::GetEventCount();
+    double simulated = Simulator::Now().GetSeconds();
+    Simulator::Destroy();
+    return Result("replay")
+        .Set("trace_dir", traceDir)
+        .Set("ranks", nRanks)
+        .Set("functions", total)
+        .Set("parse_seconds", parseSeconds)
+        .Set("seconds", seconds)
+        .Set("functions_per_second", total / seconds)
+        .Set("events", events)
+        .Set("events_per_second", events / seconds)
+        .Set("simulated_seconds", simulated);
+}
+
+} // unnamed namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t n = 100000;
+    uint32_t size = 1024;
+    uint32_t messages = 1000;
+    uint32_t maxRanks = 16;
+    uint32_t repetitions = 20;
+    int count = 1024;
+    std::string dataRate = "10Gbps";
+    std::string delay = "1us";
+    std::string traceDir;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the coroutine runtime and the MPI replay, with results in JSON.");
+    cmd.AddValue("n", "number of coroutine frames, chains and loopback messages", n);
+    cmd.AddValue("size", "size of the socket messages", size);
+    cmd.AddValue("messages", "number of point-to-point messages", messages);
+    cmd.AddValue("maxRanks", "largest group of the collectives, from 2 by powers of 2", maxRanks);
+    cmd.AddValue("repetitions", "number of each collective", repetitions);
+    cmd.AddValue("count", "number of doubles of the broadcasts and allreduces", count);
+    cmd.AddValue("dataRate", "data rate of the point-to-point links", dataRate);
+    cmd.AddValue("delay", "delay of the point-to-point links", delay);
+    cmd.AddValue("traceDir", "directory of DUMPI traces to replay, one file per rank", traceDir);
+    cmd.AddValue("output", "output file, instead of the standard output", output);
+    cmd.Parse(argc, argv);
+
+    if (n == 0 || messages == 0 || repetitions == 0 || maxRanks < 2)
+    {
+        std::cerr << "Error-- n, messages and repetitions must be positive, and maxRanks at least 2"
+                  << std::endl;
+        return 1;
+    }
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue(dataRate));
+    p2p.SetChannelAttribute("Delay", StringValue(delay));
+
+    std::vector<Result> results;
+    std::cerr << "Coroutine frames and co_await chains" << std::endl;
+    results.push_back(BenchFrames(n));
+    for (uint32_t depth : {1, 16, 256})
+    {
+        results.push_back(BenchChain(depth, std::max<uint64_t>(n / depth, 1)));
+    }
+    std::cerr << "CoroutineSocket" << std::endl;
+    results.push_back(BenchLoopback(n, size));
+    results.push_back(BenchPointToPoint(messages, size, p2p));
+    for (const std::string collective : {"barrier", "broadcast", "allreduce"})
+    {
+        for (uint32_t nRanks = 2; nRanks <= maxRanks; nRanks *= 2)
+        {
+            std::cerr << "MPICommunicator " << collective << " of " << nRanks << " ranks"
+                      << std::endl;
+            results.push_back(BenchCollective(collective, nRanks, repetitions, count, p2p));
+        }
+    }
+    if (!traceDir.empty())
+    {
+        std::cerr << "Replay of " << traceDir << std::endl;
+        results.push_back(BenchReplay(traceDir, p2p));
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        if (!file.is_open())
+        {
+            std::cerr << "Unable to open " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+    os << "{\"benchmark\": \"bench-coroutine\", \"results\": [" << std::endl;
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        os << "  ";
+        results[i].Write(os);
+        os << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    os << "]}" << std::endl;
+    return 0;
+}
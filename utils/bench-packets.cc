@@ -32,6 +32,7 @@
 #include <sstream>
 #include <stdlib.h> // for exit ()
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -350,6 +351,44 @@ benchByteTags(uint32_t n)
     }
 }
 
+/// Packets kept alive by benchInFlight, as in the queues of a simulation
+static std::vector<Ptr<Packet>> g_inFlight(1000);
+
+static void
+benchCycle(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+
+    // the cycle of a packet crossing a point to point link
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(500);
+        p->AddHeader(udp);
+        p->AddHeader(ipv4);
+        Ptr<Packet> o = p->Copy();
+        p = nullptr;
+        o->RemoveHeader(ipv4);
+        o->RemoveHeader(udp);
+    }
+}
+
+static void
+benchInFlight(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+
+    // packets are released long after, and in another order than, their creation
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(500);
+        p->AddHeader(udp);
+        p->AddHeader(ipv4);
+        g_inFlight[(i * 7919) % g_inFlight.size()] = p->Copy();
+    }
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -407,6 +446,12 @@ main(int argc, char* argv[])
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    runBench(&benchCycle, n, minIterations, "Create, add headers, copy, remove headers");
+    runBench(&benchInFlight, n, minIterations, "Same, with 1000 packets in flight");
+
+    Packet::PoolStatistics stats = Packet::GetPoolStatistics();
+    std::cout << stats.allocations << " packets allocated, " << stats.heapAllocations
+              << " from the heap" << std::endl;
 
     return 0;
 }
@@ -0,0 +1,81 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts a binary DES Metrics trace, written with
+// --DesMetricsFormat=Binary, to the DES Metrics JSON format or to the
+// Chrome trace event format displayed by Perfetto.
+// Sample usage:  ./ns3 run 'des-metrics-convert --input=my-script.desm --format=perfetto'
+
+#include "ns3/command-line.h"
+#include "ns3/des-metrics-converter.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+    std::string format = "json";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Convert a binary DES Metrics trace to JSON or to the Chrome trace event format.\n"
+              "The default output file is the input file, with the .json extension for the\n"
+              "json format and the .perfetto.json extension for the perfetto format.");
+    cmd.AddValue("input", "binary trace file", input);
+    cmd.AddValue("output", "output file", output);
+    cmd.AddValue("format", "output format, json or perfetto", format);
+    cmd.Parse(argc, argv);
+
+    if (input.empty() || (format != "json" && format != "perfetto"))
+    {
+        std::cerr << "Usage: des-metrics-convert --input=<file> [--format=json|perfetto] "
+                     "[--output=<file>]"
+                  << std::endl;
+        return 1;
+    }
+    if (output.empty())
+    {
+        output = input.substr(0, input.rfind(".desm")) +
+                 (format == "json" ? ".json" : ".perfetto.json");
+    }
+
+    std::ifstream is(input, std::ios::binary);
+    DesMetricsConverter converter;
+    if (!converter.ReadHeader(is))
+    {
+        std::cerr << "Not a binary DES Metrics trace: " << input << std::endl;
+        return 1;
+    }
+    std::ofstream os(output);
+    if (!os.is_open())
+    {
+        std::cerr << "Unable to open " << output << std::endl;
+        return 1;
+    }
+    if (!converter.Convert(is,
+                           os,
+                           format == "json" ? DesMetricsConverter::JSON
+                                            : DesMetricsConverter::PERFETTO))
+    {
+        std::cerr << "Truncated or corrupt trace: " << input << std::endl;
+        return 1;
+    }
+    return 0;
+}